@@ -0,0 +1,28 @@
+// C++ driver for application to extract a horizontal subset of a model.
+
+#include "geomodelgrids/apps/Extract.hh" // USES Extract
+
+#include <stdexcept> // USES std::exception
+#include <iostream> // USES std::cerr
+
+int
+main(int argc,
+     char* argv[]) {
+    geomodelgrids::apps::Extract extract;
+
+    int err = 0;
+    try {
+      err = extract.run(argc, argv);
+    } catch (const std::exception& ex) {
+	std::cerr << ex.what() << std::endl;
+	err = 1;
+    } catch (...) {
+      std::cerr << "Caught unknown exception." << std::endl;
+      err = 2;
+    } // try/catch
+
+    return err;
+} // main
+
+
+// End of file
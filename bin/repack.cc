@@ -0,0 +1,28 @@
+// C++ driver for application to rewrite a model with different storage settings.
+
+#include "geomodelgrids/apps/Repack.hh" // USES Repack
+
+#include <stdexcept> // USES std::exception
+#include <iostream> // USES std::cerr
+
+int
+main(int argc,
+     char* argv[]) {
+    geomodelgrids::apps::Repack repack;
+
+    int err = 0;
+    try {
+      err = repack.run(argc, argv);
+    } catch (const std::exception& ex) {
+	std::cerr << ex.what() << std::endl;
+	err = 1;
+    } catch (...) {
+      std::cerr << "Caught unknown exception." << std::endl;
+      err = 2;
+    } // try/catch
+
+    return err;
+} // main
+
+
+// End of file
@@ -0,0 +1,172 @@
+"""Client for the geomodelgrids_queryd local query server.
+
+The server keeps the models open with warm caches and answers batches of queries over a Unix
+domain socket. See libsrc/geomodelgrids/serial/queryprotocol.h for the protocol.
+"""
+
+import socket
+import struct
+
+import numpy
+
+MAGIC = 0x51474d47
+MAX_POINTS = 16777216
+
+REQUEST_INFO = 0
+REQUEST_QUERY = 1
+REQUEST_TOP_ELEVATION = 2
+REQUEST_TOPOBATHY_ELEVATION = 3
+REQUEST_PROFILE = 4
+REQUEST_SHUTDOWN = 5
+
+STATUS_OK = 0
+
+REQUEST_HEADER = struct.Struct("=IIQddQ")
+RESPONSE_HEADER = struct.Struct("=IIQQQ")
+
+
+class QueryClient():
+    """Client for querying models served by geomodelgrids_queryd.
+
+    Usage:
+        client = QueryClient("/tmp/geomodelgrids.sock")
+        values, errors = client.query(points)
+        client.close()
+    """
+
+    def __init__(self, socket_path):
+        """Constructor.
+
+        Args:
+            socket_path(str)
+                Path of Unix domain socket for server.
+        """
+        self.socket = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.socket.connect(socket_path)
+        _, payload = self._request(REQUEST_INFO)
+        self.value_names = [name.decode("utf-8") for name in payload.split(b"\0")[:-1]]
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.close()
+
+    def query(self, points):
+        """Query for values at points.
+
+        Args:
+            points(numpy.ndarray)
+                Points (x, y, z) in server input CRS [numPoints, 3].
+
+        Returns:
+            Tuple of values [numPoints, numValues] and error codes [numPoints] (0 on success).
+        """
+        num_values = len(self.value_names)
+        num_points, payload = self._request(REQUEST_QUERY, points, 3)
+        values = numpy.frombuffer(payload, dtype=numpy.float64, count=num_points * num_values)
+        errors = numpy.frombuffer(payload, dtype=numpy.int32, count=num_points, offset=values.nbytes)
+        return values.reshape((num_points, num_values)), errors
+
+    def query_top_elevation(self, points):
+        """Query for elevation of top of model at points.
+
+        Args:
+            points(numpy.ndarray)
+                Points (x, y) in server input CRS [numPoints, 2].
+
+        Returns:
+            Elevations [numPoints].
+        """
+        num_points, payload = self._request(REQUEST_TOP_ELEVATION, points, 2)
+        return numpy.frombuffer(payload, dtype=numpy.float64, count=num_points)
+
+    def query_topobathy_elevation(self, points):
+        """Query for elevation of topography/bathymetry at points.
+
+        Args:
+            points(numpy.ndarray)
+                Points (x, y) in server input CRS [numPoints, 2].
+
+        Returns:
+            Elevations [numPoints].
+        """
+        num_points, payload = self._request(REQUEST_TOPOBATHY_ELEVATION, points, 2)
+        return numpy.frombuffer(payload, dtype=numpy.float64, count=num_points)
+
+    def query_profile(self, locations, dz, max_depth):
+        """Query for values along vertical profiles (boreholes) below the top surface.
+
+        Args:
+            locations(numpy.ndarray)
+                Locations (x, y) in server input CRS [numLocations, 2].
+            dz(float)
+                Vertical resolution of profile (m).
+            max_depth(float)
+                Maximum depth of profile (m).
+
+        Returns:
+            Tuple of samples [numLocations, numDepths, 2+numValues] with (elevation, depth, values)
+            and error codes [numLocations, numDepths] (0 on success).
+        """
+        sample_size = 2 + len(self.value_names)
+        num_locations = len(locations)
+        num_samples, payload = self._request(REQUEST_PROFILE, locations, 2, dz, max_depth)
+        num_depths = num_samples // num_locations if num_locations else 0
+        samples = numpy.frombuffer(payload, dtype=numpy.float64, count=num_samples * sample_size)
+        errors = numpy.frombuffer(payload, dtype=numpy.int32, count=num_samples, offset=samples.nbytes)
+        return samples.reshape((num_locations, num_depths, sample_size)), errors.reshape((num_locations, num_depths))
+
+    def shutdown(self):
+        """Ask server to shut down."""
+        self._request(REQUEST_SHUTDOWN)
+        self.close()
+
+    def close(self):
+        """Close connection to server."""
+        if self.socket:
+            self.socket.close()
+        self.socket = None
+
+    def _request(self, request_type, points=None, space_dim=0, dz=0.0, max_depth=0.0):
+        """Send request and receive response.
+
+        Returns:
+            Tuple of number of points in response and response payload.
+        """
+        if self.socket is None:
+            raise ConnectionError("Query client is not connected to a query server.")
+        if points is not None:
+            points = numpy.ascontiguousarray(points, dtype=numpy.float64).reshape((-1, space_dim))
+            num_points = points.shape[0]
+            if num_points > MAX_POINTS:
+                raise ValueError(f"Number of points in request ({num_points}) exceeds maximum ({MAX_POINTS}). "
+                                 "Split the points into multiple requests.")
+        else:
+            num_points = 0
+        self.socket.sendall(REQUEST_HEADER.pack(MAGIC, request_type, num_points, dz, max_depth, 0))
+        if num_points > 0:
+            self.socket.sendall(points.tobytes())
+
+        magic, status, num_points, _, payload_size = RESPONSE_HEADER.unpack(self._recv(RESPONSE_HEADER.size))
+        if magic != MAGIC:
+            raise ConnectionError("Error receiving response from query server.")
+        payload = self._recv(payload_size)
+        if status != STATUS_OK:
+            raise RuntimeError("Query server error: " + payload.decode("utf-8"))
+        return num_points, payload
+
+    def _recv(self, num_bytes):
+        """Receive exactly num_bytes from server."""
+        buffer = bytearray(num_bytes)
+        view = memoryview(buffer)
+        num_received = 0
+        while num_received < num_bytes:
+            n = self.socket.recv_into(view[num_received:], num_bytes - num_received)
+            if n == 0:
+                raise ConnectionError("Query server closed connection.")
+            num_received += n
+        return bytes(buffer)
+
+
+# End of file
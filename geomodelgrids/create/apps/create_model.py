@@ -5,12 +5,100 @@ import sys
 import argparse
 import logging
 import configparser
+import copy
+import concurrent.futures
+import multiprocessing
 from importlib import import_module
 
 import geomodelgrids.create.core as core
 from geomodelgrids.create.utils import config
 
 
+def _create_datasrc(model_config):
+    """Create and initialize data source given by the configuration.
+
+    Args:
+        model_config (dict)
+            Model configuration.
+    Returns:
+        Initialized data source.
+    """
+    data_path = model_config["geomodelgrids"]["data_source"].split(".")
+    data_obj = getattr(import_module(".".join(data_path[:-1])), data_path[-1])
+    datasrc = data_obj(model_config)
+    datasrc.initialize()
+    return datasrc
+
+
+class _SurfaceCache():
+    """Elevation of a surface held in memory, used by worker processes in place of the model file.
+
+    The parent process writes the model file while the workers evaluate batches, so the workers
+    do not read the surfaces from the file.
+    """
+
+    def __init__(self, elevation):
+        """Constructor.
+
+        Args:
+            elevation (numpy.array [Nx,Ny,1])
+                Elevation of surface at all points.
+        """
+        self.elevation = elevation
+
+    def load_surface(self, surface, batch=None):
+        """Get elevation of surface (same as HDF5Storage.load_surface()).
+
+        Args:
+            surface (Surface)
+                Model surface.
+            batch (utils.BatchGenerator2D)
+                Current batch of points in domain corresponding to elevation data.
+        """
+        if batch:
+            x_start, x_end = batch.x_range
+            y_start, y_end = batch.y_range
+            return self.elevation[x_start:x_end, y_start:y_end]
+        return self.elevation
+
+
+_worker = {}  # Data source and model in worker process.
+
+
+def _initialize_worker(model_config, elevations):
+    """Create data source and model in worker process.
+
+    Args:
+        model_config (dict)
+            Model configuration.
+        elevations (dict)
+            Elevation of each surface in the model.
+    """
+    _worker["datasrc"] = _create_datasrc(model_config)
+    model = core.model.Model(model_config)
+    for surface in (model.top_surface, model.topo_bathy):
+        if surface:
+            surface.storage = _SurfaceCache(elevations[surface.name])
+    _worker["model"] = model
+
+
+def _get_block_values(block_index, batch):
+    """Evaluate values of block for a batch of points in worker process.
+
+    Args:
+        block_index (int)
+            Index of block in model.
+        batch (BatchGenerator3D)
+            Batch of points in block.
+    Returns:
+        Tuple of batch and numpy array with values at points in batch.
+    """
+    model = _worker["model"]
+    topo_depth = model.topo_bathy if model.topo_bathy else model.top_surface
+    values = _worker["datasrc"].get_values(model.blocks[block_index], model.top_surface, topo_depth, batch)
+    return (batch, values)
+
+
 class App():
     """Application for generating a GeoModelGrids model from data.
     """
@@ -33,7 +121,8 @@ class App():
              import_surfaces: bool = False,
              import_blocks: bool = False,
              update_metadata: bool = False,
-             all_steps: bool = False):
+             all_steps: bool = False,
+             num_workers: int = 1):
         """Main entry point.
 
         Arguments:
@@ -51,6 +140,9 @@ class App():
                 If True, update all metadata in model.
             all
                 If True, equivalent to import_domain=True, import_surfaces=True, import_blocks=True
+            num_workers
+                Number of worker processes evaluating batches of block values. The values are
+                evaluated in this process if num_workers is 1 or batch_size is not set.
             show_progress
                 If False, print progress to stdout.
             log_filename
@@ -58,6 +150,8 @@ class App():
             debug
                 Print additional debugging information to log file.
         """
+        if num_workers < 1:
+            raise ValueError(f"Number of workers must be positive. Found {num_workers}.")
         self.initialize(config_filenames.split(","))
 
         if show_parameters:
@@ -65,10 +159,7 @@ class App():
             return
 
         if import_domain or import_surfaces or import_blocks or all_steps:
-            data_path = self.config["geomodelgrids"]["data_source"].split(".")
-            data_obj = getattr(import_module(".".join(data_path[:-1])), data_path[-1])
-            datasrc = data_obj(self.config)
-            datasrc.initialize()
+            datasrc = _create_datasrc(self.config)
         model = core.model.Model(self.config)
 
         if import_domain or all_steps:
@@ -102,18 +193,25 @@ class App():
         if import_blocks or all_steps:
             batch_size = int(self.config["domain"]["batch_size"]) if "batch_size" in self.config["domain"] else None
             topo_depth = model.topo_bathy if model.topo_bathy else model.top_surface
-            for block in model.blocks:
+            executor = self._create_workers(model, num_workers) if batch_size and num_workers > 1 else None
+            for iblock, block in enumerate(model.blocks):
                 model.init_block(block)
-                if batch_size:
+                if executor:
+                    self._save_block_parallel(executor, model, iblock, batch_size, num_workers)
+                elif batch_size:
                     for batch in block.get_batches(batch_size):
                         values = datasrc.get_values(block, model.top_surface, topo_depth, batch)
                         model.save_block(block, values, batch)
                 else:
                     values = datasrc.get_values(block, model.top_surface, topo_depth)
                     model.save_block(block, values)
+                model.save_block_levels(block)
+            if executor:
+                executor.shutdown()
 
         if update_metadata:
             model.update_metadata()
+        model.close()
 
     def initialize(self, config_filenames):
         """Set parameters from config file and DEFAULTS.
@@ -124,6 +222,60 @@ class App():
         """
         self.config = config.get_config(config_filenames)
 
+    def _create_workers(self, model, num_workers):
+        """Start pool of worker processes for evaluating batches of block values.
+
+        Args:
+            model (Model)
+                Model with surfaces already written to storage.
+            num_workers (int)
+                Number of worker processes.
+        Returns:
+            Process pool executor.
+        """
+        elevations = {}
+        for surface in (model.top_surface, model.topo_bathy):
+            if surface:
+                elevations[surface.name] = model.storage.load_surface(surface)
+        # Start new interpreters rather than forking this process, which may have the model file open.
+        context = multiprocessing.get_context("spawn")
+        return concurrent.futures.ProcessPoolExecutor(max_workers=num_workers, mp_context=context,
+                                                      initializer=_initialize_worker,
+                                                      initargs=(self.config, elevations))
+
+    @staticmethod
+    def _save_block_parallel(executor, model, iblock, batch_size, num_workers):
+        """Evaluate batches of block values in worker processes and write them as they complete.
+
+        This process is the only writer. At most 2 batches per worker are pending at a time to
+        limit the memory used by finished values waiting to be written.
+
+        Args:
+            executor (ProcessPoolExecutor)
+                Pool of worker processes.
+            model (Model)
+                Model containing block.
+            iblock (int)
+                Index of block in model.
+            batch_size (int)
+                Maximum number of points in a batch.
+            num_workers (int)
+                Number of worker processes.
+        """
+        block = model.blocks[iblock]
+        pending = set()
+        for batch in block.get_batches(batch_size):
+            # The batch generator updates the same object for each batch.
+            pending.add(executor.submit(_get_block_values, iblock, copy.copy(batch)))
+            if len(pending) >= 2 * num_workers:
+                done, pending = concurrent.futures.wait(pending, return_when=concurrent.futures.FIRST_COMPLETED)
+                for future in done:
+                    batch_done, values = future.result()
+                    model.save_block(block, values, batch_done)
+        for future in concurrent.futures.as_completed(pending):
+            batch_done, values = future.result()
+            model.save_block(block, values, batch_done)
+
     def show_parameters(self):
         """Write parameters to stdout.
         """
@@ -148,6 +300,7 @@ def cli():
     parser.add_argument("--update-metadata", action="store_true", dest="update_metadata")
 
     parser.add_argument("--all", action="store_true", dest="all")
+    parser.add_argument("--num-workers", action="store", dest="num_workers", type=int, default=1)
     parser.add_argument("--quiet", action="store_false", dest="show_progress", default=True)
     parser.add_argument("--log", action="store", dest="log_filename", default="create_model.log")
     parser.add_argument("--debug", action="store_true", dest="debug")
@@ -160,6 +313,7 @@ def cli():
         "import_surfaces": args.import_surfaces,
         "import_blocks": args.import_blocks,
         "update_metadata": args.update_metadata,
+        "num_workers": args.num_workers,
     }
     app.main(**kwargs)
 
@@ -1,6 +1,7 @@
 """Initialization geomodelgrids core module."""
 
+# Defined before importing submodules, which use it.
+NODATA_VALUE = -1.0e+20
+
 from . import datasrc
 from . import model
-
-NODATA_VALUE = -1.0e+20
@@ -1,6 +1,7 @@
 """Georeferenced data source providing gridded data.
 """
 
+import os
 from abc import ABC, abstractmethod
 
 
@@ -25,6 +26,22 @@ class DataSrc(ABC):
         """
         return {}
 
+    @staticmethod
+    def scratch_filename(filename):
+        """Get name of scratch file unique to the current process.
+
+        Worker processes evaluate batches of block values concurrently, so data sources that exchange
+        points and values with other programs through files must not share file names across processes.
+
+        Args:
+            filename (str)
+                Name of scratch file, e.g., "block_points.dat".
+        Returns:
+            Name of scratch file with process id appended to the stem, e.g., "block_points_1234.dat".
+        """
+        stem, suffix = os.path.splitext(filename)
+        return "{}_{}{}".format(stem, os.getpid(), suffix)
+
     @abstractmethod
     def get_top_surface(self, points):
         """Query model for elevation of top surface at points.
@@ -11,6 +11,7 @@ import numpy
 from geomodelgrids.create.utils.config import string_to_list
 from geomodelgrids.create.utils import batch
 from geomodelgrids.create.io.hdf5 import HDF5Storage
+from geomodelgrids.create.core import NODATA_VALUE
 
 
 class Surface():
@@ -66,10 +67,10 @@ class Surface():
         return (num_x, num_y, 1)
 
     def get_batches(self, batch_size):
-        """Get generator for batches of points.
+        """Get generator for batches of points aligned to the dataset chunks.
         """
         num_x, num_y, _ = self.get_dims()
-        return batch.BatchGenerator2D(num_x, num_y, batch_size)
+        return batch.BatchGenerator2D(num_x, num_y, batch_size, chunks=self.chunk_size[:2])
 
     def generate_points(self, batch=None):
         """Generate points for surface.
@@ -132,6 +133,8 @@ class Surface():
 class Block():
     """Grid of points on a logically regular grid.
     """
+    VALUE_TYPES = ("float32", "int16", "int8")
+    VALUE_LAYOUTS = ("interleaved", "planar")
 
     def __init__(self, name, model_metadata, config):
         """Constructor.
@@ -154,6 +157,14 @@ class Block():
                     - z_coordinates: Array of z coordinates (m) if variable resolution in z-direction.
                     - z_top_offset: Vertical offset of top set of points below top of block (m) (used to avoid roundoff errors).
                     - chunk_size: Dimensions of dataset chunk (should be about 10Kb - 1Mb)
+                    - levels: Factors of coarser levels (downsampled copies) of block, e.g., [2, 4, 8] (optional).
+                    - value_type: Type of stored values, float32 (default), int16, or int8 (optional).
+                    - value_min: Array of minimum of each value if value_type is an integer type.
+                    - value_max: Array of maximum of each value if value_type is an integer type.
+                    - scale_offset_digits: Number of decimal digits retained by HDF5 scale-offset filter if
+                      value_type is float32 (optional).
+                    - value_layout: Layout of values, interleaved (default) with dimensions (x, y, z, value)
+                      or planar with dimensions (value, x, y, z) and one value per chunk (optional).
         """
         self.name = name
         self.model_metadata = model_metadata
@@ -183,6 +194,37 @@ class Block():
 
         self.z_top_offset = float(config["z_top_offset"])
         self.chunk_size = tuple(map(int, string_to_list(config["chunk_size"])))
+        self.levels = tuple(map(int, string_to_list(config["levels"]))) if "levels" in config else ()
+        for factor in self.levels:
+            if factor < 2:
+                raise ValueError(f"Factor of level for block '{name}' must be at least 2. Got {factor}.")
+
+        self.value_type = config.get("value_type", "float32")
+        if not self.value_type in self.VALUE_TYPES:
+            raise ValueError(f"Unknown value type '{self.value_type}' for block '{name}'. "
+                             f"Expected one of {self.VALUE_TYPES}.")
+        self.scale_offset_digits = int(config["scale_offset_digits"]) if "scale_offset_digits" in config else None
+        if self.value_type.startswith("int"):
+            if self.scale_offset_digits is not None:
+                raise ValueError(f"Block '{name}' with value type '{self.value_type}' cannot use scale-offset filter.")
+            num_values = len(model_metadata.data_values)
+            self.value_min = tuple(map(float, string_to_list(config["value_min"])))
+            self.value_max = tuple(map(float, string_to_list(config["value_max"])))
+            if len(self.value_min) != num_values or len(self.value_max) != num_values:
+                raise ValueError(f"Expected {num_values} values for value_min and value_max of block '{name}'. "
+                                 f"Got {len(self.value_min)} and {len(self.value_max)}.")
+            for value_min, value_max in zip(self.value_min, self.value_max):
+                if value_max <= value_min:
+                    raise ValueError(f"Maximum value ({value_max}) must be greater than minimum value ({value_min}) "
+                                     f"for block '{name}'.")
+        else:
+            self.value_min = None
+            self.value_max = None
+
+        self.value_layout = config.get("value_layout", "interleaved")
+        if not self.value_layout in self.VALUE_LAYOUTS:
+            raise ValueError(f"Unknown value layout '{self.value_layout}' for block '{name}'. "
+                             f"Expected one of {self.VALUE_LAYOUTS}.")
 
     def get_dims(self):
         """Get number of points in block along each dimension.
@@ -204,14 +246,126 @@ class Block():
             num_z = len(self.z_coordinates)
         return (num_x, num_y, num_z)
 
+    def to_storage_order(self, items):
+        """Arrange items for each dimension (shape, chunks, or slices) in the order of the stored values.
+
+        Args:
+            items (tuple)
+                Items for dimensions (x, y, z, value) with values as the last dimension.
+        Returns:
+            Tuple with items for dimensions (value, x, y, z) for planar layout, (x, y, z, value) otherwise.
+        """
+        items = tuple(items)
+        return items[3:] + items[:3] if self.value_layout == "planar" else items
+
+    def from_storage_order(self, items):
+        """Arrange items for each dimension in the order of the stored values with values as the last dimension.
+
+        Args:
+            items (tuple)
+                Items for dimensions in the order of the stored values.
+        Returns:
+            Tuple with items for dimensions (x, y, z, value).
+        """
+        items = tuple(items)
+        return items[1:] + items[:1] if self.value_layout == "planar" else items
+
+    def to_storage(self, values):
+        """Arrange values for storage in the layout of values.
+
+        Args:
+            values (numpy.array)
+                Numpy array [Nx,Ny,Nz,Nv] of gridded data.
+        Returns:
+            Numpy array [Nv,Nx,Ny,Nz] for planar layout, values otherwise.
+        """
+        return numpy.moveaxis(values, 3, 0) if self.value_layout == "planar" else values
+
+    def get_level_steps(self):
+        """Get steps between points of block for each coarser level.
+
+        A level contains every step-th point of the block along each axis. Along an axis the step is
+        the largest divisor of the factor that is also a divisor of the number of intervals, so the
+        level spans the entire block. Levels identical to the next finer level are omitted.
+
+        Returns:
+            List of tuples (factor, (step_x, step_y, step_z)) in order of increasing factor.
+        """
+        steps_prev = (1, 1, 1)
+        level_steps = []
+        for factor in sorted(self.levels):
+            steps = tuple(math.gcd(factor, num - 1) for num in self.get_dims())
+            if steps != steps_prev:
+                level_steps.append((factor, steps))
+                steps_prev = steps
+        return level_steps
+
+    def get_value_encoding(self):
+        """Get encoding of values stored as integers.
+
+        Stored integers (codes) are decoded using value = code * scale_factor + add_offset. The codes
+        -code_max...+code_max span the range [value_min, value_max] of each value, and the minimum
+        integer, missing_value, encodes NODATA_VALUE.
+
+        Returns:
+            Tuple (scale_factor, add_offset, missing_value) with arrays of scale factors and offsets
+            for each value, or None if values are stored as floating point values.
+        """
+        if not self.value_type.startswith("int"):
+            return None
+        code_max = numpy.iinfo(self.value_type).max
+        value_min = numpy.array(self.value_min)
+        value_max = numpy.array(self.value_max)
+        scale_factor = (value_max - value_min) / (2 * code_max)
+        add_offset = 0.5 * (value_max + value_min)
+        missing_value = float(numpy.iinfo(self.value_type).min)
+        return (scale_factor, add_offset, missing_value)
+
+    def get_fill_value(self):
+        """Get stored value for points that have not been written.
+
+        Returns:
+            Encoded NODATA_VALUE for integer values or values using the scale-offset filter, None otherwise.
+        """
+        encoding = self.get_value_encoding()
+        if encoding:
+            return encoding[2]
+        return NODATA_VALUE if self.scale_offset_digits is not None else None
+
+    def encode_values(self, values):
+        """Encode values for storage.
+
+        Values outside [value_min, value_max] are clipped to the range.
+
+        Args:
+            values (numpy.array)
+                Numpy array [Nx,Ny,Nz,Nv] of gridded data.
+        Returns:
+            Numpy array [Nx,Ny,Nz,Nv] of integer codes if values are stored as integers, values otherwise.
+        """
+        encoding = self.get_value_encoding()
+        if not encoding:
+            return values
+        scale_factor, add_offset, missing_value = encoding
+        code_max = numpy.iinfo(self.value_type).max
+        nodata = values <= 0.5 * NODATA_VALUE
+        codes = numpy.rint((values - add_offset) / scale_factor)
+        num_clipped = numpy.sum(numpy.logical_and(numpy.abs(codes) > code_max, ~nodata))
+        if num_clipped:
+            logger = logging.getLogger(__name__)
+            logger.warning(f"Clipping {num_clipped} values outside [value_min, value_max] in block '{self.name}'.")
+        codes = numpy.clip(codes, -code_max, code_max)
+        codes[nodata] = missing_value
+        return codes.astype(self.value_type)
+
     def get_batches(self, batch_size):
-        """Get batch generator for block.
+        """Get batch generator for block with batches aligned to the dataset chunks.
 
         Returns:
             BatchGenerator3D for block.
         """
         num_x, num_y, num_z = self.get_dims()
-        return batch.BatchGenerator3D(num_x, num_y, num_z, batch_size)
+        return batch.BatchGenerator3D(num_x, num_y, num_z, batch_size, chunks=self.chunk_size[:3])
 
     def generate_points(self, top_surface, batch=None):
         """Generate grid of points in block.
@@ -588,6 +742,17 @@ class Model():
         """
         self.storage.save_block(block, values, batch)
 
+    def save_block_levels(self, block):
+        """Write coarser levels of block to storage.
+
+        Must be called after all of the values of the block have been written.
+
+        Args:
+            block (Block)
+                Block information.
+        """
+        self.storage.save_block_levels(block)
+
     def update_metadata(self):
         """Update all metadata for model using current model configuration.
         """
@@ -599,6 +764,11 @@ class Model():
         for block in self.blocks:
             self.storage.save_block_metadata(block)
 
+    def close(self):
+        """Close storage.
+        """
+        self.storage.close()
+
     def _initialize(self, config):
         """Setup model.
 
@@ -65,8 +65,8 @@ class RulesDataSrc(DataSrc):
         Returns:
             Numpy array [Nx,Ny] of elevation of top surface at points.
         """
-        POINTS_FILENAME = "top_surface_points.dat"  # Must have .dat suffix.
-        ELEV_FILENAME = "top_surface_elev.dat"  # Must have .dat suffix.
+        POINTS_FILENAME = self.scratch_filename("top_surface_points.dat")  # Must have .dat suffix.
+        ELEV_FILENAME = self.scratch_filename("top_surface_elev.dat")  # Must have .dat suffix.
 
         points_abspath = os.path.join(self.model_dir, POINTS_FILENAME)
         elev_abspath = os.path.join(self.model_dir, ELEV_FILENAME)
@@ -95,8 +95,8 @@ class RulesDataSrc(DataSrc):
         Returns:
             Numpy array [Nx,Ny] of elevation of topography or bathymetry at points.
         """
-        POINTS_FILENAME = "topography_bathymetry_points.dat"  # Must have .dat suffix.
-        ELEV_FILENAME = "topography_bathymetry_elev.dat"  # Must have .dat suffix.
+        POINTS_FILENAME = self.scratch_filename("topography_bathymetry_points.dat")  # Must have .dat suffix.
+        ELEV_FILENAME = self.scratch_filename("topography_bathymetry_elev.dat")  # Must have .dat suffix.
 
         points_abspath = os.path.join(self.model_dir, POINTS_FILENAME)
         elev_abspath = os.path.join(self.model_dir, ELEV_FILENAME)
@@ -129,8 +129,8 @@ class RulesDataSrc(DataSrc):
             batch (BatchGenerator3D)
                 Current batch of points in block.
         """
-        POINTS_FILENAME = "block_points.dat"  # Must have .dat suffix.
-        VALUES_FILENAME = "block_values.dat"  # Must have .data suffix.
+        POINTS_FILENAME = self.scratch_filename("block_points.dat")  # Must have .dat suffix.
+        VALUES_FILENAME = self.scratch_filename("block_values.dat")  # Must have .dat suffix.
         DTYPE = {
             "names": ("x", "y", "z", "fault_block", "zone"),
             "formats": ("f4", "f4", "f4", "<U32", "<U32")
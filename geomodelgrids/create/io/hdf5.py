@@ -6,7 +6,16 @@ import numpy
 
 class HDF5Storage():
     """HDF5 file for storing gridded model.
+
+    Whenever metadata is written, we also write a consolidated snapshot of the metadata for the root,
+    surfaces, and blocks as a root attribute, so readers can load all of the metadata in a single
+    read. Tools that modify attributes directly must rewrite (or delete) the snapshot.
+
+    The file is opened when it is first accessed and kept open until close() is called, so that
+    writing a model in many batches does not reopen the file and reload its metadata for each batch.
     """
+    SNAPSHOT_NAME = "metadata_snapshot"
+    SNAPSHOT_VERSION = "geomodelgrids-metadata-1"
 
     def __init__(self, filename):
         """Constructor.
@@ -16,6 +25,14 @@ class HDF5Storage():
                 Name for HDF5 file
         """
         self.filename = filename
+        self.h5 = None
+
+    def close(self):
+        """Close HDF5 file if it is open.
+        """
+        if self.h5:
+            self.h5.close()
+        self.h5 = None
 
     def save_domain(self, domain):
         """Write domain attributes to HDF5 file.
@@ -24,12 +41,12 @@ class HDF5Storage():
             domain (Model):
                 Model domain.
         """
-        h5 = h5py.File(self.filename, "a")
+        h5 = self._get_file()
         attrs = h5.attrs
         for attr_info in domain.get_attributes():
             attr_name = attr_info[0]
             attrs[attr_name] = self._get_attribute(domain.metadata, attr_info)
-        h5.close()
+        self._save_metadata_snapshot(h5)
 
     def create_surface(self, surface):
         """Create surface in HDF5 file.
@@ -38,7 +55,7 @@ class HDF5Storage():
             surface (Surface)
                 Model surface.
         """
-        h5 = h5py.File(self.filename, "a")
+        h5 = self._get_file()
         if not "surfaces" in h5:
             h5.create_group("surfaces")
         surfaces_group = h5["surfaces"]
@@ -46,7 +63,6 @@ class HDF5Storage():
             del surfaces_group[surface.name]
         surf_dataset = surfaces_group.create_dataset(surface.name, shape=surface.get_dims(),
                                                      chunks=surface.chunk_size, compression="gzip")
-        h5.close()
         self.save_surface_metadata(surface)
 
     def save_surface_metadata(self, surface):
@@ -56,12 +72,12 @@ class HDF5Storage():
             surface (Surface)
                 Model surface
         """
-        h5 = h5py.File(self.filename, "a")
+        h5 = self._get_file()
         attrs = h5["surfaces"][surface.name].attrs
         for attr_info in surface.get_attributes():
             attr_name = attr_info[0]
             attrs[attr_name] = self._get_attribute(surface, attr_info)
-        h5.close()
+        self._save_metadata_snapshot(h5)
 
     def save_surface(self, surface, elevation, batch=None):
         """Write surface to HDF5 file.
@@ -74,7 +90,7 @@ class HDF5Storage():
             batch (utils.BatchGenerator2D)
                 Current batch of points in domain corresponding to elevation data.
         """
-        h5 = h5py.File(self.filename, "a")
+        h5 = self._get_file()
         surfaces_group = h5["surfaces"]
         assert surface.name in surfaces_group
         surf_dataset = surfaces_group[surface.name]
@@ -84,7 +100,6 @@ class HDF5Storage():
             surf_dataset[x_start:x_end, y_start:y_end, :] = elevation
         else:
             surf_dataset[:] = elevation
-        h5.close()
 
     def load_surface(self, surface, batch=None):
         """Load surface from HDF5 file.
@@ -95,7 +110,7 @@ class HDF5Storage():
             batch (utils.BatchGenerator2D)
                 Current batch of points in domain corresponding to elevation data.
         """
-        h5 = h5py.File(self.filename, "r")
+        h5 = self._get_file()
         surf_dataset = h5["surfaces"][surface.name]
         attrs = surf_dataset.attrs
         for attr_info in surface.get_attributes():
@@ -122,27 +137,45 @@ class HDF5Storage():
             elevation = surf_dataset[x_start:x_end, y_start:y_end]
         else:
             elevation = surf_dataset[:]
-        h5.close()
 
         return elevation
 
     def create_block(self, block):
         """Create block in HDF5 file.
 
+        Values stored as integers have attributes 'scale_factor', 'add_offset', and 'missing_value'
+        with the encoding (see Block.get_value_encoding()). Blocks with planar layout store the
+        values as the leading dimension, with one value in each chunk, and have the attribute
+        'value_layout' set to 'planar'. The encoding and layout are fixed when the block is created,
+        so they are not updated with the rest of the metadata.
+
         Args:
             block (Block)
                 Block associated with gridded data.
         """
-        h5 = h5py.File(self.filename, "a")
+        h5 = self._get_file()
         if not "blocks" in h5:
             h5.create_group("blocks")
         blocks_group = h5["blocks"]
         if block.name in blocks_group:
             del blocks_group[block.name]
-        shape = list(block.get_dims()) + [len(block.model_metadata.data_values)]
+        if "levels" in h5 and block.name in h5["levels"]:
+            del h5["levels"][block.name]
+        num_values = len(block.model_metadata.data_values)
+        shape = block.to_storage_order(list(block.get_dims()) + [num_values])
+        chunks = block.to_storage_order(tuple(block.chunk_size[:3]) + (1,)) if block.value_layout == "planar" \
+            else block.chunk_size
         block_dataset = blocks_group.create_dataset(
-            block.name, shape=shape, chunks=block.chunk_size, compression="gzip")
-        h5.close()
+            block.name, shape=shape, chunks=chunks, dtype=block.value_type, compression="gzip",
+            scaleoffset=block.scale_offset_digits, fillvalue=block.get_fill_value())
+        if block.value_layout == "planar":
+            block_dataset.attrs["value_layout"] = numpy.string_(block.value_layout)
+        encoding = block.get_value_encoding()
+        if encoding:
+            scale_factor, add_offset, missing_value = encoding
+            block_dataset.attrs["scale_factor"] = scale_factor
+            block_dataset.attrs["add_offset"] = add_offset
+            block_dataset.attrs["missing_value"] = missing_value
         self.save_block_metadata(block)
 
     def save_block_metadata(self, block):
@@ -152,12 +185,12 @@ class HDF5Storage():
             block (Block)
                 Block associated with gridded data.
         """
-        h5 = h5py.File(self.filename, "a")
+        h5 = self._get_file()
         attrs = h5["blocks"][block.name].attrs
         for attr_info in block.get_attributes():
             attr_name = attr_info[0]
             attrs[attr_name] = self._get_attribute(block, attr_info)
-        h5.close()
+        self._save_metadata_snapshot(h5)
 
     def save_block(self, block, data, batch=None):
         """Write block data to HDF5 file.
@@ -170,7 +203,7 @@ class HDF5Storage():
             batch (BatchGenerator3D)
                 Current batch of points in block.
         """
-        h5 = h5py.File(self.filename, "a")
+        h5 = self._get_file()
         assert "blocks" in h5
         blocks_group = h5["blocks"]
         assert block.name in blocks_group
@@ -179,10 +212,112 @@ class HDF5Storage():
             x_start, x_end = batch.x_range
             y_start, y_end = batch.y_range
             z_start, z_end = batch.z_range
-            block_dataset[x_start:x_end, y_start:y_end, z_start:z_end, :] = data
+            region = (slice(x_start, x_end), slice(y_start, y_end), slice(z_start, z_end), slice(None))
+            block_dataset[block.to_storage_order(region)] = block.to_storage(block.encode_values(data))
         else:
-            block_dataset[:] = data
-        h5.close()
+            block_dataset[:] = block.to_storage(block.encode_values(data))
+
+    def save_block_levels(self, block):
+        """Write coarser levels of block to HDF5 file.
+
+        Each level is a copy of every step-th point of the block (see Block.get_level_steps())
+        stored in dataset 'levels/BLOCK_NAME/FACTOR' with the same attributes and layout of values as
+        the block, adjusted for the coarser resolution. Values are copied in slabs along the x axis to
+        limit memory use.
+
+        Args:
+            block (Block)
+                Block associated with gridded data.
+        """
+        h5 = self._get_file()
+        block_dataset = h5["blocks"][block.name]
+        if "levels" in h5 and block.name in h5["levels"]:
+            del h5["levels"][block.name]
+        level_steps = block.get_level_steps()
+        if level_steps:
+            levels_group = h5.require_group("levels").create_group(block.name)
+        # Work with the values as the last dimension and map slices to the layout of the values.
+        storage = block.to_storage_order
+        block_shape = block.from_storage_order(block_dataset.shape)
+        block_chunks = block.from_storage_order(block_dataset.chunks)
+        for factor, steps in level_steps:
+            shape = [1 + (num - 1) // step for num, step in zip(block_shape[:3], steps)]
+            shape += [block_shape[3]]
+            chunks = tuple(min(chunk, num) for chunk, num in zip(block_chunks, shape))
+            level_dataset = levels_group.create_dataset(str(factor), shape=storage(shape), chunks=storage(chunks),
+                                                        dtype=block_dataset.dtype, compression="gzip")
+            step_x, step_y, step_z = steps
+            for x_start in range(0, shape[0], chunks[0]):
+                x_end = min(x_start + chunks[0], shape[0])
+                dest = (slice(x_start, x_end), slice(None), slice(None), slice(None))
+                src = (slice(x_start * step_x, (x_end - 1) * step_x + 1, step_x), slice(None, None, step_y),
+                       slice(None, None, step_z), slice(None))
+                level_dataset[storage(dest)] = block_dataset[storage(src)]
+
+            attrs = level_dataset.attrs
+            for attr_name, value in block_dataset.attrs.items():
+                axis = "xyz".find(attr_name[0]) if attr_name[1:] in ("_resolution", "_coordinates") else -1
+                if axis < 0:
+                    attrs[attr_name] = value
+                elif attr_name.endswith("_resolution"):
+                    attrs[attr_name] = value * steps[axis]
+                else:
+                    attrs[attr_name] = value[::steps[axis]]
+        self._save_metadata_snapshot(h5)
+
+    def _get_file(self):
+        """Get HDF5 file, opening it for reading and writing (created if it does not exist) on first use.
+
+        Returns:
+            h5py.File
+        """
+        if not self.h5:
+            self.h5 = h5py.File(self.filename, "a")
+        return self.h5
+
+    @classmethod
+    def _save_metadata_snapshot(cls, h5):
+        """Write consolidated snapshot of metadata for root, surfaces, blocks, and levels of blocks.
+
+        The snapshot is an array of strings with the version followed by records
+        [path, name, kind, count, values...]. Records with kind 'group' or 'dataset' (values are
+        the dimensions) describe an object; records with kind 'float' or 'string' describe an
+        attribute of an object.
+
+        Args:
+            h5 (h5py.File)
+                HDF5 file opened for writing.
+        """
+        objects = [h5]
+        for group_name in ("surfaces", "blocks"):
+            if group_name in h5:
+                group = h5[group_name]
+                objects.append(group)
+                objects += [group[name] for name in sorted(group) if isinstance(group[name], h5py.Dataset)]
+        if "levels" in h5:
+            levels_group = h5["levels"]
+            objects.append(levels_group)
+            for block_name in sorted(levels_group):
+                block_group = levels_group[block_name]
+                objects.append(block_group)
+                objects += [block_group[name] for name in sorted(block_group, key=int)]
+
+        records = [cls.SNAPSHOT_VERSION]
+        for obj in objects:
+            if isinstance(obj, h5py.Dataset):
+                records += [obj.name, "", "dataset", str(len(obj.shape))] + [str(dim) for dim in obj.shape]
+            else:
+                records += [obj.name, "", "group", "0"]
+            for attr_name, value in obj.attrs.items():
+                if attr_name == cls.SNAPSHOT_NAME:
+                    continue
+                values = numpy.atleast_1d(value).ravel()
+                if values.dtype.kind in "SUO":
+                    strings = [v.decode("utf-8") if isinstance(v, bytes) else str(v) for v in values]
+                    records += [obj.name, attr_name, "string", str(len(strings))] + strings
+                else:
+                    records += [obj.name, attr_name, "float", str(len(values))] + [repr(float(v)) for v in values]
+        h5.attrs[cls.SNAPSHOT_NAME] = numpy.array(records, dtype=h5py.string_dtype())
 
     @staticmethod
     def _get_attribute(metadata, attr_info):
@@ -3,6 +3,8 @@
 We use analytical functions for the spatial variations of values.
 """
 
+import os
+
 import numpy
 
 from geomodelgrids.create.core.datasrc import DataSrc
@@ -117,4 +119,41 @@ class AnalyticDataSrc(DataSrc):
             * numpy.sin(twopi*points[:, :, :, 1]/ly) \
             * numpy.sin(twopi*points[:, :, :, 2]/lz)
 
+
+class AnalyticFileDataSrc(AnalyticDataSrc):
+    """Model with values from analytical functions, exchanging points and values through scratch files.
+
+    Mimics data sources, such as EarthVision, that query external programs through files in a
+    working directory.
+    """
+
+    def get_values(self, block, top_surface, topo_bathy, batch=None):
+        """Get block values using analytical function, passing points and values through files.
+
+        Args:
+            block (Block)
+                Block information.
+            top_surface (Surface)
+                Elevation of ground surface (top of model).
+            topo_bathy (Surface)
+                Elevation of topography or bathymetry used to define depth.
+            batch (BatchGenerator3D)
+                Current batch of points in block.
+        """
+        POINTS_FILENAME = self.scratch_filename("block_points.npy")
+        VALUES_FILENAME = self.scratch_filename("block_values.npy")
+
+        numpy.save(POINTS_FILENAME, block.generate_points(top_surface, batch))
+        points = numpy.load(POINTS_FILENAME)
+        npts = points.shape
+        values = numpy.zeros((npts[0], npts[1], npts[2], 2), dtype=numpy.float32)
+        values[:, :, :, 0] = self._get_values_one(points)
+        values[:, :, :, 1] = self._get_values_two(points)
+        numpy.save(VALUES_FILENAME, values)
+        values = numpy.load(VALUES_FILENAME)
+
+        os.remove(POINTS_FILENAME)
+        os.remove(VALUES_FILENAME)
+        return values
+
 # End of file
@@ -5,15 +5,36 @@ import logging
 import math
 
 
+def _align_to_chunk(bnum, num, chunk):
+    """Round number of points in batch along an axis down to a multiple of the chunk size.
+
+    Batches that start and end on chunk boundaries (or the end of the dataset) write whole chunks,
+    so compressed chunks are not read, modified, and recompressed when writing later batches.
+
+    Args:
+        bnum(int)
+            Number of points in batch.
+        num(int)
+            Number of points in dataset.
+        chunk(int)
+            Number of points in chunk.
+    Returns:
+        Number of points in batch (at least one chunk and at most the number of points in dataset).
+    """
+    if not chunk or bnum >= num:
+        return bnum
+    return min(num, max(chunk, (bnum // chunk) * chunk))
+
+
 class BatchGenerator2D():
     """Iterator for batches of points for 2D domains.
 
     Usage:
-        for batch in BatchGenerator2D(num_x, num_y, max_nvalues):
+        for batch in BatchGenerator2D(num_x, num_y, max_nvalues, chunks):
             # Use batch
     """
 
-    def __init__(self, num_x, num_y, max_nvalues=None):
+    def __init__(self, num_x, num_y, max_nvalues=None, chunks=None):
         """Constructor.
 
         Args:
@@ -23,6 +44,8 @@ class BatchGenerator2D():
                 Number of points in y direction.
             max_nvalues(int)
                 Maximum number of points in a batch.
+            chunks(tuple)
+                Number of points in dataset chunk in x and y directions. Batches are aligned to chunks.
         """
         self.num_x = num_x
         self.num_y = num_y
@@ -42,6 +65,9 @@ class BatchGenerator2D():
                 self.bnum_x = max_nvalues // num_y
             else:
                 raise ValueError("Unknown case.")
+        if chunks:
+            self.bnum_x = _align_to_chunk(self.bnum_x, num_x, chunks[0])
+            self.bnum_y = _align_to_chunk(self.bnum_y, num_y, chunks[1])
         self.nbatch_x = round(math.ceil(num_x / self.bnum_x))
         self.nbatch_y = round(math.ceil(num_y / self.bnum_y))
 
@@ -94,11 +120,11 @@ class BatchGenerator3D():
     """Iterator for batches of points for 3D domains.
 
     Usage:
-        for batch in BatchGenerator3D(num_x, num_y, num_z, max_nvalues):
+        for batch in BatchGenerator3D(num_x, num_y, num_z, max_nvalues, chunks):
             # Use batch
     """
 
-    def __init__(self, num_x, num_y, num_z, max_nvalues=None):
+    def __init__(self, num_x, num_y, num_z, max_nvalues=None, chunks=None):
         """Constructor.
 
         Args:
@@ -110,6 +136,8 @@ class BatchGenerator3D():
                 Number of points in z direction.
             max_nvalues(int)
                 Maximum number of points in a batch.
+            chunks(tuple)
+                Number of points in dataset chunk in x, y, and z directions. Batches are aligned to chunks.
         """
         self.num_x = num_x
         self.num_y = num_y
@@ -155,6 +183,10 @@ class BatchGenerator3D():
                     raise ValueError("Unknown case")
             else:
                 raise ValueError("Unknown case")
+        if chunks:
+            self.bnum_x = _align_to_chunk(self.bnum_x, num_x, chunks[0])
+            self.bnum_y = _align_to_chunk(self.bnum_y, num_y, chunks[1])
+            self.bnum_z = _align_to_chunk(self.bnum_z, num_z, chunks[2])
         self.nbatch_x = round(math.ceil(num_x / self.bnum_x))
         self.nbatch_y = round(math.ceil(num_y / self.bnum_y))
         self.nbatch_z = round(math.ceil(num_z / self.bnum_z))
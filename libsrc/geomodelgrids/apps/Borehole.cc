@@ -5,11 +5,16 @@
 #include "geomodelgrids/serial/Query.hh" // USES Query
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+#include "geomodelgrids/utils/PointsReader.hh" // USES PointsReader
+#include "geomodelgrids/utils/PointsWriter.hh" // USES PointsWriter
+#include "geomodelgrids/utils/PointsPipeline.hh" // USES PointsPipeline
 
 #include <getopt.h> // USES getopt_long()
 #include <iomanip>
-#include <fstream> // USES std::ofstream
 #include <sstream> // USES std::ostringstream, std::istringstream
+#include <algorithm> // USES std::max(), std::fill(), std::copy()
+#include <atomic> // USES std::atomic
+#include <memory> // USES std::unique_ptr
 #include <cassert> // USES assert()
 #include <iostream> // USES std::cout
 
@@ -17,6 +22,8 @@ namespace geomodelgrids {
     namespace apps {
         namespace _Borehole {
             static const int cwidth = 14;
+            static const int precision = 6;
+            static const size_t batchRows = 16384;
         } // _Borehole
     } // apps
 } // geomodelgrids
@@ -25,10 +32,13 @@ namespace geomodelgrids {
 // Constructor
 geomodelgrids::apps::Borehole::Borehole() :
     _pointsCRS("EPSG:4326"),
+    _locationsFilename(""),
     _outputFilename(""),
     _logFilename(""),
     _maxDepth(5000.0),
     _dz(10.0),
+    _numThreads(1),
+    _outputPerSite(false),
     _showHelp(false) {
     _location[0] = geomodelgrids::NODATA_VALUE;
     _location[1] = geomodelgrids::NODATA_VALUE;
@@ -52,52 +62,156 @@ geomodelgrids::apps::Borehole::run(int argc,
         return 0;
     } // if
 
-    geomodelgrids::serial::Query query;
-    if (!_logFilename.empty()) {
-        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
-        errorHandler->setLogFilename(_logFilename.c_str());
-        errorHandler->setLoggingOn(true);
-    } // if
-    query.initialize(_modelFilenames, _valueNames, _pointsCRS);
+    // Each worker thread uses its own query object.
+    std::vector<std::unique_ptr<geomodelgrids::serial::Query> > queries(_numThreads);
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        queries[iThread].reset(new geomodelgrids::serial::Query());
+        geomodelgrids::serial::Query& query = *queries[iThread];
+        if (!_logFilename.empty()) {
+            std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
+            errorHandler->setLogFilename(_logFilename.c_str());
+            errorHandler->setLoggingOn(true);
+        } // if
+        query.initialize(_modelFilenames, _valueNames, _pointsCRS);
+    } // for
+
+    const size_t numDepths = size_t(1 + _maxDepth / _dz);
+    const size_t numQueryValues = _valueNames.size();
+    int status = 0;
+    if (_locationsFilename.empty()) {
+        const size_t numColumns = 2 + numQueryValues;
+        std::vector<double> rows(numDepths*numColumns);
+        if (!_queryBorehole(rows.data(), numColumns, queries[0].get(), _location[0], _location[1])) {
+            std::cout << "Could not find elevation for location. Point is outside the models." << std::endl;
+            status = 1;
+        } else {
+            geomodelgrids::utils::PointsWriter writer;
+            writer.setHeader(_createOutputHeader(argc, argv, false));
+            writer.setTextFormat(_Borehole::cwidth, _Borehole::precision);
+            writer.open(_outputFilename.c_str(), geomodelgrids::utils::PointsReader::TEXT, numColumns);
+            writer.write(rows.data(), numDepths);
+            writer.close();
+        } // if/else
+    } else {
+        const size_t spaceDim = 2;
+        geomodelgrids::utils::PointsReader reader;
+        reader.open(_locationsFilename.c_str(), geomodelgrids::utils::PointsReader::TEXT, spaceDim);
+
+        // Output for each site has elevation, depth, and values; combined output also has location.
+        const size_t numLocationColumns = (_outputPerSite) ? 0 : spaceDim;
+        const size_t numColumns = numLocationColumns + 2 + numQueryValues;
+        geomodelgrids::utils::PointsWriter writer;
+        if (!_outputPerSite) {
+            writer.setHeader(_createOutputHeader(argc, argv, true));
+            writer.setTextFormat(_Borehole::cwidth, _Borehole::precision);
+            writer.open(_outputFilename.c_str(), geomodelgrids::utils::PointsReader::TEXT, numColumns);
+        } // if
+        const std::string siteHeader = (_outputPerSite) ? _createOutputHeader(argc, argv, false) : "";
+        const size_t siteHeaderSplit = siteHeader.find('\n') + 1;
+
+        std::atomic<size_t> numOutside(0);
+        geomodelgrids::utils::PointsPipeline pipeline;
+        pipeline.setNumWorkers(_numThreads);
+        pipeline.setBatchSize(std::max(size_t(1), _Borehole::batchRows / numDepths));
+        pipeline.setRowsPerPoint(numDepths);
+        pipeline.run(&reader, spaceDim, (_outputPerSite) ? nullptr : &writer, numColumns,
+                     [this, &queries, &numOutside, &siteHeader, siteHeaderSplit, spaceDim, numDepths,
+                      numLocationColumns, numColumns](double* const rows,
+                                                      const double* const points,
+                                                      const size_t numPoints,
+                                                      const size_t offset,
+                                                      const size_t worker) {
+            geomodelgrids::serial::Query* query = queries[worker].get();
+            for (size_t iLoc = 0; iLoc < numPoints; ++iLoc) {
+                const double* xy = &points[iLoc*spaceDim];
+                double* locRows = &rows[iLoc*numDepths*numColumns];
+                for (size_t iDepth = 0; iDepth < numDepths && numLocationColumns > 0; ++iDepth) {
+                    locRows[iDepth*numColumns+0] = xy[0];
+                    locRows[iDepth*numColumns+1] = xy[1];
+                } // for
+                if (!_queryBorehole(&locRows[numLocationColumns], numColumns, query, xy[0], xy[1])) {
+                    ++numOutside;
+                } // if
+
+                if (_outputPerSite) {
+                    std::ostringstream location;
+                    location << "# Location: " << std::setprecision(12) << xy[0] << ", " << xy[1] << "\n";
+
+                    geomodelgrids::utils::PointsWriter siteWriter;
+                    siteWriter.setHeader(siteHeader.substr(0, siteHeaderSplit) + location.str() +
+                                         siteHeader.substr(siteHeaderSplit));
+                    siteWriter.setTextFormat(_Borehole::cwidth, _Borehole::precision);
+                    siteWriter.open(_siteFilename(offset + iLoc).c_str(), geomodelgrids::utils::PointsReader::TEXT,
+                                    numColumns);
+                    siteWriter.write(locRows, numDepths);
+                    siteWriter.close();
+                } // if
+            } // for
+        });
+        if (!_outputPerSite) {
+            writer.close();
+        } // if
+        reader.close();
+
+        if (numOutside > 0) {
+            std::cout << "Could not find elevation for " << numOutside.load() << " location(s). "
+                      << "Values for boreholes outside the models are " << geomodelgrids::NODATA_VALUE << "."
+                      << std::endl;
+        } // if
+    } // if/else
+
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        queries[iThread]->finalize();
+    } // for
+
+    return status;
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Query values along virtual borehole.
+bool
+geomodelgrids::apps::Borehole::_queryBorehole(double* const rows,
+                                              const size_t numColumns,
+                                              geomodelgrids::serial::Query* query,
+                                              const double x,
+                                              const double y) const {
+    assert(rows);
+    assert(query);
+
+    const size_t numDepths = size_t(1 + _maxDepth / _dz);
+    const size_t numQueryValues = _valueNames.size();
 
     const double groundOffset = -1.0e-6;
-    double groundSurf = query.queryTopElevation(_location[0], _location[1]);
+    double groundSurf = query->queryTopElevation(x, y);
     if (groundSurf == geomodelgrids::NODATA_VALUE) {
-        std::cout << "Could not find elevation for location. Point is outside the models." << std::endl;
-        return 1;
+        for (size_t iDepth = 0; iDepth < numDepths; ++iDepth) {
+            double* row = &rows[iDepth*numColumns];
+            row[0] = geomodelgrids::NODATA_VALUE;
+            row[1] = _dz*iDepth;
+            std::fill(&row[2], &row[2+numQueryValues], geomodelgrids::NODATA_VALUE);
+        } // for
+        return false;
     } else if (groundSurf != 0.0) {
         groundSurf += groundOffset;
     } // if
-    const size_t numPoints = size_t(1 + _maxDepth / _dz);
-
-    std::ofstream sout(_outputFilename);
-    if (!sout.is_open() && !sout.good()) {
-        std::ostringstream msg;
-        msg << "Could not open output file '" << _outputFilename << "' for writing.";
-        throw std::runtime_error(msg.str().c_str());
-    } // if
-    sout << _createOutputHeader(argc, argv);
 
-    const size_t numQueryValues = _valueNames.size();
-    std::vector<double> values(numQueryValues);
-    sout << std::scientific << std::setprecision(6);
-    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
-        const double elevation = groundSurf - _dz*iPt;
-        query.query(&values[0], _location[0], _location[1], elevation);
-
-        const double depth = groundSurf - elevation;
-        sout << std::setw(_Borehole::cwidth) << elevation
-             << std::setw(_Borehole::cwidth) << depth;
-        for (size_t i = 0; i < numQueryValues; ++i) {
-            sout << std::setw(_Borehole::cwidth) << values[i];
-        } // for
-        sout << "\n";
-    } // while
+    std::vector<double> elevations(numDepths);
+    for (size_t iDepth = 0; iDepth < numDepths; ++iDepth) {
+        elevations[iDepth] = groundSurf - _dz*iDepth;
+    } // for
+    std::vector<double> values(numDepths*numQueryValues);
+    query->queryProfile(values.data(), x, y, elevations.data(), numDepths);
 
-    query.finalize();
+    for (size_t iDepth = 0; iDepth < numDepths; ++iDepth) {
+        double* row = &rows[iDepth*numColumns];
+        row[0] = elevations[iDepth];
+        row[1] = groundSurf - elevations[iDepth];
+        std::copy(&values[iDepth*numQueryValues], &values[(iDepth+1)*numQueryValues], &row[2]);
+    } // for
 
-    return 0;
-} // run
+    return true;
+} // _queryBorehole
 
 
 // ------------------------------------------------------------------------------------------------
@@ -105,11 +219,14 @@ geomodelgrids::apps::Borehole::run(int argc,
 void
 geomodelgrids::apps::Borehole::_parseArgs(int argc,
                                           char* argv[]) {
-    static struct option options[11] = {
+    static struct option options[14] = {
         {"help", no_argument, nullptr, 'h'},
         {"values", required_argument, nullptr, 'v'},
         {"max-depth", required_argument, nullptr, 'd'},
         {"location", required_argument, nullptr, 'p'},
+        {"locations", required_argument, nullptr, 'f'},
+        {"output-per-site", no_argument, nullptr, 's'},
+        {"num-threads", required_argument, nullptr, 't'},
         {"dz", required_argument, nullptr, 'r'},
         {"points-coordsys", required_argument, nullptr, 'c'},
         {"output", required_argument, nullptr, 'o'},
@@ -120,7 +237,7 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:d:o:r:p:c:o:l:m:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:d:o:r:p:f:st:c:o:l:m:", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -148,6 +265,18 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
             } // while
             break;
         } // 'o'
+        case 'f': {
+            _locationsFilename = optarg;
+            break;
+        } // 'f'
+        case 's': {
+            _outputPerSite = true;
+            break;
+        } // 's'
+        case 't': {
+            _numThreads = size_t(std::max(0, atoi(optarg)));
+            break;
+        } // 't'
         case 'r': {
             _dz = atof(optarg);
             break;
@@ -202,8 +331,21 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
             msg << "    - Missing list of model filenames. Use --models=FILE_0,...,FILE_M\n";
             optionsOkay = false;
         } // if
-        if ((_location[0] == geomodelgrids::NODATA_VALUE) || (_location[1] == geomodelgrids::NODATA_VALUE)) {
-            msg << "    - Missing boreole location. Use --location=X,Y\n";
+        const bool hasLocation = (_location[0] != geomodelgrids::NODATA_VALUE) &&
+                                 (_location[1] != geomodelgrids::NODATA_VALUE);
+        if (!hasLocation && _locationsFilename.empty()) {
+            msg << "    - Missing boreole location. Use --location=X,Y or --locations=FILE_LOCATIONS\n";
+            optionsOkay = false;
+        } else if (hasLocation && !_locationsFilename.empty()) {
+            msg << "    - Conflicting borehole locations. Use either --location=X,Y or --locations=FILE_LOCATIONS\n";
+            optionsOkay = false;
+        } // if/else
+        if (_outputPerSite && _locationsFilename.empty()) {
+            msg << "    - Output for each site requires a file of locations. Use --locations=FILE_LOCATIONS\n";
+            optionsOkay = false;
+        } // if
+        if (!_numThreads) {
+            msg << "    - Number of threads must be positive. Use --num-threads=NUM_THREADS\n";
             optionsOkay = false;
         } // if
 
@@ -219,19 +361,24 @@ geomodelgrids::apps::Borehole::_parseArgs(int argc,
 void
 geomodelgrids::apps::Borehole::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_borehole "
-              << "[--help] [--log=FILE_LOG] --location=X,Y --values=VALUE_0,...,VALUE_N --models=FILE_0,...,FILE_M "
-              << "--output=FILE_OUTPUT [--max-depth=Z] [--dz=RESOLUTION] [--points-coordsys=PROJ|EPSG|WKT]\n\n"
+              << "[--help] [--log=FILE_LOG] --location=X,Y|--locations=FILE_LOCATIONS --values=VALUE_0,...,VALUE_N "
+              << "--models=FILE_0,...,FILE_M --output=FILE_OUTPUT [--output-per-site] [--max-depth=Z] [--dz=RESOLUTION] "
+              << "[--points-coordsys=PROJ|EPSG|WKT] [--num-threads=NUM_THREADS]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --location=X,Y                   Location of virtual borehole in point coordinate system.\n"
+              << "    --locations=FILE_LOCATIONS       Read locations of virtual boreholes from FILE_LOCATIONS.\n"
               << "    --values=VALUE_0,...,VALUE_N     Values (in order) to return in borehole query.\n"
               << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
+              << "    --output-per-site                Write values for each location to FILE_OUTPUT with location "
+              << "index inserted before extension.\n"
               << "    --max-depth=DEPTH                Depth extent of virtual borehole in point coordinate system "
               << "vertical units (default=5000m).\n"
               << "    --dz=RESOLUTION                  Vertical resolution of query points in virtual borehole "
               << "in point coordinate system vertical units (default=10m).\n"
-              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326)."
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
+              << "    --num-threads=NUM_THREADS        Number of threads querying boreholes (default=1)."
               << std::endl;
 } // _printHelp
 
@@ -240,15 +387,22 @@ geomodelgrids::apps::Borehole::_printHelp(void) {
 // Create header for output.
 std::string
 geomodelgrids::apps::Borehole::_createOutputHeader(int argc,
-                                                   char* argv[]) {
+                                                   char* argv[],
+                                                   const bool withLocation) {
     std::ostringstream header;
     header << "#";
     for (int i = 0; i < argc; ++i) {
         header << " " << argv[i];
     } // for
-    header << "\n#"
-           << std::setw(_Borehole::cwidth-1) << "Elevation"
-           << std::setw(_Borehole::cwidth) << "Depth";
+    header << "\n#";
+    if (withLocation) {
+        header << std::setw(_Borehole::cwidth-1) << "x0"
+               << std::setw(_Borehole::cwidth) << "x1"
+               << std::setw(_Borehole::cwidth) << "Elevation";
+    } else {
+        header << std::setw(_Borehole::cwidth-1) << "Elevation";
+    } // if/else
+    header << std::setw(_Borehole::cwidth) << "Depth";
     for (size_t i = 0; i < _valueNames.size(); ++i) {
         header << std::setw(_Borehole::cwidth) << _valueNames[i];
     } // for
@@ -257,4 +411,22 @@ geomodelgrids::apps::Borehole::_createOutputHeader(int argc,
 } // _createOutputHeader
 
 
+// ------------------------------------------------------------------------------------------------
+// Get name of output file for site.
+std::string
+geomodelgrids::apps::Borehole::_siteFilename(const size_t index) const {
+    const size_t dirPos = _outputFilename.find_last_of('/');
+    const size_t extPos = _outputFilename.find_last_of('.');
+    const bool hasExtension = (extPos != std::string::npos) && (dirPos == std::string::npos || extPos > dirPos);
+
+    std::ostringstream filename;
+    if (hasExtension) {
+        filename << _outputFilename.substr(0, extPos) << "-" << index << _outputFilename.substr(extPos);
+    } else {
+        filename << _outputFilename << "-" << index;
+    } // if/else
+    return filename.str();
+} // _siteFilename
+
+
 // End of file
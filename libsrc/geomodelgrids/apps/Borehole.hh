@@ -3,6 +3,8 @@
 
 #include "appsfwd.hh" // forward declarations
 
+#include "geomodelgrids/serial/serialfwd.hh" // USES Query
+
 #include <vector> // HASA std::std::vector
 #include <string> // HASA std::string
 
@@ -25,12 +27,15 @@ public:
      *   --help
      *   --log=FILE_LOG
      *   --location=X,Y
+     *   --locations=FILE_LOCATIONS
      *   --models=FILE_0,...,FILE_M
      *   --output=FILE_OUTPUT
+     *   --output-per-site
      *   --values=VALUE_0,...,VALUE_N
      *   --max-depth=DEPTH
      *   --dz=RESOLUTION
      *   --points-coordsys=PROJ|EPSG|WKT
+     *   --num-threads=NUM_THREADS
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -58,9 +63,36 @@ private:
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
+     * @param withLocation[in] True if rows include borehole location.
      */
     std::string _createOutputHeader(int argc,
-                                    char* argv[]);
+                                    char* argv[],
+                                    const bool withLocation);
+
+    /** Query values along virtual borehole.
+     *
+     * Rows contain elevation, depth, and values. If the location is outside the models, the
+     * elevations and values are NODATA_VALUE.
+     *
+     * @param rows[out] Rows for points in borehole [numDepths*numColumns].
+     * @param numColumns[in] Stride between rows.
+     * @param query[inout] Query object.
+     * @param x[in] X coordinate of borehole (in points CRS).
+     * @param y[in] Y coordinate of borehole (in points CRS).
+     * @returns True if location is inside models, false otherwise.
+     */
+    bool _queryBorehole(double* const rows,
+                        const size_t numColumns,
+                        geomodelgrids::serial::Query* query,
+                        const double x,
+                        const double y) const;
+
+    /** Get name of output file for site.
+     *
+     * @param index[in] Index of site in file of locations.
+     * @returns Output filename with index inserted before extension.
+     */
+    std::string _siteFilename(const size_t index) const;
 
     // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
 private:
@@ -68,11 +100,14 @@ private:
     std::vector<std::string> _modelFilenames;
     std::vector<std::string> _valueNames;
     std::string _pointsCRS;
+    std::string _locationsFilename;
     std::string _outputFilename;
     std::string _logFilename;
     double _maxDepth;
     double _location[2];
     double _dz;
+    size_t _numThreads;
+    bool _outputPerSite;
     bool _showHelp;
 
     // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
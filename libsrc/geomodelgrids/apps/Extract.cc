@@ -0,0 +1,568 @@
+#include <portinfo>
+
+#include "Extract.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/HDF5Copier.hh" // USES HDF5Copier
+#include "geomodelgrids/utils/constants.hh" // USES TOLERANCE
+
+#include <getopt.h> // USES getopt_long()
+#include <iostream> // USES std::cout
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::min(), std::max()
+#include <cmath> // USES M_PI, cos(), sin(), floor(), ceil(), fabs()
+#include <cassert> // USES assert()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream, std::istringstream
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace apps {
+        namespace _Extract {
+            /// Dataset (surface or block) to extract.
+            struct Dataset {
+                std::string path; ///< Full path to dataset.
+                double resolution[2]; ///< Horizontal resolution along x and y axes.
+                hsize_t chunk[2]; ///< Chunk dimensions along x and y axes (0 if not chunked).
+                int xDim; ///< Index of x axis in dataset (1 if values are the leading dimension, 0 otherwise).
+            };
+
+            /// Statistics for copying datasets.
+            struct CopyStats {
+                size_t numChunksRaw; ///< Number of chunks copied without decompressing.
+                size_t numChunksByValue; ///< Number of edge chunks copied by reading and writing values.
+                size_t numDatasetsByValue; ///< Number of datasets copied by reading and writing values.
+
+                CopyStats(void) :
+                    numChunksRaw(0),
+                    numChunksByValue(0),
+                    numDatasetsByValue(0) {}
+
+
+            }; // CopyStats
+
+            typedef geomodelgrids::serial::HDF5Copier::Handle Handle;
+
+            /** Get resolution and chunking of dataset.
+             *
+             * @param[out] dataset Dataset with path and xDim set.
+             * @param[in] file HDF5 file.
+             */
+            static
+            void getDatasetInfo(Dataset* dataset,
+                                const hid_t file);
+
+            /** Read scalar double attribute.
+             *
+             * @param[in] object HDF5 object with attribute.
+             * @param[in] name Name of attribute.
+             * @returns Value of attribute.
+             */
+            static
+            double readDouble(const hid_t object,
+                              const char* name);
+
+            /** Copy horizontal subset of dataset.
+             *
+             * Whole chunks are copied without decompressing and recompressing them when the subset
+             * starts on a chunk boundary. Chunks at the end of the subset that extend into points of
+             * the dataset outside the subset are copied by value, so they do not carry those points.
+             * Otherwise, the values are read and written.
+             *
+             * @param[inout] stats Statistics for copying datasets.
+             * @param[inout] copier Copier for model file.
+             * @param[in] dataset Dataset to copy.
+             * @param[in] offset Index of first point of subset along x and y axes.
+             * @param[in] dims Number of points in subset along x and y axes.
+             */
+            static
+            void copyDataset(CopyStats* stats,
+                             geomodelgrids::serial::HDF5Copier* copier,
+                             const Dataset& dataset,
+                             const hsize_t offset[2],
+                             const hsize_t dims[2]);
+
+            /** Copy values in hyperslab of dataset.
+             *
+             * @param[in] src Source dataset.
+             * @param[in] srcSpace Dataspace of source dataset.
+             * @param[in] dest Destination dataset.
+             * @param[in] destSpace Dataspace of destination dataset.
+             * @param[in] memType Type of values in memory.
+             * @param[in] srcStart Index of first point of hyperslab in source dataset.
+             * @param[in] destStart Index of first point of hyperslab in destination dataset.
+             * @param[in] count Number of points in hyperslab.
+             * @param[inout] buffer Buffer for values.
+             * @param[in] path Full path to dataset, used in error messages.
+             */
+            static
+            void copyValues(const hid_t src,
+                            const hid_t srcSpace,
+                            const hid_t dest,
+                            const hid_t destSpace,
+                            const hid_t memType,
+                            const std::vector<hsize_t>& srcStart,
+                            const std::vector<hsize_t>& destStart,
+                            const std::vector<hsize_t>& count,
+                            std::vector<char>* buffer,
+                            const std::string& path);
+
+            /** Compute least common multiple of two resolutions.
+             *
+             * @param[in] a First resolution.
+             * @param[in] b Second resolution.
+             * @returns Least common multiple or 0 if there is no small common multiple.
+             */
+            static
+            double leastCommonMultiple(const double a,
+                                       const double b);
+
+        } // _Extract
+    } // apps
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::apps::Extract::Extract() :
+    _bboxCRS("EPSG:4326"),
+    _showHelp(false) {
+    _bbox[0] = 0.0;
+    _bbox[1] = 0.0;
+    _bbox[2] = 0.0;
+    _bbox[3] = 0.0;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::apps::Extract::~Extract(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Run extract application.
+int
+geomodelgrids::apps::Extract::run(int argc,
+                                  char* argv[]) {
+    _parseArgs(argc, argv);
+
+    if (_showHelp) {
+        _printHelp();
+        return 0;
+    } // if
+
+    // Get bounding box in model coordinates.
+    double xModelMin = 0.0;
+    double xModelMax = 0.0;
+    double yModelMin = 0.0;
+    double yModelMax = 0.0;
+    double modelDims[2] = { 0.0, 0.0 };
+    double modelOrigin[2] = { 0.0, 0.0 };
+    double yazimuth = 0.0;
+    { // Model
+        geomodelgrids::serial::Model model;
+        model.setInputCRS(_bboxCRS);
+        model.open(_modelFilename.c_str(), geomodelgrids::serial::Model::READ);
+        model.loadMetadata();
+        model.initialize();
+        model.computeModelBoundingBox(&xModelMin, &xModelMax, &yModelMin, &yModelMax,
+                                      _bbox[0], _bbox[1], _bbox[2], _bbox[3]);
+        modelDims[0] = model.getDims()[0];
+        modelDims[1] = model.getDims()[1];
+        modelOrigin[0] = model.getOrigin()[0];
+        modelOrigin[1] = model.getOrigin()[1];
+        yazimuth = model.getYAzimuth();
+        model.close();
+    } // Model
+    xModelMin = std::max(0.0, xModelMin);
+    xModelMax = std::min(modelDims[0], xModelMax);
+    yModelMin = std::max(0.0, yModelMin);
+    yModelMax = std::min(modelDims[1], yModelMax);
+    if (( xModelMin >= xModelMax) || ( yModelMin >= yModelMax) ) {
+        throw std::runtime_error("Bounding box does not overlap the model domain.");
+    } // if
+
+    geomodelgrids::serial::HDF5Copier copier;
+    copier.open(_modelFilename.c_str(), _outputFilename.c_str());
+    std::vector<std::string> paths;
+    copier.getDatasets(&paths);
+    std::vector<_Extract::Dataset> datasets(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) {
+        datasets[i].path = paths[i];
+        datasets[i].xDim = copier.isPlanar(paths[i].c_str()) ? 1 : 0;
+        _Extract::getDatasetInfo(&datasets[i], copier.getSource());
+    } // for
+
+    // The subset must start and end on points of every dataset, so it is aligned to the least common
+    // multiple of the horizontal resolutions.
+    double step[2] = { 0.0, 0.0 };
+    for (size_t iDim = 0; iDim < 2; ++iDim) {
+        for (size_t i = 0; i < datasets.size(); ++i) {
+            step[iDim] = (i > 0) ?
+                         _Extract::leastCommonMultiple(step[iDim], datasets[i].resolution[iDim]) :
+                         datasets[i].resolution[iDim];
+            if (step[iDim] <= 0.0) {
+                std::ostringstream msg;
+                msg << "Cannot extract subset of model '" << _modelFilename << "'. Horizontal resolutions of "
+                    << "surfaces and blocks do not have a common multiple.";
+                throw std::runtime_error(msg.str());
+            } // if
+        } // for
+    } // for
+    const double xStart = step[0] * floor(xModelMin / step[0] + TOLERANCE);
+    const double yStart = step[1] * floor(yModelMin / step[1] + TOLERANCE);
+    const double xEnd = std::min(modelDims[0], step[0] * ceil(xModelMax / step[0] - TOLERANCE));
+    const double yEnd = std::min(modelDims[1], step[1] * ceil(yModelMax / step[1] - TOLERANCE));
+
+    // The metadata snapshot would describe the original model, so it is omitted.
+    copier.copyGroups(false);
+    const double yazimuthRad = yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    copier.writeAttribute("/", "origin_x", modelOrigin[0] + xStart*cosAz + yStart*sinAz);
+    copier.writeAttribute("/", "origin_y", modelOrigin[1] - xStart*sinAz + yStart*cosAz);
+    copier.writeAttribute("/", "dim_x", xEnd - xStart);
+    copier.writeAttribute("/", "dim_y", yEnd - yStart);
+
+    _Extract::CopyStats stats;
+    for (size_t i = 0; i < datasets.size(); ++i) {
+        const _Extract::Dataset& dataset = datasets[i];
+        const hsize_t offset[2] = {
+            hsize_t(floor(xStart / dataset.resolution[0] + 0.5)),
+            hsize_t(floor(yStart / dataset.resolution[1] + 0.5)),
+        };
+        const hsize_t dims[2] = {
+            hsize_t(floor((xEnd - xStart) / dataset.resolution[0] + 0.5)) + 1,
+            hsize_t(floor((yEnd - yStart) / dataset.resolution[1] + 0.5)) + 1,
+        };
+        _Extract::copyDataset(&stats, &copier, dataset, offset, dims);
+    } // for
+
+    std::cout << "Extracted region x=[" << xStart << ", " << xEnd << "], y=[" << yStart << ", " << yEnd
+              << "] (model coordinates) of model '" << _modelFilename << "' to '" << _outputFilename << "'.\n"
+              << "Copied " << stats.numChunksRaw << " chunks without recompression and "
+              << stats.numChunksByValue << " edge chunks by value; copied "
+              << stats.numDatasetsByValue << " datasets by value." << std::endl;
+    copier.close();
+
+    return 0;
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse command line arguments.
+void
+geomodelgrids::apps::Extract::_parseArgs(int argc,
+                                         char* argv[]) {
+    static struct option options[6] = {
+        {"help", no_argument, nullptr, 'h'},
+        {"model", required_argument, nullptr, 'm'},
+        {"output", required_argument, nullptr, 'o'},
+        {"bbox", required_argument, nullptr, 'b'},
+        {"bbox-crs", required_argument, nullptr, 'c'},
+        {0, 0, 0, 0}
+    };
+
+    bool haveBBox = false;
+    while (true) {
+        // extern char* optarg;
+        const char c = getopt_long(argc, argv, "hm:o:b:c:", options, nullptr);
+        if (-1 == c) { break; }
+        switch (c) {
+        case 'h':
+            _showHelp = true;
+            break;
+        case 'm':
+            _modelFilename = optarg;
+            break;
+        case 'o':
+            _outputFilename = optarg;
+            break;
+        case 'b': {
+            std::istringstream tokenStream(optarg);
+            std::string token;
+            size_t numValues = 0;
+            while (std::getline(tokenStream, token, ',')) {
+                if (numValues < 4) {
+                    _bbox[numValues] = std::stod(token);
+                } // if
+                ++numValues;
+            } // while
+            if (4 != numValues) {
+                std::ostringstream msg;
+                msg << "Bounding box must have 4 values (XMIN,XMAX,YMIN,YMAX). Found '" << optarg << "'.";
+                throw std::runtime_error(msg.str());
+            } // if
+            haveBBox = true;
+            break;
+        } // 'b'
+        case 'c':
+            _bboxCRS = optarg;
+            break;
+        case '?': {
+            std::ostringstream msg;
+            msg << "Error passing command line arguments:\n";
+            for (int i = 0; i < argc; ++i) {
+                msg << argv[i] << " ";
+            } // for
+            throw std::logic_error(msg.str().c_str());
+        } // ?
+        } // switch
+    } // while
+    if (1 == argc) {
+        _showHelp = true;
+    } // if
+    if (_showHelp) {
+        return;
+    } // if
+
+    std::ostringstream msg;
+    if (_modelFilename.empty()) {
+        msg << "    --model=FILE\n";
+    } // if
+    if (_outputFilename.empty()) {
+        msg << "    --output=FILE\n";
+    } // if
+    if (!haveBBox) {
+        msg << "    --bbox=XMIN,XMAX,YMIN,YMAX\n";
+    } // if
+    if (msg.str().length() > 0) {
+        throw std::runtime_error("Missing required command line arguments:\n" + msg.str());
+    } // if
+    if (( _bbox[0] > _bbox[1]) || ( _bbox[2] > _bbox[3]) ) {
+        throw std::runtime_error("Bounding box minimum must not be greater than maximum.");
+    } // if
+} // _parseArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Print help information.
+void
+geomodelgrids::apps::Extract::_printHelp(void) {
+    std::cout << "Usage: geomodelgrids_extract "
+              << "[--help] --model=FILE --output=FILE --bbox=XMIN,XMAX,YMIN,YMAX [--bbox-crs=CRS]\n\n"
+              << "    --help                       Print help information to stdout and exit.\n"
+              << "    --model=FILE                 Model to extract subset from.\n"
+              << "    --output=FILE                Model file for subset (overwritten if it exists).\n"
+              << "    --bbox=XMIN,XMAX,YMIN,YMAX   Horizontal bounding box of subset.\n"
+              << "    --bbox-crs=CRS               Coordinate system of bounding box (default is EPSG:4326)."
+              << std::endl;
+} // _printHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Get resolution and chunking of dataset.
+void
+geomodelgrids::apps::_Extract::getDatasetInfo(Dataset* dataset,
+                                              const hid_t file) {
+    assert(dataset);
+
+    Handle datasetId(H5Dopen2(file, dataset->path.c_str(), H5P_DEFAULT), H5Dclose,
+                     "open dataset '" + dataset->path + "'");
+    if (( H5Aexists(datasetId, "x_resolution") <= 0) || ( H5Aexists(datasetId, "y_resolution") <= 0) ) {
+        std::ostringstream msg;
+        msg << "Cannot extract subset of dataset '" << dataset->path << "'. Only datasets with uniform "
+            << "horizontal resolution are supported.";
+        throw std::runtime_error(msg.str());
+    } // if
+    dataset->resolution[0] = readDouble(datasetId, "x_resolution");
+    dataset->resolution[1] = readDouble(datasetId, "y_resolution");
+
+    Handle dcpl(H5Dget_create_plist(datasetId), H5Pclose, "get creation properties of dataset '" + dataset->path + "'");
+    dataset->chunk[0] = 0;
+    dataset->chunk[1] = 0;
+    if (H5D_CHUNKED == H5Pget_layout(dcpl)) {
+        Handle space(H5Dget_space(datasetId), H5Sclose, "get dataspace of dataset '" + dataset->path + "'");
+        const int ndims = H5Sget_simple_extent_ndims(space);
+        std::vector<hsize_t> chunk(ndims);
+        H5Pget_chunk(dcpl, ndims, chunk.data());
+        dataset->chunk[0] = chunk[dataset->xDim+0];
+        dataset->chunk[1] = chunk[dataset->xDim+1];
+    } // if
+} // getDatasetInfo
+
+
+// ------------------------------------------------------------------------------------------------
+// Read scalar double attribute.
+double
+geomodelgrids::apps::_Extract::readDouble(const hid_t object,
+                                          const char* name) {
+    Handle attribute(H5Aopen(object, name, H5P_DEFAULT), H5Aclose, std::string("open attribute '") + name + "'");
+    double value = 0.0;
+    if (H5Aread(attribute, H5T_NATIVE_DOUBLE, &value) < 0) {
+        throw std::runtime_error(std::string("Could not read attribute '") + name + "'.");
+    } // if
+    return value;
+} // readDouble
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy horizontal subset of dataset.
+void
+geomodelgrids::apps::_Extract::copyDataset(CopyStats* stats,
+                                           geomodelgrids::serial::HDF5Copier* copier,
+                                           const Dataset& dataset,
+                                           const hsize_t offset[2],
+                                           const hsize_t dims[2]) {
+    assert(stats);
+    assert(copier);
+
+    const char* path = dataset.path.c_str();
+    Handle src(H5Dopen2(copier->getSource(), path, H5P_DEFAULT), H5Dclose, "open dataset '" + dataset.path + "'");
+    Handle srcSpace(H5Dget_space(src), H5Sclose, "get dataspace of dataset '" + dataset.path + "'");
+    const int ndims = H5Sget_simple_extent_ndims(srcSpace);
+    std::vector<hsize_t> srcDims(ndims);
+    H5Sget_simple_extent_dims(srcSpace, srcDims.data(), nullptr);
+    std::vector<hsize_t> destDims(srcDims);
+    std::vector<hsize_t> srcOrigin(ndims, 0); // Offset of subset in each dimension of dataset.
+    const int xDim = dataset.xDim;
+    for (int iDim = 0; iDim < 2; ++iDim) {
+        if (offset[iDim] + dims[iDim] > srcDims[xDim+iDim]) {
+            std::ostringstream msg;
+            msg << "Subset (offset: " << offset[iDim] << ", dim: " << dims[iDim] << ") exceeds dimension "
+                << srcDims[xDim+iDim] << " of dataset '" << dataset.path << "'.";
+            throw std::length_error(msg.str());
+        } // if
+        destDims[xDim+iDim] = dims[iDim];
+        srcOrigin[xDim+iDim] = offset[iDim];
+    } // for
+
+    // Create dataset with the same type, chunking, and filters.
+    Handle fileType(H5Dget_type(src), H5Tclose, "get type of dataset '" + dataset.path + "'");
+    Handle dcpl(H5Dget_create_plist(src), H5Pclose, "get creation properties of dataset '" + dataset.path + "'");
+    Handle destSpace(H5Screate_simple(ndims, destDims.data(), nullptr), H5Sclose, "create dataspace");
+    Handle dest(H5Dcreate2(copier->getDestination(), path, fileType, destSpace, H5P_DEFAULT, dcpl, H5P_DEFAULT), H5Dclose,
+                "create dataset '" + dataset.path + "'");
+    copier->copyAttributes(path);
+    Handle memType(H5Tget_native_type(fileType, H5T_DIR_ASCEND), H5Tclose, "get native type of dataset");
+
+    const bool copyChunks = dataset.chunk[0] && dataset.chunk[1] &&
+                            0 == offset[0] % dataset.chunk[0] && 0 == offset[1] % dataset.chunk[1];
+    if (copyChunks) {
+        std::vector<hsize_t> chunk(ndims);
+        H5Pget_chunk(dcpl, ndims, chunk.data());
+        std::vector<hsize_t> numChunks(ndims);
+        hsize_t numChunksTotal = 1;
+        for (int iDim = 0; iDim < ndims; ++iDim) {
+            numChunks[iDim] = (destDims[iDim] + chunk[iDim] - 1) / chunk[iDim];
+            numChunksTotal *= numChunks[iDim];
+        } // for
+
+        std::vector<char> buffer;
+        std::vector<hsize_t> destOffset(ndims);
+        std::vector<hsize_t> srcOffset(ndims);
+        std::vector<hsize_t> count(ndims);
+        for (hsize_t iChunk = 0; iChunk < numChunksTotal; ++iChunk) {
+            hsize_t index = iChunk;
+            for (int iDim = ndims-1; iDim >= 0; --iDim) {
+                destOffset[iDim] = (index % numChunks[iDim]) * chunk[iDim];
+                srcOffset[iDim] = destOffset[iDim] + srcOrigin[iDim];
+                index /= numChunks[iDim];
+            } // for
+
+            // Chunks that were never written hold only the fill value and are skipped.
+            hsize_t numBytes = 0;
+            herr_t err = 0;
+            H5E_BEGIN_TRY {
+                err = H5Dget_chunk_storage_size(src, srcOffset.data(), &numBytes);
+            } H5E_END_TRY;
+            if (( err < 0) || !numBytes) {
+                continue;
+            } // if
+
+            // A chunk extending past the end of the subset, but not past the end of the dataset,
+            // holds points outside the subset, so only the points within the subset are copied.
+            bool isEdge = false;
+            for (int iDim = 0; iDim < ndims; ++iDim) {
+                count[iDim] = std::min(chunk[iDim], destDims[iDim] - destOffset[iDim]);
+                if (( count[iDim] < chunk[iDim]) && ( srcOrigin[iDim] + destDims[iDim] < srcDims[iDim]) ) {
+                    isEdge = true;
+                } // if
+            } // for
+            if (isEdge) {
+                copyValues(src, srcSpace, dest, destSpace, memType, srcOffset, destOffset, count, &buffer, dataset.path);
+                ++stats->numChunksByValue;
+                continue;
+            } // if
+
+            buffer.resize(numBytes);
+            uint32_t filters = 0;
+            if (H5Dread_chunk(src, H5P_DEFAULT, srcOffset.data(), &filters, buffer.data()) < 0) {
+                throw std::runtime_error("Could not read chunk of dataset '" + dataset.path + "'.");
+            } // if
+            if (H5Dwrite_chunk(dest, H5P_DEFAULT, filters, destOffset.data(), numBytes, buffer.data()) < 0) {
+                throw std::runtime_error("Could not write chunk of dataset '" + dataset.path + "'.");
+            } // if
+            ++stats->numChunksRaw;
+        } // for
+    } else {
+        // Copy values in slabs along the x axis.
+        const hsize_t slabSize = std::max(hsize_t(1), dataset.chunk[0]);
+        std::vector<hsize_t> count(destDims);
+        std::vector<hsize_t> srcStart(srcOrigin);
+        std::vector<hsize_t> destStart(ndims, 0);
+        std::vector<char> buffer;
+        for (hsize_t x = 0; x < destDims[xDim]; x += slabSize) {
+            count[xDim] = std::min(slabSize, destDims[xDim] - x);
+            srcStart[xDim] = srcOrigin[xDim] + x;
+            destStart[xDim] = x;
+            copyValues(src, srcSpace, dest, destSpace, memType, srcStart, destStart, count, &buffer, dataset.path);
+        } // for
+        ++stats->numDatasetsByValue;
+    } // if/else
+} // copyDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy values in hyperslab of dataset.
+void
+geomodelgrids::apps::_Extract::copyValues(const hid_t src,
+                                          const hid_t srcSpace,
+                                          const hid_t dest,
+                                          const hid_t destSpace,
+                                          const hid_t memType,
+                                          const std::vector<hsize_t>& srcStart,
+                                          const std::vector<hsize_t>& destStart,
+                                          const std::vector<hsize_t>& count,
+                                          std::vector<char>* buffer,
+                                          const std::string& path) {
+    assert(buffer);
+
+    const int ndims = count.size();
+    hsize_t numValues = 1;
+    for (int iDim = 0; iDim < ndims; ++iDim) {
+        numValues *= count[iDim];
+    } // for
+    buffer->resize(numValues * H5Tget_size(memType));
+
+    Handle memSpace(H5Screate_simple(ndims, count.data(), nullptr), H5Sclose, "create dataspace");
+    H5Sselect_hyperslab(srcSpace, H5S_SELECT_SET, srcStart.data(), nullptr, count.data(), nullptr);
+    if (H5Dread(src, memType, memSpace, srcSpace, H5P_DEFAULT, buffer->data()) < 0) {
+        throw std::runtime_error("Could not read values of dataset '" + path + "'.");
+    } // if
+    H5Sselect_hyperslab(destSpace, H5S_SELECT_SET, destStart.data(), nullptr, count.data(), nullptr);
+    if (H5Dwrite(dest, memType, memSpace, destSpace, H5P_DEFAULT, buffer->data()) < 0) {
+        throw std::runtime_error("Could not write values of dataset '" + path + "'.");
+    } // if
+} // copyValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute least common multiple of two resolutions.
+double
+geomodelgrids::apps::_Extract::leastCommonMultiple(const double a,
+                                                   const double b) {
+    const size_t maxMultiple = 1000;
+    if (( a <= 0.0) || ( b <= 0.0) ) {
+        return 0.0;
+    } // if
+    for (size_t i = 1; i <= maxMultiple; ++i) {
+        const double ratio = i * a / b;
+        if (fabs(ratio - floor(ratio + 0.5)) < TOLERANCE) {
+            return i * a;
+        } // if
+    } // for
+    return 0.0;
+} // leastCommonMultiple
+
+
+// End of file
@@ -0,0 +1,69 @@
+/// C++ application to extract a horizontal subset of a model into a new model file.
+#pragma once
+
+#include "appsfwd.hh" // forward declarations
+
+#include <string> // USES std::string
+
+class geomodelgrids::apps::Extract {
+    friend class TestExtract; // unit testing
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Constructor
+    Extract(void);
+
+    /// Destructor
+    ~Extract(void);
+
+    /**
+     * Run extract application.
+     *
+     * Arguments:
+     *   --help
+     *   --model=FILE
+     *   --output=FILE
+     *   --bbox=XMIN,XMAX,YMIN,YMAX
+     *   --bbox-crs=CRS
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     *
+     * @returns 1 if errors were detected, 0 otherwise.
+     */
+    int run(int argc,
+            char* argv[]);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Parse command line arguments.
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     */
+    void _parseArgs(int argc,
+                    char* argv[]);
+
+    /// Print help information.
+    void _printHelp(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    std::string _modelFilename;
+    std::string _outputFilename;
+    std::string _bboxCRS;
+    double _bbox[4]; ///< Bounding box [xmin, xmax, ymin, ymax].
+    bool _showHelp;
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    Extract(const Extract&); ///< Not implemented
+    const Extract& operator=(const Extract&); ///< Not implemented
+
+}; // Extract
+
+// End of file
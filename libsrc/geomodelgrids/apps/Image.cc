@@ -0,0 +1,145 @@
+#include <portinfo>
+
+#include "Image.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/ModelImage.hh" // USES ModelImage
+
+#include <getopt.h> // USES getopt_long()
+#include <unistd.h> // USES unlink()
+#include <iostream> // USES std::cout
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream, std::istringstream
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::apps::Image::Image() :
+    _useDefaultImageDir(true),
+    _removeImages(false),
+    _showHelp(false) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::apps::Image::~Image(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Run image application.
+int
+geomodelgrids::apps::Image::run(int argc,
+                                char* argv[]) {
+    _parseArgs(argc, argv);
+
+    if (_showHelp) {
+        _printHelp();
+        return 0;
+    } // if
+
+    const char* imageDir = _useDefaultImageDir ? nullptr : _imageDir.c_str();
+    const size_t numModels = _modelFilenames.size();
+    for (size_t i = 0; i < numModels; ++i) {
+        const char* filename = _modelFilenames[i].c_str();
+        const std::string& imagePath = geomodelgrids::serial::ModelImage::getImagePath(filename, imageDir);
+        if (imagePath.empty()) {
+            throw std::runtime_error("Model images are disabled (empty image directory).");
+        } // if
+
+        if (_removeImages) {
+            if (0 == unlink(imagePath.c_str())) {
+                std::cout << "Removed image '" << imagePath << "' for model '" << filename << "'." << std::endl;
+            } // if
+            continue;
+        } // if
+
+        geomodelgrids::serial::Model model;
+        model.open(filename, geomodelgrids::serial::Model::READ);
+        model.loadMetadata();
+        model.initialize();
+        const size_t numBytes = geomodelgrids::serial::ModelImage::write(imagePath.c_str(), filename, model);
+        model.close();
+
+        std::cout << "Wrote image '" << imagePath << "' (" << numBytes << " bytes) for model '" << filename << "'."
+                  << std::endl;
+    } // for
+
+    return 0;
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse command line arguments.
+void
+geomodelgrids::apps::Image::_parseArgs(int argc,
+                                       char* argv[]) {
+    static struct option options[5] = {
+        {"help", no_argument, nullptr, 'h'},
+        {"models", required_argument, nullptr, 'm'},
+        {"image-dir", required_argument, nullptr, 'd'},
+        {"remove", no_argument, nullptr, 'r'},
+        {0, 0, 0, 0}
+    };
+
+    while (true) {
+        // extern char* optarg;
+        const char c = getopt_long(argc, argv, "hm:d:r", options, nullptr);
+        if (-1 == c) { break; }
+        switch (c) {
+        case 'h':
+            _showHelp = true;
+            break;
+        case 'm': {
+            _modelFilenames.clear();
+            std::istringstream tokenStream(optarg);
+            if (tokenStream.str().find(",") != std::string::npos) {
+                std::string token;
+                while (std::getline(tokenStream, token, ',')) {
+                    _modelFilenames.push_back(token);
+                } // while
+            } else {
+                _modelFilenames.push_back(optarg);
+            } // if/else
+            break;
+        } // 'm'
+        case 'd':
+            _imageDir = optarg;
+            _useDefaultImageDir = false;
+            break;
+        case 'r':
+            _removeImages = true;
+            break;
+        case '?': {
+            std::ostringstream msg;
+            msg << "Error passing command line arguments:\n";
+            for (int i = 0; i < argc; ++i) {
+                msg << argv[i] << " ";
+            } // for
+            throw std::logic_error(msg.str().c_str());
+        } // ?
+        } // switch
+    } // while
+    if (1 == argc) {
+        _showHelp = true;
+    } // if
+    if (!_showHelp && (0 == _modelFilenames.size())) {
+        throw std::runtime_error("Missing required command line argument --models=FILE_0,...,FILE_M.");
+    } // if
+} // _parseArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Print help information.
+void
+geomodelgrids::apps::Image::_printHelp(void) {
+    std::cout << "Usage: geomodelgrids_image "
+              << "[--help] --models=FILE_0,...,FILE_M [--image-dir=DIR] [--remove]\n\n"
+              << "    --help                       Print help information to stdout and exit.\n"
+              << "    --models=FILE_0,...,FILE_M   Models to publish as images.\n"
+              << "    --image-dir=DIR              Directory for images (default is GEOMODELGRIDS_IMAGE_DIR\n"
+              << "                                 environment variable or /dev/shm).\n"
+              << "    --remove                     Remove images instead of writing them."
+              << std::endl;
+} // _printHelp
+
+
+// End of file
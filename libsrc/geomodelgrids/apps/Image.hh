@@ -0,0 +1,69 @@
+/// C++ application to publish model images in shared memory.
+#pragma once
+
+#include "appsfwd.hh" // forward declarations
+
+#include <vector> // USES std::std::vector
+#include <string> // USES std::string
+
+class geomodelgrids::apps::Image {
+    friend class TestImage; // unit testing
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Constructor
+    Image(void);
+
+    /// Destructor
+    ~Image(void);
+
+    /**
+     * Run image application.
+     *
+     * Arguments:
+     *   --help
+     *   --models=FILE_0,...,FILE_M
+     *   --image-dir=DIR
+     *   --remove
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     *
+     * @returns 1 if errors were detected, 0 otherwise.
+     */
+    int run(int argc,
+            char* argv[]);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Parse command line arguments.
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     */
+    void _parseArgs(int argc,
+                    char* argv[]);
+
+    /// Print help information.
+    void _printHelp(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    std::vector<std::string> _modelFilenames;
+    std::string _imageDir;
+    bool _useDefaultImageDir;
+    bool _removeImages;
+    bool _showHelp;
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    Image(const Image&); ///< Not implemented
+    const Image& operator=(const Image&); ///< Not implemented
+
+}; // Image
+
+// End of file
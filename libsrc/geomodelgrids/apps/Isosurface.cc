@@ -10,7 +10,12 @@
 
 #include <cmath>
 #include <strings.h> // USES strcasecmp()
-#include <algorithm>
+#include <algorithm> // USES std::min()
+#include <thread> // USES std::thread
+#include <mutex> // USES std::mutex
+#include <atomic> // USES std::atomic
+#include <exception> // USES std::exception_ptr
+#include <memory> // USES std::unique_ptr
 #include <getopt.h> // USES getopt_long()
 #include <iomanip>
 #include <fstream> // USES std::ofstream
@@ -20,6 +25,10 @@
 
 namespace geomodelgrids {
     namespace apps {
+        namespace _Isosurface {
+            static const size_t tileSize = 128; ///< Number of raster cells along each side of a tile (and GeoTiff tile).
+        } // _Isosurface
+
         // ----------------------------------------------------------------------------------------
         class Isosurfacer {
 public:
@@ -35,16 +44,33 @@ public:
 
             void query(double* values,
                        const double x,
-                       const double y);
+                       const double y,
+                       const double* seeds=nullptr);
 
             void finalize(void);
 
 private:
 
+            void _searchColumn(double* values,
+                               const double x,
+                               const double y,
+                               const double topElev);
+
+            bool _seedBracket(double* zTop,
+                              double* zBot,
+                              const double x,
+                              const double y,
+                              const double topElev,
+                              const double seed,
+                              const size_t iValue);
+
             const Isosurface& _app;
             geomodelgrids::serial::Query* _query;
             size_t _numLevels;
+            double _seedHalfWidth;
             std::vector<double> _vbuffer;
+            std::vector<double> _elevations;
+            std::vector<double> _columnValues;
 
         }; // Isosurfacer
 
@@ -127,8 +153,13 @@ geomodelgrids::apps::Isosurface::Isosurface(void) :
     _vertRes(10.0),
     _maxDepth(0.0),
     _numSearchPoints(10),
+    _numThreads(1),
     _depthSurface(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY),
     _preferShallow(true),
+    _columnSearch(true),
+    _seedNeighbors(false),
+    _compression("DEFLATE"),
+    _numOverviews(0),
     _showHelp(false) {
     _isosurfaces.resize(2);
     _isosurfaces[0] = Isosurfacer::isosurface_t("Vs", 1.0e+3);
@@ -157,72 +188,126 @@ geomodelgrids::apps::Isosurface::run(int argc,
         return 0;
     } // if
 
-    geomodelgrids::utils::CRSTransformer* toXYOrder =
-        geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(_bboxCRS.c_str());
+    std::unique_ptr<geomodelgrids::utils::CRSTransformer> toXYOrder(
+        geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(_bboxCRS.c_str()));
     assert(toXYOrder);
     toXYOrder->transform(&_minX, &_minY, nullptr, _minX, _minY, 0.0);
     toXYOrder->transform(&_maxX, &_maxY, nullptr, _maxX, _maxY, 0.0);
 
-    try {
-        Isosurfacer isosurfacer(*this);
-        isosurfacer.initialize();
+    // Each worker thread uses its own isosurfacer (with its own query) and coordinate transformer.
+    std::vector<std::unique_ptr<Isosurfacer> > isosurfacers(_numThreads);
+    std::vector<std::unique_ptr<geomodelgrids::utils::CRSTransformer> > transformers(_numThreads);
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        isosurfacers[iThread].reset(new Isosurfacer(*this));
+        isosurfacers[iThread]->initialize();
         if (!_logFilename.empty()) {
-            geomodelgrids::serial::Query* query = isosurfacer.getQuery();assert(query);
+            geomodelgrids::serial::Query* query = isosurfacers[iThread]->getQuery();assert(query);
             std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query->getErrorHandler();
             errorHandler->setLogFilename(_logFilename.c_str());
             errorHandler->setLoggingOn(true);
         } // if
+        transformers[iThread].reset(geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(_bboxCRS.c_str()));
+    } // for
 
-        const size_t numX = size_t((_maxX + 0.5*_horizRes - _minX) / _horizRes);
-        const size_t numY = size_t((_maxY + 0.5*_horizRes - _minY) / _horizRes);
-        const size_t numIsosurfaces = _isosurfaces.size();
+    const size_t numX = size_t((_maxX + 0.5*_horizRes - _minX) / _horizRes);
+    const size_t numY = size_t((_maxY + 0.5*_horizRes - _minY) / _horizRes);
+    const size_t numIsosurfaces = _isosurfaces.size();
 
-        std::vector<std::string> bandLabels(numIsosurfaces);
-        for (size_t i = 0; i < numIsosurfaces; ++i) {
-            std::ostringstream label;
-            label << _isosurfaces[i].first << "=" << _isosurfaces[i].second;
-            bandLabels[i] = label.str();
-        } // for
+    std::vector<std::string> bandLabels(numIsosurfaces);
+    for (size_t i = 0; i < numIsosurfaces; ++i) {
+        std::ostringstream label;
+        label << _isosurfaces[i].first << "=" << _isosurfaces[i].second;
+        bandLabels[i] = label.str();
+    } // for
 
-        geomodelgrids::utils::GeoTiff writer;
-        writer.setNumCols(numX);
-        writer.setNumRows(numY);
-        writer.setNumBands(numIsosurfaces);
-        writer.setBandLabels(bandLabels);
-        writer.setCRS(_bboxCRS.c_str());
-        writer.setBBox(_minX, _maxX, _minY, _maxY);
-        writer.setNoDataValue(geomodelgrids::NODATA_VALUE);
-        writer.create(_outputFilename.c_str());
-
-        std::vector<double> values(numIsosurfaces);
-        float* buffer = writer.getBands();
-        for (size_t iY = 0, iPt = 0; iY < numY; ++iY) {
-            const size_t row = numY - iY - 1;
-            const double y = _minY + (iY + 0.5) * _horizRes;
-            double xCRS, yCRS;
-
-            for (size_t iX = 0; iX < numX; ++iX, ++iPt) {
-                const size_t col = iX;
-                const double x = _minX + (iX + 0.5) * _horizRes;
-
-                toXYOrder->inverse_transform(&xCRS, &yCRS, nullptr, x, y, 0.0);
-                isosurfacer.query(&values[0], xCRS, yCRS);
-                for (size_t iValue = 0; iValue < numIsosurfaces; ++iValue) {
-                    buffer[iValue*numY*numX + row*numX + col] = values[iValue];
+    geomodelgrids::utils::GeoTiff writer;
+    writer.setNumCols(numX);
+    writer.setNumRows(numY);
+    writer.setNumBands(numIsosurfaces);
+    writer.setBandLabels(bandLabels);
+    writer.setCRS(_bboxCRS.c_str());
+    writer.setBBox(_minX, _maxX, _minY, _maxY);
+    writer.setNoDataValue(geomodelgrids::NODATA_VALUE);
+    writer.setTileSize(_Isosurface::tileSize);
+    writer.setCompression(_compression.c_str());
+    writer.setNumOverviews(_numOverviews);
+    writer.create(_outputFilename.c_str());
+
+    // Workers take tiles of the raster in turn and write each tile as soon as it is computed, so
+    // memory use is proportional to the tile size rather than the raster size.
+    const size_t tileSize = _Isosurface::tileSize;
+    const size_t numTilesX = (numX + tileSize - 1) / tileSize;
+    const size_t numTilesY = (numY + tileSize - 1) / tileSize;
+    const size_t numTiles = numTilesX * numTilesY;
+    std::atomic<size_t> nextTile(0);
+    std::atomic<bool> aborted(false);
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    std::mutex writerMutex;
+    auto processTiles = [&](const size_t iThread) {
+        try {
+            Isosurfacer& isosurfacer = *isosurfacers[iThread];
+            geomodelgrids::utils::CRSTransformer& transformer = *transformers[iThread];
+            std::vector<double> values(numIsosurfaces);
+            std::vector<double> seeds(numIsosurfaces);
+            std::vector<float> buffer(numIsosurfaces*tileSize*tileSize);
+            for (size_t iTile = nextTile++; iTile < numTiles && !aborted; iTile = nextTile++) {
+                // Tiles are aligned with the image rows (top to bottom), matching the GeoTiff tiles.
+                const size_t colBegin = (iTile % numTilesX) * tileSize;
+                const size_t rowBegin = (iTile / numTilesX) * tileSize;
+                const size_t numTileCols = std::min(colBegin + tileSize, numX) - colBegin;
+                const size_t numTileRows = std::min(rowBegin + tileSize, numY) - rowBegin;
+                bool haveSeeds = false;
+                for (size_t iRow = 0; iRow < numTileRows; ++iRow) {
+                    const size_t iY = numY - (rowBegin + iRow) - 1;
+                    const double y = _minY + (iY + 0.5) * _horizRes;
+                    double xCRS, yCRS;
+
+                    // Serpentine order, so consecutive cells are always neighbors.
+                    const bool reverse = iRow % 2;
+                    for (size_t i = 0; i < numTileCols; ++i) {
+                        const size_t iCol = (reverse) ? numTileCols - 1 - i : i;
+                        const double x = _minX + (colBegin + iCol + 0.5) * _horizRes;
+
+                        transformer.inverse_transform(&xCRS, &yCRS, nullptr, x, y, 0.0);
+                        isosurfacer.query(&values[0], xCRS, yCRS, (haveSeeds) ? &seeds[0] : nullptr);
+                        for (size_t iValue = 0; iValue < numIsosurfaces; ++iValue) {
+                            buffer[iValue*numTileRows*numTileCols + iRow*numTileCols + iCol] = values[iValue];
+                        } // for
+                        if (_seedNeighbors) {
+                            seeds = values;
+                            haveSeeds = true;
+                        } // if
+                    } // for
                 } // for
+
+                std::lock_guard<std::mutex> lock(writerMutex);
+                writer.writeWindow(&buffer[0], colBegin, rowBegin, numTileCols, numTileRows);
             } // for
-        } // for
-        delete toXYOrder;toXYOrder = nullptr;
-        writer.write();
-        writer.close();
-        isosurfacer.finalize();
-    } catch (const std::exception& err) {
-        delete toXYOrder;toXYOrder = nullptr;
-        throw;
-    } catch (...) {
-        delete toXYOrder;toXYOrder = nullptr;
-        throw;
-    } // try/catch
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            } // if
+            aborted = true;
+        } // try/catch
+    };
+    std::vector<std::thread> threads;
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        threads.push_back(std::thread(processTiles, iThread));
+    } // for
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        threads[iThread].join();
+    } // for
+    if (error) {
+        std::rethrow_exception(error);
+    } // if
+
+    writer.buildOverviews();
+    writer.close();
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        isosurfacers[iThread]->finalize();
+    } // for
 
     return 0;
 #endif
@@ -234,7 +319,7 @@ geomodelgrids::apps::Isosurface::run(int argc,
 void
 geomodelgrids::apps::Isosurface::_parseArgs(int argc,
                                             char* argv[]) {
-    static struct option options[14] = {
+    static struct option options[19] = {
         {"help", no_argument, nullptr, 'h'},
         {"log", required_argument, nullptr, 'l'},
         {"bbox", required_argument, nullptr, 'b'},
@@ -248,13 +333,18 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
         {"output", required_argument, nullptr, 'o'},
         {"prefer-deep", no_argument, nullptr, 'p'},
         {"bbox-coordsys", required_argument, nullptr, 'c'},
+        {"num-threads", required_argument, nullptr, 't'},
+        {"line-search", no_argument, nullptr, 'g'},
+        {"seed-neighbors", no_argument, nullptr, 'e'},
+        {"compression", required_argument, nullptr, 'z'},
+        {"num-overviews", required_argument, nullptr, 'w'},
         {0, 0, 0, 0}
     };
 
     _isosurfaces.clear();
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hl:b:r:v:i:s:d:m:o:pc:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hl:b:r:v:i:s:d:m:o:pc:t:gez:w:", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -343,6 +433,26 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
             _bboxCRS = optarg;
             break;
         } // 'c'
+        case 't': {
+            _numThreads = size_t(std::max(0, atoi(optarg)));
+            break;
+        } // 't'
+        case 'g': {
+            _columnSearch = false;
+            break;
+        } // 'g'
+        case 'e': {
+            _seedNeighbors = true;
+            break;
+        } // 'e'
+        case 'z': {
+            _compression = optarg;
+            break;
+        } // 'z'
+        case 'w': {
+            _numOverviews = size_t(std::max(0, atoi(optarg)));
+            break;
+        } // 'w'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -392,6 +502,19 @@ geomodelgrids::apps::Isosurface::_parseArgs(int argc,
             msg << "    - Number of search points (" << _numSearchPoints << ") must be at least 2.\n";
             optionsOkay = false;
         } // if
+        if (!_numThreads) {
+            msg << "    - Number of threads must be positive. Use --num-threads=NUM_THREADS\n";
+            optionsOkay = false;
+        } // if
+        if (_seedNeighbors && _columnSearch) {
+            msg << "    - Seeding search from neighboring cells requires line search. Use --line-search\n";
+            optionsOkay = false;
+        } // if
+        if (( 0 != strcasecmp(_compression.c_str(), "DEFLATE")) && ( 0 != strcasecmp(_compression.c_str(), "LZW")) &&
+            ( 0 != strcasecmp(_compression.c_str(), "NONE")) ) {
+            msg << "    - Unknown compression '" << _compression << "'. Use --compression=DEFLATE|LZW|NONE\n";
+            optionsOkay = false;
+        } // if
         if (_isosurfaces.empty()) {
             msg << "    - Missing isosurfaces. Use --isosurface=NAME,VALUE (can be repeated)\n";
             optionsOkay = false;
@@ -425,7 +548,8 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
               << "[--help] [--log=FILE_LOG] --bbox=XMIN,XMAX,YMIN,YMAX --hresolution=RESOLUTION "
               << "[--vresolution=RESOLUTION] --isosurface=NAME,VALUE [--depth-reference=SURFACE] "
               << "--max-depth=DEPTH [--num-search-points=NUM] --models=FILE_0,...,FILE_M --output=FILE_OUTPUT "
-              << " [--prefer-deep] [--bbox-coordsys=PROJ|EPSG|WKT]\n\n"
+              << " [--prefer-deep] [--bbox-coordsys=PROJ|EPSG|WKT] [--num-threads=NUM_THREADS] [--line-search] [--seed-neighbors] "
+              << "[--compression=DEFLATE|LZW|NONE] [--num-overviews=NUM]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --bbox=XMIN,XMAX,YMIN,YMAX       Bounding box for iosurface.\n"
@@ -434,14 +558,22 @@ geomodelgrids::apps::Isosurface::_printHelp(void) {
               << "    --depth-reference=SURFACE        Surface to use for calculating depth "
               << "(default=topography_bathymetry)\n"
               << "    --max-depth=DEPTH                Maximum depth allowed for isosurface.\n"
-              << "    --num-search-points=NUM          Number of search points in each iteration (default=10).\n"
+              << "    --num-search-points=NUM          Number of search points in each iteration of line search (default=10).\n"
               << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
               << "    --hresolution=RESOLUTION         Horizontal resolution of isosurface.\n"
-              << "    --vresolution=RESOLUTION         Vertical resolution for depth of isosurface (default=10.0).\n"
+              << "    --vresolution=RESOLUTION         Vertical resolution for depth of isosurface in line search (default=10.0).\n"
               << "    --prefer-deep                    Prefer deepest elevation for isosurface rather than "
               << "shallowest (default=shallowest).\n"
-              << "    --bbox-coordsys=PROJ|EPSG|WKT    Coordinate system for isosurface points (default=EPSG:4326)."
+              << "    --bbox-coordsys=PROJ|EPSG|WKT    Coordinate system for isosurface points (default=EPSG:4326).\n"
+              << "    --num-threads=NUM_THREADS        Number of threads computing isosurface tiles (default=1).\n"
+              << "    --line-search                    Find isosurface using iterative line search rather than "
+              << "scanning model grid points along each column.\n"
+              << "    --seed-neighbors                 Start line search in each cell from depths in neighboring "
+              << "cell (requires --line-search); crossings thinner than the first search spacing may differ.\n"
+              << "    --compression=DEFLATE|LZW|NONE   Compression of GeoTiff tiles (default=DEFLATE).\n"
+              << "    --num-overviews=NUM              Number of overviews, each reduced by another factor of 2 "
+              << "(default=0)."
               << std::endl;
 } // _printHelp
 
@@ -472,6 +604,8 @@ geomodelgrids::apps::Isosurfacer::initialize(void) {
 
     _numLevels = size_t(ceil(log(_app._maxDepth/_app._vertRes) / log(_app._numSearchPoints)));
     assert(_numLevels >= 1);
+    // Window around seed depth that reaches the same final resolution in one level of refinement.
+    _seedHalfWidth = 0.5 * _app._maxDepth / pow(_app._numSearchPoints-1, _numLevels-1);
 
     const size_t numValues = _app._isosurfaces.size();
     _vbuffer.resize(numValues);
@@ -489,7 +623,8 @@ geomodelgrids::apps::Isosurfacer::getQuery(void) const {
 void
 geomodelgrids::apps::Isosurfacer::query(double* values,
                                         const double x,
-                                        const double y) {
+                                        const double y,
+                                        const double* seeds) {
     assert(values);
     assert(_query);
 
@@ -512,6 +647,11 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
         return;
     } // if
 
+    if (_app._columnSearch) {
+        _searchColumn(values, x, y, topElev);
+        return;
+    } // if
+
     LineSearch* lineSearch = _app._preferShallow ?
                              (LineSearch*) new LineSearchDown(_query, _vbuffer, _app._numSearchPoints, x, y) :
                              (LineSearch*) new LineSearchUp(_query, _vbuffer, _app._numSearchPoints, x, y);
@@ -523,7 +663,11 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
         double zBot = topElev - _app._maxDepth;
         assert(zTop > zBot);
 
-        for (size_t iLevel = 0; iLevel < _numLevels; ++iLevel) {
+        size_t numLevels = _numLevels;
+        if (seeds && _seedBracket(&zTop, &zBot, x, y, topElev, seeds[iValue], iValue)) {
+            numLevels = 1;
+        } // if
+        for (size_t iLevel = 0; iLevel < numLevels; ++iLevel) {
             const double dz = (zTop - zBot) / (_app._numSearchPoints-1);
             const size_t iTop = lineSearch->search(zTop, zBot, dz, vTarget, iValue);
             zTop -= iTop*dz;
@@ -553,6 +697,75 @@ geomodelgrids::apps::Isosurfacer::query(double* values,
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// Narrow the search interval to a window around the depth of the isosurface in a neighboring
+// cell. Returns false and leaves the interval unchanged if the isosurface is not within the window
+// or if the first level of the full search finds a crossing above (shallow) or below (deep) the
+// window.
+bool
+geomodelgrids::apps::Isosurfacer::_seedBracket(double* zTop,
+                                               double* zBot,
+                                               const double x,
+                                               const double y,
+                                               const double topElev,
+                                               const double seed,
+                                               const size_t iValue) {
+    assert(zTop);
+    assert(zBot);
+    assert(_query);
+
+    if ((geomodelgrids::NODATA_VALUE == seed) || (seed <= 0.0)) {
+        return false;
+    } // if
+
+    const double zSeedTop = std::min(*zTop, topElev - seed + _seedHalfWidth);
+    const double zSeedBot = std::max(*zBot, topElev - seed - _seedHalfWidth);
+    if (zSeedTop <= zSeedBot) {
+        return false;
+    } // if
+
+    const double vTarget = _app._isosurfaces[iValue].second;
+    _query->query(&_vbuffer[0], x, y, zSeedTop);
+    const double vTop = _vbuffer[iValue];
+    _query->query(&_vbuffer[0], x, y, zSeedBot);
+    const double vBot = _vbuffer[iValue];
+    if ((geomodelgrids::NODATA_VALUE == vTop) || (geomodelgrids::NODATA_VALUE == vBot) ||
+        ( vTop >= vTarget) || ( vBot < vTarget) ) {
+        return false;
+    } // if
+
+    const size_t numSearchPoints = _app._numSearchPoints;
+    const double dz = (*zTop - *zBot) / (numSearchPoints-1);
+    if (_app._preferShallow) {
+        for (size_t iPt = 1; iPt < numSearchPoints; ++iPt) {
+            const double z = *zTop - iPt*dz;
+            if (z <= zSeedTop) {
+                break;
+            } // if
+            _query->query(&_vbuffer[0], x, y, z);
+            if (_vbuffer[iValue] >= vTarget) {
+                return false;
+            } // if
+        } // for
+    } else {
+        for (size_t iPt = 1; iPt < numSearchPoints; ++iPt) {
+            const double z = *zBot + iPt*dz;
+            if (z >= zSeedBot) {
+                break;
+            } // if
+            _query->query(&_vbuffer[0], x, y, z);
+            if (_vbuffer[iValue] < vTarget) {
+                return false;
+            } // if
+        } // for
+    } // if/else
+
+    *zTop = zSeedTop;
+    *zBot = zSeedBot;
+    return true;
+}
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::apps::Isosurfacer::finalize(void) {
@@ -561,6 +774,78 @@ geomodelgrids::apps::Isosurfacer::finalize(void) {
 }
 
 
+// ------------------------------------------------------------------------------------------------
+// Find isosurfaces from values at the model grid points along the column. Values vary linearly
+// between consecutive grid points, so interpolating between them gives the exact depth.
+void
+geomodelgrids::apps::Isosurfacer::_searchColumn(double* values,
+                                                const double x,
+                                                const double y,
+                                                const double topElev) {
+    assert(values);
+    assert(_query);
+
+    const double zTop = topElev - 1.0e-4;
+    const double zBot = topElev - _app._maxDepth;
+    assert(zTop > zBot);
+
+    const std::vector<double>& nodeElevations = _query->queryNodeElevations(x, y);
+    _elevations.clear();
+    _elevations.push_back(zTop);
+    for (size_t i = 0; i < nodeElevations.size(); ++i) {
+        if ((nodeElevations[i] < zTop) && (nodeElevations[i] > zBot)) {
+            _elevations.push_back(nodeElevations[i]);
+        } // if
+    } // for
+    _elevations.push_back(zBot);
+
+    const size_t numPoints = _elevations.size();
+    const size_t numValues = _vbuffer.size();
+    _columnValues.resize(numPoints*numValues);
+    _query->queryProfile(&_columnValues[0], x, y, &_elevations[0], numPoints);
+
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        const double vTarget = _app._isosurfaces[iValue].second;
+
+        // Find points above (iAbove) and below (iBelow) the crossing, skipping points outside the models.
+        size_t iAbove = numPoints;
+        size_t iBelow = numPoints;
+        size_t iPrev = numPoints;
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double v = _columnValues[iPt*numValues+iValue];
+            if (geomodelgrids::NODATA_VALUE == v) {
+                continue;
+            } // if
+            if (( v >= vTarget) && (( iPrev == numPoints) || ( _columnValues[iPrev*numValues+iValue] < vTarget) )) {
+                iAbove = iPrev;
+                iBelow = iPt;
+                if (_app._preferShallow) {
+                    break;
+                } // if
+            } // if
+            iPrev = iPt;
+        } // for
+        if (!_app._preferShallow && ( iPrev < numPoints) && ( _columnValues[iPrev*numValues+iValue] < vTarget) ) {
+            iBelow = numPoints; // Value at deepest point is less than target.
+        } // if
+
+        if (iBelow == numPoints) {
+            values[iValue] = geomodelgrids::NODATA_VALUE;
+        } else if (0 == iBelow) {
+            values[iValue] = 0.0;
+        } else if (iAbove == numPoints) {
+            values[iValue] = topElev - _elevations[iBelow];
+        } else {
+            const double vAbove = _columnValues[iAbove*numValues+iValue];
+            const double vBelow = _columnValues[iBelow*numValues+iValue];
+            const double zCross = _elevations[iAbove] +
+                                  (vTarget - vAbove) * (_elevations[iBelow] - _elevations[iAbove]) / (vBelow - vAbove);
+            values[iValue] = topElev - zCross;
+        } // if/else
+    } // for
+}
+
+
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::apps::LineSearch::LineSearch(geomodelgrids::serial::Query* query,
                                             std::vector<double>& vbuffer,
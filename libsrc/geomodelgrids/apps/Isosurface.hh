@@ -38,6 +38,7 @@ public:
      *   --output=FILE_OUTPUT
      *   --prefer-deep
      *   --bbox-coordsys=PROJ|EPSG|WKT
+     *   --num-threads=NUM_THREADS
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -85,8 +86,13 @@ private:
     double _vertRes;
     double _maxDepth;
     int _numSearchPoints;
+    size_t _numThreads;
     geomodelgrids::serial::Query::SquashingEnum _depthSurface;
     bool _preferShallow;
+    bool _columnSearch;
+    bool _seedNeighbors;
+    std::string _compression;
+    size_t _numOverviews;
     bool _showHelp;
 
     // NOT IMPLEMENTED /////////////////////////////////////////////////////////////////////////////////////////////////
@@ -4,11 +4,14 @@
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+#include "geomodelgrids/utils/PointsReader.hh" // USES PointsReader
+#include "geomodelgrids/utils/PointsWriter.hh" // USES PointsWriter
+#include "geomodelgrids/utils/PointsPipeline.hh" // USES PointsPipeline
 
 #include <getopt.h> // USES getopt_long()
 #include <iomanip>
-#include <fstream> // USES std::ifstream, std::ofstream
 #include <sstream> // USES std::ostringstream, std::istringstream
+#include <memory> // USES std::unique_ptr
 #include <cassert> // USES assert()
 #include <iostream> // USES std::cout
 
@@ -28,7 +31,14 @@ geomodelgrids::apps::Query::Query() :
     _pointsCRS("EPSG:4326"),
     _outputFilename(""),
     _logFilename(""),
+    _inputDataset("/points"),
+    _outputDataset("/values"),
+    _inputNumColumns(0),
+    _numThreads(1),
     _squashMinElev(-10.0e+3),
+    _targetResolution(0.0),
+    _inputFormat(geomodelgrids::utils::PointsReader::TEXT),
+    _outputFormat(geomodelgrids::utils::PointsReader::TEXT),
     _squash(geomodelgrids::serial::Query::SQUASH_NONE),
     _showHelp(false) {}
 
@@ -50,55 +60,67 @@ geomodelgrids::apps::Query::run(int argc,
         return 0;
     } // if
 
-    geomodelgrids::serial::Query query;
-    if (!_logFilename.empty()) {
-        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
-        errorHandler->setLogFilename(_logFilename.c_str());
-        errorHandler->setLoggingOn(true);
-    } // if
-    query.initialize(_modelFilenames, _valueNames, _pointsCRS);
-    if (geomodelgrids::serial::Query::SQUASH_NONE != _squash) {
-        query.setSquashing(_squash);
-        query.setSquashMinElev(_squashMinElev);
-    } // if
+    // Each worker thread uses its own query object.
+    std::vector<std::unique_ptr<geomodelgrids::serial::Query> > queries(_numThreads);
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        queries[iThread].reset(new geomodelgrids::serial::Query());
+        geomodelgrids::serial::Query& query = *queries[iThread];
+        if (!_logFilename.empty()) {
+            std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
+            errorHandler->setLogFilename(_logFilename.c_str());
+            errorHandler->setLoggingOn(true);
+        } // if
+        query.setTargetResolution(_targetResolution);
+        query.initialize(_modelFilenames, _valueNames, _pointsCRS);
+        if (geomodelgrids::serial::Query::SQUASH_NONE != _squash) {
+            query.setSquashing(_squash);
+            query.setSquashMinElev(_squashMinElev);
+        } // if
+    } // for
 
-    std::ifstream sin(_pointsFilename);
-    if (!sin.is_open() && !sin.good()) {
-        std::ostringstream msg;
-        msg << "Could not open points file '" << _pointsFilename << "' for reading.";
-        throw std::runtime_error(msg.str().c_str());
-    } // if
+    const size_t spaceDim = 3;
+    geomodelgrids::utils::PointsReader reader;
+    reader.setColumns(_inputColumns);
+    reader.setNumColumns(_inputNumColumns);
+    reader.setDataset(_inputDataset.c_str());
+    reader.open(_pointsFilename.c_str(), _inputFormat, spaceDim);
 
-    std::ofstream sout(_outputFilename);
-    if (!sout.is_open() && !sout.good()) {
-        std::ostringstream msg;
-        msg << "Could not open output file '" << _outputFilename << "' for writing.";
-        throw std::runtime_error(msg.str().c_str());
-    } // if
-
-    sout << _createOutputHeader(argc, argv);
     const size_t numQueryValues = _valueNames.size();
-    std::vector<double> values(numQueryValues);
-    sout << std::scientific << std::setprecision(_Query::precision);
-    while (true) {
-        double srcX, srcY, srcZ;
-        sin >> srcX >> srcY >> srcZ;
-        if (sin.eof() || !sin.good()) {
-            break;
-        } // if
+    const size_t numColumns = spaceDim + numQueryValues;
+    std::vector<std::string> columnNames = { "x0", "x1", "x2" };
+    columnNames.insert(columnNames.end(), _valueNames.begin(), _valueNames.end());
 
-        query.query(&values[0], srcX, srcY, srcZ);
+    geomodelgrids::utils::PointsWriter writer;
+    writer.setHeader(_createOutputHeader(argc, argv));
+    writer.setColumnNames(columnNames);
+    writer.setTextFormat(_Query::cwidth, _Query::precision);
+    writer.setDataset(_outputDataset.c_str());
+    writer.open(_outputFilename.c_str(), _outputFormat, numColumns);
 
-        sout << std::setw(_Query::cwidth) << srcX
-             << std::setw(_Query::cwidth) << srcY
-             << std::setw(_Query::cwidth) << srcZ;
-        for (size_t i = 0; i < numQueryValues; ++i) {
-            sout << std::setw(_Query::cwidth) << values[i];
+    geomodelgrids::utils::PointsPipeline pipeline;
+    pipeline.setNumWorkers(_numThreads);
+    pipeline.run(&reader, spaceDim, &writer, numColumns,
+                 [&queries, spaceDim, numColumns](double* const rows,
+                                                  const double* const points,
+                                                  const size_t numPoints,
+                                                  const size_t offset,
+                                                  const size_t worker) {
+        geomodelgrids::serial::Query& query = *queries[worker];
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* xyz = &points[iPt*spaceDim];
+            double* row = &rows[iPt*numColumns];
+            row[0] = xyz[0];
+            row[1] = xyz[1];
+            row[2] = xyz[2];
+            query.query(&row[spaceDim], xyz[0], xyz[1], xyz[2]);
         } // for
-        sout << "\n";
-    } // while
+    });
+    writer.close();
+    reader.close();
 
-    query.finalize();
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        queries[iThread]->finalize();
+    } // for
 
     return 0;
 } // run
@@ -109,7 +131,7 @@ geomodelgrids::apps::Query::run(int argc,
 void
 geomodelgrids::apps::Query::_parseArgs(int argc,
                                        char* argv[]) {
-    static struct option options[10] = {
+    static struct option options[18] = {
         {"help", no_argument, nullptr, 'h'},
         {"values", required_argument, nullptr, 'v'},
         {"squash-min-elev", required_argument, nullptr, 's'},
@@ -119,12 +141,20 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
         {"output", required_argument, nullptr, 'o'},
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
+        {"input-format", required_argument, nullptr, 'i'},
+        {"input-columns", required_argument, nullptr, 'n'},
+        {"input-num-columns", required_argument, nullptr, 'N'},
+        {"input-dataset", required_argument, nullptr, 'd'},
+        {"output-format", required_argument, nullptr, 'f'},
+        {"output-dataset", required_argument, nullptr, 'D'},
+        {"num-threads", required_argument, nullptr, 't'},
+        {"target-resolution", required_argument, nullptr, 'T'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:s:r:p:c:o:l:m:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:s:r:p:c:o:l:m:i:n:N:d:f:D:t:T:", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -182,6 +212,43 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
             } // while
             break;
         } // 'm'
+        case 'i': {
+            _inputFormat = geomodelgrids::utils::PointsReader::parseFormat(optarg);
+            break;
+        } // 'i'
+        case 'n': {
+            _inputColumns.clear();
+            std::istringstream tokenStream(optarg);
+            std::string token;
+            while (std::getline(tokenStream, token, ',')) {
+                _inputColumns.push_back(std::stoul(token));
+            } // while
+            break;
+        } // 'n'
+        case 'N': {
+            _inputNumColumns = std::stoul(optarg);
+            break;
+        } // 'N'
+        case 'd': {
+            _inputDataset = optarg;
+            break;
+        } // 'd'
+        case 'f': {
+            _outputFormat = geomodelgrids::utils::PointsReader::parseFormat(optarg);
+            break;
+        } // 'f'
+        case 'D': {
+            _outputDataset = optarg;
+            break;
+        } // 'D'
+        case 't': {
+            _numThreads = std::stoul(optarg);
+            break;
+        } // 't'
+        case 'T': {
+            _targetResolution = std::stod(optarg);
+            break;
+        } // 'T'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -215,6 +282,10 @@ geomodelgrids::apps::Query::_parseArgs(int argc,
             msg << "    - Missing list of model filenames. Use --models=FILE_0,...,FILE_M\n";
             optionsOkay = false;
         } // if
+        if (!_numThreads) {
+            msg << "    - Number of threads must be positive. Use --num-threads=NUM_THREADS\n";
+            optionsOkay = false;
+        } // if
 
         if (!optionsOkay) {
             throw std::runtime_error(std::string("Missing required command line arguments:\n")+ msg.str());
@@ -230,7 +301,10 @@ geomodelgrids::apps::Query::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_query "
               << "[--help]  [--log=FILE_LOG] --values=VALUE_0,...,VALUE_N --models=FILE_0,...,FILE_M "
               << "--points=FILE_POINTS  --output=FILE_OUTPUT [--squash-min-elev=ELEV] "
-              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT]\n\n"
+              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT] "
+              << "[--input-format=FORMAT] [--input-columns=COL_X,COL_Y,COL_Z] [--input-num-columns=NUM_COLUMNS] "
+              << "[--input-dataset=DATASET] [--output-format=FORMAT] [--output-dataset=DATASET] "
+              << "[--num-threads=NUM_THREADS] [--target-resolution=RESOLUTION]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --values=VALUE_0,...,VALUE_N     Values (in order) to return in query.\n"
@@ -239,7 +313,15 @@ geomodelgrids::apps::Query::_printHelp(void) {
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
               << "    --squash-min-elev=ELEV           Top of the model is squashed/stretched to z=0 with the model below z=ELEV held fixed (default=-10.0e+3).\n"
               << "    --squash-surface=none|top_surface|topography_bathymetry    Surface reference for squashing/stretching (default=none).\n"
-              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326)."
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
+              << "    --input-format=FORMAT            Format of FILE_POINTS: text, raw64, raw32, npy, or hdf5 (default=text).\n"
+              << "    --input-columns=COL_X,COL_Y,COL_Z  Zero-based columns of FILE_POINTS with point coordinates (default=0,1,2).\n"
+              << "    --input-num-columns=NUM_COLUMNS  Number of columns in raw FILE_POINTS (default=last selected column + 1).\n"
+              << "    --input-dataset=DATASET          Dataset with points in hdf5 FILE_POINTS (default=/points).\n"
+              << "    --output-format=FORMAT           Format of FILE_OUTPUT: text, raw64, raw32, npy, or hdf5 (default=text).\n"
+              << "    --output-dataset=DATASET         Dataset for points and values in hdf5 FILE_OUTPUT (default=/values).\n"
+              << "    --num-threads=NUM_THREADS        Number of threads querying the models (default=1).\n"
+              << "    --target-resolution=RESOLUTION   Query coarsest stored levels of blocks with horizontal resolution at least as fine as RESOLUTION (default=full resolution)."
               << std::endl;
 } // _printHelp
 
@@ -4,6 +4,7 @@
 #include "appsfwd.hh" // forward declarations
 
 #include "geomodelgrids/serial/Query.hh" // HASA SquashingEnum
+#include "geomodelgrids/utils/PointsReader.hh" // HASA PointsReader::FormatEnum
 
 #include <vector> // HASA std::std::vector
 #include <string> // HASA std::string
@@ -33,6 +34,14 @@ public:
      *   --output=FILE_OUTPUT
      *   --log=FILE_LOG
      *   --points-coordsys=PROJ|EPSG|WKT
+     *   --input-format=text|raw64|raw32|npy|hdf5
+     *   --input-columns=COL_X,COL_Y,COL_Z
+     *   --input-num-columns=NUM_COLUMNS
+     *   --input-dataset=DATASET
+     *   --output-format=text|raw64|raw32|npy|hdf5
+     *   --output-dataset=DATASET
+     *   --num-threads=NUM_THREADS
+     *   --target-resolution=RESOLUTION
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -69,11 +78,19 @@ private:
 
     std::vector<std::string> _modelFilenames;
     std::vector<std::string> _valueNames;
+    std::vector<size_t> _inputColumns;
     std::string _pointsFilename;
     std::string _pointsCRS;
     std::string _outputFilename;
     std::string _logFilename;
+    std::string _inputDataset;
+    std::string _outputDataset;
+    size_t _inputNumColumns;
+    size_t _numThreads;
     double _squashMinElev;
+    double _targetResolution; ///< Target horizontal resolution for selecting levels (0 for full resolution).
+    geomodelgrids::utils::PointsReader::FormatEnum _inputFormat;
+    geomodelgrids::utils::PointsReader::FormatEnum _outputFormat;
     geomodelgrids::serial::Query::SquashingEnum _squash;
     bool _showHelp;
 
@@ -4,11 +4,14 @@
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
 #include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+#include "geomodelgrids/utils/PointsReader.hh" // USES PointsReader
+#include "geomodelgrids/utils/PointsWriter.hh" // USES PointsWriter
+#include "geomodelgrids/utils/PointsPipeline.hh" // USES PointsPipeline
 
 #include <getopt.h> // USES getopt_long()
 #include <iomanip>
-#include <fstream> // USES std::ifstream, std::ofstream
 #include <sstream> // USES std::ostringstream, std::istringstream
+#include <memory> // USES std::unique_ptr
 #include <cassert> // USES assert()
 #include <iostream> // USES std::cout
 
@@ -17,7 +20,7 @@ namespace geomodelgrids {
         namespace _QueryElev {
             static const int cwidth = 14;
             static const int precision = 6;
-        } // _Query
+        } // _QueryElev
     } // apps
 } // geomodelgrids
 // ------------------------------------------------------------------------------------------------
@@ -27,6 +30,7 @@ geomodelgrids::apps::QueryElev::QueryElev() :
     _pointsCRS("EPSG:4326"),
     _outputFilename(""),
     _logFilename(""),
+    _numThreads(1),
     _useTopoBathy(false),
     _showHelp(false) {}
 
@@ -48,47 +52,57 @@ geomodelgrids::apps::QueryElev::run(int argc,
         return 0;
     } // if
 
-    geomodelgrids::serial::Query query;
-    if (!_logFilename.empty()) {
-        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
-        errorHandler->setLogFilename(_logFilename.c_str());
-        errorHandler->setLoggingOn(true);
-    } // if
-    std::vector<std::string> valueNames;
-    query.initialize(_modelFilenames, valueNames, _pointsCRS);
-
-    std::ifstream sin(_pointsFilename);
-    if (!sin.is_open() && !sin.good()) {
-        std::ostringstream msg;
-        msg << "Could not open points file '" << _pointsFilename << "' for reading.";
-        throw std::runtime_error(msg.str().c_str());
-    } // if
-
-    std::ofstream sout(_outputFilename);
-    if (!sout.is_open() && !sout.good()) {
-        std::ostringstream msg;
-        msg << "Could not open output file '" << _outputFilename << "' for writing.";
-        throw std::runtime_error(msg.str().c_str());
-    } // if
-
-    sout << _createOutputHeader(argc, argv);
-    sout << std::scientific << std::setprecision(_QueryElev::precision);
-    while (true) {
-        double srcX, srcY;
-        sin >> srcX >> srcY;
-        if (sin.eof() || !sin.good()) {
-            break;
+    // Each worker thread uses its own query object.
+    std::vector<std::unique_ptr<geomodelgrids::serial::Query> > queries(_numThreads);
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        queries[iThread].reset(new geomodelgrids::serial::Query());
+        geomodelgrids::serial::Query& query = *queries[iThread];
+        if (!_logFilename.empty()) {
+            std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
+            errorHandler->setLogFilename(_logFilename.c_str());
+            errorHandler->setLoggingOn(true);
         } // if
+        std::vector<std::string> valueNames;
+        query.initialize(_modelFilenames, valueNames, _pointsCRS);
+    } // for
 
-        const double elev = (_useTopoBathy) ? query.queryTopoBathyElevation(srcX, srcY) : query.queryTopElevation(srcX, srcY);
-
-        sout << std::setw(_QueryElev::cwidth) << srcX
-             << std::setw(_QueryElev::cwidth) << srcY
-             << std::setw(_QueryElev::cwidth) << elev
-             << "\n";
-    } // while
-
-    query.finalize();
+    const size_t spaceDim = 2;
+    geomodelgrids::utils::PointsReader reader;
+    reader.open(_pointsFilename.c_str(), geomodelgrids::utils::PointsReader::TEXT, spaceDim);
+
+    const size_t numColumns = spaceDim + 1;
+    geomodelgrids::utils::PointsWriter writer;
+    writer.setHeader(_createOutputHeader(argc, argv));
+    writer.setTextFormat(_QueryElev::cwidth, _QueryElev::precision);
+    writer.open(_outputFilename.c_str(), geomodelgrids::utils::PointsReader::TEXT, numColumns);
+
+    const bool useTopoBathy = _useTopoBathy;
+    geomodelgrids::utils::PointsPipeline pipeline;
+    pipeline.setNumWorkers(_numThreads);
+    pipeline.run(&reader, spaceDim, &writer, numColumns,
+                 [&queries, spaceDim, numColumns, useTopoBathy](double* const rows,
+                                                                const double* const points,
+                                                                const size_t numPoints,
+                                                                const size_t offset,
+                                                                const size_t worker) {
+        geomodelgrids::serial::Query& query = *queries[worker];
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double srcX = points[iPt*spaceDim+0];
+            const double srcY = points[iPt*spaceDim+1];
+            const double elev = (useTopoBathy) ? query.queryTopoBathyElevation(srcX, srcY) : query.queryTopElevation(srcX, srcY);
+
+            double* row = &rows[iPt*numColumns];
+            row[0] = srcX;
+            row[1] = srcY;
+            row[2] = elev;
+        } // for
+    });
+    writer.close();
+    reader.close();
+
+    for (size_t iThread = 0; iThread < _numThreads; ++iThread) {
+        queries[iThread]->finalize();
+    } // for
 
     return 0;
 } // run
@@ -107,12 +121,13 @@ geomodelgrids::apps::QueryElev::_parseArgs(int argc,
         {"log", required_argument, nullptr, 'l'},
         {"models", required_argument, nullptr, 'm'},
         {"surface", required_argument, nullptr, 's'},
+        {"num-threads", required_argument, nullptr, 't'},
         {0, 0, 0, 0}
     };
 
     while (true) {
         // extern char* optarg;
-        const char c = getopt_long(argc, argv, "hv:s:p:c:o:l:m:s:", options, nullptr);
+        const char c = getopt_long(argc, argv, "hv:s:p:c:o:l:m:s:t:", options, nullptr);
         if (-1 == c) { break; }
         switch (c) {
         case 'h':
@@ -151,6 +166,10 @@ geomodelgrids::apps::QueryElev::_parseArgs(int argc,
             } // if
             break;
         } // 'm'
+        case 't': {
+            _numThreads = std::stoul(optarg);
+            break;
+        } // 't'
         case '?': {
             std::ostringstream msg;
             msg << "Error parsing command line arguments:\n";
@@ -180,6 +199,10 @@ geomodelgrids::apps::QueryElev::_parseArgs(int argc,
             msg << "    - Missing list of model filenames. Use --models=FILE_0,...,FILE_M\n";
             optionsOkay = false;
         } // if
+        if (!_numThreads) {
+            msg << "    - Number of threads must be positive. Use --num-threads=NUM_THREADS\n";
+            optionsOkay = false;
+        } // if
 
         if (!optionsOkay) {
             throw std::runtime_error(std::string("Missing required command line arguments:\n")+ msg.str());
@@ -194,14 +217,16 @@ void
 geomodelgrids::apps::QueryElev::_printHelp(void) {
     std::cout << "Usage: geomodelgrids_queryelev "
               << "[--help] [--log=FILE_LOG] --models=FILE_0,...,FILE_M --points=FILE_POINTS --output=FILE_OUTPUT "
-              << "[--points-coordsys=PROJ|EPSG|WKT] [--surface=top_surface|topography_bathymetry]\n\n"
+              << "[--points-coordsys=PROJ|EPSG|WKT] [--surface=top_surface|topography_bathymetry] "
+              << "[--num-threads=NUM_THREADS]\n\n"
               << "    --help                           Print help information to stdout and exit.\n"
               << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
               << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
               << "    --points=FILE_POINTS             Read input points from FILE_POINTS.\n"
               << "    --output=FILE_OUTPUT             Write values to FILE_OUTPUT.\n"
               << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326).\n"
-              << "    --surface=top_surface|topography_bathymetry  Surface elevation to query (default=top_surface)."
+              << "    --surface=top_surface|topography_bathymetry  Surface elevation to query (default=top_surface).\n"
+              << "    --num-threads=NUM_THREADS        Number of threads querying the models (default=1)."
               << std::endl;
 } // _printHelp
 
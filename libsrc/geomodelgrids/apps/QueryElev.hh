@@ -29,6 +29,7 @@ public:
      *   --log=FILE_LOG
      *   --points-coordsys=PROJ|EPSG|WKT
      *   --surface=SURFACE ["top_surface" (default) | "topography_bathymetry"]
+     *   --num-threads=NUM_THREADS
      *
      * @param argc[in] Number of arguments passed.
      * @param argv[in] Array of input arguments.
@@ -68,6 +69,7 @@ private:
     std::string _pointsCRS;
     std::string _outputFilename;
     std::string _logFilename;
+    size_t _numThreads;
     bool _useTopoBathy;
     bool _showHelp;
 
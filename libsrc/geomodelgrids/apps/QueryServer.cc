@@ -0,0 +1,636 @@
+#include <portinfo>
+
+#include "QueryServer.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Query.hh" // USES Query
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+extern "C" {
+#include "geomodelgrids/serial/queryprotocol.h" // USES GeomodelgridsQuerydRequest, GeomodelgridsQuerydResponse
+}
+
+#include <getopt.h> // USES getopt_long()
+#include <sys/socket.h> // USES socket(), bind(), listen(), accept(), recv(), setsockopt()
+#include <sys/stat.h> // USES lstat(), umask()
+#include <sys/time.h> // USES timeval
+#include <sys/un.h> // USES sockaddr_un
+#include <poll.h> // USES poll()
+#include <signal.h> // USES sigaction()
+#include <unistd.h> // USES close(), unlink()
+#include <cstring> // USES memset(), memcpy(), strncpy()
+#include <sstream> // USES std::ostringstream, std::istringstream
+#include <cassert> // USES assert()
+#include <iostream> // USES std::cout
+#include <algorithm> // USES std::max()
+#include <cmath> // USES floor()
+#include <stdexcept> // USES std::exception
+#include <chrono> // USES std::chrono::steady_clock
+#include <cerrno> // USES errno
+
+/// State of a client connection, holding a partially received request.
+struct geomodelgrids::apps::_QueryServerConnection {
+    int fd; ///< Socket for connection.
+    GeomodelgridsQuerydRequest request; ///< Header of current request.
+    size_t headerSize; ///< Number of bytes of header received.
+    std::vector<double> points; ///< Points in current request.
+    size_t pointsSize; ///< Number of bytes of points received.
+    std::chrono::steady_clock::time_point start; ///< Time when first byte of current request was received.
+};
+
+namespace geomodelgrids {
+    namespace apps {
+        namespace _QueryServer {
+            static volatile sig_atomic_t shutdownRequested = 0;
+
+            /// Time (ms) allowed for receiving a request after its first byte and for sending each
+            /// part of a response.
+            static const int requestTimeout = 10000;
+
+            /** Signal handler for SIGINT and SIGTERM.
+             *
+             * @param[in] signum Signal number.
+             */
+            static
+            void
+            handleSignal(int signum) {
+                shutdownRequested = 1;
+            } // handleSignal
+
+            /** Get dimension of points in request payload.
+             *
+             * @param[in] type Type of request.
+             * @returns Number of coordinates for each point, 0 if request does not carry points.
+             */
+            static
+            size_t
+            getSpaceDim(const int type) {
+                switch (type) {
+                case GEOMODELGRIDS_QUERYD_QUERY:
+                    return 3;
+                case GEOMODELGRIDS_QUERYD_TOP_ELEVATION:
+                case GEOMODELGRIDS_QUERYD_TOPOBATHY_ELEVATION:
+                case GEOMODELGRIDS_QUERYD_PROFILE:
+                    return 2;
+                default:
+                    return 0;
+                } // switch
+            } // getSpaceDim
+
+            /** Receive available bytes without blocking.
+             *
+             * @param[in] fd Socket.
+             * @param[out] buffer Buffer for data.
+             * @param[in] numBytes Maximum number of bytes to receive.
+             * @param[inout] numReceived Number of bytes received (incremented).
+             * @returns True if connection is still usable, false if it was closed or had an error.
+             */
+            static
+            bool
+            receiveAvailable(const int fd,
+                             void* buffer,
+                             const size_t numBytes,
+                             size_t* numReceived) {
+                assert(numReceived);
+                const ssize_t n = recv(fd, buffer, numBytes, MSG_DONTWAIT);
+                if (n < 0) {
+                    return (EINTR == errno) || (EAGAIN == errno) || (EWOULDBLOCK == errno);
+                } else if (0 == n) {
+                    return false; // Client closed connection.
+                } // if/else
+                *numReceived += size_t(n);
+                return true;
+            } // receiveAvailable
+
+        } // _QueryServer
+    } // apps
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::apps::QueryServer::QueryServer() :
+    _socketPath(""),
+    _pointsCRS("EPSG:4326"),
+    _logFilename(""),
+    _squashMinElev(-10.0e+3),
+    _squash(geomodelgrids::serial::Query::SQUASH_NONE),
+    _socket(-1),
+    _showHelp(false) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::apps::QueryServer::~QueryServer(void) {
+    _closeSocket();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Run query server application.
+int
+geomodelgrids::apps::QueryServer::run(int argc,
+                                      char* argv[]) {
+    _parseArgs(argc, argv);
+
+    if (_showHelp) {
+        _printHelp();
+        return 0;
+    } // if
+
+    geomodelgrids::serial::Query query;
+    if (!_logFilename.empty()) {
+        std::shared_ptr<geomodelgrids::utils::ErrorHandler>& errorHandler = query.getErrorHandler();
+        errorHandler->setLogFilename(_logFilename.c_str());
+        errorHandler->setLoggingOn(true);
+    } // if
+    query.initialize(_modelFilenames, _valueNames, _pointsCRS);
+    if (geomodelgrids::serial::Query::SQUASH_NONE != _squash) {
+        query.setSquashing(_squash);
+        query.setSquashMinElev(_squashMinElev);
+    } // if
+
+    _openSocket();
+    _serve(&query);
+    _closeSocket();
+
+    query.finalize();
+
+    return 0;
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse command line arguments.
+void
+geomodelgrids::apps::QueryServer::_parseArgs(int argc,
+                                             char* argv[]) {
+    static struct option options[9] = {
+        {"help", no_argument, nullptr, 'h'},
+        {"socket", required_argument, nullptr, 'k'},
+        {"values", required_argument, nullptr, 'v'},
+        {"squash-min-elev", required_argument, nullptr, 's'},
+        {"squash-surface", required_argument, nullptr, 'r'},
+        {"points-coordsys", required_argument, nullptr, 'c'},
+        {"log", required_argument, nullptr, 'l'},
+        {"models", required_argument, nullptr, 'm'},
+        {0, 0, 0, 0}
+    };
+
+    while (true) {
+        // extern char* optarg;
+        const char c = getopt_long(argc, argv, "hk:v:s:r:c:l:m:", options, nullptr);
+        if (-1 == c) { break; }
+        switch (c) {
+        case 'h':
+            _showHelp = true;
+            break;
+        case 'k': {
+            _socketPath = optarg;
+            break;
+        } // 'k'
+        case 'v': {
+            _valueNames.clear();
+            std::istringstream tokenStream(optarg);
+            std::string token;
+            while (std::getline(tokenStream, token, ',')) {
+                _valueNames.push_back(token);
+            } // while
+            break;
+        } // 'v'
+        case 's': {
+            if (geomodelgrids::serial::Query::SQUASH_NONE == _squash) {
+                _squash = geomodelgrids::serial::Query::SQUASH_TOP_SURFACE;
+            } // if
+            _squashMinElev = std::stod(optarg);
+            break;
+        } // 's'
+        case 'r': {
+            const std::string& surface = optarg;
+            if (std::string("top_surface") == surface) {
+                _squash = geomodelgrids::serial::Query::SQUASH_TOP_SURFACE;
+            } else if (std::string("topography_bathymetry") == surface) {
+                _squash = geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY;
+            } else {
+                _squash = geomodelgrids::serial::Query::SQUASH_NONE;
+            }
+            break;
+        } // 'r'
+        case 'c': {
+            _pointsCRS = optarg;
+            break;
+        } // 'c'
+        case 'l': {
+            _logFilename = optarg;
+            break;
+        } // 'l'
+        case 'm': {
+            _modelFilenames.clear();
+            std::istringstream tokenStream(optarg);
+            std::string token;
+            while (std::getline(tokenStream, token, ',')) {
+                _modelFilenames.push_back(token);
+            } // while
+            break;
+        } // 'm'
+        case '?': {
+            std::ostringstream msg;
+            msg << "Error parsing command line arguments:\n";
+            for (int i = 0; i < argc; ++i) {
+                msg << argv[i] << " ";
+            } // for
+            throw std::logic_error(msg.str().c_str());
+        } // ?
+        } // switch
+    } // while
+
+    if (1 == argc) {
+        _showHelp = true;
+    } // if
+    if (!_showHelp) { // Verify required arguments were provided.
+        bool optionsOkay = true;
+        std::ostringstream msg;
+        if (_socketPath.empty()) {
+            msg << "    - Missing path for socket. Use --socket=FILE_SOCKET\n";
+            optionsOkay = false;
+        } // if
+        if (_valueNames.empty()) {
+            msg << "    - Missing names of values to return in queries. Use --values=VALUE_0,...,VALUE_N\n";
+            optionsOkay = false;
+        } // if
+        if (_modelFilenames.empty()) {
+            msg << "    - Missing list of model filenames. Use --models=FILE_0,...,FILE_M\n";
+            optionsOkay = false;
+        } // if
+
+        if (!optionsOkay) {
+            throw std::runtime_error(std::string("Missing required command line arguments:\n")+ msg.str());
+        } // if
+    } // if
+} // _parseArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Print help information.
+void
+geomodelgrids::apps::QueryServer::_printHelp(void) {
+    std::cout << "Usage: geomodelgrids_queryd "
+              << "[--help] [--log=FILE_LOG] --socket=FILE_SOCKET --values=VALUE_0,...,VALUE_N "
+              << "--models=FILE_0,...,FILE_M [--squash-min-elev=ELEV] "
+              << "[--squash-surface=none|top_surface|topography_bathymetry] [--points-coordsys=PROJ|EPSG|WKT]\n\n"
+              << "    --help                           Print help information to stdout and exit.\n"
+              << "    --log=FILE_LOG                   Write logging information to FILE_LOG.\n"
+              << "    --socket=FILE_SOCKET             Listen for clients on Unix domain socket FILE_SOCKET.\n"
+              << "    --values=VALUE_0,...,VALUE_N     Values (in order) to return in queries.\n"
+              << "    --models=FILE_0,...,FILE_M       Models to query (in order).\n"
+              << "    --squash-min-elev=ELEV           Top of the model is squashed/stretched to z=0 with the model below z=ELEV held fixed (default=-10.0e+3).\n"
+              << "    --squash-surface=none|top_surface|topography_bathymetry    Surface reference for squashing/stretching (default=none).\n"
+              << "    --points-coordsys=PROJ|EPSG|WKT  Coordinate system of input points (default=EPSG:4326)."
+              << std::endl;
+} // _printHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Create socket and listen for connections.
+void
+geomodelgrids::apps::QueryServer::_openSocket(void) {
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (_socketPath.length() >= sizeof(address.sun_path)) {
+        std::ostringstream msg;
+        msg << "Path of socket '" << _socketPath << "' is too long.";
+        throw std::length_error(msg.str());
+    } // if
+    strncpy(address.sun_path, _socketPath.c_str(), sizeof(address.sun_path)-1);
+
+    // Remove stale socket file, but never another kind of file given by mistake.
+    struct stat socketStat;
+    if (0 == lstat(_socketPath.c_str(), &socketStat)) {
+        if (!S_ISSOCK(socketStat.st_mode)) {
+            std::ostringstream msg;
+            msg << "File '" << _socketPath << "' exists and is not a socket.";
+            throw std::runtime_error(msg.str());
+        } // if
+        unlink(_socketPath.c_str());
+    } // if
+
+    _socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_socket < 0) {
+        throw std::runtime_error("Could not create socket for query server.");
+    } // if
+    // Only the user running the server may connect (socket file has mode 0600).
+    const mode_t umaskOrig = umask(S_IRWXG | S_IRWXO);
+    const int bindErr = bind(_socket, (struct sockaddr*) &address, sizeof(address));
+    umask(umaskOrig);
+    if (( bindErr != 0) || ( listen(_socket, SOMAXCONN) != 0) ) {
+        ::close(_socket);_socket = -1;
+        std::ostringstream msg;
+        msg << "Could not listen for clients on socket '" << _socketPath << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+} // _openSocket
+
+
+// ------------------------------------------------------------------------------------------------
+// Close socket and remove socket file.
+void
+geomodelgrids::apps::QueryServer::_closeSocket(void) {
+    if (_socket >= 0) {
+        ::close(_socket);
+        unlink(_socketPath.c_str());
+    } // if
+    _socket = -1;
+} // _closeSocket
+
+
+// ------------------------------------------------------------------------------------------------
+// Accept connections and answer requests until shutdown.
+void
+geomodelgrids::apps::QueryServer::_serve(geomodelgrids::serial::Query* query) {
+    assert(query);
+    assert(_socket >= 0);
+
+    // Interrupt blocking calls (no SA_RESTART) so that we can shut down cleanly.
+    struct sigaction action, actionINT, actionTERM;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = _QueryServer::handleSignal;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, &actionINT);
+    sigaction(SIGTERM, &action, &actionTERM);
+
+    // Poll the listening socket and all connections, so that idle clients never block others.
+    std::vector<_QueryServerConnection> connections;
+    std::vector<struct pollfd> pfds;
+    _QueryServer::shutdownRequested = 0;
+    while (!_QueryServer::shutdownRequested) {
+        const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        int timeout = -1;
+        pfds.resize(1 + connections.size());
+        pfds[0].fd = _socket;
+        pfds[0].events = POLLIN;
+        pfds[0].revents = 0;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            pfds[1+i].fd = connections[i].fd;
+            pfds[1+i].events = POLLIN;
+            pfds[1+i].revents = 0;
+            if (connections[i].headerSize > 0) {
+                const int elapsed = int(std::chrono::duration_cast<std::chrono::milliseconds>(now - connections[i].start).count());
+                const int remaining = std::max(0, _QueryServer::requestTimeout - elapsed);
+                timeout = (timeout < 0) ? remaining : std::min(timeout, remaining);
+            } // if
+        } // for
+        if (poll(pfds.data(), pfds.size(), timeout) < 0) {
+            continue; // Interrupted; check for shutdown.
+        } // if
+
+        // Answer requests, and close connections that had errors or partial requests that timed out.
+        std::vector<_QueryServerConnection> connectionsOpen;
+        for (size_t i = 0; i < connections.size(); ++i) {
+            _QueryServerConnection& connection = connections[i];
+            bool keepOpen = true;
+            if (pfds[1+i].revents && !_QueryServer::shutdownRequested) {
+                keepOpen = _receive(query, &connection);
+            } // if
+            if (keepOpen && ( connection.headerSize > 0) &&
+                ( std::chrono::steady_clock::now() - connection.start > std::chrono::milliseconds(_QueryServer::requestTimeout)) ) {
+                keepOpen = false;
+            } // if
+            if (keepOpen) {
+                connectionsOpen.push_back(std::move(connection));
+            } else {
+                ::close(connection.fd);
+            } // if/else
+        } // for
+        connections.swap(connectionsOpen);
+
+        if (pfds[0].revents & POLLIN) {
+            const int fd = accept(_socket, nullptr, nullptr);
+            if (fd >= 0) {
+                // Do not let a client that stops reading responses block the server.
+                struct timeval sendTimeout;
+                sendTimeout.tv_sec = _QueryServer::requestTimeout / 1000;
+                sendTimeout.tv_usec = 1000 * (_QueryServer::requestTimeout % 1000);
+                setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+                _QueryServerConnection connection;
+                connection.fd = fd;
+                connection.headerSize = 0;
+                connection.pointsSize = 0;
+                connections.push_back(std::move(connection));
+            } // if
+        } // if
+    } // while
+
+    for (size_t i = 0; i < connections.size(); ++i) {
+        ::close(connections[i].fd);
+    } // for
+
+    sigaction(SIGINT, &actionINT, nullptr);
+    sigaction(SIGTERM, &actionTERM, nullptr);
+} // _serve
+
+
+// ------------------------------------------------------------------------------------------------
+// Receive available data on a connection and answer the request once it is complete.
+bool
+geomodelgrids::apps::QueryServer::_receive(geomodelgrids::serial::Query* query,
+                                           _QueryServerConnection* connection) {
+    assert(query);
+    assert(connection);
+
+    GeomodelgridsQuerydRequest& request = connection->request;
+    if (connection->headerSize < sizeof(request)) {
+        const size_t headerSize = connection->headerSize;
+        if (!_QueryServer::receiveAvailable(connection->fd, (char*) &request + headerSize, sizeof(request) - headerSize,
+                                            &connection->headerSize)) {
+            return false;
+        } // if
+        if (( 0 == headerSize) && ( connection->headerSize > 0) ) {
+            connection->start = std::chrono::steady_clock::now();
+        } // if
+        if (connection->headerSize < sizeof(request)) {
+            return true; // Wait for rest of header.
+        } // if
+
+        if (request.magic != GEOMODELGRIDS_QUERYD_MAGIC) {
+            return false; // Not a geomodelgrids_queryd client.
+        } // if
+        if (request.numPoints > GEOMODELGRIDS_QUERYD_MAX_POINTS) {
+            std::ostringstream msg;
+            msg << "Number of points in request (" << request.numPoints << ") exceeds maximum ("
+                << GEOMODELGRIDS_QUERYD_MAX_POINTS << ").";
+            _respond(connection->fd, GEOMODELGRIDS_QUERYD_ERROR, 0, 0, msg.str().c_str(), msg.str().length());
+            return false; // Cannot resynchronize without reading the points.
+        } // if
+        const size_t spaceDim = _QueryServer::getSpaceDim(request.type);
+        if (( request.numPoints > 0) && ( 0 == spaceDim) ) {
+            std::ostringstream msg;
+            msg << "Request type (" << request.type << ") does not take points, but request has "
+                << request.numPoints << " points.";
+            _respond(connection->fd, GEOMODELGRIDS_QUERYD_ERROR, 0, 0, msg.str().c_str(), msg.str().length());
+            return false; // Cannot resynchronize without reading the points.
+        } // if
+        connection->points.resize(request.numPoints*spaceDim);
+        connection->pointsSize = 0;
+    } // if
+
+    const size_t pointsSize = connection->points.size()*sizeof(double);
+    if (connection->pointsSize < pointsSize) {
+        if (!_QueryServer::receiveAvailable(connection->fd, (char*) connection->points.data() + connection->pointsSize,
+                                            pointsSize - connection->pointsSize, &connection->pointsSize)) {
+            return false;
+        } // if
+        if (connection->pointsSize < pointsSize) {
+            return true; // Wait for rest of points.
+        } // if
+    } // if
+
+    connection->headerSize = 0; // Request is complete; next byte starts a new request.
+    try {
+        return _answer(query, connection->fd, request.type, request.numPoints, connection->points.data(),
+                       request.dz, request.maxDepth);
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error answering request: " << err.what();
+        _respond(connection->fd, GEOMODELGRIDS_QUERYD_ERROR, 0, 0, msg.str().c_str(), msg.str().length());
+        return false;
+    } // try/catch
+} // _receive
+
+
+// ------------------------------------------------------------------------------------------------
+// Answer a single request.
+bool
+geomodelgrids::apps::QueryServer::_answer(geomodelgrids::serial::Query* query,
+                                          const int connection,
+                                          const int type,
+                                          const size_t numPoints,
+                                          const double* points,
+                                          const double dz,
+                                          const double maxDepth) {
+    assert(query);
+    assert(!numPoints || points);
+
+    const size_t numValues = _valueNames.size();
+    const size_t spaceDim = _QueryServer::getSpaceDim(type);
+
+    switch (type) {
+    case GEOMODELGRIDS_QUERYD_INFO: {
+        _payload.clear();
+        for (size_t i = 0; i < numValues; ++i) {
+            _payload.insert(_payload.end(), _valueNames[i].begin(), _valueNames[i].end());
+            _payload.push_back('\0');
+        } // for
+        return _respond(connection, GEOMODELGRIDS_QUERYD_OK, 0, numValues, _payload.data(), _payload.size());
+    } // INFO
+    case GEOMODELGRIDS_QUERYD_QUERY: {
+        const size_t valuesSize = numPoints*numValues*sizeof(double);
+        _payload.resize(valuesSize + numPoints*sizeof(int32_t));
+        double* values = (double*) _payload.data();
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* xyz = &points[iPt*spaceDim];
+            const int32_t error = query->query(&values[iPt*numValues], xyz[0], xyz[1], xyz[2]);
+            memcpy(&_payload[valuesSize + iPt*sizeof(int32_t)], &error, sizeof(int32_t));
+        } // for
+        return _respond(connection, GEOMODELGRIDS_QUERYD_OK, numPoints, numValues, _payload.data(), _payload.size());
+    } // QUERY
+    case GEOMODELGRIDS_QUERYD_TOP_ELEVATION:
+    case GEOMODELGRIDS_QUERYD_TOPOBATHY_ELEVATION: {
+        _payload.resize(numPoints*sizeof(double));
+        double* elevations = (double*) _payload.data();
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double* xy = &points[iPt*spaceDim];
+            elevations[iPt] = (GEOMODELGRIDS_QUERYD_TOP_ELEVATION == type) ?
+                              query->queryTopElevation(xy[0], xy[1]) :
+                              query->queryTopoBathyElevation(xy[0], xy[1]);
+        } // for
+        return _respond(connection, GEOMODELGRIDS_QUERYD_OK, numPoints, 1, _payload.data(), _payload.size());
+    } // TOP_ELEVATION/TOPOBATHY_ELEVATION
+    case GEOMODELGRIDS_QUERYD_PROFILE: {
+        if (!(dz > 0.0) || !(maxDepth >= 0.0)) {
+            const std::string msg = "Profile requests require dz > 0 and maxDepth >= 0.";
+            return _respond(connection, GEOMODELGRIDS_QUERYD_ERROR, 0, 0, msg.c_str(), msg.length());
+        } // if
+        // Check number of depths as a double before converting it, because dz and maxDepth come from the client.
+        const double numDepthsValue = floor(1.0 + maxDepth / dz);
+        const double numDepthsMax = double(GEOMODELGRIDS_QUERYD_MAX_POINTS / std::max(numPoints, size_t(1)));
+        if (!(numDepthsValue <= numDepthsMax)) {
+            std::ostringstream msg;
+            msg << "Number of profile samples in request (" << numPoints << " locations with " << numDepthsValue
+                << " depths) exceeds maximum (" << GEOMODELGRIDS_QUERYD_MAX_POINTS << ").";
+            return _respond(connection, GEOMODELGRIDS_QUERYD_ERROR, 0, 0, msg.str().c_str(), msg.str().length());
+        } // if
+        const size_t numDepths = size_t(numDepthsValue);
+        const size_t numSamples = numPoints * numDepths;
+
+        const size_t sampleSize = 2 + numValues;
+        const size_t samplesSize = numSamples*sampleSize*sizeof(double);
+        _payload.resize(samplesSize + numSamples*sizeof(int32_t));
+        double* samples = (double*) _payload.data();
+        const double groundOffset = -1.0e-6;
+        for (size_t iLoc = 0; iLoc < numPoints; ++iLoc) {
+            const double* xy = &points[iLoc*spaceDim];
+            double groundSurf = query->queryTopElevation(xy[0], xy[1]);
+            const bool outside = (groundSurf == geomodelgrids::NODATA_VALUE);
+            if (!outside && (groundSurf != 0.0)) {
+                groundSurf += groundOffset;
+            } // if
+            for (size_t iDepth = 0; iDepth < numDepths; ++iDepth) {
+                const size_t iSample = iLoc*numDepths + iDepth;
+                double* sample = &samples[iSample*sampleSize];
+                int32_t error = 1;
+                if (!outside) {
+                    sample[0] = groundSurf - dz*iDepth;
+                    sample[1] = groundSurf - sample[0];
+                    error = query->query(&sample[2], xy[0], xy[1], sample[0]);
+                } else {
+                    for (size_t i = 0; i < sampleSize; ++i) {
+                        sample[i] = geomodelgrids::NODATA_VALUE;
+                    } // for
+                } // if/else
+                memcpy(&_payload[samplesSize + iSample*sizeof(int32_t)], &error, sizeof(int32_t));
+            } // for
+        } // for
+        return _respond(connection, GEOMODELGRIDS_QUERYD_OK, numSamples, numValues, _payload.data(), _payload.size());
+    } // PROFILE
+    case GEOMODELGRIDS_QUERYD_SHUTDOWN: {
+        _QueryServer::shutdownRequested = 1;
+        return _respond(connection, GEOMODELGRIDS_QUERYD_OK, 0, 0, nullptr, 0);
+    } // SHUTDOWN
+    default: {
+        std::ostringstream msg;
+        msg << "Unknown request type (" << type << ").";
+        return _respond(connection, GEOMODELGRIDS_QUERYD_ERROR, 0, 0, msg.str().c_str(), msg.str().length());
+    } // default
+    } // switch
+} // _answer
+
+
+// ------------------------------------------------------------------------------------------------
+// Send response to client.
+bool
+geomodelgrids::apps::QueryServer::_respond(const int connection,
+                                           const int status,
+                                           const size_t numPoints,
+                                           const size_t numValues,
+                                           const void* payload,
+                                           const size_t payloadSize) {
+    GeomodelgridsQuerydResponse response;
+    memset(&response, 0, sizeof(response));
+    response.magic = GEOMODELGRIDS_QUERYD_MAGIC;
+    response.status = status;
+    response.numPoints = numPoints;
+    response.numValues = numValues;
+    response.payloadSize = payloadSize;
+    if (geomodelgrids_queryd_send(connection, &response, sizeof(response)) != 0) {
+        return false;
+    } // if
+    if (( payloadSize > 0) && ( geomodelgrids_queryd_send(connection, payload, payloadSize) != 0) ) {
+        return false;
+    } // if
+
+    return true;
+} // _respond
+
+
+// End of file
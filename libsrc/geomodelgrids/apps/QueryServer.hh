@@ -0,0 +1,153 @@
+/// C++ application to serve queries of models to local clients over a Unix domain socket.
+#pragma once
+
+#include "appsfwd.hh" // forward declarations
+
+#include "geomodelgrids/serial/Query.hh" // HASA SquashingEnum
+
+#include <vector> // HASA std::std::vector
+#include <string> // HASA std::string
+
+// Forward declarations of helper classes.
+namespace geomodelgrids {
+    namespace apps {
+        struct _QueryServerConnection;
+    } // apps
+} // geomodelgrids
+
+class geomodelgrids::apps::QueryServer {
+    friend class TestQueryServer; // unit testing
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Constructor
+    QueryServer(void);
+
+    /// Destructor
+    ~QueryServer(void);
+
+    /**
+     * Run query server application.
+     *
+     * The models are opened once and kept open (with their caches) until the server receives a
+     * shutdown request, SIGINT, or SIGTERM. Clients use the protocol in
+     * geomodelgrids/serial/queryprotocol.h.
+     *
+     * The server polls all client connections and answers each request once it has been received
+     * completely, so idle clients do not block other clients. Connections with requests that are
+     * not completed within the request timeout are closed. The socket file is accessible only by
+     * the user running the server.
+     *
+     * Arguments:
+     *   --help
+     *   --socket=FILE_SOCKET
+     *   --values=VALUE_0,...,VALUE_N
+     *   --squash-min-elev=ELEV
+     *   --squash-surface=top_surface|topography_bathymetry
+     *   --models=FILE_0,...,FILE_M
+     *   --log=FILE_LOG
+     *   --points-coordsys=PROJ|EPSG|WKT
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     *
+     * @returns 1 if errors were detected, 0 otherwise.
+     */
+    int run(int argc,
+            char* argv[]);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Parse command line arguments.
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     */
+    void _parseArgs(int argc,
+                    char* argv[]);
+
+    /// Print help information.
+    void _printHelp(void);
+
+    /// Create socket and listen for connections.
+    void _openSocket(void);
+
+    /// Close socket and remove socket file.
+    void _closeSocket(void);
+
+    /** Accept connections and answer requests until shutdown.
+     *
+     * @param query[in] Query object with models opened.
+     */
+    void _serve(geomodelgrids::serial::Query* query);
+
+    /** Receive available data on a connection and answer the request once it is complete.
+     *
+     * @param query[in] Query object with models opened.
+     * @param connection[inout] State of connection.
+     * @returns True if connection should remain open, false if it should be closed.
+     */
+    bool _receive(geomodelgrids::serial::Query* query,
+                  _QueryServerConnection* connection);
+
+    /** Answer a single request.
+     *
+     * @param query[in] Query object with models opened.
+     * @param connection[in] Socket for connection.
+     * @param type[in] Type of request.
+     * @param numPoints[in] Number of points in request.
+     * @param points[in] Points in request.
+     * @param dz[in] Vertical resolution for profiles.
+     * @param maxDepth[in] Maximum depth for profiles.
+     * @returns True if response was sent, false if there was a communication error.
+     */
+    bool _answer(geomodelgrids::serial::Query* query,
+                 const int connection,
+                 const int type,
+                 const size_t numPoints,
+                 const double* points,
+                 const double dz,
+                 const double maxDepth);
+
+    /** Send response to client.
+     *
+     * @param connection[in] Socket for connection.
+     * @param status[in] Status of response.
+     * @param numPoints[in] Number of points in response.
+     * @param numValues[in] Number of values at each point.
+     * @param payload[in] Response payload.
+     * @param payloadSize[in] Size of response payload in bytes.
+     * @returns True if response was sent, false otherwise.
+     */
+    bool _respond(const int connection,
+                  const int status,
+                  const size_t numPoints,
+                  const size_t numValues,
+                  const void* payload,
+                  const size_t payloadSize);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    std::vector<std::string> _modelFilenames;
+    std::vector<std::string> _valueNames;
+    std::vector<char> _payload; ///< Payload for current response.
+    std::string _socketPath;
+    std::string _pointsCRS;
+    std::string _logFilename;
+    double _squashMinElev;
+    geomodelgrids::serial::Query::SquashingEnum _squash;
+    int _socket;
+    bool _showHelp;
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    QueryServer(const QueryServer&); ///< Not implemented
+    const QueryServer& operator=(const QueryServer&); ///< Not implemented
+
+}; // QueryServer
+
+// End of file
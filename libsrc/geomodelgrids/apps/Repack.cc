@@ -0,0 +1,463 @@
+#include <portinfo>
+
+#include "Repack.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/HDF5Copier.hh" // USES HDF5Copier
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+#include <getopt.h> // USES getopt_long()
+#include <sys/stat.h> // USES stat()
+#include <iostream> // USES std::cout
+#include <vector> // USES std::vector
+#include <random> // USES std::mt19937, std::uniform_real_distribution
+#include <chrono> // USES std::chrono
+#include <algorithm> // USES std::min(), std::max()
+#include <cmath> // USES M_PI, cos(), sin(), sqrt()
+#include <memory> // USES std::unique_ptr
+#include <cassert> // USES assert()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream, std::istringstream
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace apps {
+        namespace _Repack {
+            typedef geomodelgrids::serial::HDF5Copier::Handle Handle;
+
+            /** Rewrite dataset with new chunking, filters, and value datatype.
+             *
+             * The values are copied one chunk column (all points along the z axis and all values) at
+             * a time, so each chunk of the new dataset is written once.
+             *
+             * @param[inout] copier Copier for model file.
+             * @param[in] path Path of dataset.
+             * @param[in] chunk Chunk dimensions along x, y, and z axes (0 keeps chunking of dataset).
+             * @param[in] filter Filter pipeline.
+             * @param[in] filterLevel Deflate level or number of decimal digits for scale-offset.
+             * @param[in] valueType Value datatype.
+             */
+            static
+            void repackDataset(geomodelgrids::serial::HDF5Copier* copier,
+                               const std::string& path,
+                               const size_t chunk[3],
+                               const geomodelgrids::apps::Repack::FilterEnum filter,
+                               const int filterLevel,
+                               const geomodelgrids::apps::Repack::ValueTypeEnum valueType);
+
+            /** Get size of file.
+             *
+             * @param[in] filename Name of file.
+             * @returns Size of file in bytes.
+             */
+            static
+            size_t fileSize(const char* filename);
+
+        } // _Repack
+    } // apps
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::apps::Repack::Repack() :
+    _filter(FILTER_KEEP),
+    _filterLevel(0),
+    _valueType(TYPE_KEEP),
+    _benchmarkNumPoints(1000),
+    _showHelp(false) {
+    _chunk[0] = 0;
+    _chunk[1] = 0;
+    _chunk[2] = 0;
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::apps::Repack::~Repack(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Run repack application.
+int
+geomodelgrids::apps::Repack::run(int argc,
+                                 char* argv[]) {
+    _parseArgs(argc, argv);
+
+    if (_showHelp) {
+        _printHelp();
+        return 0;
+    } // if
+
+    { // Repack
+        geomodelgrids::serial::HDF5Copier copier;
+        copier.open(_modelFilename.c_str(), _outputFilename.c_str());
+        // Attributes and dataset dimensions, including those of the coarser levels, do not change, so the
+        // metadata snapshot stays valid.
+        copier.copyGroups(true, true);
+        std::vector<std::string> paths;
+        copier.getDatasets(&paths, true);
+        for (size_t i = 0; i < paths.size(); ++i) {
+            _Repack::repackDataset(&copier, paths[i], _chunk, _filter, _filterLevel, _valueType);
+        } // for
+        copier.close();
+    } // Repack
+
+    const size_t sizeBefore = _Repack::fileSize(_modelFilename.c_str());
+    const size_t sizeAfter = _Repack::fileSize(_outputFilename.c_str());
+    std::cout << "Repacked model '" << _modelFilename << "' to '" << _outputFilename << "'.\n"
+              << "File size: " << sizeBefore << " bytes before, " << sizeAfter << " bytes after." << std::endl;
+
+    if (_benchmarkNumPoints > 0) {
+        double pointsBefore = 0.0;
+        double sliceBefore = 0.0;
+        _benchmark(&pointsBefore, &sliceBefore, _modelFilename.c_str());
+        double pointsAfter = 0.0;
+        double sliceAfter = 0.0;
+        _benchmark(&pointsAfter, &sliceAfter, _outputFilename.c_str());
+        std::cout << "Query time for " << _benchmarkNumPoints << " scattered points: "
+                  << pointsBefore << " s before, " << pointsAfter << " s after.\n"
+                  << "Query time for horizontal slice with " << _benchmarkNumPoints << " points: "
+                  << sliceBefore << " s before, " << sliceAfter << " s after." << std::endl;
+    } // if
+
+    return 0;
+} // run
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse command line arguments.
+void
+geomodelgrids::apps::Repack::_parseArgs(int argc,
+                                        char* argv[]) {
+    static struct option options[8] = {
+        {"help", no_argument, nullptr, 'h'},
+        {"model", required_argument, nullptr, 'm'},
+        {"output", required_argument, nullptr, 'o'},
+        {"chunk", required_argument, nullptr, 'c'},
+        {"filter", required_argument, nullptr, 'f'},
+        {"type", required_argument, nullptr, 't'},
+        {"benchmark", required_argument, nullptr, 'b'},
+        {0, 0, 0, 0}
+    };
+
+    while (true) {
+        // extern char* optarg;
+        const char c = getopt_long(argc, argv, "hm:o:c:f:t:b:", options, nullptr);
+        if (-1 == c) { break; }
+        switch (c) {
+        case 'h':
+            _showHelp = true;
+            break;
+        case 'm':
+            _modelFilename = optarg;
+            break;
+        case 'o':
+            _outputFilename = optarg;
+            break;
+        case 'c': {
+            std::istringstream tokenStream(optarg);
+            std::string token;
+            std::vector<long> values;
+            while (std::getline(tokenStream, token, ',')) {
+                values.push_back(std::stol(token));
+            } // while
+            if (( 3 != values.size()) || ( values[0] <= 0) || ( values[1] <= 0) || ( values[2] <= 0) ) {
+                std::ostringstream msg;
+                msg << "Chunk dimensions must be 3 positive integers (NX,NY,NZ). Found '" << optarg << "'.";
+                throw std::runtime_error(msg.str());
+            } // if
+            for (size_t i = 0; i < 3; ++i) {
+                _chunk[i] = size_t(values[i]);
+            } // for
+            break;
+        } // 'c'
+        case 'f': {
+            const std::string value(optarg);
+            if (value == "none") {
+                _filter = FILTER_NONE;
+            } else if (value == "deflate") {
+                _filter = FILTER_DEFLATE;
+                _filterLevel = 6;
+            } else if (0 == value.compare(0, 8, "deflate:")) {
+                _filter = FILTER_DEFLATE;
+                _filterLevel = std::stoi(value.substr(8));
+            } else if (0 == value.compare(0, 12, "scaleoffset:")) {
+                _filter = FILTER_SCALEOFFSET;
+                _filterLevel = std::stoi(value.substr(12));
+            } else {
+                std::ostringstream msg;
+                msg << "Unknown filter '" << value << "'. Use 'none', 'deflate[:LEVEL]', or 'scaleoffset:DIGITS'.";
+                throw std::runtime_error(msg.str());
+            } // if/else
+            if (( FILTER_DEFLATE == _filter) && (( _filterLevel < 0) || ( _filterLevel > 9) )) {
+                std::ostringstream msg;
+                msg << "Deflate level must be in the range 0-9. Found " << _filterLevel << ".";
+                throw std::runtime_error(msg.str());
+            } // if
+            if (( FILTER_SCALEOFFSET == _filter) && ( _filterLevel < 0) ) {
+                std::ostringstream msg;
+                msg << "Number of decimal digits for scale-offset filter must be nonnegative. Found "
+                    << _filterLevel << ".";
+                throw std::runtime_error(msg.str());
+            } // if
+            break;
+        } // 'f'
+        case 't': {
+            const std::string value(optarg);
+            if (value == "float32") {
+                _valueType = TYPE_FLOAT32;
+            } else if (value == "float64") {
+                _valueType = TYPE_FLOAT64;
+            } else {
+                std::ostringstream msg;
+                msg << "Unknown value type '" << value << "'. Use 'float32' or 'float64'.";
+                throw std::runtime_error(msg.str());
+            } // if/else
+            break;
+        } // 't'
+        case 'b':
+            _benchmarkNumPoints = std::stoul(optarg);
+            break;
+        case '?': {
+            std::ostringstream msg;
+            msg << "Error passing command line arguments:\n";
+            for (int i = 0; i < argc; ++i) {
+                msg << argv[i] << " ";
+            } // for
+            throw std::logic_error(msg.str().c_str());
+        } // ?
+        } // switch
+    } // while
+    if (1 == argc) {
+        _showHelp = true;
+    } // if
+    if (_showHelp) {
+        return;
+    } // if
+
+    std::ostringstream msg;
+    if (_modelFilename.empty()) {
+        msg << "    --model=FILE\n";
+    } // if
+    if (_outputFilename.empty()) {
+        msg << "    --output=FILE\n";
+    } // if
+    if (msg.str().length() > 0) {
+        throw std::runtime_error("Missing required command line arguments:\n" + msg.str());
+    } // if
+} // _parseArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Print help information.
+void
+geomodelgrids::apps::Repack::_printHelp(void) {
+    std::cout << "Usage: geomodelgrids_repack "
+              << "[--help] --model=FILE --output=FILE [--chunk=NX,NY,NZ] "
+              << "[--filter=none|deflate[:LEVEL]|scaleoffset:DIGITS] [--type=float32|float64] "
+              << "[--benchmark=NUM_POINTS]\n\n"
+              << "    --help                 Print help information to stdout and exit.\n"
+              << "    --model=FILE           Model to repack.\n"
+              << "    --output=FILE          Repacked model file (overwritten if it exists).\n"
+              << "    --chunk=NX,NY,NZ       Chunk dimensions of surfaces and blocks (default is chunking of model).\n"
+              << "    --filter=FILTER        Filter pipeline (default is filters of model).\n"
+              << "    --type=TYPE            Value datatype (default is datatype of model).\n"
+              << "    --benchmark=NUM_POINTS Number of points in query benchmark; 0 skips the benchmark (default is 1000)."
+              << std::endl;
+} // _printHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Time queries of model.
+void
+geomodelgrids::apps::Repack::_benchmark(double* pointsTime,
+                                        double* sliceTime,
+                                        const char* filename) {
+    assert(pointsTime);
+    assert(sliceTime);
+    assert(filename);
+
+    geomodelgrids::serial::Model model;
+    model.open(filename, geomodelgrids::serial::Model::READ);
+    model.loadMetadata();
+    model.setInputCRS(model.getCRSString());
+    model.initialize();
+
+    const double* const origin = model.getOrigin();
+    const double* const dims = model.getDims();
+    const double yazimuth = model.getYAzimuth();
+    const double yazimuthRad = yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    const size_t numValues = model.getValueNames().size();
+
+    // Scattered points, as for a set of stations. The same points are used for each model.
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<double> points(3*_benchmarkNumPoints);
+    for (size_t i = 0; i < _benchmarkNumPoints; ++i) {
+        const double xModel = uniform(generator) * dims[0];
+        const double yModel = uniform(generator) * dims[1];
+        points[3*i+0] = origin[0] + xModel*cosAz + yModel*sinAz;
+        points[3*i+1] = origin[1] - xModel*sinAz + yModel*cosAz;
+        points[3*i+2] = uniform(generator);
+    } // for
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < _benchmarkNumPoints; ++i) {
+        const double x = points[3*i+0];
+        const double y = points[3*i+1];
+        const double elevation = model.queryTopElevation(x, y);
+        const double z = elevation - points[3*i+2] * (elevation + dims[2]);
+        if (model.contains(x, y, z)) {
+            model.query(x, y, z);
+        } // if
+    } // for
+    *pointsTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Horizontal slice through the middle of the model, aligned with the model axes.
+    const size_t numX = std::max(size_t(2), size_t(sqrt(double(_benchmarkNumPoints) * dims[0] / dims[1])));
+    const size_t numY = std::max(size_t(2), _benchmarkNumPoints / numX);
+    const double gridOrigin[3] = { origin[0], origin[1], -0.5*dims[2] };
+    const double gridSpacing[3] = { dims[0] / (numX-1), dims[1] / (numY-1), 1.0 };
+    const size_t gridDims[3] = { numX, numY, 1 };
+    std::vector<double> values(numX*numY*numValues);
+    std::unique_ptr<bool[]> inModel(new bool[numX*numY]);
+    start = std::chrono::steady_clock::now();
+    model.queryGrid(values.data(), inModel.get(), gridOrigin, gridSpacing, gridDims, yazimuth);
+    *sliceTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    model.close();
+} // _benchmark
+
+
+// ------------------------------------------------------------------------------------------------
+// Rewrite dataset with new chunking, filters, and value datatype.
+void
+geomodelgrids::apps::_Repack::repackDataset(geomodelgrids::serial::HDF5Copier* copier,
+                                            const std::string& path,
+                                            const size_t chunk[3],
+                                            const geomodelgrids::apps::Repack::FilterEnum filter,
+                                            const int filterLevel,
+                                            const geomodelgrids::apps::Repack::ValueTypeEnum valueType) {
+    assert(copier);
+
+    Handle src(H5Dopen2(copier->getSource(), path.c_str(), H5P_DEFAULT), H5Dclose, "open dataset '" + path + "'");
+    Handle srcSpace(H5Dget_space(src), H5Sclose, "get dataspace of dataset '" + path + "'");
+    const int ndims = H5Sget_simple_extent_ndims(srcSpace);
+    std::vector<hsize_t> dims(ndims);
+    H5Sget_simple_extent_dims(srcSpace, dims.data(), nullptr);
+
+    // Chunk dimensions: x, y, and z (blocks only) from the arguments. Values are not split, except
+    // with the planar layout, where each chunk holds a single value.
+    Handle dcpl(H5Dget_create_plist(src), H5Pclose, "get creation properties of dataset '" + path + "'");
+    std::vector<hsize_t> chunkDims(dims);
+    if (H5D_CHUNKED == H5Pget_layout(dcpl)) {
+        H5Pget_chunk(dcpl, ndims, chunkDims.data());
+    } // if
+    if (chunk[0] > 0) {
+        const bool isPlanar = copier->isPlanar(path.c_str());
+        const int xDim = isPlanar ? 1 : 0;
+        const int valueDim = isPlanar ? 0 : ndims-1;
+        chunkDims[xDim+0] = std::min(hsize_t(chunk[0]), dims[xDim+0]);
+        chunkDims[xDim+1] = std::min(hsize_t(chunk[1]), dims[xDim+1]);
+        if (ndims > 3) {
+            chunkDims[xDim+2] = std::min(hsize_t(chunk[2]), dims[xDim+2]);
+        } // if
+        chunkDims[valueDim] = isPlanar ? 1 : dims[valueDim];
+    } // if
+    if (H5Pset_chunk(dcpl, ndims, chunkDims.data()) < 0) {
+        throw std::runtime_error("Could not set chunk dimensions of dataset '" + path + "'.");
+    } // if
+
+    hid_t fileTypeId = -1;
+    switch (valueType) {
+    case geomodelgrids::apps::Repack::TYPE_KEEP:
+        fileTypeId = H5Dget_type(src);
+        break;
+    case geomodelgrids::apps::Repack::TYPE_FLOAT32:
+        fileTypeId = H5Tcopy(H5T_IEEE_F32LE);
+        break;
+    case geomodelgrids::apps::Repack::TYPE_FLOAT64:
+        fileTypeId = H5Tcopy(H5T_IEEE_F64LE);
+        break;
+    default:
+        throw std::logic_error("Unknown value type in repackDataset().");
+    } // switch
+    Handle fileType(fileTypeId, H5Tclose, "get type of dataset '" + path + "'");
+
+    switch (filter) {
+    case geomodelgrids::apps::Repack::FILTER_KEEP:
+        break;
+    case geomodelgrids::apps::Repack::FILTER_NONE:
+        H5Premove_filter(dcpl, H5Z_FILTER_ALL);
+        break;
+    case geomodelgrids::apps::Repack::FILTER_DEFLATE:
+        H5Premove_filter(dcpl, H5Z_FILTER_ALL);
+        H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, filterLevel);
+        break;
+    case geomodelgrids::apps::Repack::FILTER_SCALEOFFSET:
+        H5Premove_filter(dcpl, H5Z_FILTER_ALL);
+        if (H5T_INTEGER == H5Tget_class(fileType)) {
+            // Values encoded as integers are stored with the minimum number of bits (lossless).
+            H5Pset_scaleoffset(dcpl, H5Z_SO_INT, H5Z_SO_INT_MINBITS_DEFAULT);
+        } else {
+            // The filter excludes the fill value from scaling, so NODATA values remain exact.
+            H5Pset_fill_value(dcpl, H5T_NATIVE_DOUBLE, &geomodelgrids::NODATA_VALUE);
+            H5Pset_scaleoffset(dcpl, H5Z_SO_FLOAT_DSCALE, filterLevel);
+        } // if/else
+        break;
+    default:
+        throw std::logic_error("Unknown filter in repackDataset().");
+    } // switch
+
+    Handle dest(H5Dcreate2(copier->getDestination(), path.c_str(), fileType, srcSpace, H5P_DEFAULT, dcpl, H5P_DEFAULT),
+                H5Dclose, "create dataset '" + path + "'");
+    copier->copyAttributes(path.c_str());
+
+    // Copy values one chunk column at a time (one value and one range of x chunks with planar layout).
+    Handle destSpace(H5Dget_space(dest), H5Sclose, "get dataspace of dataset '" + path + "'");
+    std::vector<hsize_t> start(ndims, 0);
+    std::vector<hsize_t> count(dims);
+    std::vector<double> buffer;
+    for (hsize_t x = 0; x < dims[0]; x += chunkDims[0]) {
+        for (hsize_t y = 0; y < dims[1]; y += chunkDims[1]) {
+            start[0] = x;
+            start[1] = y;
+            count[0] = std::min(chunkDims[0], dims[0] - x);
+            count[1] = std::min(chunkDims[1], dims[1] - y);
+            hsize_t numValues = 1;
+            for (int iDim = 0; iDim < ndims; ++iDim) {
+                numValues *= count[iDim];
+            } // for
+            buffer.resize(numValues);
+
+            Handle memSpace(H5Screate_simple(ndims, count.data(), nullptr), H5Sclose, "create dataspace");
+            H5Sselect_hyperslab(srcSpace, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+            if (H5Dread(src, H5T_NATIVE_DOUBLE, memSpace, srcSpace, H5P_DEFAULT, buffer.data()) < 0) {
+                throw std::runtime_error("Could not read values of dataset '" + path + "'.");
+            } // if
+            H5Sselect_hyperslab(destSpace, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+            if (H5Dwrite(dest, H5T_NATIVE_DOUBLE, memSpace, destSpace, H5P_DEFAULT, buffer.data()) < 0) {
+                throw std::runtime_error("Could not write values of dataset '" + path + "'.");
+            } // if
+        } // for
+    } // for
+} // repackDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Get size of file.
+size_t
+geomodelgrids::apps::_Repack::fileSize(const char* filename) {
+    struct stat info;
+    if (stat(filename, &info)) {
+        std::ostringstream msg;
+        msg << "Could not get size of file '" << filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    return size_t(info.st_size);
+} // fileSize
+
+
+// End of file
@@ -0,0 +1,101 @@
+/// C++ application to rewrite the surfaces and blocks of a model with different storage settings.
+#pragma once
+
+#include "appsfwd.hh" // forward declarations
+
+#include <string> // USES std::string
+#include <cstddef> // USES size_t
+
+class geomodelgrids::apps::Repack {
+    friend class TestRepack; // unit testing
+
+    // PUBLIC ENUMS ///////////////////////////////////////////////////////////////////////////////
+public:
+
+    enum FilterEnum {
+        FILTER_KEEP=0, ///< Keep filter pipeline of model.
+        FILTER_NONE=1, ///< No filters.
+        FILTER_DEFLATE=2, ///< Shuffle and deflate (gzip).
+        FILTER_SCALEOFFSET=3, ///< Scale-offset with fixed number of decimal digits (lossy).
+    }; // FilterEnum
+
+    enum ValueTypeEnum {
+        TYPE_KEEP=0, ///< Keep value datatype of model.
+        TYPE_FLOAT32=1, ///< 32-bit floating point values.
+        TYPE_FLOAT64=2, ///< 64-bit floating point values.
+    }; // ValueTypeEnum
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Constructor
+    Repack(void);
+
+    /// Destructor
+    ~Repack(void);
+
+    /**
+     * Run repack application.
+     *
+     * Arguments:
+     *   --help
+     *   --model=FILE
+     *   --output=FILE
+     *   --chunk=NX,NY,NZ
+     *   --filter=none|deflate[:LEVEL]|scaleoffset:DIGITS
+     *   --type=float32|float64
+     *   --benchmark=NUM_POINTS
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     *
+     * @returns 1 if errors were detected, 0 otherwise.
+     */
+    int run(int argc,
+            char* argv[]);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    /** Parse command line arguments.
+     *
+     * @param argc[in] Number of arguments passed.
+     * @param argv[in] Array of input arguments.
+     */
+    void _parseArgs(int argc,
+                    char* argv[]);
+
+    /// Print help information.
+    void _printHelp(void);
+
+    /** Time queries of model.
+     *
+     * @param[out] pointsTime Time (s) for queries at scattered points.
+     * @param[out] sliceTime Time (s) for query of a horizontal slice.
+     * @param[in] filename Name of model file.
+     */
+    void _benchmark(double* pointsTime,
+                    double* sliceTime,
+                    const char* filename);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////////////////////////////
+private:
+
+    std::string _modelFilename;
+    std::string _outputFilename;
+    size_t _chunk[3]; ///< Chunk dimensions along x, y, and z axes (0 keeps chunking of model).
+    FilterEnum _filter;
+    int _filterLevel; ///< Deflate level or number of decimal digits for scale-offset.
+    ValueTypeEnum _valueType;
+    size_t _benchmarkNumPoints; ///< Number of points in query benchmark (0 for no benchmark).
+    bool _showHelp;
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////////////////////////////
+private:
+
+    Repack(const Repack&); ///< Not implemented
+    const Repack& operator=(const Repack&); ///< Not implemented
+
+}; // Repack
+
+// End of file
@@ -7,6 +7,10 @@ namespace geomodelgrids {
         class QueryElev;
         class Borehole;
         class Isosurface;
+        class Image;
+        class QueryServer;
+        class Extract;
+        class Repack;
     } // apps
 } // geomodelgrids
 
@@ -0,0 +1,13 @@
+/** High-level header file for geomodelgrids parallel library.
+ * This file can be used as the include for the parallel query api.
+ */
+
+#if !defined(geomodelgrids_parallel_hh)
+#define geomodelgrids_parallel_hh
+
+#include "parallel/Query.hh"
+#include "parallel/NodeCache.hh"
+
+#endif // geomodelgrids_parallel_hh
+
+// End of file
@@ -0,0 +1,197 @@
+#include <portinfo>
+
+#include "NodeCache.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/Surface.hh" // USES Surface
+
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <algorithm> // USES std::min()
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::parallel::NodeCache::NodeCache(MPI_Comm comm) :
+    _nodeComm(MPI_COMM_NULL),
+    _numBytes(0) {
+    int err = MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, 0, MPI_INFO_NULL, &_nodeComm);
+    if (err != MPI_SUCCESS) {
+        throw std::runtime_error("Could not create MPI communicator for processes sharing memory.");
+    } // if
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::parallel::NodeCache::~NodeCache(void) {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+    if (!finalized) {
+        deallocate();
+        if (_nodeComm != MPI_COMM_NULL) {
+            MPI_Comm_free(&_nodeComm);
+        } // if
+    } // if
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get MPI communicator for processes on this compute node.
+MPI_Comm
+geomodelgrids::parallel::NodeCache::getNodeCommunicator(void) const {
+    return _nodeComm;
+} // getNodeCommunicator
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of bytes of model values stored in shared memory on this compute node.
+size_t
+geomodelgrids::parallel::NodeCache::getNumBytes(void) const {
+    return _numBytes;
+} // getNumBytes
+
+
+// ------------------------------------------------------------------------------------------------
+// Load values for the surfaces and blocks of a model into shared memory.
+void
+geomodelgrids::parallel::NodeCache::load(geomodelgrids::serial::Model* model) {
+    assert(model);
+
+    if (model->getTopSurface()) {
+        _loadSurface(model->getTopSurface().get());
+    } // if
+    if (model->getTopoBathy()) {
+        _loadSurface(model->getTopoBathy().get());
+    } // if
+    const std::vector<std::shared_ptr<geomodelgrids::serial::Block> >& blocks = model->getBlocks();
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        assert(blocks[i]);
+        _loadBlock(blocks[i].get());
+    } // for
+} // load
+
+
+// ------------------------------------------------------------------------------------------------
+// Free shared memory.
+void
+geomodelgrids::parallel::NodeCache::deallocate(void) {
+    for (size_t i = 0; i < _windows.size(); ++i) {
+        MPI_Win_unlock_all(_windows[i]);
+        MPI_Win_free(&_windows[i]);
+    } // for
+    _windows.clear();
+    _numBytes = 0;
+} // deallocate
+
+
+// ------------------------------------------------------------------------------------------------
+// Load values for surface into shared memory.
+void
+geomodelgrids::parallel::NodeCache::_loadSurface(geomodelgrids::serial::Surface* surface) {
+    assert(surface);
+
+    const size_t* dims = surface->getDims();assert(dims);
+    const size_t numValuesX = dims[1];
+    double* values = _allocate(dims[0]*numValuesX);
+
+    size_t xOrigin = 0;
+    size_t numX = 0;
+    _partition(&xOrigin, &numX, dims[0]);
+    if (numX > 0) {
+        surface->readValues(&values[xOrigin*numValuesX], xOrigin, numX);
+    } // if
+    _synchronize();
+
+    surface->setValues(values);
+} // _loadSurface
+
+
+// ------------------------------------------------------------------------------------------------
+// Load values for block into shared memory.
+void
+geomodelgrids::parallel::NodeCache::_loadBlock(geomodelgrids::serial::Block* block) {
+    assert(block);
+
+    const size_t* dims = block->getDims();assert(dims);
+    const size_t numValuesX = dims[1] * dims[2] * block->getNumValues();
+    double* values = _allocate(dims[0]*numValuesX);
+
+    size_t xOrigin = 0;
+    size_t numX = 0;
+    _partition(&xOrigin, &numX, dims[0]);
+    if (numX > 0) {
+        block->readValues(&values[xOrigin*numValuesX], xOrigin, numX);
+    } // if
+    _synchronize();
+
+    block->setValues(values);
+} // _loadBlock
+
+
+// ------------------------------------------------------------------------------------------------
+// Allocate shared memory window on this compute node.
+double*
+geomodelgrids::parallel::NodeCache::_allocate(const size_t numValues) {
+    int nodeRank = 0;
+    MPI_Comm_rank(_nodeComm, &nodeRank);
+
+    // First process on the node allocates the entire window; other processes allocate nothing.
+    const MPI_Aint numBytes = (0 == nodeRank) ? MPI_Aint(numValues * sizeof(double)) : 0;
+    double* values = nullptr;
+    MPI_Win window = MPI_WIN_NULL;
+    int err = MPI_Win_allocate_shared(numBytes, sizeof(double), MPI_INFO_NULL, _nodeComm, &values, &window);
+    if (err != MPI_SUCCESS) {
+        std::ostringstream msg;
+        msg << "Could not allocate MPI shared memory window with " << numValues*sizeof(double) << " bytes.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    MPI_Aint windowBytes = 0;
+    int dispUnit = 0;
+    MPI_Win_shared_query(window, 0, &windowBytes, &dispUnit, &values);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+    _windows.push_back(window);
+    _numBytes += numValues * sizeof(double);
+
+    return values;
+} // _allocate
+
+
+// ------------------------------------------------------------------------------------------------
+// Wait for processes on this compute node to finish writing to the most recent window.
+void
+geomodelgrids::parallel::NodeCache::_synchronize(void) {
+    assert(_windows.size() > 0);
+
+    MPI_Win window = _windows.back();
+    MPI_Win_sync(window);
+    MPI_Barrier(_nodeComm);
+    MPI_Win_sync(window);
+} // _synchronize
+
+
+// ------------------------------------------------------------------------------------------------
+// Get range of x indices read by this process.
+void
+geomodelgrids::parallel::NodeCache::_partition(size_t* xOrigin,
+                                               size_t* numX,
+                                               const size_t numXAll) const {
+    assert(xOrigin);
+    assert(numX);
+
+    int nodeRank = 0;
+    int nodeSize = 1;
+    MPI_Comm_rank(_nodeComm, &nodeRank);
+    MPI_Comm_size(_nodeComm, &nodeSize);
+
+    const size_t numXPerProc = numXAll / nodeSize;
+    const size_t numRemainder = numXAll % nodeSize;
+    const size_t rank = nodeRank;
+    *numX = numXPerProc + ((rank < numRemainder) ? 1 : 0);
+    *xOrigin = rank * numXPerProc + std::min(rank, numRemainder);
+} // _partition
+
+
+// End of file
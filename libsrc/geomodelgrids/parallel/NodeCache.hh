@@ -0,0 +1,116 @@
+/** Node-level cache of model values in MPI-3 shared memory.
+ *
+ * The values for the surfaces and blocks of a model are stored once per compute node in MPI shared
+ * memory windows. The processes on a node read the values from the model file cooperatively, with
+ * each process reading a different range of x indices, and then all of the processes on the node
+ * query the shared values (read only).
+ */
+#pragma once
+
+#include "parallelfwd.hh" // forward declarations
+
+#include "geomodelgrids/serial/serialfwd.hh" // USES Model, Block, Surface
+
+#include <mpi.h> // HASA MPI_Comm, MPI_Win
+
+#include <cstddef> // USES size_t
+#include <vector> // HASA std::vector
+
+class geomodelgrids::parallel::NodeCache {
+    friend class TestNodeCache; // unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Constructor.
+     *
+     * Collective operation; splits the communicator into communicators for the processes on each
+     * compute node.
+     *
+     * @param[in] comm MPI communicator with processes querying the models.
+     */
+    NodeCache(MPI_Comm comm);
+
+    /// Destructor
+    ~NodeCache(void);
+
+    /** Get MPI communicator for processes on this compute node.
+     *
+     * @returns MPI communicator for processes sharing memory.
+     */
+    MPI_Comm getNodeCommunicator(void) const;
+
+    /** Get number of bytes of model values stored in shared memory on this compute node.
+     *
+     * @returns Number of bytes.
+     */
+    size_t getNumBytes(void) const;
+
+    /** Load values for the surfaces and blocks of a model into shared memory.
+     *
+     * Collective operation; all processes in the communicator must call this method AFTER the
+     * model has been opened for querying. The surfaces and blocks use the shared values for all
+     * queries until the model is closed.
+     *
+     * @param[inout] model Model to load.
+     */
+    void load(geomodelgrids::serial::Model* model);
+
+    /** Free shared memory.
+     *
+     * Collective operation. Must be called AFTER closing the models using the shared values.
+     */
+    void deallocate(void);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Load values for surface into shared memory.
+     *
+     * @param[inout] surface Surface to load.
+     */
+    void _loadSurface(geomodelgrids::serial::Surface* surface);
+
+    /** Load values for block into shared memory.
+     *
+     * @param[inout] block Block to load.
+     */
+    void _loadBlock(geomodelgrids::serial::Block* block);
+
+    /** Allocate shared memory window on this compute node.
+     *
+     * @param[in] numValues Number of values in window.
+     * @returns Address of values in window.
+     */
+    double* _allocate(const size_t numValues);
+
+    /** Wait for processes on this compute node to finish writing to the most recent window.
+     */
+    void _synchronize(void);
+
+    /** Get range of x indices read by this process.
+     *
+     * @param[out] xOrigin Index of first point in x direction.
+     * @param[out] numX Number of points in x direction.
+     * @param[in] numXAll Total number of points in x direction.
+     */
+    void _partition(size_t* xOrigin,
+                    size_t* numX,
+                    const size_t numXAll) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    MPI_Comm _nodeComm; ///< MPI communicator for processes on this compute node.
+    std::vector<MPI_Win> _windows; ///< Shared memory windows.
+    size_t _numBytes; ///< Number of bytes in shared memory windows.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    NodeCache(const NodeCache&); ///< Not implemented
+    const NodeCache& operator=(const NodeCache&); ///< Not implemented
+
+}; // NodeCache
+
+// End of file
@@ -0,0 +1,163 @@
+#include <portinfo>
+
+#include "Query.hh" // implementation of class methods
+
+#include "geomodelgrids/parallel/NodeCache.hh" // USES NodeCache
+#include "geomodelgrids/serial/Model.hh" // USES Model
+
+#include <hdf5.h> // USES H5Pset_fapl_mpio()
+#include <limits> // USES std::numeric_limits
+#include <algorithm> // USES std::min(), std::max()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::parallel::Query::Query(MPI_Comm comm) :
+    _comm(comm),
+    _nodeCache(nullptr) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::parallel::Query::~Query(void) {
+    delete _nodeCache;_nodeCache = nullptr;
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get MPI communicator.
+MPI_Comm
+geomodelgrids::parallel::Query::getCommunicator(void) const {
+    return _comm;
+} // getCommunicator
+
+
+// ------------------------------------------------------------------------------------------------
+// Load model values for region containing the points queried by this process.
+void
+geomodelgrids::parallel::Query::loadRegion(const double xMin,
+                                           const double xMax,
+                                           const double yMin,
+                                           const double yMax) {
+    hid_t datasetTransfer = H5P_DEFAULT;
+#if defined(H5_HAVE_PARALLEL)
+    datasetTransfer = H5Pcreate(H5P_DATASET_XFER);
+    if (datasetTransfer < 0) {
+        throw std::runtime_error("Could not create HDF5 dataset transfer properties.");
+    } // if
+    if (H5Pset_dxpl_mpio(datasetTransfer, H5FD_MPIO_COLLECTIVE) < 0) {
+        H5Pclose(datasetTransfer);
+        throw std::runtime_error("Could not set collective MPI-IO dataset transfer.");
+    } // if
+#endif
+
+    try {
+        for (size_t i = 0; i < _models.size(); ++i) {
+            assert(_models[i]);
+            _models[i]->loadRegion(xMin, xMax, yMin, yMax, datasetTransfer);
+        } // for
+    } catch (...) {
+        if (datasetTransfer != H5P_DEFAULT) {
+            H5Pclose(datasetTransfer);
+        } // if
+        throw;
+    } // try/catch
+
+    if (datasetTransfer != H5P_DEFAULT) {
+        H5Pclose(datasetTransfer);
+    } // if
+} // loadRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Load model values for region containing the bounding box of the given points.
+void
+geomodelgrids::parallel::Query::loadRegion(const double* const points,
+                                           const size_t numPoints,
+                                           const size_t spaceDim) {
+    if (numPoints > 0) {
+        if (!points) {
+            throw std::invalid_argument("geomodelgrids::parallel::Query::loadRegion() passed nullptr for points.");
+        } // if
+        if (( spaceDim < 2) || ( spaceDim > 3) ) {
+            std::ostringstream msg;
+            msg << "Expected spatial dimension of 2 or 3 for points, got " << spaceDim << ".";
+            throw std::invalid_argument(msg.str());
+        } // if
+    } // if
+
+    // Bounding box of points (empty if there are no points).
+    double xMin = +std::numeric_limits<double>::max();
+    double xMax = -std::numeric_limits<double>::max();
+    double yMin = +std::numeric_limits<double>::max();
+    double yMax = -std::numeric_limits<double>::max();
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        xMin = std::min(xMin, points[iPt*spaceDim+0]);
+        xMax = std::max(xMax, points[iPt*spaceDim+0]);
+        yMin = std::min(yMin, points[iPt*spaceDim+1]);
+        yMax = std::max(yMax, points[iPt*spaceDim+1]);
+    } // for
+
+    loadRegion(xMin, xMax, yMin, yMax);
+} // loadRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Load entire models into memory shared by the processes on each compute node.
+void
+geomodelgrids::parallel::Query::loadNodeCache(void) {
+    delete _nodeCache;_nodeCache = new geomodelgrids::parallel::NodeCache(_comm);
+
+    for (size_t i = 0; i < _models.size(); ++i) {
+        assert(_models[i]);
+        _nodeCache->load(_models[i].get());
+    } // for
+} // loadNodeCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Cleanup after querying.
+void
+geomodelgrids::parallel::Query::finalize(void) {
+    geomodelgrids::serial::Query::finalize();
+
+    // Free shared memory after closing the models that use it.
+    delete _nodeCache;_nodeCache = nullptr;
+} // finalize
+
+
+// ------------------------------------------------------------------------------------------------
+// Open model file using the MPI-IO driver.
+void
+geomodelgrids::parallel::Query::_openModel(geomodelgrids::serial::Model* model,
+                                           const char* filename) {
+    assert(model);
+    assert(filename);
+
+#if defined(H5_HAVE_PARALLEL)
+    hid_t fileAccess = H5Pcreate(H5P_FILE_ACCESS);
+    if (fileAccess < 0) {
+        throw std::runtime_error("Could not create HDF5 file access properties.");
+    } // if
+    if (H5Pset_fapl_mpio(fileAccess, _comm, MPI_INFO_NULL) < 0) {
+        H5Pclose(fileAccess);
+        throw std::runtime_error("Could not set MPI-IO driver for HDF5 file access.");
+    } // if
+
+    try {
+        model->open(filename, geomodelgrids::serial::Model::READ, fileAccess);
+    } catch (...) {
+        H5Pclose(fileAccess);
+        throw;
+    } // try/catch
+    H5Pclose(fileAccess);
+#else
+    // Without parallel HDF5, each process opens the (read only) file independently.
+    model->open(filename, geomodelgrids::serial::Model::READ);
+#endif
+} // _openModel
+
+
+// End of file
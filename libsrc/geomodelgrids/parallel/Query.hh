@@ -0,0 +1,106 @@
+/// C++ interface for querying a model in parallel using MPI.
+#pragma once
+
+#include "parallelfwd.hh" // forward declarations
+
+#include "geomodelgrids/serial/Query.hh" // ISA Query
+
+#include <mpi.h> // HASA MPI_Comm
+
+class geomodelgrids::parallel::Query : public geomodelgrids::serial::Query {
+    friend class TestQuery; // unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /** Constructor
+     *
+     * @param[in] comm MPI communicator with processes querying the models.
+     */
+    Query(MPI_Comm comm=MPI_COMM_WORLD);
+
+    /// Destructor
+    ~Query(void);
+
+    /** Get MPI communicator.
+     *
+     * @returns MPI communicator with processes querying the models.
+     */
+    MPI_Comm getCommunicator(void) const;
+
+    /** Load model values for region containing the points queried by this process.
+     *
+     * Collective operation; all processes in the communicator must call this method AFTER
+     * initialize(). Processes without any points pass an empty region (xMin > xMax or yMin > yMax).
+     *
+     * Each process reads only the portions of the surfaces and blocks covering its region, so that
+     * subsequent queries for points in the region do not read from the model files. With parallel
+     * HDF5, the reads are collective MPI-IO operations.
+     *
+     * @param[in] xMin Minimum x coordinate of region (in input CRS).
+     * @param[in] xMax Maximum x coordinate of region (in input CRS).
+     * @param[in] yMin Minimum y coordinate of region (in input CRS).
+     * @param[in] yMax Maximum y coordinate of region (in input CRS).
+     */
+    void loadRegion(const double xMin,
+                    const double xMax,
+                    const double yMin,
+                    const double yMax);
+
+    /** Load model values for region containing the bounding box of the given points.
+     *
+     * Collective operation; all processes in the communicator must call this method AFTER
+     * initialize(), including processes without any points.
+     *
+     * @param[in] points Array of points (in input CRS) queried by this process [numPoints*spaceDim].
+     * @param[in] numPoints Number of points.
+     * @param[in] spaceDim Spatial dimension of points (2 or 3).
+     */
+    void loadRegion(const double* const points,
+                    const size_t numPoints,
+                    const size_t spaceDim);
+
+    /** Load entire models into memory shared by the processes on each compute node.
+     *
+     * Collective operation; all processes in the communicator must call this method AFTER
+     * initialize(). The values for the surfaces and blocks are stored once per compute node in MPI-3
+     * shared memory windows, which the processes on the node fill cooperatively. All queries then
+     * interpolate from the shared values without reading from the model files, so the memory for
+     * model values does not grow with the number of processes per node.
+     */
+    void loadNodeCache(void);
+
+    /** Cleanup after querying.
+     *
+     * Collective operation if loadNodeCache() was called.
+     */
+    void finalize(void);
+
+    // PROTECTED METHODS --------------------------------------------------------------------------
+protected:
+
+    /** Open model file using the MPI-IO driver.
+     *
+     * Collective operation.
+     *
+     * @param[inout] model Model to open.
+     * @param[in] filename Name of model file.
+     */
+    void _openModel(geomodelgrids::serial::Model* model,
+                    const char* filename);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    MPI_Comm _comm; ///< MPI communicator.
+    geomodelgrids::parallel::NodeCache* _nodeCache; ///< Node-level cache of model values.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    Query(const Query&); ///< Not implemented
+    const Query& operator=(const Query&); ///< Not implemented
+
+}; // Query
+
+// End of file
@@ -0,0 +1,10 @@
+#pragma once
+
+namespace geomodelgrids {
+    namespace parallel {
+        class Query;
+        class NodeCache;
+    } // parallel
+} // geomodelgrids
+
+// End of file
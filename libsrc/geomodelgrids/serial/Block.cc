@@ -5,17 +5,24 @@
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
 #include "geomodelgrids/serial/Hyperslab.hh" // USES Hyperslab
 #include "geomodelgrids/utils/Indexing.hh" // USES Indexing
+#include "geomodelgrids/utils/constants.hh" // USES TOLERANCE, NODATA_VALUE
 
 #include <cstring> // USES strlen()
-#include <algorithm> // USES std::max()
+#include <cstdlib> // USES strtoul()
+#include <cmath> // USES floor(), ceil()
+#include <algorithm> // USES std::max(), std::sort(), std::find(), std::fill()
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
+#include <limits> // USES std::numeric_limits
 #include <cassert> // USES assert()
 
 // ------------------------------------------------------------------------------------------------
 // Default constructor.
 geomodelgrids::serial::Block::Block(const char* name) :
     _name(name),
+    _path(std::string("blocks/") + name),
+    _level(1),
+    _h5(nullptr),
     _hyperslab(nullptr),
     _resolutionX(0.0),
     _resolutionY(0.0),
@@ -64,129 +71,128 @@ geomodelgrids::serial::Block::loadMetadata(geomodelgrids::serial::HDF5* const h5
     assert(h5);
     delete[] _values;_values = nullptr;
 
-    const std::string& blockPath = std::string("blocks/") + _name;
+    // Coarser levels are stored as datasets named by their factor in the group levels/BLOCK_NAME.
+    _levels.clear();
+    const std::string& levelsPath = std::string("levels/") + _name;
+    if (h5->hasGroup("levels") && h5->hasGroup(levelsPath.c_str())) {
+        std::vector<std::string> names;
+        h5->getGroupDatasets(&names, levelsPath.c_str());
+        for (size_t i = 0; i < names.size(); ++i) {
+            char* end = nullptr;
+            const size_t factor = strtoul(names[i].c_str(), &end, 10);
+            if (!*end && (factor > 1)) {
+                _levels.push_back(factor);
+            } // if
+        } // for
+        std::sort(_levels.begin(), _levels.end());
+    } // if
 
-    std::ostringstream msg;
-    const char* indent = "            ";
-    bool attributeErrors = false;
+    _level = 1;
+    _path = std::string("blocks/") + _name;
+    _loadGrid(h5, _path);
+} // loadMetadata
 
-    size_t dims[3];
-    if (h5->hasAttribute(blockPath.c_str(), "x_resolution")) {
-        h5->readAttribute(blockPath.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, (void*)&_resolutionX);
-    } else {
-        if (h5->hasAttribute(blockPath.c_str(), "x_coordinates")) {
-            h5->readAttribute(blockPath.c_str(), "x_coordinates", H5T_NATIVE_DOUBLE, (void**)&_coordinatesX, &dims[0]);
-            std::sort(_coordinatesX, _coordinatesX+dims[0], geomodelgrids::utils::IndexingVariable::less);
-        } else {
-            msg << indent << "    /" << blockPath << "/x_resolution or /" << blockPath << "/x_coordinates\n";
-            attributeErrors = true;
-        } // if/else
-    } // if/else
 
-    if (h5->hasAttribute(blockPath.c_str(), "y_resolution")) {
-        h5->readAttribute(blockPath.c_str(), "y_resolution", H5T_NATIVE_DOUBLE, (void*)&_resolutionY);
-    } else {
-        if (h5->hasAttribute(blockPath.c_str(), "y_coordinates")) {
-            h5->readAttribute(blockPath.c_str(), "y_coordinates", H5T_NATIVE_DOUBLE, (void**)&_coordinatesY, &dims[1]);
-            std::sort(_coordinatesY, _coordinatesY+dims[1], geomodelgrids::utils::IndexingVariable::less);
-        } else {
-            msg << indent << "    /" << blockPath << "/y_resolution or /" << blockPath << "/y_coordinates\n";
-            attributeErrors = true;
-        } // if/else
-    } // if/else
+// ------------------------------------------------------------------------------------------------
+// Get name of block.
+const std::string&
+geomodelgrids::serial::Block::getName(void) const {
+    return _name;
+} // getName
 
-    if (h5->hasAttribute(blockPath.c_str(), "z_resolution")) {
-        h5->readAttribute(blockPath.c_str(), "z_resolution", H5T_NATIVE_DOUBLE, (void*)&_resolutionZ);
-    } else {
-        if (h5->hasAttribute(blockPath.c_str(), "z_coordinates")) {
-            h5->readAttribute(blockPath.c_str(), "z_coordinates", H5T_NATIVE_DOUBLE, (void**)&_coordinatesZ, &dims[2]);
-            std::sort(_coordinatesZ, _coordinatesZ+dims[2], geomodelgrids::utils::IndexingVariable::greater);
-        } else {
-            msg << indent << "    /" << blockPath << "/z_resolution or /" << blockPath << "/z_coordinates\n";
-            attributeErrors = true;
-        } // if/else
-    } // if/else
 
-    if (h5->hasAttribute(blockPath.c_str(), "z_resolution")) {
-        if (h5->hasAttribute(blockPath.c_str(), "z_top")) {
-            h5->readAttribute(blockPath.c_str(), "z_top", H5T_NATIVE_DOUBLE, (void*)&_zTop);
-        } else {
-            msg << indent << "    " << blockPath << "/z_top\n";
-            attributeErrors = true;
-        } // if/else
-    } else if (h5->hasAttribute(blockPath.c_str(), "z_coordinates")) {
-        assert(_coordinatesZ);
-        _zTop = _coordinatesZ[0];
-    } // if/else
+// ------------------------------------------------------------------------------------------------
+// Get path of dataset with values used for queries.
+const std::string&
+geomodelgrids::serial::Block::getPath(void) const {
+    return _path;
+} // getPath
 
-    hsize_t* hdims = nullptr;
-    int ndims = 0;
-    h5->getDatasetDims(&hdims, &ndims, blockPath.c_str());
-    assert(4 == ndims);
-    for (int i = 0; i < 3; ++i) {
-        _dims[i] = hdims[i];
-    } // for
 
-    if (0 == _hyperslabDims[2]) {
-        _hyperslabDims[2] = hdims[2];
-    } // if
-    if (0 == _hyperslabDims[3]) {
-        _hyperslabDims[3] = hdims[3];
-    } // if
+// ------------------------------------------------------------------------------------------------
+// Get factors of coarser levels stored in the model.
+const std::vector<size_t>&
+geomodelgrids::serial::Block::getLevels(void) const {
+    return _levels;
+} // getLevels
 
-    _numValues = hdims[3];
-    delete[] hdims;hdims = nullptr;
 
-    // Check to make sure dimensions of block match coordinates (if provided).
-    if (_coordinatesX && (dims[0] != _dims[0])) {
-        msg << indent << "    x dimension of block " << blockPath << " (" << _dims[0]
-            << ") does not match number of x coordinates (" << dims[0] << ").\n";
-        attributeErrors = true;
-    } // if
-    if (_coordinatesY && (dims[1] != _dims[1])) {
-        msg << indent << "    y dimension of block " << blockPath << " (" << _dims[1]
-            << ") does not match number of x coordinates (" << dims[1] << ").\n";
-        attributeErrors = true;
-    } // if
-    if (_coordinatesZ && (dims[2] != _dims[2])) {
-        msg << indent << "    z dimension of block " << blockPath << " (" << _dims[2]
-            << ") does not match number of x coordinates (" << dims[2] << ").\n";
-        attributeErrors = true;
+// ------------------------------------------------------------------------------------------------
+// Get factor of level used for queries.
+size_t
+geomodelgrids::serial::Block::getLevel(void) const {
+    return _level;
+} // getLevel
+
+
+// ------------------------------------------------------------------------------------------------
+// Use coarser level for queries.
+void
+geomodelgrids::serial::Block::setLevel(geomodelgrids::serial::HDF5* const h5,
+                                       const size_t factor) {
+    assert(h5);
+    if (( factor != 1) && ( std::find(_levels.begin(), _levels.end(), factor) == _levels.end()) ) {
+        std::ostringstream msg;
+        msg << "Block '" << _name << "' does not have a level with factor " << factor << ".";
+        throw std::invalid_argument(msg.str());
     } // if
 
-    if (attributeErrors) { throw std::runtime_error(msg.str().c_str()); }
+    delete _hyperslab;_hyperslab = nullptr;
 
-    delete _indexingX;_indexingX = nullptr;
-    delete _indexingY;_indexingY = nullptr;
-    delete _indexingZ;_indexingZ = nullptr;
-    if (!_coordinatesX) {
-        _indexingX = new geomodelgrids::utils::IndexingUniform(_resolutionX);
+    std::ostringstream path;
+    if (1 == factor) {
+        path << "blocks/" << _name;
     } else {
-        assert(_coordinatesX);
-        _indexingX = new geomodelgrids::utils::IndexingVariable(_coordinatesX, _dims[0]);
-    } // if/else
-    if (!_coordinatesY) {
-        _indexingY = new geomodelgrids::utils::IndexingUniform(_resolutionY);
-    } else {
-        assert(_coordinatesY);
-        _indexingY = new geomodelgrids::utils::IndexingVariable(_coordinatesY, _dims[1]);
-    } // if/else
-    if (!_coordinatesZ) {
-        _indexingZ = new geomodelgrids::utils::IndexingUniform(_resolutionZ);
-    } else {
-        assert(_coordinatesZ);
-        _indexingZ = new geomodelgrids::utils::IndexingVariable(_coordinatesZ, _dims[2],
-                                                                geomodelgrids::utils::IndexingVariable::DESCENDING);
+        path << "levels/" << _name << "/" << factor;
     } // if/else
-} // loadMetadata
+    _level = factor;
+    _path = path.str();
+    _loadGrid(h5, _path);
+} // setLevel
 
 
 // ------------------------------------------------------------------------------------------------
-// Get name of block.
-const std::string&
-geomodelgrids::serial::Block::getName(void) const {
-    return _name;
-} // getName
+// Use coarsest level with horizontal resolution at least as fine as target resolution.
+void
+geomodelgrids::serial::Block::setTargetResolution(geomodelgrids::serial::HDF5* const h5,
+                                                  const double resolution) {
+    size_t factor = 1;
+    if (resolution > 0.0) {
+        for (std::vector<size_t>::const_reverse_iterator iter = _levels.rbegin(); iter != _levels.rend(); ++iter) {
+            setLevel(h5, *iter);
+            if (getResolutionHoriz() <= resolution * (1.0 + geomodelgrids::TOLERANCE)) {
+                factor = *iter;
+                break;
+            } // if
+        } // for
+    } // if
+
+    if (factor != _level) {
+        setLevel(h5, factor);
+    } // if
+} // setTargetResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Get horizontal resolution of grid.
+double
+geomodelgrids::serial::Block::getResolutionHoriz(void) const {
+    const double resolution[2] = { _resolutionX, _resolutionY };
+    const double* coordinates[2] = { _coordinatesX, _coordinatesY };
+
+    double resolutionHoriz = 0.0;
+    for (size_t i = 0; i < 2; ++i) {
+        if (coordinates[i]) {
+            for (size_t j = 1; j < _dims[i]; ++j) {
+                resolutionHoriz = std::max(resolutionHoriz, fabs(coordinates[i][j] - coordinates[i][j-1]));
+            } // for
+        } else {
+            resolutionHoriz = std::max(resolutionHoriz, resolution[i]);
+        } // if/else
+    } // for
+
+    return resolutionHoriz;
+} // getResolutionHoriz
 
 
 // ------------------------------------------------------------------------------------------------
@@ -299,19 +305,128 @@ geomodelgrids::serial::Block::setHyperslabDims(const size_t dims[],
 // ------------------------------------------------------------------------------------------------
 // Prepare for querying.
 void
-geomodelgrids::serial::Block::openQuery(geomodelgrids::serial::HDF5* const h5) {
-    const size_t ndims = 4;
-    hsize_t dims[ndims];
-    for (size_t i = 0; i < ndims; ++i) {
-        dims[i] = _hyperslabDims[i];
-    } // for
-    const std::string blockPath(std::string("/blocks/") + _name);
-    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, blockPath.c_str(), dims, ndims);
+geomodelgrids::serial::Block::openQuery(geomodelgrids::serial::HDF5* const h5,
+                                        const std::vector<size_t>& valueIndices) {
+    _h5 = h5;
+    _valueIndices = valueIndices;
+    delete _hyperslab;_hyperslab = nullptr;
 
+    // Values that are not selected are never set by queries.
     delete[] _values;_values = (_numValues > 0) ? new double[_numValues] : nullptr;
+    std::fill(_values, _values+_numValues, geomodelgrids::NODATA_VALUE);
 } // openQuery
 
 
+// ------------------------------------------------------------------------------------------------
+// Load values for horizontal region of block.
+void
+geomodelgrids::serial::Block::loadRegion(const double xMin,
+                                         const double xMax,
+                                         const double yMin,
+                                         const double yMax,
+                                         const hid_t datasetTransfer) {
+    const double zUnbounded = std::numeric_limits<double>::max();
+    loadRegion(xMin, xMax, yMin, yMax, -zUnbounded, +zUnbounded, datasetTransfer);
+} // loadRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Load values for region of block bounded in all three dimensions.
+void
+geomodelgrids::serial::Block::loadRegion(const double xMin,
+                                         const double xMax,
+                                         const double yMin,
+                                         const double yMax,
+                                         const double zMin,
+                                         const double zMax,
+                                         const hid_t datasetTransfer) {
+    if (!_h5) {
+        std::ostringstream msg;
+        msg << "Cannot load region of block '" << _name << "'. Block not opened for querying.";
+        throw std::logic_error(msg.str());
+    } // if
+    assert(_indexingX);
+    assert(_indexingY);
+    assert(_indexingZ);
+
+    const size_t spaceDim = 3;
+    hsize_t origin[spaceDim] = { 0, 0, 0 };
+    hsize_t dims[spaceDim] = { 0, 0, 0 };
+
+    // Indexing along the z axis uses depth below the top of the block.
+    const double coordMin[spaceDim] = { xMin, yMin, _zTop - zMax };
+    const double coordMax[spaceDim] = { xMax, yMax, _zTop - zMin };
+    const double extent[spaceDim] = {
+        _coordinatesX ? _coordinatesX[_dims[0]-1] - _coordinatesX[0] : _resolutionX * (_dims[0]-1),
+        _coordinatesY ? _coordinatesY[_dims[1]-1] - _coordinatesY[0] : _resolutionY * (_dims[1]-1),
+        _zTop - getZBottom(),
+    };
+    const geomodelgrids::utils::Indexing* indexing[spaceDim] = { _indexingX, _indexingY, _indexingZ };
+    for (size_t i = 0; i < spaceDim; ++i) {
+        if (( coordMin[i] > coordMax[i]) || ( coordMax[i] < 0.0) || ( coordMin[i] > extent[i]) ) {
+            dims[0] = dims[1] = dims[2] = 0;
+            break;
+        } // if
+        const double indexMin = indexing[i]->getIndex(std::max(0.0, coordMin[i]));
+        const double indexMax = indexing[i]->getIndex(std::min(extent[i], coordMax[i]));
+        hsize_t iMin = std::min(hsize_t(std::max(0.0, std::floor(indexMin))), hsize_t(_dims[i]-1));
+        hsize_t iMax = std::min(hsize_t(std::max(0.0, std::ceil(indexMax))), hsize_t(_dims[i]-1));
+        // Region needs at least two points along each dimension for interpolation.
+        if (iMax == iMin) {
+            if (iMax+1 < _dims[i]) {
+                ++iMax;
+            } else if (iMin > 0) {
+                --iMin;
+            } // if/else
+        } // if
+        origin[i] = iMin;
+        dims[i] = iMax - iMin + 1;
+    } // for
+
+    _getHyperslab()->loadRegion(origin, dims, datasetTransfer);
+} // loadRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values for a range of x indices.
+void
+geomodelgrids::serial::Block::readValues(double* const values,
+                                         const size_t xOrigin,
+                                         const size_t numX,
+                                         const hid_t datasetTransfer) {
+    if (!_h5) {
+        std::ostringstream msg;
+        msg << "Cannot read values of block '" << _name << "'. Block not opened for querying.";
+        throw std::logic_error(msg.str());
+    } // if
+
+    const size_t spaceDim = 3;
+    const hsize_t origin[spaceDim] = { xOrigin, 0, 0 };
+    const hsize_t dims[spaceDim] = { numX, _dims[1], _dims[2] };
+    _getHyperslab()->readValues(values, origin, dims, datasetTransfer);
+} // readValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Use values for the entire block stored in external memory for queries.
+void
+geomodelgrids::serial::Block::setValues(const double* values) {
+    if (!_h5) {
+        std::ostringstream msg;
+        msg << "Cannot set values of block '" << _name << "'. Block not opened for querying.";
+        throw std::logic_error(msg.str());
+    } // if
+    if (!values && !_hyperslab) {
+        return;
+    } // if
+
+    const size_t spaceDim = 3;
+    const hsize_t origin[spaceDim] = { 0, 0, 0 };
+    const hsize_t dims[spaceDim] = { _dims[0], _dims[1], _dims[2] };
+    _getHyperslab()->setRegion(origin, dims, values);
+} // setValues
+
+
 // ------------------------------------------------------------------------------------------------
 // Query for values at a point using bilinear interpolation.
 const double*
@@ -331,13 +446,47 @@ geomodelgrids::serial::Block::query(const double x,
     index[1] = _indexingY->getIndex(y);
     index[2] = _indexingZ->getIndex(_zTop - z);
 
+    return queryIndex(index);
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Get floating point index of a coordinate along one axis of the block.
+double
+geomodelgrids::serial::Block::getIndex(const size_t axis,
+                                       const double coordinate) const {
+    double index = 0.0;
+    switch (axis) {
+    case 0:
+        assert(_indexingX);
+        index = _indexingX->getIndex(coordinate);
+        break;
+    case 1:
+        assert(_indexingY);
+        index = _indexingY->getIndex(coordinate);
+        break;
+    case 2:
+        assert(_indexingZ);
+        index = _indexingZ->getIndex(_zTop - coordinate);
+        break;
+    default:
+        throw std::logic_error("Unknown axis for block index.");
+    } // switch
+
+    return index;
+} // getIndex
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values at a point given its index using bilinear interpolation.
+const double*
+geomodelgrids::serial::Block::queryIndex(const double index[3]) {
     assert( (_numValues > 0 && _values) || (!_numValues && !_values) );
 
-    assert(_hyperslab);
-    _hyperslab->interpolate(_values, index);
+    _getHyperslab()->interpolate(_values, index);
 
     return _values;
-} // query
+} // queryIndex
 
 
 // ------------------------------------------------------------------------------------------------
@@ -345,6 +494,8 @@ geomodelgrids::serial::Block::query(const double x,
 void
 geomodelgrids::serial::Block::closeQuery(void) {
     delete _hyperslab;_hyperslab = nullptr;
+    _h5 = nullptr;
+    _valueIndices.clear();
     delete[] _values;_values = nullptr;
 } // closeQuery
 
@@ -360,4 +511,165 @@ geomodelgrids::serial::Block::compare(const std::shared_ptr<Block>& a,
 } // compare
 
 
+// ------------------------------------------------------------------------------------------------
+// Load resolution, coordinates, and dimensions of grid.
+void
+geomodelgrids::serial::Block::_loadGrid(geomodelgrids::serial::HDF5* const h5,
+                                        const std::string& blockPath) {
+    assert(h5);
+
+    delete[] _coordinatesX;_coordinatesX = nullptr;
+    delete[] _coordinatesY;_coordinatesY = nullptr;
+    delete[] _coordinatesZ;_coordinatesZ = nullptr;
+    _resolutionX = 0.0;
+    _resolutionY = 0.0;
+    _resolutionZ = 0.0;
+
+    std::ostringstream msg;
+    const char* indent = "            ";
+    bool attributeErrors = false;
+
+    size_t dims[3];
+    if (h5->hasAttribute(blockPath.c_str(), "x_resolution")) {
+        h5->readAttribute(blockPath.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, (void*)&_resolutionX);
+    } else {
+        if (h5->hasAttribute(blockPath.c_str(), "x_coordinates")) {
+            h5->readAttribute(blockPath.c_str(), "x_coordinates", H5T_NATIVE_DOUBLE, (void**)&_coordinatesX, &dims[0]);
+            std::sort(_coordinatesX, _coordinatesX+dims[0], geomodelgrids::utils::IndexingVariable::less);
+        } else {
+            msg << indent << "    /" << blockPath << "/x_resolution or /" << blockPath << "/x_coordinates\n";
+            attributeErrors = true;
+        } // if/else
+    } // if/else
+
+    if (h5->hasAttribute(blockPath.c_str(), "y_resolution")) {
+        h5->readAttribute(blockPath.c_str(), "y_resolution", H5T_NATIVE_DOUBLE, (void*)&_resolutionY);
+    } else {
+        if (h5->hasAttribute(blockPath.c_str(), "y_coordinates")) {
+            h5->readAttribute(blockPath.c_str(), "y_coordinates", H5T_NATIVE_DOUBLE, (void**)&_coordinatesY, &dims[1]);
+            std::sort(_coordinatesY, _coordinatesY+dims[1], geomodelgrids::utils::IndexingVariable::less);
+        } else {
+            msg << indent << "    /" << blockPath << "/y_resolution or /" << blockPath << "/y_coordinates\n";
+            attributeErrors = true;
+        } // if/else
+    } // if/else
+
+    if (h5->hasAttribute(blockPath.c_str(), "z_resolution")) {
+        h5->readAttribute(blockPath.c_str(), "z_resolution", H5T_NATIVE_DOUBLE, (void*)&_resolutionZ);
+    } else {
+        if (h5->hasAttribute(blockPath.c_str(), "z_coordinates")) {
+            h5->readAttribute(blockPath.c_str(), "z_coordinates", H5T_NATIVE_DOUBLE, (void**)&_coordinatesZ, &dims[2]);
+            std::sort(_coordinatesZ, _coordinatesZ+dims[2], geomodelgrids::utils::IndexingVariable::greater);
+        } else {
+            msg << indent << "    /" << blockPath << "/z_resolution or /" << blockPath << "/z_coordinates\n";
+            attributeErrors = true;
+        } // if/else
+    } // if/else
+
+    if (h5->hasAttribute(blockPath.c_str(), "z_resolution")) {
+        if (h5->hasAttribute(blockPath.c_str(), "z_top")) {
+            h5->readAttribute(blockPath.c_str(), "z_top", H5T_NATIVE_DOUBLE, (void*)&_zTop);
+        } else {
+            msg << indent << "    " << blockPath << "/z_top\n";
+            attributeErrors = true;
+        } // if/else
+    } else if (h5->hasAttribute(blockPath.c_str(), "z_coordinates")) {
+        assert(_coordinatesZ);
+        _zTop = _coordinatesZ[0];
+    } // if/else
+
+    // Values are the last dimension (interleaved layout) or the leading dimension (planar layout).
+    bool isPlanar = false;
+    if (h5->hasAttribute(blockPath.c_str(), "value_layout")) {
+        const std::string& layout = h5->readAttribute(blockPath.c_str(), "value_layout");
+        if (layout == "planar") {
+            isPlanar = true;
+        } else if (layout != "interleaved") {
+            msg << indent << "    Unknown value layout '" << layout << "' for block " << blockPath << ".\n";
+            attributeErrors = true;
+        } // if/else
+    } // if
+
+    hsize_t* hdims = nullptr;
+    int ndims = 0;
+    h5->getDatasetDims(&hdims, &ndims, blockPath.c_str());
+    assert(4 == ndims);
+    const size_t xDim = isPlanar ? 1 : 0;
+    const size_t valueDim = isPlanar ? 0 : 3;
+    for (int i = 0; i < 3; ++i) {
+        _dims[i] = hdims[xDim+i];
+    } // for
+
+    if (0 == _hyperslabDims[2]) {
+        _hyperslabDims[2] = _dims[2];
+    } // if
+    if (0 == _hyperslabDims[3]) {
+        _hyperslabDims[3] = hdims[valueDim];
+    } // if
+
+    _numValues = hdims[valueDim];
+    delete[] hdims;hdims = nullptr;
+
+    // Check to make sure dimensions of block match coordinates (if provided).
+    if (_coordinatesX && (dims[0] != _dims[0])) {
+        msg << indent << "    x dimension of block " << blockPath << " (" << _dims[0]
+            << ") does not match number of x coordinates (" << dims[0] << ").\n";
+        attributeErrors = true;
+    } // if
+    if (_coordinatesY && (dims[1] != _dims[1])) {
+        msg << indent << "    y dimension of block " << blockPath << " (" << _dims[1]
+            << ") does not match number of x coordinates (" << dims[1] << ").\n";
+        attributeErrors = true;
+    } // if
+    if (_coordinatesZ && (dims[2] != _dims[2])) {
+        msg << indent << "    z dimension of block " << blockPath << " (" << _dims[2]
+            << ") does not match number of x coordinates (" << dims[2] << ").\n";
+        attributeErrors = true;
+    } // if
+
+    if (attributeErrors) { throw std::runtime_error(msg.str().c_str()); }
+
+    delete _indexingX;_indexingX = nullptr;
+    delete _indexingY;_indexingY = nullptr;
+    delete _indexingZ;_indexingZ = nullptr;
+    if (!_coordinatesX) {
+        _indexingX = new geomodelgrids::utils::IndexingUniform(_resolutionX);
+    } else {
+        assert(_coordinatesX);
+        _indexingX = new geomodelgrids::utils::IndexingVariable(_coordinatesX, _dims[0]);
+    } // if/else
+    if (!_coordinatesY) {
+        _indexingY = new geomodelgrids::utils::IndexingUniform(_resolutionY);
+    } else {
+        assert(_coordinatesY);
+        _indexingY = new geomodelgrids::utils::IndexingVariable(_coordinatesY, _dims[1]);
+    } // if/else
+    if (!_coordinatesZ) {
+        _indexingZ = new geomodelgrids::utils::IndexingUniform(_resolutionZ);
+    } else {
+        assert(_coordinatesZ);
+        _indexingZ = new geomodelgrids::utils::IndexingVariable(_coordinatesZ, _dims[2],
+                                                                geomodelgrids::utils::IndexingVariable::DESCENDING);
+    } // if/else
+} // _loadGrid
+
+
+// ------------------------------------------------------------------------------------------------
+// Get hyperslab for querying, creating it on first access.
+geomodelgrids::serial::Hyperslab*
+geomodelgrids::serial::Block::_getHyperslab(void) {
+    if (!_hyperslab) {
+        assert(_h5);
+        const size_t ndims = 4;
+        hsize_t dims[ndims];
+        for (size_t i = 0; i < ndims; ++i) {
+            dims[i] = _hyperslabDims[i];
+        } // for
+        _hyperslab = new geomodelgrids::serial::Hyperslab(_h5, _path.c_str(), dims, ndims, _valueIndices);
+    } // if
+
+    return _hyperslab;
+} // _getHyperslab
+
+
 // End of file
@@ -6,6 +6,7 @@
 
 #include "geomodelgrids/utils/utilsfwd.hh" // forward declarations
 
+#include <hdf5.h> // USES hid_t
 #include <memory> // HASA std::std::vector
 #include <vector> // HASA std::std::vector
 #include <string> // HASA std::string
@@ -37,6 +38,53 @@ public:
      */
     const std::string& getName(void) const;
 
+    /** Get path of dataset with values used for queries.
+     *
+     * @returns Path of dataset for block (full resolution) or selected level.
+     */
+    const std::string& getPath(void) const;
+
+    /** Get factors of coarser levels stored in the model.
+     *
+     * @returns Array of factors in ascending order (empty if model does not have coarser levels).
+     */
+    const std::vector<size_t>& getLevels(void) const;
+
+    /** Get factor of level used for queries.
+     *
+     * @returns Factor of level (1 for full resolution).
+     */
+    size_t getLevel(void) const;
+
+    /** Use coarser level for queries.
+     *
+     * The resolution, coordinates, and dimensions of the block become those of the level. Any
+     * values loaded or set for the block are discarded. Call BEFORE openQuery() or loadRegion().
+     *
+     * @param[in] h5 HDF5 with model.
+     * @param[in] factor Factor of level (1 for full resolution).
+     */
+    void setLevel(geomodelgrids::serial::HDF5* const h5,
+                  const size_t factor);
+
+    /** Use coarsest level with horizontal resolution at least as fine as target resolution.
+     *
+     * Uses the full resolution block if no level is fine enough.
+     *
+     * @param[in] h5 HDF5 with model.
+     * @param[in] resolution Target horizontal resolution (m) (<= 0 for full resolution).
+     */
+    void setTargetResolution(geomodelgrids::serial::HDF5* const h5,
+                             const double resolution);
+
+    /** Get horizontal resolution of grid.
+     *
+     * For variable resolution, the largest spacing between coordinates is used.
+     *
+     * @returns Largest resolution along x and y axes.
+     */
+    double getResolutionHoriz(void) const;
+
     /** Get resolution along x axis.
      *
      * @returns Resolution along x axis.
@@ -106,10 +154,84 @@ public:
                           const size_t ndims);
 
     /** Prepare for querying.
+     *
+     * The hyperslab for the block is created on the first query or region request.
+     *
+     * Queries and loaded regions contain only the selected values; the other values returned by
+     * query() are NODATA_VALUE.
      *
      * @param[in] h5 HDF5 with model.
+     * @param[in] valueIndices Indices of values at a point to query (empty for all values).
+     */
+    void openQuery(geomodelgrids::serial::HDF5* const h5,
+                   const std::vector<size_t>& valueIndices=std::vector<size_t>());
+
+    /** Load values for horizontal region of block.
+     *
+     * The region spans the entire block in the z direction. Queries for points in the region do
+     * not read from the model file. Must be called AFTER openQuery().
+     *
+     * An empty region (xMin > xMax or yMin > yMax) clears the region. With a collective dataset
+     * transfer property list, all processes must call this method, including those with empty
+     * regions.
+     *
+     * @param[in] xMin Minimum x coordinate of region in model coordinate system.
+     * @param[in] xMax Maximum x coordinate of region in model coordinate system.
+     * @param[in] yMin Minimum y coordinate of region in model coordinate system.
+     * @param[in] yMax Maximum y coordinate of region in model coordinate system.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
      */
-    void openQuery(geomodelgrids::serial::HDF5* const h5);
+    void loadRegion(const double xMin,
+                    const double xMax,
+                    const double yMin,
+                    const double yMax,
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Load values for region of block bounded in all three dimensions.
+     *
+     * Same as loadRegion() for a horizontal region, but only the portion of the block between
+     * zMin and zMax is loaded. A block that does not overlap the z range gets an empty region.
+     *
+     * @param[in] xMin Minimum x coordinate of region in model coordinate system.
+     * @param[in] xMax Maximum x coordinate of region in model coordinate system.
+     * @param[in] yMin Minimum y coordinate of region in model coordinate system.
+     * @param[in] yMax Maximum y coordinate of region in model coordinate system.
+     * @param[in] zMin Minimum z coordinate of region in model coordinate system.
+     * @param[in] zMax Maximum z coordinate of region in model coordinate system.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void loadRegion(const double xMin,
+                    const double xMax,
+                    const double yMin,
+                    const double yMax,
+                    const double zMin,
+                    const double zMax,
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Read values for a range of x indices over the entire y and z extent.
+     *
+     * The values are read into a caller-supplied buffer and the block is not modified. Must be
+     * called AFTER openQuery().
+     *
+     * @param[out] values Preallocated array for values.
+     * @param[in] xOrigin Index of first point in x direction.
+     * @param[in] numX Number of points in x direction.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void readValues(double* const values,
+                    const size_t xOrigin,
+                    const size_t numX,
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Use values for the entire block stored in external memory for queries.
+     *
+     * The block does not take ownership of the values, which must remain valid until closeQuery()
+     * (for example, values in MPI shared memory). Queries do not read from the model file. Must be
+     * called AFTER openQuery(). Passing nullptr clears the values.
+     *
+     * @param[in] values Values for entire block in the same layout as the model file.
+     */
+    void setValues(const double* values);
 
     /** Query for values at a point using bilinear interpolation.
      *
@@ -122,6 +244,25 @@ public:
                         const double y,
                         const double z);
 
+    /** Get floating point index of a coordinate along one axis of the block.
+     *
+     * Computing the indices along each axis separately allows them to be reused for points on a
+     * structured grid.
+     *
+     * @param[in] axis Coordinate axis (0=x, 1=y, 2=z).
+     * @param[in] coordinate Coordinate along axis in model coordinate system.
+     * @returns Index of coordinate along axis.
+     */
+    double getIndex(const size_t axis,
+                    const double coordinate) const;
+
+    /** Query for values at a point given its index using bilinear interpolation.
+     *
+     * @param[in] index Floating point index of point [x, y, z] (from getIndex()).
+     * @returns Value of model at specified point.
+     */
+    const double* queryIndex(const double index[3]);
+
     // Cleanup after querying.
     void closeQuery(void);
 
@@ -135,11 +276,36 @@ public:
     bool compare(const std::shared_ptr<Block>& a,
                  const std::shared_ptr<Block>& b);
 
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Load resolution, coordinates, and dimensions of grid.
+     *
+     * @param[in] h5 HDF5 with model.
+     * @param[in] path Path of dataset with grid.
+     */
+    void _loadGrid(geomodelgrids::serial::HDF5* const h5,
+                   const std::string& path);
+
+    /** Get hyperslab for querying, creating it on first access.
+     *
+     * The hyperslab (and its buffer and dataset handle) is not created by openQuery(), so blocks
+     * that are never queried do not use any memory for values or read from the model file.
+     *
+     * @returns Hyperslab for block.
+     */
+    geomodelgrids::serial::Hyperslab* _getHyperslab(void);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
     std::string _name; ///< Name of block.
-    geomodelgrids::serial::Hyperslab* _hyperslab; ///< Hyperslab of data in model.
+    std::string _path; ///< Path of dataset with values used for queries.
+    std::vector<size_t> _levels; ///< Factors of coarser levels stored in model.
+    size_t _level; ///< Factor of level used for queries (1 for full resolution).
+    geomodelgrids::serial::HDF5* _h5; ///< HDF5 file with model (set by openQuery()).
+    std::vector<size_t> _valueIndices; ///< Indices of values to query (set by openQuery()).
+    geomodelgrids::serial::Hyperslab* _hyperslab; ///< Hyperslab of data in model (created on first access).
     double _resolutionX; ///< Resolution along x axis.
     double _resolutionY; ///< Resolution along y axis.
     double _resolutionZ; ///< Resolution along z axis.
@@ -2,7 +2,11 @@
 
 #include "HDF5.hh" // implementation of class methods
 
+#include <mutex> // USES std::recursive_mutex, std::mutex
+#include <map> // USES std::map
+#include <algorithm> // USES std::copy()
 #include <cstring> // USES strlen()
+#include <cstdlib> // USES strtod(), strtoul()
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
 #include <cassert> // USES assert()
@@ -17,6 +21,30 @@
 
 const hid_t geomodelgrids::serial::HDF5::H5_NULL = -1;
 
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        namespace _HDF5 {
+#if !defined(H5_HAVE_THREADSAFE)
+            /** Get mutex serializing calls to HDF5 library.
+             *
+             * @returns Mutex for HDF5 library.
+             */
+            static
+            std::recursive_mutex&
+            getMutex(void) {
+                static std::recursive_mutex mutex;
+                return mutex;
+            } // getMutex
+
+#endif
+
+            static const char* const snapshotName = "metadata_snapshot"; ///< Name of snapshot attribute.
+            static const char* const snapshotVersion = "geomodelgrids-metadata-1"; ///< Snapshot format.
+        } // _HDF5
+    } // serial
+} // geomodelgrids
+
 // ------------------------------------------------------------------------------------------------
 namespace geomodelgrids {
     namespace serial {
@@ -51,19 +79,234 @@ struct geomodelgrids::serial::_HDF5Access {
 
 };
 
+// ------------------------------------------------------------------------------------------------
+struct geomodelgrids::serial::_HDF5Cache {
+    /// Attribute in metadata snapshot.
+    struct Attribute {
+        std::vector<double> values; ///< Numeric values.
+        std::vector<std::string> strings; ///< String values.
+        bool isString; ///< True if attribute has string values.
+    };
+
+    /// Group or dataset in metadata snapshot.
+    struct Object {
+        std::map<std::string, Attribute> attributes; ///< Attributes of object.
+        std::vector<hsize_t> dims; ///< Dimensions of dataset.
+        bool isDataset; ///< True if object is a dataset.
+
+        Object(void) :
+            isDataset(false) {}
+
+    };
+
+    /// Open dataset.
+    struct Dataset {
+        hid_t dataset; ///< Dataset handle.
+        hid_t dataspace; ///< Dataspace of dataset (copied before selecting a hyperslab).
+        std::vector<hsize_t> dims; ///< Dimensions of dataset.
+    };
+
+    std::map<std::string, Object> objects; ///< Objects in metadata snapshot.
+    std::map<std::string, Dataset> datasets; ///< Open datasets.
+    std::mutex datasetsMutex; ///< Mutex for open datasets (HDF5 lock is empty with thread-safe HDF5).
+
+    /** Get path without leading and trailing slashes, so "/" and "" refer to the root group.
+     *
+     * @param[in] path Path of object.
+     * @returns Normalized path.
+     */
+    static
+    std::string normalize(const char* path) {
+        std::string value(path ? path : "");
+        const size_t first = value.find_first_not_of('/');
+        if (first == std::string::npos) {
+            return std::string();
+        } // if
+        const size_t last = value.find_last_not_of('/');
+        return value.substr(first, last-first+1);
+    } // normalize
+
+    /** Get object in metadata snapshot.
+     *
+     * @param[in] path Path of object.
+     * @returns Object or nullptr if object is not in snapshot.
+     */
+    const Object* getObject(const char* path) const {
+        std::map<std::string, Object>::const_iterator iter = objects.find(normalize(path));
+        return (iter != objects.end()) ? &iter->second : nullptr;
+    } // getObject
+
+    /** Get attribute in metadata snapshot.
+     *
+     * @param[in] path Path of object with attribute.
+     * @param[in] name Name of attribute.
+     * @returns Attribute or nullptr if attribute is not in snapshot.
+     */
+    const Attribute* getAttribute(const char* path,
+                                  const char* name) const {
+        const Object* object = getObject(path);
+        if (!object) {
+            return nullptr;
+        } // if
+        std::map<std::string, Attribute>::const_iterator iter = object->attributes.find(name);
+        return (iter != object->attributes.end()) ? &iter->second : nullptr;
+    } // getAttribute
+
+    /** Parse metadata snapshot.
+     *
+     * The snapshot is a version string followed by records [path, name, kind, count, values...].
+     * Records with kind 'group' or 'dataset' (values are the dimensions) describe an object; records
+     * with kind 'float' or 'string' describe an attribute of an object.
+     *
+     * @param[in] records Strings in snapshot.
+     * @returns True if snapshot is valid, false otherwise.
+     */
+    bool parse(const std::vector<std::string>& records) {
+        objects.clear();
+        if (records.empty() || (records[0] != _HDF5::snapshotVersion)) {
+            return false;
+        } // if
+
+        const size_t numRecords = records.size();
+        for (size_t i = 1; i < numRecords;) {
+            if (i + 4 > numRecords) {
+                objects.clear();
+                return false;
+            } // if
+            const std::string& path = normalize(records[i].c_str());
+            const std::string& name = records[i+1];
+            const std::string& kind = records[i+2];
+            char* end = nullptr;
+            const size_t count = strtoul(records[i+3].c_str(), &end, 10);
+            if (*end || (i + 4 + count > numRecords)) {
+                objects.clear();
+                return false;
+            } // if
+            const std::string* values = &records[i+4];
+            i += 4 + count;
+
+            Object& object = objects[path];
+            if (kind == "group") {
+                object.isDataset = false;
+            } else if (kind == "dataset") {
+                object.isDataset = true;
+                object.dims.resize(count);
+                for (size_t iValue = 0; iValue < count; ++iValue) {
+                    object.dims[iValue] = strtoul(values[iValue].c_str(), &end, 10);
+                    if (*end) {
+                        objects.clear();
+                        return false;
+                    } // if
+                } // for
+            } else if (kind == "float") {
+                Attribute& attribute = object.attributes[name];
+                attribute.isString = false;
+                attribute.values.resize(count);
+                for (size_t iValue = 0; iValue < count; ++iValue) {
+                    attribute.values[iValue] = strtod(values[iValue].c_str(), &end);
+                    if (*end) {
+                        objects.clear();
+                        return false;
+                    } // if
+                } // for
+            } else if (kind == "string") {
+                Attribute& attribute = object.attributes[name];
+                attribute.isString = true;
+                attribute.strings.assign(values, values + count);
+            } else {
+                objects.clear();
+                return false;
+            } // if/else
+        } // for
+
+        return true;
+    } // parse
+
+    /** Get open dataset, opening it on first access.
+     *
+     * @param[in] file HDF5 file.
+     * @param[in] path Path of dataset.
+     * @returns Open dataset.
+     */
+    Dataset getDataset(hid_t file,
+                       const char* path) {
+        std::lock_guard<std::mutex> lock(datasetsMutex);
+        const std::string& key = normalize(path);
+        std::map<std::string, Dataset>::const_iterator iter = datasets.find(key);
+        if (iter != datasets.end()) {
+            return iter->second;
+        } // if
+
+        _HDF5Access h5access;
+        h5access.dataset = H5Dopen2(file, path, H5P_DEFAULT);
+        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
+
+        h5access.dataspace = H5Dget_space(h5access.dataset);
+        if (h5access.dataspace < 0) { throw std::runtime_error("Could not get dataspace."); }
+
+        Dataset dataset;
+        const int ndims = H5Sget_simple_extent_ndims(h5access.dataspace);
+        dataset.dims.resize((ndims > 0) ? ndims : 0);
+        H5Sget_simple_extent_dims(h5access.dataspace, dataset.dims.data(), nullptr);
+
+        dataset.dataset = h5access.dataset;h5access.dataset = HDF5::H5_NULL;
+        dataset.dataspace = h5access.dataspace;h5access.dataspace = HDF5::H5_NULL;
+        datasets[key] = dataset;
+
+        return dataset;
+    } // getDataset
+
+    /// Close open datasets and clear metadata snapshot.
+    void clear(void) {
+        std::lock_guard<std::mutex> lock(datasetsMutex);
+        for (std::map<std::string, Dataset>::iterator iter = datasets.begin(); iter != datasets.end(); ++iter) {
+            H5Sclose(iter->second.dataspace);
+            H5Dclose(iter->second.dataset);
+        } // for
+        datasets.clear();
+        objects.clear();
+    } // clear
+
+};
+
+// ------------------------------------------------------------------------------------------------
+// Acquire lock for calls to HDF5 library.
+geomodelgrids::serial::HDF5::Lock::Lock(void) {
+#if !defined(H5_HAVE_THREADSAFE)
+    _HDF5::getMutex().lock();
+#endif
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Release lock for calls to HDF5 library.
+geomodelgrids::serial::HDF5::Lock::~Lock(void) {
+#if !defined(H5_HAVE_THREADSAFE)
+    _HDF5::getMutex().unlock();
+#endif
+} // destructor
+
+
 // ------------------------------------------------------------------------------------------------
 // Default constructor.
 geomodelgrids::serial::HDF5::HDF5(void) :
     _file(H5_NULL),
+    _fileAccess(H5_NULL),
     _cacheSize(128*1048576),
     _cacheNumSlots(63997),
-    _cachePreemption(0.75) {}
+    _cachePreemption(0.75),
+    _cache(new _HDF5Cache) {}
 
 
 // ------------------------------------------------------------------------------------------------
 // Destructor
 geomodelgrids::serial::HDF5::~HDF5(void) {
+    Lock lock;
     close();
+    if (_fileAccess >= 0) {
+        H5Pclose(_fileAccess);_fileAccess = H5_NULL;
+    } // if
+    delete _cache;_cache = nullptr;
 } // destructor
 
 
@@ -79,18 +322,34 @@ geomodelgrids::serial::HDF5::setCache(const size_t cacheSize,
 } // setDatasetCache
 
 
+// ------------------------------------------------------------------------------------------------
+// Set file access property list.
+void
+geomodelgrids::serial::HDF5::setFileAccess(const hid_t fileAccess) {
+    Lock lock;
+    if (_fileAccess >= 0) {
+        H5Pclose(_fileAccess);_fileAccess = H5_NULL;
+    } // if
+    if (fileAccess != H5P_DEFAULT) {
+        _fileAccess = H5Pcopy(fileAccess);
+        if (_fileAccess < 0) { throw std::runtime_error("Could not copy HDF5 file access properties."); }
+    } // if
+} // setFileAccess
+
+
 // ------------------------------------------------------------------------------------------------
 // Open HDF5 file.
 void
 geomodelgrids::serial::HDF5::open(const char* filename,
                                   hid_t mode) {
+    Lock lock;
     assert(filename);
 
     if (_file >= 0) {
         throw std::runtime_error("HDF5 file already open.");
     } // if
 
-    hid_t fileAccess = H5Pcreate(H5P_FILE_ACCESS);
+    hid_t fileAccess = (_fileAccess >= 0) ? H5Pcopy(_fileAccess) : H5Pcreate(H5P_FILE_ACCESS);
     if (fileAccess < 0) { throw std::runtime_error("Could not create property for HDF5 cache parameters."); }
     herr_t err = H5Pset_cache(fileAccess, 0, _cacheNumSlots, _cacheSize, _cachePreemption);
     if (err < 0) { throw std::runtime_error("Could not set HDF5 file cache properties."); }
@@ -113,6 +372,8 @@ geomodelgrids::serial::HDF5::open(const char* filename,
     } // if/else
 
     H5Pclose(fileAccess);
+
+    _loadMetadataSnapshot();
 } // constructor
 
 
@@ -120,6 +381,8 @@ geomodelgrids::serial::HDF5::open(const char* filename,
 // Close HDF5 file.
 void
 geomodelgrids::serial::HDF5::close(void) {
+    Lock lock;
+    _cache->clear();
     if (_file >= 0) {
         herr_t err = H5Fclose(_file);
         if (err < 0) {
@@ -138,13 +401,27 @@ geomodelgrids::serial::HDF5::isOpen(void) const {
 } // isOpen
 
 
+// ------------------------------------------------------------------------------------------------
+// Check if metadata is read from a consolidated metadata snapshot.
+bool
+geomodelgrids::serial::HDF5::hasMetadataSnapshot(void) const {
+    return !_cache->objects.empty();
+} // hasMetadataSnapshot
+
+
 // ------------------------------------------------------------------------------------------------
 // Check if HDF5 file has group.
 bool
 geomodelgrids::serial::HDF5::hasGroup(const char* name) {
+    Lock lock;
     assert(isOpen());
     assert(name);
 
+    const _HDF5Cache::Object* object = _cache->getObject(name);
+    if (object) {
+        return !object->isDataset;
+    } // if
+
     bool exists = false;
     if (H5Lexists(_file, name, H5P_DEFAULT)) {
         _HDF5Access h5access;
@@ -169,9 +446,15 @@ geomodelgrids::serial::HDF5::hasGroup(const char* name) {
 // Check if HDF5 file has dataset.
 bool
 geomodelgrids::serial::HDF5::hasDataset(const char* name) {
+    Lock lock;
     assert(isOpen());
     assert(name);
 
+    const _HDF5Cache::Object* object = _cache->getObject(name);
+    if (object) {
+        return object->isDataset;
+    } // if
+
     bool exists = false;
     if (H5Lexists(_file, name, H5P_DEFAULT)) {
         _HDF5Access h5access;
@@ -198,24 +481,22 @@ void
 geomodelgrids::serial::HDF5::getDatasetDims(hsize_t** dims,
                                             int* ndims,
                                             const char* path) {
+    Lock lock;
     assert(dims);
     assert(ndims);
     assert(path);
     assert(isOpen());
 
     try {
-        _HDF5Access h5access;
-
-        // Open the dataset
-        h5access.dataset = H5Dopen2(_file, path, H5P_DEFAULT);
-        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
-
-        h5access.dataspace = H5Dget_space(h5access.dataset);
-        if (h5access.dataspace < 0) { throw std::runtime_error("Could not get dataspace."); }
+        const _HDF5Cache::Object* object = _cache->getObject(path);
+        const std::vector<hsize_t>& datasetDims = (object && object->isDataset) ?
+                                                  object->dims : _cache->getDataset(_file, path).dims;
 
-        *ndims = H5Sget_simple_extent_ndims(h5access.dataspace);
+        *ndims = int(datasetDims.size());
         delete[] *dims;*dims = (*ndims > 0) ? new hsize_t[*ndims] : 0;
-        H5Sget_simple_extent_dims(h5access.dataspace, *dims, 0);
+        for (int i = 0; i < *ndims; ++i) {
+            (*dims)[i] = datasetDims[i];
+        } // for
 
     } catch (const std::exception& err) {
         std::ostringstream msg;
@@ -232,9 +513,24 @@ geomodelgrids::serial::HDF5::getDatasetDims(hsize_t** dims,
 void
 geomodelgrids::serial::HDF5::getGroupDatasets(std::vector<std::string>* names,
                                               const char* path) {
+    Lock lock;
     assert(names);
     assert(isOpen());
 
+    const _HDF5Cache::Object* object = _cache->getObject(path);
+    if (object && !object->isDataset) {
+        const std::string& prefix = _HDF5Cache::normalize(path) + "/";
+        names->clear();
+        for (std::map<std::string, _HDF5Cache::Object>::const_iterator iter = _cache->objects.begin();
+             iter != _cache->objects.end(); ++iter) {
+            const std::string& child = iter->first;
+            if (( child.compare(0, prefix.size(), prefix) == 0) && ( child.find('/', prefix.size()) == std::string::npos) ) {
+                names->push_back(child.substr(prefix.size()));
+            } // if
+        } // for
+        return;
+    } // if
+
     try {
         _HDF5Access h5access;
 
@@ -274,9 +570,14 @@ geomodelgrids::serial::HDF5::getGroupDatasets(std::vector<std::string>* names,
 bool
 geomodelgrids::serial::HDF5::hasAttribute(const char* path,
                                           const char* name) {
+    Lock lock;
     assert(path);
     assert(name);
 
+    if (_cache->getObject(path)) {
+        return _cache->getAttribute(path, name) != nullptr;
+    } // if
+
     htri_t exists = H5Aexists_by_name(_file, path, name, H5P_DEFAULT);
     return exists > 0;
 } // hasAttribute
@@ -289,10 +590,17 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
                                            const char* name,
                                            hid_t datatype,
                                            void* value) {
+    Lock lock;
     assert(path);
     assert(name);
     assert(value);
 
+    const _HDF5Cache::Attribute* attribute = _cache->getAttribute(path, name);
+    if (attribute && !attribute->isString && ( 1 == attribute->values.size()) && ( H5Tequal(datatype, H5T_NATIVE_DOUBLE) > 0) ) {
+        *(double*)value = attribute->values[0];
+        return;
+    } // if
+
     try {
         _HDF5Access h5access;
 
@@ -318,11 +626,22 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
                                            hid_t datatype,
                                            void** values,
                                            size_t* valuesSize) {
+    Lock lock;
     assert(path);
     assert(name);
     assert(values);
     assert(valuesSize);
 
+    const _HDF5Cache::Attribute* attribute = _cache->getAttribute(path, name);
+    if (attribute && !attribute->isString && !attribute->values.empty() && ( H5Tequal(datatype, H5T_NATIVE_DOUBLE) > 0) ) {
+        const size_t numValues = attribute->values.size();
+        double* buffer = new double[numValues];
+        std::copy(attribute->values.begin(), attribute->values.end(), buffer);
+        *valuesSize = numValues;
+        *values = buffer;
+        return;
+    } // if
+
     try {
         _HDF5Access h5access;
 
@@ -358,11 +677,17 @@ geomodelgrids::serial::HDF5::readAttribute(const char* path,
 std::string
 geomodelgrids::serial::HDF5::readAttribute(const char* path,
                                            const char* name) {
+    Lock lock;
     assert(path);
     assert(name);
 
     std::string value;
 
+    const _HDF5Cache::Attribute* attribute = _cache->getAttribute(path, name);
+    if (attribute && attribute->isString && ( 1 == attribute->strings.size()) ) {
+        return attribute->strings[0];
+    } // if
+
     try {
         _HDF5Access h5access;
 
@@ -411,10 +736,17 @@ void
 geomodelgrids::serial::HDF5::readAttribute(const char* path,
                                            const char* name,
                                            std::vector<std::string>* values) {
+    Lock lock;
     assert(path);
     assert(name);
     assert(values);
 
+    const _HDF5Cache::Attribute* attribute = _cache->getAttribute(path, name);
+    if (attribute && attribute->isString && !attribute->strings.empty()) {
+        *values = attribute->strings;
+        return;
+    } // if
+
     try {
         _HDF5Access h5access;
 
@@ -485,46 +817,85 @@ geomodelgrids::serial::HDF5::readDatasetHyperslab(void* values,
                                                   const hsize_t* const origin,
                                                   const hsize_t* const dims,
                                                   const int ndims,
-                                                  hid_t datatype) {
-    assert(values);
+                                                  hid_t datatype,
+                                                  const hid_t datasetTransfer) {
+    readDatasetHyperslab(values, path, origin, dims, ndims, nullptr, 0, datatype, datasetTransfer);
+} // readDatasetHyperslab
+
+
+// ------------------------------------------------------------------------------------------------
+// Read dataset slice with a subset of the indices along the last dimension.
+void
+geomodelgrids::serial::HDF5::readDatasetHyperslab(void* values,
+                                                  const char* path,
+                                                  const hsize_t* const origin,
+                                                  const hsize_t* const dims,
+                                                  const int ndims,
+                                                  const hsize_t* const indices,
+                                                  const size_t numIndices,
+                                                  hid_t datatype,
+                                                  const hid_t datasetTransfer) {
+    Lock lock;
     assert(path);
     assert(origin);
     assert(dims);
     assert(_file > 0);
+    assert(indices || !numIndices);
 
     try {
         _HDF5Access h5access;
 
-        // Open the dataset
-        h5access.dataset = H5Dopen2(_file, path, H5P_DEFAULT);
-        if (h5access.dataset < 0) { throw std::runtime_error("Could not open dataset."); }
-
-        h5access.dataspace = H5Dget_space(h5access.dataset);
+        // Use open dataset with a copy of its dataspace for selecting the hyperslab.
+        const _HDF5Cache::Dataset& dataset = _cache->getDataset(_file, path);
+        h5access.dataspace = H5Scopy(dataset.dataspace);
         if (h5access.dataspace < 0) { throw std::runtime_error("Could not get dataspace."); }
 
-        const int ndimsAll = H5Sget_simple_extent_ndims(h5access.dataspace);
-        hsize_t* dimsAll = (ndimsAll > 0) ? new hsize_t[ndimsAll] : nullptr;
-        H5Sget_simple_extent_dims(h5access.dataspace, dimsAll, nullptr);
+        const int ndimsAll = int(dataset.dims.size());
+        const hsize_t* dimsAll = dataset.dims.data();
 
         // Validate arguments.
         if (ndims != ndimsAll) {
             std::ostringstream msg;
             msg << "Rank of hyperslab origin and dimension (" << ndims
                 << ") does not match rank of dataset (" << ndimsAll << ").";
-            delete[] dimsAll;dimsAll = nullptr;
             throw std::length_error(msg.str());
         } // if
-        for (int i = 0; i < ndimsAll; ++i) {
+        const int ndimsSlab = indices ? ndimsAll-1 : ndimsAll;
+        for (int i = 0; i < ndimsSlab; ++i) {
             if (origin[i] + dims[i] > dimsAll[i]) {
                 std::ostringstream msg;
                 msg << "Hyperslab extent in dimension " << i
                     << " (origin:" << origin[i] << ", dim: " << dims[i] << ") "
                     << "exceeds dataset dimension " << dimsAll[i] << ".";
-                delete[] dimsAll;dimsAll = nullptr;
                 throw std::length_error(msg.str());
             } // if
         } // for
-        delete[] dimsAll;dimsAll = nullptr;
+        for (size_t i = 0; i < numIndices; ++i) {
+            if (( indices[i] >= dimsAll[ndimsAll-1]) || ( i > 0 && indices[i] <= indices[i-1]) ) {
+                std::ostringstream msg;
+                msg << "Index " << indices[i] << " along last dimension is not in increasing order or "
+                    << "exceeds dataset dimension " << dimsAll[ndimsAll-1] << ".";
+                throw std::length_error(msg.str());
+            } // if
+        } // for
+
+        // Selected origin and dimensions, with the first index and number of indices along the last
+        // dimension.
+        std::vector<hsize_t> originSlab(origin, origin+ndims);
+        std::vector<hsize_t> dimsSlab(dims, dims+ndims);
+        if (indices) {
+            originSlab[ndims-1] = numIndices ? indices[0] : 0;
+            dimsSlab[ndims-1] = numIndices;
+        } // if
+
+        bool isEmpty = false;
+        for (int i = 0; i < ndims; ++i) {
+            if (!dimsSlab[i]) {
+                isEmpty = true;
+                break;
+            } // if
+        } // for
+        assert(values || isEmpty);
 
         // Stride and count are 1 for contiguous slab.
         hsize_t* stride = (ndimsAll > 0) ? new hsize_t[ndimsAll] : nullptr;
@@ -534,14 +905,38 @@ geomodelgrids::serial::HDF5::readDatasetHyperslab(void* values,
             count[i] = 1;
         } // for
 
-        hid_t memspace = H5Screate_simple(ndims, dims, dims);
+        hid_t memspace = H5Screate_simple(ndims, dimsSlab.data(), dimsSlab.data());
         if (memspace < 0) { throw std::runtime_error("Could not create memory space."); }
 
-        herr_t err = H5Sselect_hyperslab(h5access.dataspace, H5S_SELECT_SET, origin, stride, count, dims);
+        herr_t err = 0;
+        if (isEmpty) {
+            err = H5Sselect_none(h5access.dataspace);
+            if (err >= 0) { err = H5Sselect_none(memspace); }
+        } else if (indices) {
+            // Union of runs of consecutive indices along the last dimension.
+            H5S_seloper_t op = H5S_SELECT_SET;
+            for (size_t iRun = 0; iRun < numIndices && err >= 0;) {
+                size_t iEnd = iRun + 1;
+                while (iEnd < numIndices && indices[iEnd] == indices[iEnd-1] + 1) {
+                    ++iEnd;
+                } // while
+                originSlab[ndims-1] = indices[iRun];
+                dimsSlab[ndims-1] = iEnd - iRun;
+                err = H5Sselect_hyperslab(h5access.dataspace, op, originSlab.data(), stride, count, dimsSlab.data());
+                op = H5S_SELECT_OR;
+                iRun = iEnd;
+            } // for
+        } else {
+            err = H5Sselect_hyperslab(h5access.dataspace, H5S_SELECT_SET, origin, stride, count, dims);
+        } // if/else
         delete[] stride;stride = nullptr;
         delete[] count;count = nullptr;
         if (err < 0) { throw std::runtime_error("Could not select hyperslab."); }
-        err = H5Dread(h5access.dataset, datatype, memspace, h5access.dataspace, H5P_DEFAULT, values);
+
+        // Buffer must be non-null even when no values are selected.
+        double emptyBuffer = 0.0;
+        void* buffer = (!isEmpty) ? values : (void*)&emptyBuffer;
+        err = H5Dread(dataset.dataset, datatype, memspace, h5access.dataspace, datasetTransfer, buffer);
         if (err < 0) { throw std::runtime_error("Could not read hyperslab."); }
 
         H5Sclose(memspace);memspace = H5_NULL;
@@ -555,4 +950,27 @@ geomodelgrids::serial::HDF5::readDatasetHyperslab(void* values,
 } // readDatasetHyperslab
 
 
+// ------------------------------------------------------------------------------------------------
+// Load consolidated metadata snapshot, if present.
+void
+geomodelgrids::serial::HDF5::_loadMetadataSnapshot(void) {
+    Lock lock;
+    assert(isOpen());
+
+    _cache->objects.clear();
+    if (H5Aexists(_file, _HDF5::snapshotName) <= 0) {
+        return;
+    } // if
+
+    // Files with an invalid snapshot are read without it.
+    try {
+        std::vector<std::string> records;
+        readAttribute("/", _HDF5::snapshotName, &records);
+        _cache->parse(records);
+    } catch (const std::exception&) {
+        _cache->objects.clear();
+    } // try/catch
+} // _loadMetadataSnapshot
+
+
 // End of file
@@ -1,4 +1,11 @@
 /** Model stored as HDF5 file.
+ *
+ * If the file has a consolidated metadata snapshot (root attribute `metadata_snapshot` written
+ * when the model is created), the attributes, dataset dimensions, and group contents of the root,
+ * surfaces, and blocks are read in one call when the file is opened, and queries for them do not
+ * access the file. Other objects and files without a snapshot are read from the file.
+ *
+ * Datasets stay open after the first access until the file is closed.
  */
 #pragma once
 
@@ -8,6 +15,13 @@
 #include <vector> // USES std::std::vector
 #include <string> // USGS std::string
 
+// Forward declarations of helper classes.
+namespace geomodelgrids {
+    namespace serial {
+        struct _HDF5Cache;
+    } // serial
+} // geomodelgrids
+
 class geomodelgrids::serial::HDF5 {
     friend class TestHDF5; // Unit testing
 
@@ -16,6 +30,31 @@ public:
 
     static const hid_t H5_NULL;
 
+    // PUBLIC CLASSES -----------------------------------------------------------------------------
+public:
+
+    /** Lock serializing calls to the HDF5 library from multiple threads.
+     *
+     * Methods of HDF5 hold the lock while calling the HDF5 library; code calling the HDF5 library
+     * directly should hold it as well. The lock is recursive and does nothing if the HDF5 library
+     * was built thread safe.
+     */
+    class Lock {
+    public:
+
+        /// Acquire lock.
+        Lock(void);
+
+        /// Release lock.
+        ~Lock(void);
+
+    private:
+
+        Lock(const Lock&); ///< Not implemented
+        const Lock& operator=(const Lock&); ///< Not implemented
+
+    }; // Lock
+
     // PUBLIC METHODS -----------------------------------------------------------------------------
 public:
 
@@ -48,6 +87,18 @@ public:
                   const size_t nslots,
                   const double preemption=0.75);
 
+    /** Set file access property list.
+     *
+     * Must be called BEFORE open().
+     *
+     * Use this to select a file driver, such as the MPI-IO driver for parallel access. The property
+     * list is copied, so the caller retains ownership of `fileAccess`. The chunk cache parameters are
+     * added to the copy when the file is opened.
+     *
+     * @param[in] fileAccess HDF5 file access property list.
+     */
+    void setFileAccess(const hid_t fileAccess);
+
     /** Open HDF5.
      *
      * @param[in] filename Name of HDF5 file
@@ -65,6 +116,12 @@ public:
      */
     bool isOpen(void) const;
 
+    /** Check if metadata is read from a consolidated metadata snapshot.
+     *
+     * @returns True if HDF5 file has a valid metadata snapshot, false otherwise.
+     */
+    bool hasMetadataSnapshot(void) const;
+
     /** Check if HDF5 file has group.
      *
      * @param name Full name of group.
@@ -151,6 +208,9 @@ public:
                        std::vector<std::string>* values);
 
     /** Read hyperslab (subset of values) from dataset.
+     *
+     * A hyperslab with a zero dimension selects no values; this allows a process without any values
+     * to read to participate in a collective read.
      *
      * @param[out values Values of hyperslab.
      * @param[in] path Full path to dataset.
@@ -158,21 +218,58 @@ public:
      * @param[in] dims Dimensions of hyperslab.
      * @param[in] ndims Number of dimensions of hyperslab.
      * @param[in] datatype Type of data in dataset.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
      */
     void readDatasetHyperslab(void* values,
                               const char* path,
                               const hsize_t* const origin,
                               const hsize_t* const dims,
                               int ndims,
-                              hid_t datatype);
+                              hid_t datatype,
+                              const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Read hyperslab with a subset of the indices along the last dimension from dataset.
+     *
+     * Same as readDatasetHyperslab() except only the given indices along the last dimension (for
+     * example, a subset of the values at each point) are read; the origin and dimension along the
+     * last dimension are ignored. The values are packed in the order of the indices, which must be
+     * in increasing order.
+     *
+     * @param[out values Values of hyperslab [product of dims except last * numIndices].
+     * @param[in] path Full path to dataset.
+     * @param[in] origin Origin of hyperslab in dataset.
+     * @param[in] dims Dimensions of hyperslab.
+     * @param[in] ndims Number of dimensions of hyperslab.
+     * @param[in] indices Indices along last dimension (increasing order).
+     * @param[in] numIndices Number of indices along last dimension.
+     * @param[in] datatype Type of data in dataset.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void readDatasetHyperslab(void* values,
+                              const char* path,
+                              const hsize_t* const origin,
+                              const hsize_t* const dims,
+                              int ndims,
+                              const hsize_t* const indices,
+                              const size_t numIndices,
+                              hid_t datatype,
+                              const hid_t datasetTransfer=H5P_DEFAULT);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /// Load consolidated metadata snapshot, if present.
+    void _loadMetadataSnapshot(void);
 
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
     hid_t _file; ///< HDF5 file
+    hid_t _fileAccess; ///< File access property list (if not default).
     size_t _cacheSize; ///< Dataset cache size (in bytes).
     size_t _cacheNumSlots; ///< Number of chunk slots in dataset cache.
     double _cachePreemption; ///< Preemption policy value for cache.
+    geomodelgrids::serial::_HDF5Cache* _cache; ///< Metadata snapshot and open datasets.
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -0,0 +1,310 @@
+#include <portinfo>
+
+#include "HDF5Copier.hh" // implementation of class methods
+
+#include <algorithm> // USES std::max()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace serial {
+        namespace _HDF5Copier {
+            static const char* const snapshotName = "metadata_snapshot"; ///< Name of snapshot attribute.
+            static const char* const groupNames[2] = { "surfaces", "blocks" }; ///< Groups with datasets.
+            static const char* const levelsName = "levels"; ///< Group with coarser levels of blocks.
+        } // _HDF5Copier
+    } // serial
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::HDF5Copier::Handle::Handle(const hid_t id,
+                                                  herr_t (*closeFn)(hid_t),
+                                                  const std::string& description) :
+    _id(id),
+    _closeFn(closeFn) {
+    if (id < 0) {
+        std::ostringstream msg;
+        msg << "Could not " << description << ".";
+        throw std::runtime_error(msg.str());
+    } // if
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::serial::HDF5Copier::Handle::~Handle(void) {
+    _closeFn(_id);
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get HDF5 identifier.
+geomodelgrids::serial::HDF5Copier::Handle::operator hid_t(void) const {
+    return _id;
+} // operator hid_t
+
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::HDF5Copier::HDF5Copier(void) :
+    _srcFile(-1),
+    _destFile(-1) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::serial::HDF5Copier::~HDF5Copier(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Open source file and create destination file.
+void
+geomodelgrids::serial::HDF5Copier::open(const char* srcFilename,
+                                        const char* destFilename) {
+    assert(srcFilename);
+    assert(destFilename);
+
+    close();
+    _srcFile = H5Fopen(srcFilename, H5F_ACC_RDONLY, H5P_DEFAULT);
+    if (_srcFile < 0) {
+        std::ostringstream msg;
+        msg << "Could not open HDF5 file '" << srcFilename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    _destFile = H5Fcreate(destFilename, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (_destFile < 0) {
+        close();
+        std::ostringstream msg;
+        msg << "Could not create HDF5 file '" << destFilename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+} // open
+
+
+// ------------------------------------------------------------------------------------------------
+// Close files.
+void
+geomodelgrids::serial::HDF5Copier::close(void) {
+    if (_destFile >= 0) {
+        H5Fclose(_destFile);
+    } // if
+    _destFile = -1;
+    if (_srcFile >= 0) {
+        H5Fclose(_srcFile);
+    } // if
+    _srcFile = -1;
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Get source file.
+hid_t
+geomodelgrids::serial::HDF5Copier::getSource(void) const {
+    return _srcFile;
+} // getSource
+
+
+// ------------------------------------------------------------------------------------------------
+// Get destination file.
+hid_t
+geomodelgrids::serial::HDF5Copier::getDestination(void) const {
+    return _destFile;
+} // getDestination
+
+
+// ------------------------------------------------------------------------------------------------
+// Get paths of the surface and block datasets in the source file.
+void
+geomodelgrids::serial::HDF5Copier::getDatasets(std::vector<std::string>* paths,
+                                               const bool includeLevels) const {
+    assert(paths);
+
+    paths->clear();
+    std::vector<std::string> names;
+    for (size_t iGroup = 0; iGroup < 2; ++iGroup) {
+        const std::string groupName(_HDF5Copier::groupNames[iGroup]);
+        _getLinks(&names, groupName);
+        for (size_t i = 0; i < names.size(); ++i) {
+            paths->push_back(groupName + "/" + names[i]);
+        } // for
+    } // for
+
+    if (includeLevels) {
+        std::vector<std::string> blockNames;
+        _getLinks(&blockNames, _HDF5Copier::levelsName);
+        for (size_t iBlock = 0; iBlock < blockNames.size(); ++iBlock) {
+            const std::string groupName = std::string(_HDF5Copier::levelsName) + "/" + blockNames[iBlock];
+            _getLinks(&names, groupName);
+            for (size_t i = 0; i < names.size(); ++i) {
+                paths->push_back(groupName + "/" + names[i]);
+            } // for
+        } // for
+    } // if
+} // getDatasets
+
+
+// ------------------------------------------------------------------------------------------------
+// Check whether dataset in source file stores the values at a point as the leading dimension.
+bool
+geomodelgrids::serial::HDF5Copier::isPlanar(const char* path) const {
+    assert(path);
+
+    const char* name = "value_layout";
+    if (H5Aexists_by_name(_srcFile, path, name, H5P_DEFAULT) <= 0) {
+        return false;
+    } // if
+    Handle attribute(H5Aopen_by_name(_srcFile, path, name, H5P_DEFAULT, H5P_DEFAULT), H5Aclose,
+                     std::string("open attribute '") + name + "' of '" + path + "'");
+    Handle datatype(H5Aget_type(attribute), H5Tclose, std::string("get type of attribute '") + name + "'");
+    std::string value;
+    if (H5Tis_variable_str(datatype) > 0) {
+        char* buffer = nullptr;
+        if (H5Aread(attribute, datatype, &buffer) < 0) {
+            throw std::runtime_error(std::string("Could not read attribute '") + name + "'.");
+        } // if
+        value = buffer ? buffer : "";
+        Handle space(H5Aget_space(attribute), H5Sclose, std::string("get dataspace of attribute '") + name + "'");
+        H5Dvlen_reclaim(datatype, space, H5P_DEFAULT, &buffer);
+    } else {
+        std::vector<char> buffer(H5Tget_size(datatype)+1, '\0');
+        if (H5Aread(attribute, datatype, buffer.data()) < 0) {
+            throw std::runtime_error(std::string("Could not read attribute '") + name + "'.");
+        } // if
+        value = buffer.data();
+    } // if/else
+
+    return value == "planar";
+} // isPlanar
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy root attributes and create the surfaces and blocks groups with their attributes.
+void
+geomodelgrids::serial::HDF5Copier::copyGroups(const bool copySnapshot,
+                                              const bool includeLevels) {
+    copyAttributes("/", copySnapshot);
+    for (size_t iGroup = 0; iGroup < 2; ++iGroup) {
+        const char* groupName = _HDF5Copier::groupNames[iGroup];
+        if (H5Lexists(_srcFile, groupName, H5P_DEFAULT) <= 0) {
+            continue;
+        } // if
+        Handle group(H5Gcreate2(_destFile, groupName, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose,
+                     std::string("create group '") + groupName + "'");
+        copyAttributes(groupName);
+    } // for
+
+    if (includeLevels && (H5Lexists(_srcFile, _HDF5Copier::levelsName, H5P_DEFAULT) > 0)) {
+        const char* levelsName = _HDF5Copier::levelsName;
+        Handle levels(H5Gcreate2(_destFile, levelsName, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose,
+                      std::string("create group '") + levelsName + "'");
+        copyAttributes(levelsName);
+        std::vector<std::string> blockNames;
+        _getLinks(&blockNames, levelsName);
+        for (size_t i = 0; i < blockNames.size(); ++i) {
+            const std::string groupName = std::string(levelsName) + "/" + blockNames[i];
+            Handle group(H5Gcreate2(_destFile, groupName.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose,
+                         std::string("create group '") + groupName + "'");
+            copyAttributes(groupName.c_str());
+        } // for
+    } // if
+} // copyGroups
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy attributes of object from source to destination.
+void
+geomodelgrids::serial::HDF5Copier::copyAttributes(const char* path,
+                                                  const bool copySnapshot) {
+    assert(path);
+
+    Handle src(H5Oopen(_srcFile, path, H5P_DEFAULT), H5Oclose, std::string("open '") + path + "' in source");
+    Handle dest(H5Oopen(_destFile, path, H5P_DEFAULT), H5Oclose, std::string("open '") + path + "' in destination");
+    H5O_info_t info;
+    if (H5Oget_info(src, &info) < 0) {
+        throw std::runtime_error(std::string("Could not get information for '") + path + "'.");
+    } // if
+    for (hsize_t i = 0; i < info.num_attrs; ++i) {
+        Handle attribute(H5Aopen_by_idx(src, ".", H5_INDEX_CRT_ORDER, H5_ITER_INC, i, H5P_DEFAULT, H5P_DEFAULT),
+                         H5Aclose, std::string("open attribute of '") + path + "'");
+        const ssize_t nameLength = H5Aget_name(attribute, 0, nullptr);
+        std::vector<char> name(nameLength+1);
+        H5Aget_name(attribute, name.size(), name.data());
+        if (!copySnapshot && (std::string(_HDF5Copier::snapshotName) == name.data())) {
+            continue;
+        } // if
+
+        Handle fileType(H5Aget_type(attribute), H5Tclose, "get type of attribute");
+        Handle memType(H5Tget_native_type(fileType, H5T_DIR_ASCEND), H5Tclose, "get native type of attribute");
+        Handle space(H5Aget_space(attribute), H5Sclose, "get dataspace of attribute");
+        const hssize_t numPoints = H5Sget_simple_extent_npoints(space);
+        std::vector<char> buffer(std::max(hssize_t(1), numPoints) * H5Tget_size(memType));
+        if (H5Aread(attribute, memType, buffer.data()) < 0) {
+            throw std::runtime_error(std::string("Could not read attribute '") + name.data() + "'.");
+        } // if
+        Handle destAttribute(H5Acreate2(dest, name.data(), fileType, space, H5P_DEFAULT, H5P_DEFAULT), H5Aclose,
+                             std::string("create attribute '") + name.data() + "'");
+        const herr_t err = H5Awrite(destAttribute, memType, buffer.data());
+        if (( H5Tdetect_class(memType, H5T_VLEN) > 0) || ( H5Tis_variable_str(memType) > 0) ) {
+            H5Dvlen_reclaim(memType, space, H5P_DEFAULT, buffer.data());
+        } // if
+        if (err < 0) {
+            throw std::runtime_error(std::string("Could not write attribute '") + name.data() + "'.");
+        } // if
+    } // for
+} // copyAttributes
+
+
+// ------------------------------------------------------------------------------------------------
+// Write scalar double attribute in destination, replacing any existing attribute.
+void
+geomodelgrids::serial::HDF5Copier::writeAttribute(const char* path,
+                                                  const char* name,
+                                                  const double value) {
+    assert(path);
+    assert(name);
+
+    Handle object(H5Oopen(_destFile, path, H5P_DEFAULT), H5Oclose, std::string("open '") + path + "' in destination");
+    if (H5Aexists(object, name) > 0) {
+        H5Adelete(object, name);
+    } // if
+    Handle space(H5Screate(H5S_SCALAR), H5Sclose, "create dataspace for attribute");
+    Handle attribute(H5Acreate2(object, name, H5T_IEEE_F64LE, space, H5P_DEFAULT, H5P_DEFAULT), H5Aclose,
+                     std::string("create attribute '") + name + "'");
+    if (H5Awrite(attribute, H5T_NATIVE_DOUBLE, &value) < 0) {
+        throw std::runtime_error(std::string("Could not write attribute '") + name + "'.");
+    } // if
+} // writeAttribute
+
+
+// ------------------------------------------------------------------------------------------------
+// Get names of links in group of source file.
+void
+geomodelgrids::serial::HDF5Copier::_getLinks(std::vector<std::string>* names,
+                                             const std::string& groupName) const {
+    assert(names);
+
+    names->clear();
+    if (H5Lexists(_srcFile, groupName.c_str(), H5P_DEFAULT) <= 0) {
+        return;
+    } // if
+    Handle group(H5Gopen2(_srcFile, groupName.c_str(), H5P_DEFAULT), H5Gclose,
+                 std::string("open group '") + groupName + "'");
+    H5G_info_t groupInfo;
+    if (H5Gget_info(group, &groupInfo) < 0) {
+        throw std::runtime_error(std::string("Could not get information for group '") + groupName + "'.");
+    } // if
+    for (hsize_t i = 0; i < groupInfo.nlinks; ++i) {
+        const ssize_t nameLength = H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i, nullptr, 0,
+                                                      H5P_DEFAULT);
+        std::vector<char> name(nameLength+1);
+        H5Lget_name_by_idx(group, ".", H5_INDEX_NAME, H5_ITER_INC, i, name.data(), name.size(), H5P_DEFAULT);
+        names->push_back(name.data());
+    } // for
+} // _getLinks
+
+
+// End of file
@@ -0,0 +1,151 @@
+/** Copy of a model HDF5 file with rewritten surfaces and blocks.
+ *
+ * Used by applications that write a new model file from an existing one. The copier creates the
+ * root, surfaces, and blocks groups with their attributes in the new file; the caller creates and
+ * fills each dataset, usually copying its attributes with copyAttributes().
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <hdf5.h> // USES hid_t
+#include <vector> // USES std::vector
+#include <string> // USES std::string
+
+class geomodelgrids::serial::HDF5Copier {
+    friend class TestHDF5Copier; // Unit testing
+
+    // PUBLIC CLASSES -----------------------------------------------------------------------------
+public:
+
+    /// HDF5 identifier that is closed when it goes out of scope.
+    class Handle {
+    public:
+
+        /** Constructor.
+         *
+         * @param[in] id HDF5 identifier.
+         * @param[in] closeFn Function closing identifier (H5Dclose, H5Gclose, etc).
+         * @param[in] description Description of action creating identifier, used in error message.
+         * @throws std::runtime_error if id is negative.
+         */
+        Handle(const hid_t id,
+               herr_t (*closeFn)(hid_t),
+               const std::string& description);
+
+        /// Destructor.
+        ~Handle(void);
+
+        /// Get HDF5 identifier.
+        operator hid_t(void) const;
+
+    private:
+
+        hid_t _id;
+        herr_t (*_closeFn)(hid_t);
+
+        Handle(const Handle&); ///< Not implemented
+        const Handle& operator=(const Handle&); ///< Not implemented
+
+    }; // Handle
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    HDF5Copier(void);
+
+    /// Destructor.
+    ~HDF5Copier(void);
+
+    /** Open source file (read only) and create destination file (overwritten if it exists).
+     *
+     * @param[in] srcFilename Name of source model file.
+     * @param[in] destFilename Name of destination model file.
+     */
+    void open(const char* srcFilename,
+              const char* destFilename);
+
+    /// Close files.
+    void close(void);
+
+    /** Get source file.
+     *
+     * @returns HDF5 identifier for source file.
+     */
+    hid_t getSource(void) const;
+
+    /** Get destination file.
+     *
+     * @returns HDF5 identifier for destination file.
+     */
+    hid_t getDestination(void) const;
+
+    /** Get paths of the surface and block datasets in the source file.
+     *
+     * @param[out] paths Paths of datasets ('surfaces/NAME', 'blocks/NAME', or 'levels/NAME/FACTOR').
+     * @param[in] includeLevels Include coarser levels of blocks.
+     */
+    void getDatasets(std::vector<std::string>* paths,
+                     const bool includeLevels=false) const;
+
+    /** Check whether dataset in source file stores the values at a point as the leading dimension.
+     *
+     * @param[in] path Path of dataset.
+     * @returns True if the 'value_layout' attribute of the dataset is 'planar', false otherwise.
+     */
+    bool isPlanar(const char* path) const;
+
+    /** Copy root attributes and create the surfaces and blocks groups with their attributes.
+     *
+     * @param[in] copySnapshot Copy metadata snapshot. Set to false if the destination has different
+     *   attributes or dataset dimensions, in which case readers fall back to the attributes.
+     * @param[in] includeLevels Also create the groups for coarser levels of blocks.
+     */
+    void copyGroups(const bool copySnapshot,
+                    const bool includeLevels=false);
+
+    /** Copy attributes of object from source to destination.
+     *
+     * @param[in] path Path of object in both files.
+     * @param[in] copySnapshot Copy metadata snapshot attribute if present.
+     */
+    void copyAttributes(const char* path,
+                        const bool copySnapshot=false);
+
+    /** Write scalar double attribute in destination, replacing any existing attribute.
+     *
+     * @param[in] path Path of object in destination.
+     * @param[in] name Name of attribute.
+     * @param[in] value Value of attribute.
+     */
+    void writeAttribute(const char* path,
+                        const char* name,
+                        const double value);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Get names of links in group of source file.
+     *
+     * @param[out] names Names of links (empty if group does not exist).
+     * @param[in] groupName Path of group.
+     */
+    void _getLinks(std::vector<std::string>* names,
+                   const std::string& groupName) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    hid_t _srcFile; ///< Source HDF5 file.
+    hid_t _destFile; ///< Destination HDF5 file.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    HDF5Copier(const HDF5Copier&); ///< Not implemented
+    const HDF5Copier& operator=(const HDF5Copier&); ///< Not implemented
+
+}; // HDF5Copier
+
+// End of file
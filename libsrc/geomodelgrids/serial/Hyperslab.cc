@@ -9,7 +9,8 @@
 #include <sstream> // USES std::ostringstream
 #include <cassert> // USES assert()
 #include <cmath> // USES floor()
-#include <algorithm> // USES std::min(), std::max()
+#include <algorithm> // USES std::min(), std::max(), std::sort(), std::unique(), std::lower_bound(), std::rotate()
+#include <vector> // USES std::vector
 
 #if !defined(CALL_MEMBER_FN)
 #define CALL_MEMBER_FN(object,ptrToMember)  ((object).*(ptrToMember))
@@ -36,6 +37,13 @@ public:
      */
     void getSlab(const double indexFloat[]);
 
+    /** Check whether region contains target point.
+     *
+     * @param[in] indexFloat Floating point index of target point.
+     * @returns True if region is loaded and contains the target point, false otherwise.
+     */
+    bool inRegion(const double indexFloat[]) const;
+
     /** Compute values at point using bilinear interpolation.
      *
      * @param[out] values Preallocated array for interpolated values.
@@ -90,6 +98,10 @@ private:
                     const double indexFloat[]);
 
     geomodelgrids::serial::Hyperslab& _hyperslab; ///< Reference to hyperslab.
+    const hsize_t* _slabOrigin; ///< Origin of active slab (sliding hyperslab or region).
+    const hsize_t* _slabDims; ///< Dimensions of active slab.
+    const double* _slabValues; ///< Values of active slab.
+    const hsize_t* _slabOffsets; ///< Offsets of selected values in active slab.
     interpolate_fn_type _interpolate; ///< Function for interpolation.
     interpolate_fn_type _nearest; ///< Function for nearest.
 
@@ -100,7 +112,8 @@ private:
 geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h5,
                                             const char* path,
                                             const hsize_t dims[],
-                                            const size_t ndims) :
+                                            const size_t ndims,
+                                            const std::vector<size_t>& valueIndices) :
     _h5(h5),
     _datasetPath(path),
     _ndims(ndims),
@@ -108,6 +121,16 @@ geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h
     _dims(_ndims > 0 ? new hsize_t[_ndims] : nullptr),
     _dimsAll(nullptr),
     _values(nullptr),
+    _regionOrigin(nullptr),
+    _regionDims(nullptr),
+    _regionValues(nullptr),
+    _regionOffsets(nullptr),
+    _regionBuffer(nullptr),
+    _scaleFactor(nullptr),
+    _addOffset(nullptr),
+    _missingValue(0.0),
+    _hasMissingValue(false),
+    _isPlanar(false),
     _hyperslab(nullptr) {
     assert(_h5);
     int ndimsAll = 0;
@@ -123,12 +146,66 @@ geomodelgrids::serial::Hyperslab::Hyperslab(geomodelgrids::serial::HDF5* const h
         throw std::length_error(msg.str());
     } // if
 
-    hsize_t totalSize = 1;
+    // Planar layout stores values as the leading dimension; keep the values as the last dimension.
+    _isPlanar = h5->hasAttribute(path, "value_layout") &&
+                std::string("planar") == h5->readAttribute(path, "value_layout");
+    if (_isPlanar) {
+        std::rotate(&_dimsAll[0], &_dimsAll[1], &_dimsAll[_ndims]);
+    } // if
+
+    // Buffer for values is allocated when the first slab is read.
     for (size_t i = 0; i < ndims; ++i) {
         _dims[i] = std::min(dims[i], _dimsAll[i]);
-        totalSize *= _dims[i];
     } // for
-    _values = (totalSize > 0) ? new double[totalSize] : nullptr;
+
+    // Select values at a point (all values if none are given).
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    const size_t numValues = _dimsAll[spaceDim];
+    if (valueIndices.empty()) {
+        _valueIndices.resize(numValues);
+        for (size_t i = 0; i < numValues; ++i) {
+            _valueIndices[i] = i;
+        } // for
+    } else {
+        _valueIndices.assign(valueIndices.begin(), valueIndices.end());
+        std::sort(_valueIndices.begin(), _valueIndices.end());
+        _valueIndices.erase(std::unique(_valueIndices.begin(), _valueIndices.end()), _valueIndices.end());
+        if (_valueIndices.back() >= numValues) {
+            std::ostringstream msg;
+            msg << "Index of value (" << _valueIndices.back() << ") for dataset '" << path
+                << "' exceeds number of values (" << numValues << ").";
+            delete[] _dims;_dims = nullptr;
+            delete[] _dimsAll;_dimsAll = nullptr;
+            throw std::invalid_argument(msg.str());
+        } // if
+    } // if/else
+    _valueOffsets.resize(_valueIndices.size());
+    for (size_t i = 0; i < _valueOffsets.size(); ++i) {
+        _valueOffsets[i] = i;
+    } // for
+    _dims[spaceDim] = _valueIndices.size();
+
+    // Values stored as integers have a scale factor and offset for each value.
+    if (h5->hasAttribute(path, "scale_factor")) {
+        size_t numScaleFactors = 0;
+        size_t numOffsets = 0;
+        h5->readAttribute(path, "scale_factor", H5T_NATIVE_DOUBLE, (void**)&_scaleFactor, &numScaleFactors);
+        h5->readAttribute(path, "add_offset", H5T_NATIVE_DOUBLE, (void**)&_addOffset, &numOffsets);
+        if ((numScaleFactors != numValues) || (numOffsets != numValues)) {
+            std::ostringstream msg;
+            msg << "Number of scale factors (" << numScaleFactors << ") and offsets (" << numOffsets << ") "
+                << "for dataset '" << path << "' do not match number of values (" << numValues << ").";
+            delete[] _dims;_dims = nullptr;
+            delete[] _dimsAll;_dimsAll = nullptr;
+            delete[] _scaleFactor;_scaleFactor = nullptr;
+            delete[] _addOffset;_addOffset = nullptr;
+            throw std::length_error(msg.str());
+        } // if
+        _hasMissingValue = h5->hasAttribute(path, "missing_value");
+        if (_hasMissingValue) {
+            h5->readAttribute(path, "missing_value", H5T_NATIVE_DOUBLE, (void*)&_missingValue);
+        } // if
+    } // if
 
     delete _hyperslab;_hyperslab = new geomodelgrids::serial::_Hyperslab(*this);
 } // constructor
@@ -141,11 +218,286 @@ geomodelgrids::serial::Hyperslab::~Hyperslab(void) {
     delete[] _dims;_dims = nullptr;
     delete[] _dimsAll;_dimsAll = nullptr;
     delete[] _values;_values = nullptr;
+    delete[] _scaleFactor;_scaleFactor = nullptr;
+    delete[] _addOffset;_addOffset = nullptr;
+    _clearRegion();
 
     delete _hyperslab;_hyperslab = nullptr;
 } // destructor
 
 
+// ------------------------------------------------------------------------------------------------
+// Load values for a region of the dataset.
+void
+geomodelgrids::serial::Hyperslab::loadRegion(const hsize_t origin[],
+                                             const hsize_t dims[],
+                                             const hid_t datasetTransfer) {
+    assert(origin);
+    assert(dims);
+
+    _clearRegion();
+    _checkRegion(origin, dims);
+
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    hsize_t totalSize = _dims[spaceDim];
+    for (size_t i = 0; i < spaceDim; ++i) {
+        totalSize *= dims[i];
+    } // for
+
+    // Read values even if the region is empty, because the read may be collective.
+    double* values = (totalSize > 0) ? new double[totalSize] : nullptr;
+    try {
+        _readSelected(values, origin, dims, datasetTransfer);
+    } catch (...) {
+        delete[] values;values = nullptr;
+        throw;
+    } // try/catch
+
+    setRegion(origin, dims, values);
+    if (_regionValues) {
+        // Region contains only the selected values.
+        _regionDims[spaceDim] = _dims[spaceDim];
+        _regionOffsets = _valueOffsets.data();
+    } // if
+    _regionBuffer = values;
+} // loadRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Use values stored in external memory for a region of the dataset.
+void
+geomodelgrids::serial::Hyperslab::setRegion(const hsize_t origin[],
+                                            const hsize_t dims[],
+                                            const double* values) {
+    assert(origin);
+    assert(dims);
+
+    _clearRegion();
+    _checkRegion(origin, dims);
+
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    hsize_t totalSize = 1;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        totalSize *= dims[i];
+    } // for
+    if (!totalSize || !values) {
+        return;
+    } // if
+
+    _regionOrigin = new hsize_t[_ndims];
+    _regionDims = new hsize_t[_ndims];
+    for (size_t i = 0; i < spaceDim; ++i) {
+        _regionOrigin[i] = origin[i];
+        _regionDims[i] = dims[i];
+    } // for
+    _regionOrigin[spaceDim] = 0;
+    _regionDims[spaceDim] = _dimsAll[spaceDim];
+    _regionValues = values;
+    _regionOffsets = _valueIndices.data();
+} // setRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values for a region of the dataset into a caller-supplied buffer.
+void
+geomodelgrids::serial::Hyperslab::readValues(double* const values,
+                                             const hsize_t origin[],
+                                             const hsize_t dims[],
+                                             const hid_t datasetTransfer) {
+    assert(origin);
+    assert(dims);
+    assert(_h5);
+
+    _checkRegion(origin, dims);
+
+    _readDataset(values, origin, dims, nullptr, 0, datasetTransfer);
+
+    size_t numPoints = 1;
+    for (size_t i = 0; i < _ndims-1; ++i) {
+        numPoints *= dims[i];
+    } // for
+    _decodeValues(values, numPoints, false);
+} // readValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Get range of a value over the region.
+bool
+geomodelgrids::serial::Hyperslab::getRegionRange(double* minValue,
+                                                 double* maxValue,
+                                                 const size_t index) const {
+    assert(minValue);
+    assert(maxValue);
+
+    if (!_regionValues) {
+        return false;
+    } // if
+    assert(_regionDims);
+
+    assert(_regionOffsets);
+
+    std::vector<hsize_t>::const_iterator iter = std::lower_bound(_valueIndices.begin(), _valueIndices.end(), index);
+    if ((iter == _valueIndices.end()) || (*iter != index)) {
+        return false;
+    } // if
+    const size_t offset = _regionOffsets[iter - _valueIndices.begin()];
+
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    const size_t numValues = _regionDims[spaceDim];
+    size_t numPoints = 1;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        numPoints *= _regionDims[i];
+    } // for
+
+    *minValue = _regionValues[offset];
+    *maxValue = _regionValues[offset];
+    for (size_t iPt = 1; iPt < numPoints; ++iPt) {
+        const double value = _regionValues[iPt*numValues+offset];
+        *minValue = std::min(*minValue, value);
+        *maxValue = std::max(*maxValue, value);
+    } // for
+
+    return true;
+} // getRegionRange
+
+
+// ------------------------------------------------------------------------------------------------
+// Check that region is within the dataset.
+void
+geomodelgrids::serial::Hyperslab::_checkRegion(const hsize_t origin[],
+                                               const hsize_t dims[]) const {
+    assert(origin);
+    assert(dims);
+
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    for (size_t i = 0; i < spaceDim; ++i) {
+        if (origin[i] + dims[i] > _dimsAll[i]) {
+            std::ostringstream msg;
+            msg << "Region extent in dimension " << i << " (origin:" << origin[i] << ", dim: " << dims[i] << ") "
+                << "exceeds dimension " << _dimsAll[i] << " of dataset '" << _datasetPath << "'.";
+            throw std::length_error(msg.str());
+        } // if
+    } // for
+} // _checkRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Clear region.
+void
+geomodelgrids::serial::Hyperslab::_clearRegion(void) {
+    delete[] _regionOrigin;_regionOrigin = nullptr;
+    delete[] _regionDims;_regionDims = nullptr;
+    delete[] _regionBuffer;_regionBuffer = nullptr;
+    _regionValues = nullptr;
+    _regionOffsets = nullptr;
+} // _clearRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values from dataset with the values at a point as the last dimension.
+void
+geomodelgrids::serial::Hyperslab::_readDataset(double* const values,
+                                               const hsize_t origin[],
+                                               const hsize_t dims[],
+                                               const hsize_t* const indices,
+                                               const size_t numIndices,
+                                               const hid_t datasetTransfer) {
+    assert(origin);
+    assert(dims);
+    assert(_h5);
+
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    std::vector<hsize_t> originAll(_ndims);
+    std::vector<hsize_t> dimsAll(_ndims);
+    size_t numPoints = 1;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        numPoints *= dims[i];
+    } // for
+
+    if (!_isPlanar) {
+        for (size_t i = 0; i < spaceDim; ++i) {
+            originAll[i] = origin[i];
+            dimsAll[i] = dims[i];
+        } // for
+        originAll[spaceDim] = 0;
+        dimsAll[spaceDim] = _dimsAll[spaceDim];
+        if (indices) {
+            _h5->readDatasetHyperslab(values, _datasetPath.c_str(), originAll.data(), dimsAll.data(), _ndims,
+                                      indices, numIndices, H5T_NATIVE_DOUBLE, datasetTransfer);
+        } else {
+            _h5->readDatasetHyperslab(values, _datasetPath.c_str(), originAll.data(), dimsAll.data(), _ndims,
+                                      H5T_NATIVE_DOUBLE, datasetTransfer);
+        } // if/else
+    } else {
+        // Read each value as a contiguous plane and interleave the values in memory.
+        for (size_t i = 0; i < spaceDim; ++i) {
+            originAll[i+1] = origin[i];
+            dimsAll[i+1] = dims[i];
+        } // for
+        dimsAll[0] = 1;
+        const size_t numValues = indices ? numIndices : _dimsAll[spaceDim];
+        std::vector<double> plane(numPoints);
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            originAll[0] = indices ? indices[iValue] : iValue;
+            _h5->readDatasetHyperslab(plane.data(), _datasetPath.c_str(), originAll.data(), dimsAll.data(), _ndims,
+                                      H5T_NATIVE_DOUBLE, datasetTransfer);
+            for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+                values[iPt*numValues+iValue] = plane[iPt];
+            } // for
+        } // for
+    } // if/else
+} // _readDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values for the selected values at a point.
+void
+geomodelgrids::serial::Hyperslab::_readSelected(double* const values,
+                                                const hsize_t origin[],
+                                                const hsize_t dims[],
+                                                const hid_t datasetTransfer) {
+    assert(origin);
+    assert(dims);
+
+    const size_t spaceDim = _ndims - 1; // last dimension is values
+    size_t numPoints = 1;
+    for (size_t i = 0; i < spaceDim; ++i) {
+        numPoints *= dims[i];
+    } // for
+
+    if (_valueIndices.size() < _dimsAll[spaceDim]) {
+        _readDataset(values, origin, dims, _valueIndices.data(), _valueIndices.size(), datasetTransfer);
+    } else {
+        _readDataset(values, origin, dims, nullptr, 0, datasetTransfer);
+    } // if/else
+    _decodeValues(values, numPoints, true);
+} // _readSelected
+
+
+// ------------------------------------------------------------------------------------------------
+// Decode values stored as integers.
+void
+geomodelgrids::serial::Hyperslab::_decodeValues(double* const values,
+                                                const size_t numPoints,
+                                                const bool isSelected) const {
+    if (!_scaleFactor) {
+        return;
+    } // if
+    assert(_addOffset);
+    assert(values || !numPoints);
+
+    const size_t numValues = isSelected ? _valueIndices.size() : _dimsAll[_ndims-1];
+    for (size_t iPt = 0, index = 0; iPt < numPoints; ++iPt) {
+        for (size_t iValue = 0; iValue < numValues; ++iValue, ++index) {
+            const size_t iEncoding = isSelected ? _valueIndices[iValue] : iValue;
+            const double stored = values[index];
+            values[index] = (_hasMissingValue && (stored == _missingValue)) ?
+                            geomodelgrids::NODATA_VALUE : stored * _scaleFactor[iEncoding] + _addOffset[iEncoding];
+        } // for
+    } // for
+} // _decodeValues
+
+
 // ------------------------------------------------------------------------------------------------
 // Compute values at point using bilinear interpolation.
 void
@@ -171,7 +523,11 @@ geomodelgrids::serial::Hyperslab::nearest(double* const values,
 // ------------------------------------------------------------------------------------------------
 // Constructor.
 geomodelgrids::serial::_Hyperslab::_Hyperslab(geomodelgrids::serial::Hyperslab& hyperslab) :
-    _hyperslab(hyperslab) {
+    _hyperslab(hyperslab),
+    _slabOrigin(nullptr),
+    _slabDims(nullptr),
+    _slabValues(nullptr),
+    _slabOffsets(nullptr) {
     if (3 == hyperslab._ndims-1) {
         _interpolate = &geomodelgrids::serial::_Hyperslab::_interpolate3D;
         _nearest = &geomodelgrids::serial::_Hyperslab::_nearest3D;
@@ -194,6 +550,14 @@ geomodelgrids::serial::_Hyperslab::~_Hyperslab(void) {}
 // Get values for hyperslab containing target point.
 void
 geomodelgrids::serial::_Hyperslab::getSlab(const double indexFloat[]) {
+    if (inRegion(indexFloat)) {
+        _slabOrigin = _hyperslab._regionOrigin;
+        _slabDims = _hyperslab._regionDims;
+        _slabValues = _hyperslab._regionValues;
+        _slabOffsets = _hyperslab._regionOffsets;
+        return;
+    } // if
+
     const size_t ndims = _hyperslab._ndims;
     hsize_t* origin = _hyperslab._origin;
     const hsize_t* dims = _hyperslab._dims;
@@ -212,6 +576,12 @@ geomodelgrids::serial::_Hyperslab::getSlab(const double indexFloat[]) {
     } else {
         origin = _hyperslab._origin = (ndims > 0) ? new hsize_t[ndims] : nullptr;
         std::fill(&origin[0], &origin[ndims], 0);
+
+        hsize_t totalSize = 1;
+        for (size_t i = 0; i < ndims; ++i) {
+            totalSize *= dims[i];
+        } // for
+        delete[] _hyperslab._values;_hyperslab._values = (totalSize > 0) ? new double[totalSize] : nullptr;
         needsNewSlab = true;
     } // if/else
 
@@ -223,12 +593,39 @@ geomodelgrids::serial::_Hyperslab::getSlab(const double indexFloat[]) {
             origin[i] = index;
         } // for
 
-        _hyperslab._h5->readDatasetHyperslab(_hyperslab._values, _hyperslab._datasetPath.c_str(), origin, dims, ndims,
-                                             H5T_NATIVE_DOUBLE);
+        _hyperslab._readSelected(_hyperslab._values, origin, dims);
     } // if
+    _slabOrigin = _hyperslab._origin;
+    _slabDims = _hyperslab._dims;
+    _slabValues = _hyperslab._values;
+    _slabOffsets = _hyperslab._valueOffsets.data();
 } // getSlab
 
 
+// ------------------------------------------------------------------------------------------------
+// Check whether region contains target point.
+bool
+geomodelgrids::serial::_Hyperslab::inRegion(const double indexFloat[]) const {
+    if (!_hyperslab._regionValues) {
+        return false;
+    } // if
+    assert(_hyperslab._regionOrigin);
+    assert(_hyperslab._regionDims);
+
+    const hsize_t* origin = _hyperslab._regionOrigin;
+    const hsize_t* dims = _hyperslab._regionDims;
+    const size_t spaceDim = _hyperslab._ndims - 1; // last dimension is values
+    for (size_t i = 0; i < spaceDim; ++i) {
+        if (( indexFloat[i] < double(origin[i])) ||
+            ( indexFloat[i] > double(origin[i]+dims[i]-1)) ) {
+            return false;
+        } // if
+    } // for
+
+    return true;
+} // inRegion
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::serial::_Hyperslab::interpolate(double* const values,
@@ -253,18 +650,18 @@ geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
                                                   const double indexFloat[]) {
     assert(values);
     assert(indexFloat);
-    assert(_hyperslab._values);
-    assert(_hyperslab._origin);
+    assert(_slabValues);
+    assert(_slabOrigin);
 
     const size_t spaceDim = 2;
 
     // Coordinates within hyperslab
     const double indexSlab[spaceDim] = {
-        indexFloat[0] - _hyperslab._origin[0],
-        indexFloat[1] - _hyperslab._origin[1],
+        indexFloat[0] - _slabOrigin[0],
+        indexFloat[1] - _slabOrigin[1],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _slabDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _slabDims[1]-1);
 
     // Coordinate of "lower" point (corner of cell with lowest indices containing target point).
     const double tolerance = 1.0e-12;
@@ -278,8 +675,8 @@ geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
         hsize_t(dfloor[0]),
         hsize_t(dfloor[1]),
     };
-    assert(ifloor[0] < _hyperslab._dims[0]);
-    assert(ifloor[1] < _hyperslab._dims[1]);
+    assert(ifloor[0] < _slabDims[0]);
+    assert(ifloor[1] < _slabDims[1]);
 
     // Coordinates within cell relative to "lower" point.
     const double xRef[spaceDim] = {
@@ -298,7 +695,7 @@ geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
     };
 
     // Indices into hyperslab values for cell corners
-    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dims = _slabDims;
     const hsize_t ii[2][2] = {
         {
             (ifloor[0]+0)*(dims[1]*dims[2]) + (ifloor[1]+0)*(dims[2]),
@@ -309,14 +706,17 @@ geomodelgrids::serial::_Hyperslab::_interpolate2D(double* const values,
         },
     };
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
-    for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
-        values[iValue] = 0;
+    const std::vector<hsize_t>& valueIndices = _hyperslab._valueIndices;
+    const size_t numValues = valueIndices.size();
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        const hsize_t offset = _slabOffsets[iValue];
+        double value = 0.0;
         for (hsize_t iDim = 0; iDim < 2; ++iDim) {
             for (hsize_t jDim = 0; jDim < 2; ++jDim) {
-                values[iValue] += wts[iDim][jDim] * _hyperslab._values[ii[iDim][jDim] + iValue];
+                value += wts[iDim][jDim] * _slabValues[ii[iDim][jDim] + offset];
             } // for
         } // for
+        values[valueIndices[iValue]] = value;
     } // for
 
 } // interpolate2D
@@ -328,21 +728,21 @@ geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
                                                   const double indexFloat[]) {
     assert(values);
     assert(indexFloat);
-    assert(_hyperslab._values);
+    assert(_slabValues);
     assert(_hyperslab._dimsAll);
-    assert(_hyperslab._origin);
+    assert(_slabOrigin);
 
     const size_t spaceDim = 3;
 
     // Coordinates within hyperslab
     const double indexSlab[spaceDim] = {
-        indexFloat[0] - _hyperslab._origin[0],
-        indexFloat[1] - _hyperslab._origin[1],
-        indexFloat[2] - _hyperslab._origin[2],
+        indexFloat[0] - _slabOrigin[0],
+        indexFloat[1] - _slabOrigin[1],
+        indexFloat[2] - _slabOrigin[2],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
-    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _hyperslab._dims[2]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _slabDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _slabDims[1]-1);
+    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _slabDims[2]-1);
 
     // Coordinate of "lower" point (corner of cell with lowest indices containing target point).
     const double tolerance = 1.0e-12;
@@ -358,9 +758,9 @@ geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
         hsize_t(dfloor[1]),
         hsize_t(dfloor[2]),
     };
-    assert(ifloor[0] < _hyperslab._dims[0]);
-    assert(ifloor[1] < _hyperslab._dims[1]);
-    assert(ifloor[2] < _hyperslab._dims[2]);
+    assert(ifloor[0] < _slabDims[0]);
+    assert(ifloor[1] < _slabDims[1]);
+    assert(ifloor[2] < _slabDims[2]);
 
     // Coordinates within cell relative to "lower" point.
     const double xRef[spaceDim] = {
@@ -390,7 +790,7 @@ geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
     };
 
     // Indices into hyperslab values for cell corners
-    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dims = _slabDims;
     const hsize_t ii[2][2][2] = {
         {
             {
@@ -411,25 +811,25 @@ geomodelgrids::serial::_Hyperslab::_interpolate3D(double* const values,
         },
     };
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
-    for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
-        values[iValue] = 0;
+    const std::vector<hsize_t>& valueIndices = _hyperslab._valueIndices;
+    const size_t numValues = valueIndices.size();
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        const hsize_t offset = _slabOffsets[iValue];
+        double value = 0.0;
         bool hasNoDataValue = false;
         for (hsize_t iDim = 0; iDim < 2; ++iDim) {
             for (hsize_t jDim = 0; jDim < 2; ++jDim) {
                 for (hsize_t kDim = 0; kDim < 2; ++kDim) {
-                    const double interpolateValue = _hyperslab._values[ii[iDim][jDim][kDim] + iValue];
+                    const double interpolateValue = _slabValues[ii[iDim][jDim][kDim] + offset];
                     if (fabs(1.0 - interpolateValue/geomodelgrids::NODATA_VALUE) < 1.0e-3) {
                         hasNoDataValue = true;
                     } // if
-                    values[iValue] += wts[iDim][jDim][kDim] * interpolateValue;
+                    value += wts[iDim][jDim][kDim] * interpolateValue;
                 } // for
             } // for
         } // for
-        if (hasNoDataValue) {
-            // Set value to NODATA_VALUE if any values used in interpolation are NODATA_VALUE.
-            values[iValue] = geomodelgrids::NODATA_VALUE;
-        } // if
+        // Set value to NODATA_VALUE if any values used in interpolation are NODATA_VALUE.
+        values[valueIndices[iValue]] = (hasNoDataValue) ? geomodelgrids::NODATA_VALUE : value;
     } // for
 
 } // _interpolate3D
@@ -441,19 +841,19 @@ geomodelgrids::serial::_Hyperslab::_nearest2D(double* const values,
                                               const double indexFloat[]) {
     assert(values);
     assert(indexFloat);
-    assert(_hyperslab._values);
+    assert(_slabValues);
     assert(_hyperslab._dimsAll);
-    assert(_hyperslab._origin);
+    assert(_slabOrigin);
 
     const size_t spaceDim = 2;
 
     // Coordinates within hyperslab
     const double indexSlab[spaceDim] = {
-        indexFloat[0] - _hyperslab._origin[0],
-        indexFloat[1] - _hyperslab._origin[1],
+        indexFloat[0] - _slabOrigin[0],
+        indexFloat[1] - _slabOrigin[1],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _slabDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _slabDims[1]-1);
 
     // Coordinate of nearest point to target point.
     const double dnearest[spaceDim] = {
@@ -466,19 +866,20 @@ geomodelgrids::serial::_Hyperslab::_nearest2D(double* const values,
         hsize_t(dnearest[0]),
         hsize_t(dnearest[1]),
     };
-    assert(inearest[0] < _hyperslab._dims[0]);
-    assert(inearest[1] < _hyperslab._dims[1]);
+    assert(inearest[0] < _slabDims[0]);
+    assert(inearest[1] < _slabDims[1]);
 
     // Indices into hyperslab values for nearest point.
-    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dims = _slabDims;
     const hsize_t ii = inearest[0]*(dims[1]*dims[2]) + inearest[1]*(dims[2]);
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
-    for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
-        values[iValue] = 0;
-        const double nearestValue = _hyperslab._values[ii + iValue];
+    const std::vector<hsize_t>& valueIndices = _hyperslab._valueIndices;
+    const size_t numValues = valueIndices.size();
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        values[valueIndices[iValue]] = 0;
+        const double nearestValue = _slabValues[ii + _slabOffsets[iValue]];
         if (fabs(1.0 - nearestValue/geomodelgrids::NODATA_VALUE) < 1.0e-3) {
-            values[iValue] = geomodelgrids::NODATA_VALUE;
+            values[valueIndices[iValue]] = geomodelgrids::NODATA_VALUE;
         } // if
     } // for
 
@@ -491,21 +892,21 @@ geomodelgrids::serial::_Hyperslab::_nearest3D(double* const values,
                                               const double indexFloat[]) {
     assert(values);
     assert(indexFloat);
-    assert(_hyperslab._values);
+    assert(_slabValues);
     assert(_hyperslab._dimsAll);
-    assert(_hyperslab._origin);
+    assert(_slabOrigin);
 
     const size_t spaceDim = 3;
 
     // Coordinates within hyperslab
     const double indexSlab[spaceDim] = {
-        indexFloat[0] - _hyperslab._origin[0],
-        indexFloat[1] - _hyperslab._origin[1],
-        indexFloat[2] - _hyperslab._origin[2],
+        indexFloat[0] - _slabOrigin[0],
+        indexFloat[1] - _slabOrigin[1],
+        indexFloat[2] - _slabOrigin[2],
     };
-    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _hyperslab._dims[0]-1);
-    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _hyperslab._dims[1]-1);
-    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _hyperslab._dims[2]-1);
+    assert(indexSlab[0] >= 0.0 && indexSlab[0] <= _slabDims[0]-1);
+    assert(indexSlab[1] >= 0.0 && indexSlab[1] <= _slabDims[1]-1);
+    assert(indexSlab[2] >= 0.0 && indexSlab[2] <= _slabDims[2]-1);
 
     // Coordinate of nearest point to target point.
     const double dnearest[spaceDim] = {
@@ -520,21 +921,22 @@ geomodelgrids::serial::_Hyperslab::_nearest3D(double* const values,
         hsize_t(dnearest[1]),
         hsize_t(dnearest[2]),
     };
-    assert(inearest[0] < _hyperslab._dims[0]);
-    assert(inearest[1] < _hyperslab._dims[1]);
-    assert(inearest[2] < _hyperslab._dims[2]);
+    assert(inearest[0] < _slabDims[0]);
+    assert(inearest[1] < _slabDims[1]);
+    assert(inearest[2] < _slabDims[2]);
 
     // Indices into hyperslab values for nearest point.
-    const hsize_t* dims = _hyperslab._dims;
+    const hsize_t* dims = _slabDims;
     const hsize_t ii =
         inearest[0]*(dims[1]*dims[2]*dims[3]) + inearest[1]*(dims[2]*dims[3]) + inearest[2]*(dims[3]);
 
-    const hsize_t numValues = _hyperslab._dims[spaceDim];
-    for (hsize_t iValue = 0; iValue < numValues; ++iValue) {
-        values[iValue] = 0;
-        const double nearestValue = _hyperslab._values[ii + iValue];
+    const std::vector<hsize_t>& valueIndices = _hyperslab._valueIndices;
+    const size_t numValues = valueIndices.size();
+    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+        values[valueIndices[iValue]] = 0;
+        const double nearestValue = _slabValues[ii + _slabOffsets[iValue]];
         if (fabs(1.0 - nearestValue/geomodelgrids::NODATA_VALUE) < 1.0e-3) {
-            values[iValue] = geomodelgrids::NODATA_VALUE;
+            values[valueIndices[iValue]] = geomodelgrids::NODATA_VALUE;
         } // if
     } // for
 
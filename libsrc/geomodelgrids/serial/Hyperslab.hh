@@ -1,6 +1,16 @@
 /** Hyperslab for a chunk of data in an HDF5 file.
  *
- * The hyperslab always contains all of the values at a point and that dimension is not given in the constructor.
+ * The hyperslab always spans the values at a point and that dimension is not given in the constructor. A
+ * subset of the values may be selected, in which case only those values are read, interpolated, and
+ * stored in the sliding hyperslab and loaded regions.
+ *
+ * Datasets with the 'value_layout' attribute set to 'planar' store the values as the leading
+ * dimension (value, x, y, z) rather than the trailing dimension (x, y, z, value). The dimensions
+ * given to the hyperslab and the values in memory always have the values as the last dimension.
+ *
+ * Values stored as integers are decoded when they are read using the 'scale_factor' and 'add_offset'
+ * attributes of the dataset (value = stored * scale_factor + add_offset); stored values equal to the
+ * 'missing_value' attribute are decoded as NODATA_VALUE.
  */
 #pragma once
 
@@ -9,6 +19,7 @@
 #include <cstdlib> // USES size_t
 #include <hdf5.h> // USES hsize_t
 #include <string> // USES std::string
+#include <vector> // USES std::vector
 
 // Forward declarations of helper classes.
 namespace geomodelgrids {
@@ -30,18 +41,83 @@ public:
      * @param[in] path Full path to dataset.
      * @param[in] dims Array of hyperslab dimensions.
      * @param[in] ndims Number of dimensions in hyperslab.
+     * @param[in] valueIndices Indices of values at a point to query (empty for all values).
      */
     Hyperslab(geomodelgrids::serial::HDF5* const h5,
               const char* path,
               const hsize_t dims[],
-              const size_t ndims);
+              const size_t ndims,
+              const std::vector<size_t>& valueIndices=std::vector<size_t>());
 
     /// Destructor
     ~Hyperslab(void);
 
+    /** Load values for a region of the dataset.
+     *
+     * Queries for points within the region use these values without reading from the file; queries
+     * for points outside the region use the sliding hyperslab. The region contains the selected
+     * values at a point, so only the spatial dimensions are given.
+     *
+     * A region with a zero dimension clears the current region. With a collective dataset transfer
+     * property list, all processes must call this method, including those with empty regions.
+     *
+     * @param[in] origin Origin of region in dataset (spatial dimensions).
+     * @param[in] dims Dimensions of region (spatial dimensions).
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void loadRegion(const hsize_t origin[],
+                    const hsize_t dims[],
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Use values stored in external memory for a region of the dataset.
+     *
+     * The hyperslab does not take ownership of the values, which must remain valid as long as the
+     * region is in use (until the region is replaced or cleared, or the hyperslab is destroyed). This
+     * allows several hyperslabs, possibly in different processes, to share the same values (for
+     * example, in MPI shared memory). The layout of the values must match the dataset, including
+     * all of the values at a point, even if only a subset of the values is selected.
+     *
+     * A region with a zero dimension or nullptr for values clears the current region.
+     *
+     * @param[in] origin Origin of region in dataset (spatial dimensions).
+     * @param[in] dims Dimensions of region (spatial dimensions).
+     * @param[in] values Values for region [product of dims * number of values at a point].
+     */
+    void setRegion(const hsize_t origin[],
+                   const hsize_t dims[],
+                   const double* values);
+
+    /** Read values for a region of the dataset into a caller-supplied buffer.
+     *
+     * The region always contains all of the values at a point, independent of the selected values,
+     * so only the spatial dimensions are given. The hyperslab and its region are not modified.
+     *
+     * @param[out] values Preallocated array for values [product of dims * number of values at a point].
+     * @param[in] origin Origin of region in dataset (spatial dimensions).
+     * @param[in] dims Dimensions of region (spatial dimensions).
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void readValues(double* const values,
+                    const hsize_t origin[],
+                    const hsize_t dims[],
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Get range of a value over the region.
+     *
+     * @param[out] minValue Minimum value in region.
+     * @param[out] maxValue Maximum value in region.
+     * @param[in] index Index of value at a point.
+     * @returns True if a region is loaded and the value is selected, false otherwise.
+     */
+    bool getRegionRange(double* minValue,
+                        double* maxValue,
+                        const size_t index=0) const;
+
     /** Compute values at point using bilinear interpolation.
      *
-     * @param[out] values Preallocated array for interpolated values.
+     * Only the selected values are set; the other entries are not modified.
+     *
+     * @param[out] values Preallocated array for interpolated values [number of values at a point].
      * @param[in] indexFloat Index of target point as floating point values.
      */
     void interpolate(double* const values,
@@ -55,6 +131,58 @@ public:
     void nearest(double* const values,
                  const double indexFloat[]);
 
+    // PRIVATE METHODS --------------------------------------------------------------------------
+private:
+
+    /** Check that region is within the dataset.
+     *
+     * @param[in] origin Origin of region in dataset (spatial dimensions).
+     * @param[in] dims Dimensions of region (spatial dimensions).
+     */
+    void _checkRegion(const hsize_t origin[],
+                      const hsize_t dims[]) const;
+
+    /// Clear region.
+    void _clearRegion(void);
+
+    /** Read values from dataset with the values at a point as the last dimension.
+     *
+     * @param[out] values Preallocated array for values [product of dims * numIndices].
+     * @param[in] origin Origin of hyperslab in dataset (spatial dimensions).
+     * @param[in] dims Dimensions of hyperslab (spatial dimensions).
+     * @param[in] indices Indices of values at a point to read (nullptr for all values).
+     * @param[in] numIndices Number of indices.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void _readDataset(double* const values,
+                      const hsize_t origin[],
+                      const hsize_t dims[],
+                      const hsize_t* const indices,
+                      const size_t numIndices,
+                      const hid_t datasetTransfer);
+
+    /** Read values for the selected values at a point.
+     *
+     * @param[out] values Preallocated array for values [product of dims * number of selected values].
+     * @param[in] origin Origin of hyperslab in dataset (spatial dimensions).
+     * @param[in] dims Dimensions of hyperslab (spatial dimensions).
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void _readSelected(double* const values,
+                       const hsize_t origin[],
+                       const hsize_t dims[],
+                       const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Decode values stored as integers.
+     *
+     * @param[inout] values Values read from dataset [numPoints * number of values].
+     * @param[in] numPoints Number of points.
+     * @param[in] isSelected True if values contain only the selected values, false if they contain all values.
+     */
+    void _decodeValues(double* const values,
+                       const size_t numPoints,
+                       const bool isSelected) const;
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -63,9 +191,22 @@ private:
 
     const size_t _ndims; ///< Number of dimensions in hyperslab.
     hsize_t* _origin; ///< Origin of hyperslab relative to dataset.
-    hsize_t* _dims; ///< Dimensions of hyperslab.
-    hsize_t* _dimsAll; ///< Dimensions of entire dataset.
-    double* _values; ///< Hyperslab values.
+    hsize_t* _dims; ///< Dimensions of hyperslab (last dimension is number of selected values).
+    hsize_t* _dimsAll; ///< Dimensions of entire dataset (last dimension is values).
+    double* _values; ///< Hyperslab values (allocated when first slab is read).
+    std::vector<hsize_t> _valueIndices; ///< Indices of selected values in dataset (increasing order).
+    std::vector<hsize_t> _valueOffsets; ///< Offsets of selected values in hyperslab values.
+
+    hsize_t* _regionOrigin; ///< Origin of region relative to dataset.
+    hsize_t* _regionDims; ///< Dimensions of region.
+    const double* _regionValues; ///< Region values (owned or external).
+    const hsize_t* _regionOffsets; ///< Offsets of selected values in region values.
+    double* _regionBuffer; ///< Region values owned by hyperslab (nullptr if external).
+    double* _scaleFactor; ///< Scale factor for each value (nullptr if values are not encoded).
+    double* _addOffset; ///< Offset for each value (nullptr if values are not encoded).
+    double _missingValue; ///< Stored value for NODATA_VALUE.
+    bool _hasMissingValue; ///< True if stored values include NODATA_VALUE.
+    bool _isPlanar; ///< True if dataset stores the values as the leading dimension.
 
     geomodelgrids::serial::_Hyperslab* _hyperslab; ///< Helper object.
 
@@ -4,18 +4,125 @@
 
 #include "geomodelgrids/serial/HDF5.hh" // USES HDF5
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
+#include "geomodelgrids/serial/ModelImage.hh" // USES ModelImage
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
 #include "geomodelgrids/serial/Block.hh" // USES Block
 #include "geomodelgrids/utils/CRSTransformer.hh" // USES CRSTransformer
 #include "geomodelgrids/utils/constants.hh" // USES TOLERANCE
 
 #include <cstring> // USES strlen()
+#include <cstdlib> // USES realpath(), free()
 #include <strings.h> // USES strcasecmp()
+#include <sys/stat.h> // USES stat()
+#include <mutex> // USES std::mutex, std::lock_guard
+#include <map> // USES std::map
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
-#include <algorithm> // USES std::fill()
+#include <algorithm> // USES std::fill(), std::copy(), std::min(), std::max(), std::sort(), std::unique()
+#include <functional> // USES std::greater
+#include <limits> // USES std::numeric_limits
 #include <cassert> // USES assert()
-#include <cmath> // USES M_PI, cos(), sin()
+#include <cmath> // USES M_PI, cos(), sin(), fabs()
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        namespace _Model {
+            /// Model file and image shared by models opened for reading.
+            struct SharedFile {
+                std::weak_ptr<geomodelgrids::serial::HDF5> h5; ///< Open model file.
+                std::weak_ptr<geomodelgrids::serial::ModelImage> image; ///< Mapped model image.
+                geomodelgrids::serial::ModelImage::ModelStat modelStat; ///< Identity of model file.
+            };
+
+            /// Registry of shared model files, keyed by canonical path.
+            struct Registry {
+                std::mutex mutex; ///< Mutex for registry.
+                std::map<std::string, SharedFile> files; ///< Shared model files.
+            };
+
+            /** Get process-wide registry of shared model files.
+             *
+             * @returns Registry.
+             */
+            static
+            Registry&
+            getRegistry(void) {
+                static Registry registry;
+                return registry;
+            } // getRegistry
+
+            /** Open model file for reading, sharing it with other models with the same file.
+             *
+             * A model file that has changed since it was opened (different device, inode, size, or
+             * modification time with nanoseconds) is opened again.
+             *
+             * @param[out] h5 Model file.
+             * @param[out] image Mapped model image (empty if not present).
+             * @param[in] filename Name of model file.
+             * @returns True if model file was opened, false if the canonical path is not available.
+             */
+            static
+            bool
+            openShared(std::shared_ptr<geomodelgrids::serial::HDF5>* h5,
+                       std::shared_ptr<geomodelgrids::serial::ModelImage>* image,
+                       const char* filename) {
+                assert(h5);
+                assert(image);
+                assert(filename);
+
+                char* pathC = realpath(filename, nullptr);
+                struct stat fileStat;
+                if (!pathC || stat(pathC, &fileStat)) {
+                    free(pathC);pathC = nullptr;
+                    return false;
+                } // if
+                const std::string path(pathC);
+                free(pathC);pathC = nullptr;
+
+                Registry& registry = getRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+
+                // Remove files that are no longer used.
+                for (std::map<std::string, SharedFile>::iterator iter = registry.files.begin(); iter != registry.files.end();) {
+                    if (iter->second.h5.expired()) {
+                        iter = registry.files.erase(iter);
+                    } else {
+                        ++iter;
+                    } // if/else
+                } // for
+
+                SharedFile& file = registry.files[path];
+                *h5 = file.h5.lock();
+                const geomodelgrids::serial::ModelImage::ModelStat& modelStat =
+                    geomodelgrids::serial::ModelImage::getModelStat(fileStat);
+                if (!*h5 || !geomodelgrids::serial::ModelImage::sameModel(file.modelStat, modelStat)) {
+                    *h5 = std::make_shared<geomodelgrids::serial::HDF5>();
+                    (*h5)->open(path.c_str(), H5F_ACC_RDONLY);
+                    file.h5 = *h5;
+                    file.image.reset();
+                    file.modelStat = modelStat;
+                } // if
+
+                *image = file.image.lock();
+                if (!*image) {
+                    const std::string& imagePath = geomodelgrids::serial::ModelImage::getImagePath(filename);
+                    if (!imagePath.empty()) {
+                        *image = std::make_shared<geomodelgrids::serial::ModelImage>();
+                        if ((*image)->open(imagePath.c_str(), filename)) {
+                            file.image = *image;
+                        } else {
+                            image->reset();
+                        } // if/else
+                    } // if
+                } // if
+
+                return true;
+            } // openShared
+
+        } // _Model
+    } // serial
+} // geomodelgrids
 
 // ------------------------------------------------------------------------------------------------
 // Default constructor.
@@ -51,10 +158,18 @@ geomodelgrids::serial::Model::setInputCRS(const std::string& value) {
 // Open Model file.
 void
 geomodelgrids::serial::Model::open(const char* filename,
-                                   ModelMode mode) {
+                                   ModelMode mode,
+                                   const hid_t fileAccess) {
     assert(filename);
 
-    _h5 = std::make_unique<geomodelgrids::serial::HDF5>();
+    _h5.reset();
+    _image.reset();
+    if (( READ == mode) && ( H5P_DEFAULT == fileAccess) && _Model::openShared(&_h5, &_image, filename)) {
+        return;
+    } // if
+
+    _h5 = std::make_shared<geomodelgrids::serial::HDF5>();
+    _h5->setFileAccess(fileAccess);
     hid_t h5Mode = H5F_ACC_RDONLY;
     switch (mode) {
     case READ:
@@ -74,6 +189,14 @@ geomodelgrids::serial::Model::open(const char* filename,
     } // switch
 
     _h5->open(filename, h5Mode);
+
+    const std::string& imagePath = geomodelgrids::serial::ModelImage::getImagePath(filename);
+    if (( READ == mode) && !imagePath.empty() ) {
+        _image = std::make_shared<geomodelgrids::serial::ModelImage>();
+        if (!_image->open(imagePath.c_str(), filename)) {
+            _image.reset();
+        } // if
+    } // if
 } // open
 
 
@@ -94,9 +217,9 @@ geomodelgrids::serial::Model::close(void) {
         } // if
     } // for
 
-    if (_h5) {
-        _h5->close();
-    } // if
+    // Model file and image are closed when the last model sharing them is closed.
+    _h5.reset();
+    _image.reset();
 
     for (size_t i = 0; i < _blocks.size(); ++i) {
         _blocks[i].reset();
@@ -196,6 +319,7 @@ geomodelgrids::serial::Model::loadMetadata(void) {
         missingAttributes = true;
     } // if/else
 
+    _valueIndices.clear();
     _surfaceTop.reset();
     _surfaceTopoBathy.reset();
     if (_h5->hasGroup("surfaces")) {
@@ -266,11 +390,216 @@ geomodelgrids::serial::Model::initialize(void) {
     } // if
     size_t numBlocks = _blocks.size();
     for (size_t i = 0; i < numBlocks; ++i) {
-        _blocks[i]->openQuery(_h5.get());
+        _blocks[i]->openQuery(_h5.get(), _valueIndices);
     } // for
+
+    if (_image) {
+        // Values missing from the image (nullptr) are read from the model file.
+        if (_surfaceTop) {
+            const size_t* dims = _surfaceTop->getDims();
+            _surfaceTop->setValues(_image->getValues("surfaces/top_surface", dims[0]*dims[1]));
+        } // if
+        if (_surfaceTopoBathy) {
+            const size_t* dims = _surfaceTopoBathy->getDims();
+            _surfaceTopoBathy->setValues(_image->getValues("surfaces/topography_bathymetry", dims[0]*dims[1]));
+        } // if
+        for (size_t i = 0; i < numBlocks; ++i) {
+            const size_t* dims = _blocks[i]->getDims();
+            const size_t numValues = dims[0] * dims[1] * dims[2] * _blocks[i]->getNumValues();
+            _blocks[i]->setValues(_image->getValues(_blocks[i]->getPath().c_str(), numValues));
+        } // for
+    } // if
 } // initialize
 
 
+// ------------------------------------------------------------------------------------------------
+// Use coarser levels of blocks for queries.
+void
+geomodelgrids::serial::Model::setTargetResolution(const double resolution) {
+    for (size_t i = 0; i < _blocks.size(); ++i) {
+        _blocks[i]->setTargetResolution(_h5.get(), resolution);
+    } // for
+} // setTargetResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Query only a subset of the values in the model.
+void
+geomodelgrids::serial::Model::setValueIndices(const std::vector<size_t>& indices) {
+    const size_t numValues = _valueNames.size();
+    for (size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] >= numValues) {
+            std::ostringstream msg;
+            msg << "Index of value (" << indices[i] << ") exceeds number of values (" << numValues << ") in model.";
+            throw std::invalid_argument(msg.str());
+        } // if
+    } // for
+    _valueIndices = indices;
+} // setValueIndices
+
+
+// ------------------------------------------------------------------------------------------------
+// Compute bounding box in model coordinates of a horizontal region.
+void
+geomodelgrids::serial::Model::computeModelBoundingBox(double* xModelMin,
+                                                      double* xModelMax,
+                                                      double* yModelMin,
+                                                      double* yModelMax,
+                                                      const double xMin,
+                                                      const double xMax,
+                                                      const double yMin,
+                                                      const double yMax) const {
+    assert(xModelMin);
+    assert(xModelMax);
+    assert(yModelMin);
+    assert(yModelMax);
+    if (!_crsTransformer) {
+        throw std::logic_error("Model must be initialized before computing bounding box.");
+    } // if
+
+    // Empty region in model coordinates.
+    *xModelMin = +std::numeric_limits<double>::max();
+    *xModelMax = -std::numeric_limits<double>::max();
+    *yModelMin = +std::numeric_limits<double>::max();
+    *yModelMax = -std::numeric_limits<double>::max();
+    if (( xMin > xMax) || ( yMin > yMax) ) {
+        return;
+    } // if
+
+    // Sample boundary of region, because edges are not necessarily straight in the model CRS.
+    const size_t numEdgePoints = 9;
+    for (size_t iPt = 0; iPt < numEdgePoints; ++iPt) {
+        const double f = double(iPt) / double(numEdgePoints-1);
+        const double xEdge = xMin + f * (xMax - xMin);
+        const double yEdge = yMin + f * (yMax - yMin);
+        const size_t numCorners = 4;
+        const double xyBoundary[numCorners][2] = {
+            { xEdge, yMin },
+            { xEdge, yMax },
+            { xMin, yEdge },
+            { xMax, yEdge },
+        };
+        for (size_t i = 0; i < numCorners; ++i) {
+            double xModel = 0.0;
+            double yModel = 0.0;
+            _toModelXYZ(&xModel, &yModel, nullptr, xyBoundary[i][0], xyBoundary[i][1], 0.0);
+            *xModelMin = std::min(*xModelMin, xModel);
+            *xModelMax = std::max(*xModelMax, xModel);
+            *yModelMin = std::min(*yModelMin, yModel);
+            *yModelMax = std::max(*yModelMax, yModel);
+        } // for
+    } // for
+} // computeModelBoundingBox
+
+
+// ------------------------------------------------------------------------------------------------
+// Load model values for a horizontal region.
+void
+geomodelgrids::serial::Model::loadRegion(const double xMin,
+                                         const double xMax,
+                                         const double yMin,
+                                         const double yMax,
+                                         const hid_t datasetTransfer) {
+    const double zUnbounded = std::numeric_limits<double>::max();
+    loadRegion(xMin, xMax, yMin, yMax, -zUnbounded, +zUnbounded, datasetTransfer);
+} // loadRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Load model values for a region bounded in all three dimensions.
+void
+geomodelgrids::serial::Model::loadRegion(const double xMin,
+                                         const double xMax,
+                                         const double yMin,
+                                         const double yMax,
+                                         const double zMin,
+                                         const double zMax,
+                                         const hid_t datasetTransfer) {
+    if (!_crsTransformer) {
+        throw std::logic_error("Model must be initialized before loading region.");
+    } // if
+
+    const double zUnbounded = std::numeric_limits<double>::max();
+    const bool hasZMin = zMin > -zUnbounded;
+    const bool hasZMax = zMax < +zUnbounded;
+
+    double xModelMin = 0.0;
+    double xModelMax = 0.0;
+    double yModelMin = 0.0;
+    double yModelMax = 0.0;
+    double zModelCRSMin = +std::numeric_limits<double>::max();
+    double zModelCRSMax = -std::numeric_limits<double>::max();
+    if (zMin <= zMax) {
+        computeModelBoundingBox(&xModelMin, &xModelMax, &yModelMin, &yModelMax, xMin, xMax, yMin, yMax);
+    } else {
+        computeModelBoundingBox(&xModelMin, &xModelMax, &yModelMin, &yModelMax, 1.0, 0.0, 1.0, 0.0);
+    } // if/else
+    if (( xModelMin <= xModelMax) && ( yModelMin <= yModelMax) && ( zMin <= zMax) ) {
+        const size_t numCorners = 4;
+        const double xyCorners[numCorners][2] = {
+            { xMin, yMin },
+            { xMin, yMax },
+            { xMax, yMin },
+            { xMax, yMax },
+        };
+        const size_t numZ = 2;
+        const bool hasZ[numZ] = { hasZMin, hasZMax };
+        const double zBoundary[numZ] = { zMin, zMax };
+        for (size_t i = 0; i < numCorners; ++i) {
+            for (size_t iZ = 0; iZ < numZ; ++iZ) {
+                if (hasZ[iZ]) {
+                    double xModelCRS = 0.0;
+                    double yModelCRS = 0.0;
+                    double zModelCRS = 0.0;
+                    _crsTransformer->transform(&xModelCRS, &yModelCRS, &zModelCRS,
+                                               xyCorners[i][0], xyCorners[i][1], zBoundary[iZ]);
+                    zModelCRSMin = std::min(zModelCRSMin, zModelCRS);
+                    zModelCRSMax = std::max(zModelCRSMax, zModelCRS);
+                } // if
+            } // for
+        } // for
+    } // if
+
+    if (_surfaceTop) {
+        _surfaceTop->loadRegion(xModelMin, xModelMax, yModelMin, yModelMax, datasetTransfer);
+    } // if
+    if (_surfaceTopoBathy) {
+        _surfaceTopoBathy->loadRegion(xModelMin, xModelMax, yModelMin, yModelMax, datasetTransfer);
+    } // if
+
+    // Map elevation range to model z coordinate. The mapping is monotonic in both the elevation and
+    // the elevation of the top surface, so the extremes occur at the corners of the two ranges.
+    double zModelMin = hasZMin ? +zUnbounded : -zUnbounded;
+    double zModelMax = hasZMax ? -zUnbounded : +zUnbounded;
+    if (( zModelCRSMin <= zModelCRSMax) && ( hasZMin || hasZMax) ) {
+        double groundMin = 0.0;
+        double groundMax = 0.0;
+        if (_surfaceTop && !_surfaceTop->getRegionElevationRange(&groundMin, &groundMax)) {
+            groundMin = groundMax = 0.0;
+        } // if
+        const double zBottom = -_dims[2];
+        const double zCRS[2] = { zModelCRSMin, zModelCRSMax };
+        const double zGround[2] = { groundMin, groundMax };
+        for (size_t iZ = 0; iZ < 2; ++iZ) {
+            for (size_t iG = 0; iG < 2; ++iG) {
+                const double zModel = zBottom * (zGround[iG] - zCRS[iZ]) / (zGround[iG] - zBottom);
+                if (hasZMin) {
+                    zModelMin = std::min(zModelMin, zModel);
+                } // if
+                if (hasZMax) {
+                    zModelMax = std::max(zModelMax, zModel);
+                } // if
+            } // for
+        } // for
+    } // if
+
+    size_t numBlocks = _blocks.size();
+    for (size_t i = 0; i < numBlocks; ++i) {
+        _blocks[i]->loadRegion(xModelMin, xModelMax, yModelMin, yModelMax, zModelMin, zModelMax, datasetTransfer);
+    } // for
+} // loadRegion
+
+
 // ------------------------------------------------------------------------------------------------
 // Get names of values in model.
 const std::vector<std::string>&
@@ -359,6 +688,14 @@ geomodelgrids::serial::Model::getBlocks(void) const {
 } // getBlocks
 
 
+// ------------------------------------------------------------------------------------------------
+// Does model use values from a model image?
+bool
+geomodelgrids::serial::Model::hasImage(void) const {
+    return bool(_image);
+} // hasImage
+
+
 // ------------------------------------------------------------------------------------------------
 // Does model
 bool
@@ -458,6 +795,312 @@ geomodelgrids::serial::Model::query(const double x,
 } // query
 
 
+// ------------------------------------------------------------------------------------------------
+// Query for model values at points along a vertical column using bilinear interpolation.
+size_t
+geomodelgrids::serial::Model::queryColumn(double* const values,
+                                          bool* const inModel,
+                                          const double x,
+                                          const double y,
+                                          const double* const elevations,
+                                          const size_t numPoints) {
+    assert(values);
+    assert(inModel);
+    assert(elevations);
+    assert(_crsTransformer);
+
+    std::fill(inModel, inModel+numPoints, false);
+    if (!numPoints) {
+        return 0;
+    } // if
+
+    // Transform top and bottom of column; interpolate vertical coordinate between them.
+    double zMin = elevations[0];
+    double zMax = elevations[0];
+    for (size_t i = 1; i < numPoints; ++i) {
+        zMin = std::min(zMin, elevations[i]);
+        zMax = std::max(zMax, elevations[i]);
+    } // for
+    double xModelCRS = 0.0;
+    double yModelCRS = 0.0;
+    double zMaxModelCRS = 0.0;
+    _crsTransformer->transform(&xModelCRS, &yModelCRS, &zMaxModelCRS, x, y, zMax);
+    double zScale = 1.0;
+    if (zMax > zMin) {
+        double xTmp = 0.0;
+        double yTmp = 0.0;
+        double zMinModelCRS = 0.0;
+        _crsTransformer->transform(&xTmp, &yTmp, &zMinModelCRS, x, y, zMin);
+        zScale = (zMaxModelCRS - zMinModelCRS) / (zMax - zMin);
+    } // if
+
+    const double yazimuthRad = _yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    const double xRel = xModelCRS - _origin[0];
+    const double yRel = yModelCRS - _origin[1];
+    const double xModel = xRel*cosAz - yRel*sinAz;
+    const double yModel = xRel*sinAz + yRel*cosAz;
+    if (( xModel < 0.0) || ( xModel > _dims[0]) ||
+        ( yModel < 0.0) || ( yModel > _dims[1]) ) {
+        return 0;
+    } // if
+
+    const double zGroundSurf = (_surfaceTop) ? _surfaceTop->query(xModel, yModel) : 0.0;
+    const double zBottom = -_dims[2];
+    const size_t numValues = _valueNames.size();
+    size_t numInModel = 0;
+    for (size_t i = 0; i < numPoints; ++i) {
+        const double zModelCRS = zMaxModelCRS + zScale * (elevations[i] - zMax);
+        double zModel = zBottom * (zGroundSurf - zModelCRS) / (zGroundSurf - zBottom);
+        if ((zModel > 0.0) && (zModel < TOLERANCE)) {
+            zModel = 0.0;
+        } // if
+        if (( zModel > 0.0) || ( zModel < zBottom) ) {
+            continue;
+        } // if
+
+        std::shared_ptr<geomodelgrids::serial::Block> block = _findBlock(xModel, yModel, zModel);assert(block);
+        const double* blockValues = block->query(xModel, yModel, zModel);
+        std::copy(blockValues, blockValues+numValues, &values[i*numValues]);
+        inModel[i] = true;
+        ++numInModel;
+    } // for
+
+    return numInModel;
+} // queryColumn
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for model values at points on a regular grid using bilinear interpolation.
+size_t
+geomodelgrids::serial::Model::queryGrid(double* const values,
+                                        bool* const inModel,
+                                        const double origin[3],
+                                        const double spacing[3],
+                                        const size_t dims[3],
+                                        const double azimuth) {
+    assert(values);
+    assert(inModel);
+    assert(origin);
+    assert(spacing);
+    assert(dims);
+    assert(_crsTransformer);
+
+    const size_t numPoints = dims[0] * dims[1] * dims[2];
+    std::fill(inModel, inModel+numPoints, false);
+    if (!numPoints) {
+        return 0;
+    } // if
+
+    const double azimuthRad = azimuth * M_PI / 180.0;
+    const double gridDirX[2] = { cos(azimuthRad), -sin(azimuthRad) };
+    const double gridDirY[2] = { sin(azimuthRad), cos(azimuthRad) };
+    const double yazimuthRad = _yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+
+    // Transform grid point to model x and y coordinates and vertical coordinate in model CRS.
+    auto gridToModel = [&](const double i,
+                           const double j,
+                           const double k,
+                           double* xModel,
+                           double* yModel,
+                           double* zModelCRS) {
+        const double x = origin[0] + i*spacing[0]*gridDirX[0] + j*spacing[1]*gridDirY[0];
+        const double y = origin[1] + i*spacing[0]*gridDirX[1] + j*spacing[1]*gridDirY[1];
+        const double z = origin[2] + k*spacing[2];
+        double xModelCRS = 0.0;
+        double yModelCRS = 0.0;
+        _crsTransformer->transform(&xModelCRS, &yModelCRS, zModelCRS, x, y, z);
+        const double xRel = xModelCRS - _origin[0];
+        const double yRel = yModelCRS - _origin[1];
+        *xModel = xRel*cosAz - yRel*sinAz;
+        *yModel = xRel*sinAz + yRel*cosAz;
+    };
+
+    // Fit affine map from grid indices to model coordinates and check it at the far corner and
+    // center of the grid.
+    double xOrigin = 0.0;
+    double yOrigin = 0.0;
+    double zOriginCRS = 0.0;
+    double xTmp = 0.0;
+    double yTmp = 0.0;
+    double zTmp = 0.0;
+    gridToModel(0.0, 0.0, 0.0, &xOrigin, &yOrigin, &zOriginCRS);
+    gridToModel(1.0, 0.0, 0.0, &xTmp, &yTmp, &zTmp);
+    const double dxI = xTmp - xOrigin;
+    const double dyI = yTmp - yOrigin;
+    gridToModel(0.0, 1.0, 0.0, &xTmp, &yTmp, &zTmp);
+    const double dxJ = xTmp - xOrigin;
+    const double dyJ = yTmp - yOrigin;
+    gridToModel(0.0, 0.0, 1.0, &xTmp, &yTmp, &zTmp);
+    const double dzK = zTmp - zOriginCRS;
+
+    bool isAffine = true;
+    const size_t numCheck = 2;
+    const double checkIndex[numCheck][3] = {
+        { double(dims[0]-1), double(dims[1]-1), double(dims[2]-1) },
+        { 0.5*(dims[0]-1), 0.5*(dims[1]-1), 0.5*(dims[2]-1) },
+    };
+    for (size_t iCheck = 0; iCheck < numCheck && isAffine; ++iCheck) {
+        const double* index = checkIndex[iCheck];
+        gridToModel(index[0], index[1], index[2], &xTmp, &yTmp, &zTmp);
+        if (( fabs(xTmp - (xOrigin + index[0]*dxI + index[1]*dxJ)) > TOLERANCE) ||
+            ( fabs(yTmp - (yOrigin + index[0]*dyI + index[1]*dyJ)) > TOLERANCE) ||
+            ( fabs(zTmp - (zOriginCRS + index[2]*dzK)) > TOLERANCE) ) {
+            isAffine = false;
+        } // if
+    } // for
+    const bool isAligned = isAffine &&
+                           fabs(dxJ)*(dims[1]-1) <= TOLERANCE &&
+                           fabs(dyI)*(dims[0]-1) <= TOLERANCE;
+
+    // Indices along the horizontal axes of each block for grids aligned with the model axes.
+    const size_t numBlocks = _blocks.size();
+    std::vector<double> indexX;
+    std::vector<double> indexY;
+    if (isAligned) {
+        indexX.resize(numBlocks*dims[0]);
+        indexY.resize(numBlocks*dims[1]);
+        for (size_t iBlock = 0; iBlock < numBlocks; ++iBlock) {
+            for (size_t i = 0; i < dims[0]; ++i) {
+                const double xModel = xOrigin + i*dxI;
+                if (( xModel >= 0.0) && ( xModel <= _dims[0]) ) {
+                    indexX[iBlock*dims[0]+i] = _blocks[iBlock]->getIndex(0, xModel);
+                } // if
+            } // for
+            for (size_t j = 0; j < dims[1]; ++j) {
+                const double yModel = yOrigin + j*dyJ;
+                if (( yModel >= 0.0) && ( yModel <= _dims[1]) ) {
+                    indexY[iBlock*dims[1]+j] = _blocks[iBlock]->getIndex(1, yModel);
+                } // if
+            } // for
+        } // for
+    } // if
+
+    const double zBottom = -_dims[2];
+    const size_t numValues = _valueNames.size();
+    size_t numInModel = 0;
+    for (size_t i = 0; i < dims[0]; ++i) {
+        for (size_t j = 0; j < dims[1]; ++j) {
+            double xModel = 0.0;
+            double yModel = 0.0;
+            double zTopModelCRS = 0.0;
+            double zScale = 0.0;
+            if (isAffine) {
+                xModel = xOrigin + i*dxI + j*dxJ;
+                yModel = yOrigin + i*dyI + j*dyJ;
+                zTopModelCRS = zOriginCRS;
+                zScale = dzK;
+            } else {
+                // Vertical transformation is affine; get it from the top and bottom of the column.
+                gridToModel(i, j, 0.0, &xModel, &yModel, &zTopModelCRS);
+                if (dims[2] > 1) {
+                    gridToModel(i, j, dims[2]-1, &xTmp, &yTmp, &zTmp);
+                    zScale = (zTmp - zTopModelCRS) / (dims[2]-1);
+                } // if
+            } // if/else
+            if (( xModel < 0.0) || ( xModel > _dims[0]) ||
+                ( yModel < 0.0) || ( yModel > _dims[1]) ) {
+                continue;
+            } // if
+
+            const double zGroundSurf = (_surfaceTop) ? _surfaceTop->query(xModel, yModel) : 0.0;
+            for (size_t k = 0; k < dims[2]; ++k) {
+                const double zModelCRS = zTopModelCRS + k*zScale;
+                double zModel = zBottom * (zGroundSurf - zModelCRS) / (zGroundSurf - zBottom);
+                if ((zModel > 0.0) && (zModel < TOLERANCE)) {
+                    zModel = 0.0;
+                } // if
+                if (( zModel > 0.0) || ( zModel < zBottom) ) {
+                    continue;
+                } // if
+
+                size_t iBlock = 0;
+                while (iBlock < numBlocks &&
+                       !(( zModel <= _blocks[iBlock]->getZTop()) && ( zModel >= _blocks[iBlock]->getZBottom()) )) {
+                    ++iBlock;
+                } // while
+                if (iBlock == numBlocks) {
+                    continue;
+                } // if
+                const std::shared_ptr<geomodelgrids::serial::Block>& block = _blocks[iBlock];assert(block);
+
+                double index[3];
+                index[0] = (isAligned) ? indexX[iBlock*dims[0]+i] : block->getIndex(0, xModel);
+                index[1] = (isAligned) ? indexY[iBlock*dims[1]+j] : block->getIndex(1, yModel);
+                index[2] = block->getIndex(2, zModel);
+                const double* blockValues = block->queryIndex(index);
+
+                const size_t iPt = (i*dims[1] + j)*dims[2] + k;
+                std::copy(blockValues, blockValues+numValues, &values[iPt*numValues]);
+                inModel[iPt] = true;
+                ++numInModel;
+            } // for
+        } // for
+    } // for
+
+    return numInModel;
+} // queryGrid
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevations of grid points along a vertical column.
+std::vector<double>
+geomodelgrids::serial::Model::queryNodeElevations(const double x,
+                                                  const double y) {
+    assert(_crsTransformer);
+
+    std::vector<double> elevations;
+
+    // Vertical transformation is affine; get it from two points.
+    const double zBottom = -_dims[2];
+    double xModelCRS = 0.0;
+    double yModelCRS = 0.0;
+    double zTopModelCRS = 0.0;
+    _crsTransformer->transform(&xModelCRS, &yModelCRS, &zTopModelCRS, x, y, 0.0);
+    double zScale = 1.0;
+    if (zBottom < 0.0) {
+        double xTmp = 0.0;
+        double yTmp = 0.0;
+        double zBottomModelCRS = 0.0;
+        _crsTransformer->transform(&xTmp, &yTmp, &zBottomModelCRS, x, y, zBottom);
+        zScale = (zTopModelCRS - zBottomModelCRS) / (0.0 - zBottom);
+    } // if
+
+    const double yazimuthRad = _yazimuth * M_PI / 180.0;
+    const double cosAz = cos(yazimuthRad);
+    const double sinAz = sin(yazimuthRad);
+    const double xRel = xModelCRS - _origin[0];
+    const double yRel = yModelCRS - _origin[1];
+    const double xModel = xRel*cosAz - yRel*sinAz;
+    const double yModel = xRel*sinAz + yRel*cosAz;
+    if (( xModel < 0.0) || ( xModel > _dims[0]) ||
+        ( yModel < 0.0) || ( yModel > _dims[1]) ) {
+        return elevations;
+    } // if
+
+    const double zGroundSurf = (_surfaceTop) ? _surfaceTop->query(xModel, yModel) : 0.0;
+    for (auto block : _blocks) {
+        assert(block);
+        const size_t numZ = block->getDims()[2];
+        const double* coordinatesZ = block->getCoordinatesZ();
+        const double zTop = block->getZTop();
+        const double dz = block->getResolutionZ();
+        for (size_t i = 0; i < numZ; ++i) {
+            const double zModel = (coordinatesZ) ? coordinatesZ[i] : zTop - i*dz;
+            const double zModelCRS = zGroundSurf - zModel * (zGroundSurf - zBottom) / zBottom;
+            elevations.push_back((zModelCRS - zTopModelCRS) / zScale);
+        } // for
+    } // for
+    std::sort(elevations.begin(), elevations.end(), std::greater<double>());
+    elevations.erase(std::unique(elevations.begin(), elevations.end()), elevations.end());
+
+    return elevations;
+} // queryNodeElevations
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::serial::Model::_toModelXYZ(double* xModel,
@@ -5,6 +5,7 @@
 #include "serialfwd.hh" // forward declarations
 #include "geomodelgrids/utils/utilsfwd.hh" // HOLDSA CRSTransformer
 
+#include <hdf5.h> // USES hid_t
 #include <memory> // HASA std::std::shared_ptr
 #include <vector> // HASA std::std::vector
 #include <string> // HASA std::string
@@ -42,12 +43,23 @@ public:
     void setInputCRS(const std::string& value);
 
     /** Open Model.
+     *
+     * When opening a model for reading, a model image (see ModelImage) matching the model file is
+     * mapped read only if present, and queries use the values in the image instead of reading them
+     * from the model file. The metadata is always read from the model file.
+     *
+     * Models opened for reading with the default file access property list share the open model
+     * file (including its metadata snapshot, open datasets, and chunk cache) and the mapped image
+     * with all other such models in the process that have the same file (by canonical path). The
+     * file is closed when the last model using it is closed.
      *
      * @param[in] filename Name of Model file
      * @param[in] mode Mode for Model file
+     * @param[in] fileAccess HDF5 file access property list (for example, MPI-IO driver).
      */
     void open(const char* filename,
-              ModelMode mode);
+              ModelMode mode,
+              const hid_t fileAccess=H5P_DEFAULT);
 
     /// Close Model file.
     void close(void);
@@ -60,6 +72,94 @@ public:
      */
     void initialize(void);
 
+    /** Use coarser levels of blocks for queries.
+     *
+     * Each block uses the coarsest level stored in the model with a horizontal resolution at least
+     * as fine as the target resolution, or the full resolution block if no level is fine enough.
+     * Values for coarser levels are always read from the model file (not a model image). Must be
+     * called AFTER loadMetadata() and BEFORE initialize().
+     *
+     * @param[in] resolution Target horizontal resolution (m) (<= 0 for full resolution).
+     */
+    void setTargetResolution(const double resolution);
+
+    /** Query only a subset of the values in the model.
+     *
+     * Blocks read and interpolate only the selected values; the other values returned by block
+     * queries are NODATA_VALUE. Must be called AFTER loadMetadata() and BEFORE initialize().
+     *
+     * @param[in] indices Indices of values in model to query (empty for all values).
+     */
+    void setValueIndices(const std::vector<size_t>& indices);
+
+    /** Compute bounding box in model coordinates of a horizontal region.
+     *
+     * The boundary of the region is sampled, because its edges are not necessarily straight in the
+     * model coordinate system. An empty region (xMin > xMax or yMin > yMax) gives an empty bounding
+     * box. Must be called AFTER initialize().
+     *
+     * @param[out] xModelMin Minimum x coordinate of region in model coordinate system.
+     * @param[out] xModelMax Maximum x coordinate of region in model coordinate system.
+     * @param[out] yModelMin Minimum y coordinate of region in model coordinate system.
+     * @param[out] yModelMax Maximum y coordinate of region in model coordinate system.
+     * @param[in] xMin Minimum x coordinate of region (in input CRS).
+     * @param[in] xMax Maximum x coordinate of region (in input CRS).
+     * @param[in] yMin Minimum y coordinate of region (in input CRS).
+     * @param[in] yMax Maximum y coordinate of region (in input CRS).
+     */
+    void computeModelBoundingBox(double* xModelMin,
+                                 double* xModelMax,
+                                 double* yModelMin,
+                                 double* yModelMax,
+                                 const double xMin,
+                                 const double xMax,
+                                 const double yMin,
+                                 const double yMax) const;
+
+    /** Load model values for a horizontal region.
+     *
+     * Loads the portions of the surfaces and blocks covering the region into memory, so that queries
+     * for points in the region do not read from the model file. Must be called AFTER initialize().
+     *
+     * An empty region (xMin > xMax or yMin > yMax) clears any loaded region. With a collective
+     * dataset transfer property list, all processes must call this method, including those with empty
+     * regions.
+     *
+     * @param[in] xMin Minimum x coordinate of region (in input CRS).
+     * @param[in] xMax Maximum x coordinate of region (in input CRS).
+     * @param[in] yMin Minimum y coordinate of region (in input CRS).
+     * @param[in] yMax Maximum y coordinate of region (in input CRS).
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void loadRegion(const double xMin,
+                    const double xMax,
+                    const double yMin,
+                    const double yMax,
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Load model values for a region bounded in all three dimensions.
+     *
+     * Same as loadRegion() for a horizontal region, but only the portions of the blocks that may
+     * contain points with elevations between zMin and zMax are loaded. The elevation range is mapped
+     * to the model z coordinate using the range of the top surface over the region, so the top
+     * surface is always loaded for the entire horizontal region.
+     *
+     * @param[in] xMin Minimum x coordinate of region (in input CRS).
+     * @param[in] xMax Maximum x coordinate of region (in input CRS).
+     * @param[in] yMin Minimum y coordinate of region (in input CRS).
+     * @param[in] yMax Maximum y coordinate of region (in input CRS).
+     * @param[in] zMin Minimum elevation of region (in input CRS).
+     * @param[in] zMax Maximum elevation of region (in input CRS).
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void loadRegion(const double xMin,
+                    const double xMax,
+                    const double yMin,
+                    const double yMax,
+                    const double zMin,
+                    const double zMax,
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
     /** Get names of values in model.
      *
      * @returns Array of names of values in model.
@@ -126,6 +226,12 @@ public:
      */
     const std::vector<std::shared_ptr<geomodelgrids::serial::Block> >& getBlocks(void) const;
 
+    /** Does model use values from a model image?
+     *
+     * @returns True if a model image was mapped when opening the model, false otherwise.
+     */
+    bool hasImage(void) const;
+
     /** Does model contain given point?
      *
      * @param[in] x X coordinate of point (in input CRS).
@@ -166,6 +272,68 @@ public:
                         const double y,
                         const double z);
 
+    /** Query for model values at points along a vertical column using bilinear interpolation.
+     *
+     * The horizontal coordinates are transformed and the top surface is queried once for the
+     * column rather than once per point. The transformation of the vertical coordinate is
+     * interpolated linearly between the top and bottom of the column, which is exact for changes
+     * in vertical datum and vertical units.
+     *
+     * @param[out] values Array of model values at points in model [numPoints*numValues].
+     * @param[out] inModel Array of flags indicating if model contains point [numPoints].
+     * @param[in] x X coordinate of column (in input CRS).
+     * @param[in] y Y coordinate of column (in input CRS).
+     * @param[in] elevations Array of elevations of points (in input CRS) [numPoints].
+     * @param[in] numPoints Number of points in column.
+     * @returns Number of points in model.
+     */
+    size_t queryColumn(double* const values,
+                       bool* const inModel,
+                       const double x,
+                       const double y,
+                       const double* const elevations,
+                       const size_t numPoints);
+
+    /** Query for model values at points on a regular grid using bilinear interpolation.
+     *
+     * Grid point (i, j, k) is at origin + i*spacing[0] along the grid x axis, + j*spacing[1] along
+     * the grid y axis, and at elevation origin[2] + k*spacing[2]; the grid y axis is rotated by
+     * azimuth (degrees clockwise from north) in the input CRS. Values are ordered with k varying
+     * fastest, matching the storage order of the blocks.
+     *
+     * When the map from the grid to the model coordinate system is affine (for example, the input
+     * CRS matches the model CRS), the coordinates are transformed only for the grid origin and axes.
+     * When the grid axes are also aligned with the model axes, the indices along the x and y axes of
+     * each block are computed once per axis rather than once per point. Otherwise, the horizontal
+     * coordinates are transformed once per vertical column.
+     *
+     * @param[out] values Array of model values at points in model [numPoints*numValues].
+     * @param[out] inModel Array of flags indicating if model contains point [numPoints].
+     * @param[in] origin Coordinates of grid origin (in input CRS) [3].
+     * @param[in] spacing Grid spacing along grid x and y axes and in elevation [3].
+     * @param[in] dims Number of points along grid x, y, and z axes [3].
+     * @param[in] azimuth Azimuth (degrees) of grid y axis.
+     * @returns Number of points in model.
+     */
+    size_t queryGrid(double* const values,
+                     bool* const inModel,
+                     const double origin[3],
+                     const double spacing[3],
+                     const size_t dims[3],
+                     const double azimuth=0.0);
+
+    /** Query for elevations of grid points along a vertical column.
+     *
+     * Model values vary linearly with elevation between consecutive grid points, so values at
+     * these elevations resolve the column exactly.
+     *
+     * @param[in] x X coordinate of column (in input CRS).
+     * @param[in] y Y coordinate of column (in input CRS).
+     * @returns Elevations (in input CRS) of grid points in descending order (empty if column is outside model).
+     */
+    std::vector<double> queryNodeElevations(const double x,
+                                            const double y);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -208,12 +376,14 @@ private:
     double _yazimuth; ///< Azimuth of y coordinate axis.
     double _dims[3]; ///< Dimensions of model along coordinate axes.
 
-    std::unique_ptr<geomodelgrids::serial::HDF5> _h5; ///< Model file.
+    std::shared_ptr<geomodelgrids::serial::HDF5> _h5; ///< Model file (may be shared).
+    std::shared_ptr<geomodelgrids::serial::ModelImage> _image; ///< Mapped model image (may be shared).
     std::shared_ptr<geomodelgrids::serial::ModelInfo> _info; ///< Model description information.
     std::shared_ptr<geomodelgrids::serial::Surface> _surfaceTop; ///< Top surface of model.
     std::shared_ptr<geomodelgrids::serial::Surface> _surfaceTopoBathy; ///< Model topography/bathymetry.
     std::shared_ptr<geomodelgrids::utils::CRSTransformer> _crsTransformer; ///< Coordinate system transformer.
     std::vector<std::shared_ptr<geomodelgrids::serial::Block> > _blocks; ///< Model blocks.
+    std::vector<size_t> _valueIndices; ///< Indices of values to query (empty for all values).
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
@@ -0,0 +1,379 @@
+#include <portinfo>
+
+#include "ModelImage.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Surface.hh" // USES Surface
+#include "geomodelgrids/serial/Block.hh" // USES Block
+
+#include <sys/mman.h> // USES mmap(), munmap()
+#include <sys/stat.h> // USES stat(), fstat(), fchmod()
+#include <fcntl.h> // USES open()
+#include <unistd.h> // USES close(), ftruncate(), unlink(), geteuid()
+#include <cstdio> // USES rename()
+#include <cstdlib> // USES getenv(), realpath(), free(), mkstemp()
+#include <cstring> // USES strncpy(), strncmp(), memcpy()
+#include <cstdint> // USES uint64_t, int64_t
+#include <vector> // USES std::vector
+#include <iomanip> // USES std::setw(), std::setfill()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace serial {
+        namespace _ModelImage {
+            static const char magic[8] = { 'G', 'M', 'G', 'I', 'M', 'A', 'G', 'E' };
+            static const uint64_t version = 2;
+            static const size_t nameLength = 256;
+            static const size_t alignment = 4096;
+
+            /// Image header.
+            struct Header {
+                char magic[8]; ///< Identifier for image files.
+                uint64_t version; ///< Version of image format.
+                uint64_t numArrays; ///< Number of arrays in image.
+                geomodelgrids::serial::ModelImage::ModelStat model; ///< Identity of model file.
+            }; // Header
+
+            /// Entry in table of arrays following header.
+            struct Array {
+                char name[nameLength]; ///< Name of surface or block dataset.
+                uint64_t offset; ///< Offset of values in bytes from start of image.
+                uint64_t numValues; ///< Number of values.
+            }; // Array
+
+            /// Surface or block to write to image.
+            struct Source {
+                std::string name;
+                size_t numValues;
+                geomodelgrids::serial::Surface* surface;
+                geomodelgrids::serial::Block* block;
+            }; // Source
+
+            /** Check whether image file can be trusted.
+             *
+             * Images usually live in a world-writable directory, so an image must be a regular file
+             * owned by the current user or the owner of the model file and not writable by others.
+             *
+             * @param[in] imageStat Status of image file from fstat().
+             * @param[in] modelStat Status of model file from stat().
+             * @returns True if image can be trusted, false otherwise.
+             */
+            bool isTrusted(const struct stat& imageStat,
+                           const struct stat& modelStat);
+
+            /** Round offset up to alignment.
+             *
+             * @param[in] offset Offset in bytes.
+             * @returns Aligned offset in bytes.
+             */
+            size_t align(const size_t offset);
+
+        } // _ModelImage
+    } // serial
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Default constructor.
+geomodelgrids::serial::ModelImage::ModelImage(void) :
+    _data(nullptr),
+    _size(0) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::ModelImage::~ModelImage(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get path of image for model file.
+std::string
+geomodelgrids::serial::ModelImage::getImagePath(const char* modelFilename,
+                                                const char* imageDir) {
+    assert(modelFilename);
+
+    if (!imageDir) {
+        imageDir = getenv("GEOMODELGRIDS_IMAGE_DIR");
+    } // if
+    const std::string dir = imageDir ? imageDir : "/dev/shm";
+    if (dir.empty()) {
+        return std::string();
+    } // if
+
+    // Use hash of absolute path of model file to distinguish models with the same name.
+    char* absPathC = realpath(modelFilename, nullptr);
+    const std::string absPath = absPathC ? absPathC : modelFilename;
+    free(absPathC);absPathC = nullptr;
+
+    uint64_t hash = 14695981039346656037ULL; // FNV-1a
+    for (size_t i = 0; i < absPath.length(); ++i) {
+        hash ^= uint64_t((unsigned char)absPath[i]);
+        hash *= 1099511628211ULL;
+    } // for
+
+    const size_t pos = absPath.find_last_of('/');
+    const std::string basename = (pos != std::string::npos) ? absPath.substr(pos+1) : absPath;
+
+    std::ostringstream path;
+    path << dir << "/geomodelgrids-" << basename << "-" << std::hex << std::setw(16) << std::setfill('0') << hash
+         << ".img";
+    return path.str();
+} // getImagePath
+
+
+// ------------------------------------------------------------------------------------------------
+// Write image of model values.
+size_t
+geomodelgrids::serial::ModelImage::write(const char* imagePath,
+                                         const char* modelFilename,
+                                         geomodelgrids::serial::Model& model) {
+    assert(imagePath);
+    assert(modelFilename);
+
+    // Layout of image: header, table of arrays, values for each array (aligned to page boundaries).
+    std::vector<_ModelImage::Source> sources;
+    if (model.getTopSurface()) {
+        const size_t* dims = model.getTopSurface()->getDims();
+        _ModelImage::Source source = { "surfaces/top_surface", dims[0]*dims[1], model.getTopSurface().get(), nullptr };
+        sources.push_back(source);
+    } // if
+    if (model.getTopoBathy()) {
+        const size_t* dims = model.getTopoBathy()->getDims();
+        _ModelImage::Source source = {
+            "surfaces/topography_bathymetry", dims[0]*dims[1], model.getTopoBathy().get(), nullptr,
+        };
+        sources.push_back(source);
+    } // if
+    const std::vector<std::shared_ptr<geomodelgrids::serial::Block> >& blocks = model.getBlocks();
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const size_t* dims = blocks[i]->getDims();
+        _ModelImage::Source source = {
+            std::string("blocks/") + blocks[i]->getName(), dims[0]*dims[1]*dims[2]*blocks[i]->getNumValues(),
+            nullptr, blocks[i].get(),
+        };
+        sources.push_back(source);
+    } // for
+
+    const size_t numArrays = sources.size();
+    _ModelImage::Header header;
+    memcpy(header.magic, _ModelImage::magic, sizeof(header.magic));
+    header.version = _ModelImage::version;
+    header.numArrays = numArrays;
+    struct stat modelStat;
+    if (stat(modelFilename, &modelStat) != 0) {
+        std::ostringstream msg;
+        msg << "Could not get status of model file '" << modelFilename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    header.model = getModelStat(modelStat);
+
+    std::vector<_ModelImage::Array> arrays(numArrays);
+    size_t imageSize = _ModelImage::align(sizeof(_ModelImage::Header) + numArrays*sizeof(_ModelImage::Array));
+    for (size_t i = 0; i < numArrays; ++i) {
+        if (sources[i].name.length() >= _ModelImage::nameLength) {
+            std::ostringstream msg;
+            msg << "Name of dataset '" << sources[i].name << "' too long for model image.";
+            throw std::length_error(msg.str());
+        } // if
+        memset(arrays[i].name, 0, _ModelImage::nameLength);
+        strncpy(arrays[i].name, sources[i].name.c_str(), _ModelImage::nameLength-1);
+        arrays[i].offset = imageSize;
+        arrays[i].numValues = sources[i].numValues;
+        imageSize = _ModelImage::align(imageSize + sources[i].numValues*sizeof(double));
+    } // for
+
+    // Write to temporary file and rename, so readers never see a partial image. The temporary file
+    // has a unique name and is created exclusively, so we never write through a file planted in a
+    // shared directory.
+    std::string tmpPath = std::string(imagePath) + ".tmp.XXXXXX";
+    const int fd = mkstemp(&tmpPath[0]);
+    if (fd < 0) {
+        std::ostringstream msg;
+        msg << "Could not create model image '" << tmpPath << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    void* data = MAP_FAILED;
+    if (( 0 == fchmod(fd, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH)) && ( 0 == ftruncate(fd, off_t(imageSize))) ) {
+        data = mmap(nullptr, imageSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    } // if
+    ::close(fd);
+    if (MAP_FAILED == data) {
+        unlink(tmpPath.c_str());
+        std::ostringstream msg;
+        msg << "Could not allocate " << imageSize << " bytes for model image '" << tmpPath << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    char* buffer = static_cast<char*>(data);
+    try {
+        memcpy(buffer, &header, sizeof(header));
+        memcpy(buffer + sizeof(header), arrays.data(), numArrays*sizeof(_ModelImage::Array));
+        for (size_t i = 0; i < numArrays; ++i) {
+            double* values = reinterpret_cast<double*>(buffer + arrays[i].offset);
+            if (sources[i].surface) {
+                sources[i].surface->readValues(values, 0, sources[i].surface->getDims()[0]);
+            } else {
+                assert(sources[i].block);
+                sources[i].block->readValues(values, 0, sources[i].block->getDims()[0]);
+            } // if/else
+        } // for
+    } catch (...) {
+        munmap(data, imageSize);
+        unlink(tmpPath.c_str());
+        throw;
+    } // try/catch
+    munmap(data, imageSize);
+
+    if (rename(tmpPath.c_str(), imagePath) != 0) {
+        unlink(tmpPath.c_str());
+        std::ostringstream msg;
+        msg << "Could not rename model image '" << tmpPath << "' to '" << imagePath << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    return imageSize;
+} // write
+
+
+// ------------------------------------------------------------------------------------------------
+// Map image read only.
+bool
+geomodelgrids::serial::ModelImage::open(const char* imagePath,
+                                        const char* modelFilename) {
+    assert(imagePath);
+    assert(modelFilename);
+
+    close();
+
+    const int fd = ::open(imagePath, O_RDONLY | O_NOFOLLOW);
+    if (fd < 0) {
+        return false;
+    } // if
+    struct stat imageStat;
+    struct stat modelStat;
+    if (( fstat(fd, &imageStat) != 0) || ( stat(modelFilename, &modelStat) != 0) ||
+        !_ModelImage::isTrusted(imageStat, modelStat) ||
+        ( size_t(imageStat.st_size) < sizeof(_ModelImage::Header)) ) {
+        ::close(fd);
+        return false;
+    } // if
+    const size_t size = imageStat.st_size;
+    void* data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (MAP_FAILED == data) {
+        return false;
+    } // if
+
+    // Verify header and table of arrays.
+    const _ModelImage::Header* header = static_cast<const _ModelImage::Header*>(data);
+    bool isValid = 0 == memcmp(header->magic, _ModelImage::magic, sizeof(header->magic)) &&
+                   _ModelImage::version == header->version &&
+                   sameModel(getModelStat(modelStat), header->model) &&
+                   sizeof(_ModelImage::Header) + header->numArrays*sizeof(_ModelImage::Array) <= size;
+    if (isValid) {
+        const _ModelImage::Array* arrays = reinterpret_cast<const _ModelImage::Array*>(header + 1);
+        for (size_t i = 0; i < header->numArrays; ++i) {
+            if (arrays[i].offset + arrays[i].numValues*sizeof(double) > size) {
+                isValid = false;
+                break;
+            } // if
+        } // for
+    } // if
+    if (!isValid) {
+        munmap(data, size);
+        return false;
+    } // if
+
+    _data = data;
+    _size = size;
+    return true;
+} // open
+
+
+// ------------------------------------------------------------------------------------------------
+// Unmap image.
+void
+geomodelgrids::serial::ModelImage::close(void) {
+    if (_data) {
+        munmap(_data, _size);
+    } // if
+    _data = nullptr;
+    _size = 0;
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Get values for surface or block in image.
+const double*
+geomodelgrids::serial::ModelImage::getValues(const char* name,
+                                             const size_t numValues) const {
+    assert(name);
+    if (!_data) {
+        return nullptr;
+    } // if
+
+    const _ModelImage::Header* header = static_cast<const _ModelImage::Header*>(_data);
+    const _ModelImage::Array* arrays = reinterpret_cast<const _ModelImage::Array*>(header + 1);
+    for (size_t i = 0; i < header->numArrays; ++i) {
+        if (0 == strncmp(arrays[i].name, name, _ModelImage::nameLength)) {
+            return (numValues == arrays[i].numValues) ?
+                   reinterpret_cast<const double*>(static_cast<const char*>(_data) + arrays[i].offset) : nullptr;
+        } // if
+    } // for
+
+    return nullptr;
+} // getValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Get identity of model file from its status.
+geomodelgrids::serial::ModelImage::ModelStat
+geomodelgrids::serial::ModelImage::getModelStat(const struct stat& fileStat) {
+    ModelStat modelStat;
+    modelStat.device = fileStat.st_dev;
+    modelStat.inode = fileStat.st_ino;
+    modelStat.size = fileStat.st_size;
+#if defined(__APPLE__)
+    modelStat.mtimeSec = fileStat.st_mtimespec.tv_sec;
+    modelStat.mtimeNsec = fileStat.st_mtimespec.tv_nsec;
+#else
+    modelStat.mtimeSec = fileStat.st_mtim.tv_sec;
+    modelStat.mtimeNsec = fileStat.st_mtim.tv_nsec;
+#endif
+    return modelStat;
+} // getModelStat
+
+
+// ------------------------------------------------------------------------------------------------
+// Check whether two identities refer to the same, unchanged model file.
+bool
+geomodelgrids::serial::ModelImage::sameModel(const ModelStat& a,
+                                             const ModelStat& b) {
+    return a.device == b.device && a.inode == b.inode && a.size == b.size &&
+           a.mtimeSec == b.mtimeSec && a.mtimeNsec == b.mtimeNsec;
+} // sameModel
+
+
+// ------------------------------------------------------------------------------------------------
+// Check whether image file can be trusted.
+bool
+geomodelgrids::serial::_ModelImage::isTrusted(const struct stat& imageStat,
+                                              const struct stat& modelStat) {
+    return S_ISREG(imageStat.st_mode) && !(imageStat.st_mode & (S_IWGRP | S_IWOTH)) &&
+           (( imageStat.st_uid == geteuid()) || ( imageStat.st_uid == modelStat.st_uid) );
+} // isTrusted
+
+
+// ------------------------------------------------------------------------------------------------
+// Round offset up to alignment.
+size_t
+geomodelgrids::serial::_ModelImage::align(const size_t offset) {
+    return ((offset + alignment - 1) / alignment) * alignment;
+} // align
+
+
+// End of file
@@ -0,0 +1,127 @@
+/** Image of model values in a memory-mapped file.
+ *
+ * The image contains the values of the surfaces and blocks of a model stored contiguously in a
+ * file, usually in a tmpfs such as /dev/shm. Processes querying the model map the image read only
+ * instead of reading and decompressing the values from the HDF5 file, so that all processes on a
+ * machine share the same pages in memory.
+ *
+ * The image header records the device, inode, size, and modification time (with nanoseconds) of
+ * the model file; an image that does not match the model file is ignored. Images usually live in a
+ * world-writable directory, so an image is also ignored unless it is a regular file owned by the
+ * current user or the owner of the model file and not writable by group or others.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <cstddef> // USES size_t
+#include <cstdint> // USES uint64_t, int64_t
+#include <sys/stat.h> // USES struct stat
+#include <string> // USES std::string
+
+class geomodelgrids::serial::ModelImage {
+    friend class TestModelImage; // Unit testing
+
+    // PUBLIC CLASSES -----------------------------------------------------------------------------
+public:
+
+    /// Identity of model file, used to detect changes to the model file.
+    struct ModelStat {
+        uint64_t device; ///< Device of model file.
+        uint64_t inode; ///< Inode of model file.
+        uint64_t size; ///< Size of model file in bytes.
+        int64_t mtimeSec; ///< Modification time of model file (seconds).
+        int64_t mtimeNsec; ///< Modification time of model file (nanoseconds).
+    }; // ModelStat
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Default constructor.
+    ModelImage(void);
+
+    /// Destructor
+    ~ModelImage(void);
+
+    /** Get path of image for model file.
+     *
+     * The image directory defaults to the GEOMODELGRIDS_IMAGE_DIR environment variable if it is
+     * set and /dev/shm otherwise. An empty image directory disables images.
+     *
+     * @param[in] modelFilename Name of model file.
+     * @param[in] imageDir Directory for image (nullptr for default).
+     * @returns Path of image file (empty if images are disabled).
+     */
+    static
+    std::string getImagePath(const char* modelFilename,
+                             const char* imageDir=nullptr);
+
+    /** Write image of model values.
+     *
+     * The image is written to a temporary file with a unique name and then renamed, so that
+     * processes never map a partial image.
+     *
+     * @param[in] imagePath Path of image file.
+     * @param[in] modelFilename Name of model file.
+     * @param[in] model Model opened for querying (after initialize()).
+     * @returns Number of bytes in image.
+     */
+    static
+    size_t write(const char* imagePath,
+                 const char* modelFilename,
+                 geomodelgrids::serial::Model& model);
+
+    /** Get identity of model file from its status.
+     *
+     * @param[in] fileStat Status of model file from stat().
+     * @returns Device, inode, size, and modification time (with nanoseconds) of model file.
+     */
+    static
+    ModelStat getModelStat(const struct stat& fileStat);
+
+    /** Check whether two identities refer to the same, unchanged model file.
+     *
+     * @param[in] a Identity of model file.
+     * @param[in] b Identity of model file.
+     * @returns True if device, inode, size, and modification time match, false otherwise.
+     */
+    static
+    bool sameModel(const ModelStat& a,
+                   const ModelStat& b);
+
+    /** Map image read only.
+     *
+     * @param[in] imagePath Path of image file.
+     * @param[in] modelFilename Name of model file.
+     * @returns True if the image exists, can be trusted, and matches the model file, false otherwise.
+     */
+    bool open(const char* imagePath,
+              const char* modelFilename);
+
+    /// Unmap image.
+    void close(void);
+
+    /** Get values for surface or block in image.
+     *
+     * @param[in] name Name of surface or block dataset (for example, 'blocks/top').
+     * @param[in] numValues Expected number of values.
+     * @returns Values in image or nullptr if the image does not contain the expected values.
+     */
+    const double* getValues(const char* name,
+                            const size_t numValues) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    void* _data; ///< Address of mapped image.
+    size_t _size; ///< Size of mapped image in bytes.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    ModelImage(const ModelImage&); ///< Not implemented
+    const ModelImage& operator=(const ModelImage&); ///< Not implemented
+
+}; // ModelImage
+
+// End of file
@@ -10,9 +10,12 @@
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include <getopt.h> // USES getopt_long()
-#include <algorithm> // USES std::transform
+#include <algorithm> // USES std::transform, std::sort(), std::unique()
+#include <functional> // USES std::greater
 #include <cctype> // USES std::lower
+#include <limits> // USES std::numeric_limits
 #include <cassert> // USES assert()
+#include <cmath> // USES M_PI, cos(), sin()
 #include <sstream> // USES std::ostringstream, std::istringstream
 
 // ------------------------------------------------------------------------------------------------
@@ -64,6 +67,7 @@ public:
 // Constructor
 geomodelgrids::serial::Query::Query() :
     _squashMinElev(0.0),
+    _targetResolution(0.0),
     _errorHandler(std::make_shared<geomodelgrids::utils::ErrorHandler>()),
     _squash(SQUASH_NONE) {}
 
@@ -85,6 +89,14 @@ geomodelgrids::serial::Query::getErrorHandler(void) {
 } // getErrorHandler
 
 
+// ------------------------------------------------------------------------------------------------
+// Set target horizontal resolution for selecting coarser levels of blocks.
+void
+geomodelgrids::serial::Query::setTargetResolution(const double value) {
+    _targetResolution = value;
+} // setTargetResolution
+
+
 // ------------------------------------------------------------------------------------------------
 // Do setup for querying.
 void
@@ -104,11 +116,21 @@ geomodelgrids::serial::Query::initialize(const std::vector<std::string>& modelFi
     for (size_t iModel = 0; iModel < numModels; ++iModel) {
         _models[iModel] = std::make_unique<geomodelgrids::serial::Model>();assert(_models[iModel]);
         _models[iModel]->setInputCRS(inputCRSString);
-        _models[iModel]->open(modelFilenames[iModel].c_str(), geomodelgrids::serial::Model::READ);
+        _openModel(_models[iModel].get(), modelFilenames[iModel].c_str());
         _models[iModel]->loadMetadata();
-        _models[iModel]->initialize();
+        if (_targetResolution > 0.0) {
+            _models[iModel]->setTargetResolution(_targetResolution);
+        } // if
 
+        // Blocks only read and interpolate the model values that are queried.
         _valuesIndex[iModel] = _Query::createModelValuesIndex(*_models[iModel], _valuesLowercase);
+        const values_map_type& modelMap = _valuesIndex[iModel];
+        std::vector<size_t> modelIndices;
+        for (values_map_type::const_iterator iter = modelMap.begin(); iter != modelMap.end(); ++iter) {
+            modelIndices.push_back(iter->second);
+        } // for
+        _models[iModel]->setValueIndices(modelIndices);
+        _models[iModel]->initialize();
 
         const std::vector<std::string>& modelValues = _models[iModel]->getValueNames();
         const std::vector<std::string>& modelUnitsLower = _Query::toLower(_models[iModel]->getValueUnits());
@@ -136,6 +158,39 @@ geomodelgrids::serial::Query::setSquashing(const SquashingEnum value) {
 } // setSquashing
 
 
+// ------------------------------------------------------------------------------------------------
+// Load the portions of the models covering a region of interest into memory.
+void
+geomodelgrids::serial::Query::preloadRegion(const double xMin,
+                                            const double xMax,
+                                            const double yMin,
+                                            const double yMax,
+                                            const double zMin,
+                                            const double zMax) {
+    if (!_valuesLowercase.size()) {
+        throw std::logic_error("geomodelgrids::serial::Query::preloadRegion() called before initialize().");
+    } // if
+
+    // Squashing maps elevations above the minimum squashing elevation to elevations between the
+    // minimum squashing elevation and the surface, which may lie above zMax.
+    double zMinModel = zMin;
+    double zMaxModel = zMax;
+    if (( _squash != SQUASH_NONE) && ( zMin <= zMax) ) {
+        if (zMin > _squashMinElev) {
+            zMinModel = _squashMinElev;
+        } // if
+        if (zMax > _squashMinElev) {
+            zMaxModel = std::numeric_limits<double>::max();
+        } // if
+    } // if
+
+    for (size_t i = 0; i < _models.size(); ++i) {
+        assert(_models[i]);
+        _models[i]->loadRegion(xMin, xMax, yMin, yMax, zMinModel, zMaxModel);
+    } // for
+} // preloadRegion
+
+
 // ------------------------------------------------------------------------------------------------
 // Get names of values in model.
 const std::vector<std::string>&
@@ -242,6 +297,224 @@ geomodelgrids::serial::Query::query(double* const values,
 } // query
 
 
+// ------------------------------------------------------------------------------------------------
+// Query at points along vertical profile.
+int
+geomodelgrids::serial::Query::queryProfile(double* const values,
+                                           const double x,
+                                           const double y,
+                                           const double* const elevations,
+                                           const size_t numPoints) {
+    if (!values || !elevations) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryProfile() passed nullptr for values or elevations argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!_valuesLowercase.size()) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryProfile() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t numQueryValues = _valuesLowercase.size();
+    std::fill(values, values+numPoints*numQueryValues, NODATA_VALUE);
+
+    // Indices of points not yet found in a model.
+    std::vector<size_t> remaining(numPoints);
+    for (size_t i = 0; i < numPoints; ++i) {
+        remaining[i] = i;
+    } // for
+    std::vector<double> elevationsModel;
+    std::vector<double> modelValues;
+    std::unique_ptr<bool[]> inModel(new bool[numPoints]);
+    for (size_t i = 0; i < _models.size() && remaining.size() > 0; ++i) {
+        assert(_models[i]);
+        const size_t numRemaining = remaining.size();
+        elevationsModel.resize(numRemaining);
+        double surfaceElev = NODATA_VALUE;
+        for (size_t iPt = 0; iPt < numRemaining; ++iPt) {
+            const double z = elevations[remaining[iPt]];
+            double zSquash = z;
+            if ((_squash != SQUASH_NONE) && (z > _squashMinElev)) {
+                if (surfaceElev == NODATA_VALUE) {
+                    switch (_squash) {
+                    case SQUASH_TOP_SURFACE:
+                        surfaceElev = _models[i]->queryTopElevation(x, y);
+                        break;
+                    case SQUASH_TOPOGRAPHY_BATHYMETRY:
+                        surfaceElev = _models[i]->queryTopoBathyElevation(x, y);
+                        break;
+                    default:
+                        throw std::logic_error("Unknown squashing type.");
+                    } // switch
+                } // if
+                zSquash = surfaceElev + z * (_squashMinElev - surfaceElev) / _squashMinElev;
+            } // if
+            elevationsModel[iPt] = zSquash;
+        } // for
+
+        const size_t numModelValues = _models[i]->getValueNames().size();
+        modelValues.resize(numRemaining*numModelValues);
+        if (!_models[i]->queryColumn(modelValues.data(), inModel.get(), x, y, elevationsModel.data(), numRemaining)) {
+            continue;
+        } // if
+
+        values_map_type& modelMap = _valuesIndex[i];
+        size_t numNotFound = 0;
+        for (size_t iPt = 0; iPt < numRemaining; ++iPt) {
+            if (inModel[iPt]) {
+                const double* pointValues = &modelValues[iPt*numModelValues];
+                double* queryValues = &values[remaining[iPt]*numQueryValues];
+                for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+                    queryValues[iValue] = pointValues[modelMap[iValue]];
+                } // for
+            } else {
+                remaining[numNotFound++] = remaining[iPt];
+            } // if/else
+        } // for
+        remaining.resize(numNotFound);
+    } // for
+
+    return remaining.empty() ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+} // queryProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Query at points on a regular grid.
+int
+geomodelgrids::serial::Query::queryGrid(double* const values,
+                                        const double origin[3],
+                                        const double spacing[3],
+                                        const size_t dims[3],
+                                        const double azimuth) {
+    if (!values || !origin || !spacing || !dims) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryGrid() passed nullptr for values or grid argument.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+    if (!_valuesLowercase.size()) {
+        assert(_errorHandler);
+        _errorHandler->setError("geomodelgrids::serial::Query::queryGrid() not initialized.");
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    const size_t numQueryValues = _valuesLowercase.size();
+    const size_t numPoints = dims[0] * dims[1] * dims[2];
+    std::fill(values, values+numPoints*numQueryValues, NODATA_VALUE);
+    if (!numPoints) {
+        return geomodelgrids::utils::ErrorHandler::OK;
+    } // if
+
+    const double azimuthRad = azimuth * M_PI / 180.0;
+    const double gridDirX[2] = { cos(azimuthRad), -sin(azimuthRad) };
+    const double gridDirY[2] = { sin(azimuthRad), cos(azimuthRad) };
+
+    if (_squash != SQUASH_NONE) {
+        // Squashing depends on the surface at each vertical profile.
+        std::vector<double> elevations(dims[2]);
+        for (size_t k = 0; k < dims[2]; ++k) {
+            elevations[k] = origin[2] + k*spacing[2];
+        } // for
+        int status = geomodelgrids::utils::ErrorHandler::OK;
+        for (size_t i = 0; i < dims[0]; ++i) {
+            for (size_t j = 0; j < dims[1]; ++j) {
+                const double x = origin[0] + i*spacing[0]*gridDirX[0] + j*spacing[1]*gridDirY[0];
+                const double y = origin[1] + i*spacing[0]*gridDirX[1] + j*spacing[1]*gridDirY[1];
+                const int err = queryProfile(&values[(i*dims[1] + j)*dims[2]*numQueryValues], x, y, elevations.data(), dims[2]);
+                if (err == geomodelgrids::utils::ErrorHandler::ERROR) {
+                    return err;
+                } else if (err) {
+                    status = err;
+                } // if/else
+            } // for
+        } // for
+        return status;
+    } // if
+
+    // Query one slice of the grid (fixed x index) at a time to bound the memory for model values.
+    const size_t sliceDims[3] = { 1, dims[1], dims[2] };
+    const size_t numSlicePoints = dims[1] * dims[2];
+    std::vector<double> modelValues;
+    std::unique_ptr<bool[]> inModel(new bool[numSlicePoints]);
+    std::unique_ptr<bool[]> found(new bool[numSlicePoints]);
+    size_t numFound = 0;
+    for (size_t i = 0; i < dims[0]; ++i) {
+        const double sliceOrigin[3] = {
+            origin[0] + i*spacing[0]*gridDirX[0],
+            origin[1] + i*spacing[0]*gridDirX[1],
+            origin[2],
+        };
+        std::fill(found.get(), found.get()+numSlicePoints, false);
+        size_t numSliceFound = 0;
+        for (size_t iModel = 0; iModel < _models.size() && numSliceFound < numSlicePoints; ++iModel) {
+            assert(_models[iModel]);
+            const size_t numModelValues = _models[iModel]->getValueNames().size();
+            modelValues.resize(numSlicePoints*numModelValues);
+            if (!_models[iModel]->queryGrid(modelValues.data(), inModel.get(), sliceOrigin, spacing, sliceDims, azimuth)) {
+                continue;
+            } // if
+
+            values_map_type& modelMap = _valuesIndex[iModel];
+            for (size_t iPt = 0; iPt < numSlicePoints; ++iPt) {
+                if (inModel[iPt] && !found[iPt]) {
+                    const double* pointValues = &modelValues[iPt*numModelValues];
+                    double* queryValues = &values[(i*numSlicePoints + iPt)*numQueryValues];
+                    for (size_t iValue = 0; iValue < numQueryValues; ++iValue) {
+                        queryValues[iValue] = pointValues[modelMap[iValue]];
+                    } // for
+                    found[iPt] = true;
+                    ++numSliceFound;
+                } // if
+            } // for
+        } // for
+        numFound += numSliceFound;
+    } // for
+
+    return (numFound == numPoints) ? geomodelgrids::utils::ErrorHandler::OK : geomodelgrids::utils::ErrorHandler::WARNING;
+} // queryGrid
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevations of grid points along a vertical profile.
+std::vector<double>
+geomodelgrids::serial::Query::queryNodeElevations(const double x,
+                                                  const double y) {
+    std::vector<double> elevations;
+    for (size_t i = 0; i < _models.size(); ++i) {
+        assert(_models[i]);
+        std::vector<double> modelElevations = _models[i]->queryNodeElevations(x, y);
+        if (modelElevations.empty()) {
+            continue;
+        } // if
+
+        if (_squash != SQUASH_NONE) {
+            double surfaceElev = NODATA_VALUE;
+            switch (_squash) {
+            case SQUASH_TOP_SURFACE:
+                surfaceElev = _models[i]->queryTopElevation(x, y);
+                break;
+            case SQUASH_TOPOGRAPHY_BATHYMETRY:
+                surfaceElev = _models[i]->queryTopoBathyElevation(x, y);
+                break;
+            default:
+                throw std::logic_error("Unknown squashing type.");
+            } // switch
+            for (size_t iPt = 0; iPt < modelElevations.size(); ++iPt) {
+                const double zSquash = modelElevations[iPt];
+                if (zSquash > _squashMinElev) {
+                    modelElevations[iPt] = (zSquash - surfaceElev) * _squashMinElev / (_squashMinElev - surfaceElev);
+                } // if
+            } // for
+        } // if
+        elevations.insert(elevations.end(), modelElevations.begin(), modelElevations.end());
+    } // for
+    std::sort(elevations.begin(), elevations.end(), std::greater<double>());
+    elevations.erase(std::unique(elevations.begin(), elevations.end()), elevations.end());
+
+    return elevations;
+} // queryNodeElevations
+
+
 // ------------------------------------------------------------------------------------------------
 // Cleanup after querying.
 void
@@ -254,6 +527,18 @@ geomodelgrids::serial::Query::finalize(void) {
 } // finalize
 
 
+// ------------------------------------------------------------------------------------------------
+// Open model file.
+void
+geomodelgrids::serial::Query::_openModel(geomodelgrids::serial::Model* model,
+                                         const char* filename) {
+    assert(model);
+    assert(filename);
+
+    model->open(filename, geomodelgrids::serial::Model::READ);
+} // _openModel
+
+
 // ------------------------------------------------------------------------------------------------
 std::vector<std::string>
 geomodelgrids::serial::_Query::toLower(const std::vector<std::string>& strings) {
@@ -31,7 +31,7 @@ public:
     Query(void);
 
     /// Destructor
-    ~Query(void);
+    virtual ~Query(void);
 
     /** Get error handler.
      *
@@ -39,6 +39,17 @@ public:
      */
     std::shared_ptr<geomodelgrids::utils::ErrorHandler>& getErrorHandler(void);
 
+    /** Set target horizontal resolution for selecting coarser levels of blocks.
+     *
+     * Blocks use the coarsest level stored in the model with a horizontal resolution at least as
+     * fine as the target resolution, so queries read less data when full resolution is not needed.
+     * Models without coarser levels are queried at full resolution. Must be called BEFORE
+     * initialize().
+     *
+     * @param[in] value Target horizontal resolution (m) (<= 0 for full resolution, default).
+     */
+    void setTargetResolution(const double value);
+
     /** Do setup for querying.
      *
      * @param[in] modelFilenames Array of model filenames (in query order).
@@ -63,6 +74,27 @@ public:
      */
     void setSquashing(const SquashingEnum value);
 
+    /** Load the portions of the models covering a region of interest into memory.
+     *
+     * The values of each block and surface within the bounding box are read once and kept in memory
+     * until the next call, so queries for points in the region do not read from the model files;
+     * queries for points outside the region still work. An empty region (min > max) clears the
+     * region. Must be called AFTER initialize() and after setting any squashing.
+     *
+     * @param[in] xMin Minimum x coordinate of region (in input CRS).
+     * @param[in] xMax Maximum x coordinate of region (in input CRS).
+     * @param[in] yMin Minimum y coordinate of region (in input CRS).
+     * @param[in] yMax Maximum y coordinate of region (in input CRS).
+     * @param[in] zMin Minimum elevation of region (in input CRS).
+     * @param[in] zMax Maximum elevation of region (in input CRS).
+     */
+    void preloadRegion(const double xMin,
+                       const double xMax,
+                       const double yMin,
+                       const double yMax,
+                       const double zMin,
+                       const double zMax);
+
     /** Get names of values returned in queries.
      *
      * @returns Array of names of values in queries queries.
@@ -102,21 +134,90 @@ public:
               const double y,
               const double z);
 
+    /** Query model for values at points along a vertical profile.
+     *
+     * Each model transforms the horizontal coordinates and looks up its top surface once for the
+     * profile rather than once for each point. Values array must be preallocated.
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[in] x X coordinate of profile (in input CRS).
+     * @param[in] y Y coordinate of profile (in input CRS).
+     * @param[in] elevations Array of elevations of points (in input CRS) [numPoints].
+     * @param[in] numPoints Number of points in profile.
+     * @returns 0 if all points were found, 1 otherwise.
+     */
+    int queryProfile(double* const values,
+                     const double x,
+                     const double y,
+                     const double* const elevations,
+                     const size_t numPoints);
+
+    /** Query model for values at points on a regular grid.
+     *
+     * Grid point (i, j, k) is at origin + i*spacing[0] along the grid x axis, + j*spacing[1] along
+     * the grid y axis, and at elevation origin[2] + k*spacing[2]; the grid y axis is rotated by
+     * azimuth (degrees clockwise from north) in the input CRS. Values are ordered with k varying
+     * fastest and must be preallocated.
+     *
+     * Without squashing, each model transforms only the grid origin and axes when the grid maps
+     * affinely onto the model (see Model::queryGrid()). With squashing, the grid is queried one
+     * vertical profile at a time (see queryProfile()).
+     *
+     * @param[out] values Array of values returned in query [numPoints*numValues].
+     * @param[in] origin Coordinates of grid origin (in input CRS) [3].
+     * @param[in] spacing Grid spacing along grid x and y axes and in elevation [3].
+     * @param[in] dims Number of points along grid x, y, and z axes [3].
+     * @param[in] azimuth Azimuth (degrees) of grid y axis.
+     * @returns 0 if all points were found, 1 otherwise.
+     */
+    int queryGrid(double* const values,
+                  const double origin[3],
+                  const double spacing[3],
+                  const size_t dims[3],
+                  const double azimuth=0.0);
+
+    /** Query for elevations of grid points along a vertical profile.
+     *
+     * Model values vary linearly with elevation between consecutive grid points (including any
+     * squashing), so querying values at these elevations resolves the profile exactly.
+     *
+     * @param[in] x X coordinate of profile (in input CRS).
+     * @param[in] y Y coordinate of profile (in input CRS).
+     * @returns Elevations (in input CRS) of grid points of all models in descending order.
+     */
+    std::vector<double> queryNodeElevations(const double x,
+                                            const double y);
+
     /// Cleanup after querying.
-    void finalize(void);
+    virtual void finalize(void);
 
-    // PRIVATE TYPEDEFS ---------------------------------------------------------------------------
-private:
+    // PROTECTED TYPEDEFS -------------------------------------------------------------------------
+protected:
 
     typedef std::map<size_t, size_t> values_map_type;
 
-    // PRIVATE MEMBERS ----------------------------------------------------------------------------
-private:
+    // PROTECTED METHODS --------------------------------------------------------------------------
+protected:
+
+    /** Open model file.
+     *
+     * Derived classes override this method to customize how the HDF5 file is accessed.
+     *
+     * @param[inout] model Model to open.
+     * @param[in] filename Name of model file.
+     */
+    virtual
+    void _openModel(geomodelgrids::serial::Model* model,
+                    const char* filename);
+
+    // PROTECTED MEMBERS --------------------------------------------------------------------------
+protected:
 
     std::vector<std::unique_ptr<geomodelgrids::serial::Model> > _models;
     std::vector<std::string> _valuesLowercase;
     std::vector<values_map_type> _valuesIndex;
     double _squashMinElev;
+    double _targetResolution; ///< Target horizontal resolution for selecting levels (<= 0 for full resolution).
     std::shared_ptr<geomodelgrids::utils::ErrorHandler> _errorHandler;
     SquashingEnum _squash;
 
@@ -0,0 +1,246 @@
+#include <portinfo>
+
+#include "QueryClient.hh" // implementation of class methods
+
+extern "C" {
+#include "queryprotocol.h" // USES GeomodelgridsQuerydRequest, GeomodelgridsQuerydResponse
+}
+
+#include <sys/socket.h> // USES socket(), connect()
+#include <sys/un.h> // USES sockaddr_un
+#include <unistd.h> // USES close()
+#include <cstring> // USES memset(), memcpy(), strncpy()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cassert> // USES assert()
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::QueryClient::QueryClient(void) :
+    _socket(-1) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::serial::QueryClient::~QueryClient(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Connect to query server.
+void
+geomodelgrids::serial::QueryClient::connect(const char* socketPath) {
+    assert(socketPath);
+
+    close();
+
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socketPath) >= sizeof(address.sun_path)) {
+        std::ostringstream msg;
+        msg << "Path of query server socket '" << socketPath << "' is too long.";
+        throw std::length_error(msg.str());
+    } // if
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path)-1);
+
+    _socket = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (_socket < 0) {
+        throw std::runtime_error("Could not create socket for connecting to query server.");
+    } // if
+    if (::connect(_socket, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        close();
+        std::ostringstream msg;
+        msg << "Could not connect to query server at '" << socketPath << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    // Get names of values.
+    _request(GEOMODELGRIDS_QUERYD_INFO, nullptr, 0, 0);
+    _valueNames.clear();
+    size_t offset = 0;
+    while (offset < _payload.size()) {
+        const std::string name(&_payload[offset]);
+        _valueNames.push_back(name);
+        offset += name.length() + 1;
+    } // while
+} // connect
+
+
+// ------------------------------------------------------------------------------------------------
+// Close connection to query server.
+void
+geomodelgrids::serial::QueryClient::close(void) {
+    if (_socket >= 0) {
+        ::close(_socket);
+    } // if
+    _socket = -1;
+    _valueNames.clear();
+    _payload.clear();
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Get names of values returned in queries.
+const std::vector<std::string>&
+geomodelgrids::serial::QueryClient::getValueNames(void) const {
+    return _valueNames;
+} // getValueNames
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values at points.
+void
+geomodelgrids::serial::QueryClient::query(double* const values,
+                                          int* const errors,
+                                          const double* const points,
+                                          const size_t numPoints) {
+    const size_t numValues = _valueNames.size();
+    _request(GEOMODELGRIDS_QUERYD_QUERY, points, numPoints, 3);
+    _copyPayload(values, 0, numPoints*numValues*sizeof(double));
+
+    const size_t errorsOffset = numPoints*numValues*sizeof(double);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        int32_t error = 0;
+        _copyPayload(&error, errorsOffset + iPt*sizeof(int32_t), sizeof(int32_t));
+        errors[iPt] = error;
+    } // for
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at points.
+void
+geomodelgrids::serial::QueryClient::queryTopElevation(double* const elevations,
+                                                      const double* const points,
+                                                      const size_t numPoints) {
+    _request(GEOMODELGRIDS_QUERYD_TOP_ELEVATION, points, numPoints, 2);
+    _copyPayload(elevations, 0, numPoints*sizeof(double));
+} // queryTopElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at points.
+void
+geomodelgrids::serial::QueryClient::queryTopoBathyElevation(double* const elevations,
+                                                            const double* const points,
+                                                            const size_t numPoints) {
+    _request(GEOMODELGRIDS_QUERYD_TOPOBATHY_ELEVATION, points, numPoints, 2);
+    _copyPayload(elevations, 0, numPoints*sizeof(double));
+} // queryTopoBathyElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values along vertical profiles below the top surface.
+void
+geomodelgrids::serial::QueryClient::queryProfile(double* const samples,
+                                                 int* const errors,
+                                                 const double* const locations,
+                                                 const size_t numLocations,
+                                                 const double dz,
+                                                 const double maxDepth) {
+    const size_t sampleSize = 2 + _valueNames.size();
+    const size_t numSamples = _request(GEOMODELGRIDS_QUERYD_PROFILE, locations, numLocations, 2, dz, maxDepth);
+    _copyPayload(samples, 0, numSamples*sampleSize*sizeof(double));
+
+    const size_t errorsOffset = numSamples*sampleSize*sizeof(double);
+    for (size_t i = 0; i < numSamples; ++i) {
+        int32_t error = 0;
+        _copyPayload(&error, errorsOffset + i*sizeof(int32_t), sizeof(int32_t));
+        errors[i] = error;
+    } // for
+} // queryProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of samples in each profile.
+size_t
+geomodelgrids::serial::QueryClient::getNumProfileDepths(const double dz,
+                                                        const double maxDepth) {
+    return (dz > 0.0 && maxDepth >= 0.0) ? size_t(1 + maxDepth / dz) : 0;
+} // getNumProfileDepths
+
+
+// ------------------------------------------------------------------------------------------------
+// Ask server to shut down.
+void
+geomodelgrids::serial::QueryClient::shutdown(void) {
+    _request(GEOMODELGRIDS_QUERYD_SHUTDOWN, nullptr, 0, 0);
+    close();
+} // shutdown
+
+
+// ------------------------------------------------------------------------------------------------
+// Send request and receive response.
+size_t
+geomodelgrids::serial::QueryClient::_request(const int type,
+                                             const double* const points,
+                                             const size_t numPoints,
+                                             const size_t spaceDim,
+                                             const double dz,
+                                             const double maxDepth) {
+    if (_socket < 0) {
+        throw std::logic_error("Query client is not connected to a query server.");
+    } // if
+    if (numPoints > 0) {
+        if (!points) {
+            throw std::invalid_argument("Query client passed nullptr for points.");
+        } // if
+        if (numPoints > GEOMODELGRIDS_QUERYD_MAX_POINTS) {
+            std::ostringstream msg;
+            msg << "Number of points in request (" << numPoints << ") exceeds maximum ("
+                << GEOMODELGRIDS_QUERYD_MAX_POINTS << "). Split the points into multiple requests.";
+            throw std::length_error(msg.str());
+        } // if
+    } // if
+
+    GeomodelgridsQuerydRequest request;
+    memset(&request, 0, sizeof(request));
+    request.magic = GEOMODELGRIDS_QUERYD_MAGIC;
+    request.type = type;
+    request.numPoints = numPoints;
+    request.dz = dz;
+    request.maxDepth = maxDepth;
+    if (( geomodelgrids_queryd_send(_socket, &request, sizeof(request)) != 0) ||
+        ( numPoints > 0 && geomodelgrids_queryd_send(_socket, points, numPoints*spaceDim*sizeof(double)) != 0) ) {
+        close();
+        throw std::runtime_error("Error sending request to query server.");
+    } // if
+
+    GeomodelgridsQuerydResponse response;
+    if (( geomodelgrids_queryd_recv(_socket, &response, sizeof(response)) != 0) ||
+        ( response.magic != GEOMODELGRIDS_QUERYD_MAGIC) ) {
+        close();
+        throw std::runtime_error("Error receiving response from query server.");
+    } // if
+    _payload.resize(response.payloadSize);
+    if (( response.payloadSize > 0) && ( geomodelgrids_queryd_recv(_socket, _payload.data(), _payload.size()) != 0) ) {
+        close();
+        throw std::runtime_error("Error receiving response from query server.");
+    } // if
+
+    if (response.status != GEOMODELGRIDS_QUERYD_OK) {
+        throw std::runtime_error(std::string("Query server error: ") + std::string(_payload.begin(), _payload.end()));
+    } // if
+
+    return response.numPoints;
+} // _request
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy response payload.
+void
+geomodelgrids::serial::QueryClient::_copyPayload(void* dest,
+                                                 const size_t offset,
+                                                 const size_t numBytes) const {
+    if (offset + numBytes > _payload.size()) {
+        throw std::runtime_error("Response from query server is smaller than expected.");
+    } // if
+    if (numBytes > 0) {
+        memcpy(dest, &_payload[offset], numBytes);
+    } // if
+} // _copyPayload
+
+
+// End of file
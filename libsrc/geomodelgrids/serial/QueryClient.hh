@@ -0,0 +1,149 @@
+/** C++ client for the geomodelgrids_queryd local query server.
+ *
+ * The server keeps the models open with warm caches and answers batches of queries over a Unix
+ * domain socket, avoiding the cost of opening the models in each short-lived process.
+ */
+#pragma once
+
+#include "serialfwd.hh" // forward declarations
+
+#include <vector> // HASA std::vector
+#include <string> // HASA std::string
+
+class geomodelgrids::serial::QueryClient {
+    friend class TestQueryClient; // Unit testing
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    QueryClient(void);
+
+    /// Destructor
+    ~QueryClient(void);
+
+    /** Connect to query server.
+     *
+     * @param[in] socketPath Path of Unix domain socket for server.
+     */
+    void connect(const char* socketPath);
+
+    /// Close connection to query server.
+    void close(void);
+
+    /** Get names of values returned in queries.
+     *
+     * @returns Array of names of values.
+     */
+    const std::vector<std::string>& getValueNames(void) const;
+
+    /** Query for values at points.
+     *
+     * @param[out] values Preallocated array of values [numPoints*numValues].
+     * @param[out] errors Preallocated array of error codes [numPoints] (0 on success).
+     * @param[in] points Array of points (x, y, z) in server input CRS [numPoints*3].
+     * @param[in] numPoints Number of points.
+     */
+    void query(double* const values,
+               int* const errors,
+               const double* const points,
+               const size_t numPoints);
+
+    /** Query for elevation of top of model at points.
+     *
+     * @param[out] elevations Preallocated array of elevations [numPoints].
+     * @param[in] points Array of points (x, y) in server input CRS [numPoints*2].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopElevation(double* const elevations,
+                           const double* const points,
+                           const size_t numPoints);
+
+    /** Query for elevation of topography/bathymetry at points.
+     *
+     * @param[out] elevations Preallocated array of elevations [numPoints].
+     * @param[in] points Array of points (x, y) in server input CRS [numPoints*2].
+     * @param[in] numPoints Number of points.
+     */
+    void queryTopoBathyElevation(double* const elevations,
+                                 const double* const points,
+                                 const size_t numPoints);
+
+    /** Query for values along vertical profiles (boreholes) below the top surface.
+     *
+     * Each location has getNumProfileDepths(dz, maxDepth) samples. Each sample contains the
+     * elevation, the depth, and the values.
+     *
+     * @param[out] samples Preallocated array of samples [numLocations*numDepths*(2+numValues)].
+     * @param[out] errors Preallocated array of error codes [numLocations*numDepths] (0 on success).
+     * @param[in] locations Array of locations (x, y) in server input CRS [numLocations*2].
+     * @param[in] numLocations Number of locations.
+     * @param[in] dz Vertical resolution of profile (m).
+     * @param[in] maxDepth Maximum depth of profile (m).
+     */
+    void queryProfile(double* const samples,
+                      int* const errors,
+                      const double* const locations,
+                      const size_t numLocations,
+                      const double dz,
+                      const double maxDepth);
+
+    /** Get number of samples in each profile.
+     *
+     * @param[in] dz Vertical resolution of profile (m).
+     * @param[in] maxDepth Maximum depth of profile (m).
+     * @returns Number of samples in each profile.
+     */
+    static
+    size_t getNumProfileDepths(const double dz,
+                               const double maxDepth);
+
+    /// Ask server to shut down.
+    void shutdown(void);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Send request and receive response.
+     *
+     * @param[in] type Type of request.
+     * @param[in] points Array of points in request payload.
+     * @param[in] numPoints Number of points in request payload.
+     * @param[in] spaceDim Spatial dimension of points.
+     * @param[in] dz Vertical resolution of profile (m).
+     * @param[in] maxDepth Maximum depth of profile (m).
+     * @returns Number of points in response.
+     */
+    size_t _request(const int type,
+                    const double* const points,
+                    const size_t numPoints,
+                    const size_t spaceDim,
+                    const double dz=0.0,
+                    const double maxDepth=0.0);
+
+    /** Copy response payload.
+     *
+     * @param[out] dest Destination buffer.
+     * @param[in] offset Offset in bytes into response payload.
+     * @param[in] numBytes Number of bytes to copy.
+     */
+    void _copyPayload(void* dest,
+                      const size_t offset,
+                      const size_t numBytes) const;
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    int _socket; ///< Socket connected to server.
+    std::vector<std::string> _valueNames; ///< Names of values returned in queries.
+    std::vector<char> _payload; ///< Payload of most recent response.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    QueryClient(const QueryClient&); ///< Not implemented
+    const QueryClient& operator=(const QueryClient&); ///< Not implemented
+
+}; // QueryClient
+
+// End of file
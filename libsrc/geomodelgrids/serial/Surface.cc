@@ -8,6 +8,7 @@
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include <cstring> // USES strlen()
+#include <cmath> // USES floor(), ceil()
 #include <algorithm> // USES std::sort
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
@@ -16,6 +17,7 @@
 // ------------------------------------------------------------------------------------------------
 // Default constructor.
 geomodelgrids::serial::Surface::Surface(const char* const name) :
+    _h5(nullptr),
     _hyperslab(nullptr),
     _name(name),
     _resolutionX(0.0),
@@ -186,21 +188,121 @@ geomodelgrids::serial::Surface::setHyperslabDims(const size_t dims[],
 // Prepare for querying.
 void
 geomodelgrids::serial::Surface::openQuery(geomodelgrids::serial::HDF5* const h5) {
-    const size_t ndims = 3;
-    hsize_t dims[ndims];
-    dims[0] = 128;
-    dims[1] = 128;
-    dims[2] = 1;
-    const std::string& surfacePath = std::string("surfaces/") + _name;
-    delete _hyperslab;_hyperslab = new geomodelgrids::serial::Hyperslab(h5, surfacePath.c_str(), dims, ndims);
+    _h5 = h5;
+    delete _hyperslab;_hyperslab = nullptr;
 } // openQuery
 
 
+// ------------------------------------------------------------------------------------------------
+// Load values for region of surface.
+void
+geomodelgrids::serial::Surface::loadRegion(const double xMin,
+                                           const double xMax,
+                                           const double yMin,
+                                           const double yMax,
+                                           const hid_t datasetTransfer) {
+    if (!_h5) {
+        std::ostringstream msg;
+        msg << "Cannot load region of surface '" << _name << "'. Surface not opened for querying.";
+        throw std::logic_error(msg.str());
+    } // if
+    assert(_indexingX);
+    assert(_indexingY);
+
+    const size_t spaceDim = 2;
+    hsize_t origin[spaceDim] = { 0, 0 };
+    hsize_t dims[spaceDim] = { 0, 0 };
+
+    const double coordMin[spaceDim] = { xMin, yMin };
+    const double coordMax[spaceDim] = { xMax, yMax };
+    const double extent[spaceDim] = {
+        _coordinatesX ? _coordinatesX[_dims[0]-1] - _coordinatesX[0] : _resolutionX * (_dims[0]-1),
+        _coordinatesY ? _coordinatesY[_dims[1]-1] - _coordinatesY[0] : _resolutionY * (_dims[1]-1),
+    };
+    const geomodelgrids::utils::Indexing* indexing[spaceDim] = { _indexingX, _indexingY };
+    for (size_t i = 0; i < spaceDim; ++i) {
+        if (( coordMin[i] > coordMax[i]) || ( coordMax[i] < 0.0) || ( coordMin[i] > extent[i]) ) {
+            dims[0] = dims[1] = 0;
+            break;
+        } // if
+        const double indexMin = indexing[i]->getIndex(std::max(0.0, coordMin[i]));
+        const double indexMax = indexing[i]->getIndex(std::min(extent[i], coordMax[i]));
+        hsize_t iMin = std::min(hsize_t(std::max(0.0, std::floor(indexMin))), hsize_t(_dims[i]-1));
+        hsize_t iMax = std::min(hsize_t(std::max(0.0, std::ceil(indexMax))), hsize_t(_dims[i]-1));
+        // Region needs at least two points along each dimension for interpolation.
+        if (iMax == iMin) {
+            if (iMax+1 < _dims[i]) {
+                ++iMax;
+            } else if (iMin > 0) {
+                --iMin;
+            } // if/else
+        } // if
+        origin[i] = iMin;
+        dims[i] = iMax - iMin + 1;
+    } // for
+
+    _getHyperslab()->loadRegion(origin, dims, datasetTransfer);
+} // loadRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Get range of elevation over the loaded region.
+bool
+geomodelgrids::serial::Surface::getRegionElevationRange(double* elevMin,
+                                                        double* elevMax) const {
+    assert(elevMin);
+    assert(elevMax);
+
+    return _hyperslab && _hyperslab->getRegionRange(elevMin, elevMax);
+} // getRegionElevationRange
+
+
+// ------------------------------------------------------------------------------------------------
+// Read values for a range of x indices.
+void
+geomodelgrids::serial::Surface::readValues(double* const values,
+                                           const size_t xOrigin,
+                                           const size_t numX,
+                                           const hid_t datasetTransfer) {
+    if (!_h5) {
+        std::ostringstream msg;
+        msg << "Cannot read values of surface '" << _name << "'. Surface not opened for querying.";
+        throw std::logic_error(msg.str());
+    } // if
+
+    const size_t spaceDim = 2;
+    const hsize_t origin[spaceDim] = { xOrigin, 0 };
+    const hsize_t dims[spaceDim] = { numX, _dims[1] };
+    _getHyperslab()->readValues(values, origin, dims, datasetTransfer);
+} // readValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Use values for the entire surface stored in external memory for queries.
+void
+geomodelgrids::serial::Surface::setValues(const double* values) {
+    if (!_h5) {
+        std::ostringstream msg;
+        msg << "Cannot set values of surface '" << _name << "'. Surface not opened for querying.";
+        throw std::logic_error(msg.str());
+    } // if
+    if (!values && !_hyperslab) {
+        return;
+    } // if
+
+    const size_t spaceDim = 2;
+    const hsize_t origin[spaceDim] = { 0, 0 };
+    const hsize_t dims[spaceDim] = { _dims[0], _dims[1] };
+    _getHyperslab()->setRegion(origin, dims, values);
+} // setValues
+
+
 // ------------------------------------------------------------------------------------------------
 // Cleanup after querying.
 void
 geomodelgrids::serial::Surface::closeQuery(void) {
     delete _hyperslab;_hyperslab = nullptr;
+    _h5 = nullptr;
 } // closeQuery
 
 
@@ -219,12 +321,30 @@ geomodelgrids::serial::Surface::query(const double x,
     double elevation = geomodelgrids::NODATA_VALUE;
     if ((index[0] >= 0) && (index[0] <= double(_dims[0]-1))
         && (index[1] >= 0) && (index[1] <= double(_dims[1]-1))) {
-        assert(_hyperslab);
-        _hyperslab->interpolate(&elevation, index);
+        _getHyperslab()->interpolate(&elevation, index);
     } // if
 
     return elevation;
 } // query
 
 
+// ------------------------------------------------------------------------------------------------
+// Get hyperslab for querying, creating it on first access.
+geomodelgrids::serial::Hyperslab*
+geomodelgrids::serial::Surface::_getHyperslab(void) {
+    if (!_hyperslab) {
+        assert(_h5);
+        const size_t ndims = 3;
+        hsize_t dims[ndims];
+        for (size_t i = 0; i < ndims; ++i) {
+            dims[i] = _hyperslabDims[i];
+        } // for
+        const std::string path(std::string("surfaces/") + _name);
+        _hyperslab = new geomodelgrids::serial::Hyperslab(_h5, path.c_str(), dims, ndims);
+    } // if
+
+    return _hyperslab;
+} // _getHyperslab
+
+
 // End of file
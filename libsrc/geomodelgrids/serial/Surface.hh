@@ -5,6 +5,7 @@
 #include "serialfwd.hh" // forward declarations
 #include "geomodelgrids/utils/utilsfwd.hh" // forward declarations
 
+#include <hdf5.h> // USES hid_t
 #include <string> // HASA std::string
 
 class geomodelgrids::serial::Surface {
@@ -67,11 +68,68 @@ public:
                           const size_t ndims);
 
     /** Prepare for querying.
+     *
+     * The hyperslab for the surface is created on the first query or region request.
      *
      * @param[in] h5 HDF5 with model.
      */
     void openQuery(geomodelgrids::serial::HDF5* const h5);
 
+    /** Load values for region of surface.
+     *
+     * Queries for points in the region do not read from the model file. Must be called AFTER
+     * openQuery().
+     *
+     * An empty region (xMin > xMax or yMin > yMax) clears the region. With a collective dataset
+     * transfer property list, all processes must call this method, including those with empty
+     * regions.
+     *
+     * @param[in] xMin Minimum x coordinate of region in model coordinate system.
+     * @param[in] xMax Maximum x coordinate of region in model coordinate system.
+     * @param[in] yMin Minimum y coordinate of region in model coordinate system.
+     * @param[in] yMax Maximum y coordinate of region in model coordinate system.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void loadRegion(const double xMin,
+                    const double xMax,
+                    const double yMin,
+                    const double yMax,
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Get range of elevation over the loaded region.
+     *
+     * @param[out] elevMin Minimum elevation (m) of surface points in region.
+     * @param[out] elevMax Maximum elevation (m) of surface points in region.
+     * @returns True if a region is loaded, false otherwise.
+     */
+    bool getRegionElevationRange(double* elevMin,
+                                 double* elevMax) const;
+
+    /** Read values for a range of x indices over the entire y extent.
+     *
+     * The values are read into a caller-supplied buffer and the surface is not modified. Must be
+     * called AFTER openQuery().
+     *
+     * @param[out] values Preallocated array for values.
+     * @param[in] xOrigin Index of first point in x direction.
+     * @param[in] numX Number of points in x direction.
+     * @param[in] datasetTransfer HDF5 dataset transfer property list.
+     */
+    void readValues(double* const values,
+                    const size_t xOrigin,
+                    const size_t numX,
+                    const hid_t datasetTransfer=H5P_DEFAULT);
+
+    /** Use values for the entire surface stored in external memory for queries.
+     *
+     * The surface does not take ownership of the values, which must remain valid until closeQuery()
+     * (for example, values in MPI shared memory). Queries do not read from the model file. Must be
+     * called AFTER openQuery(). Passing nullptr clears the values.
+     *
+     * @param[in] values Values for entire surface in the same layout as the model file.
+     */
+    void setValues(const double* values);
+
     // Cleanup after querying.
     void closeQuery(void);
 
@@ -84,10 +142,23 @@ public:
     double query(const double x,
                  const double y);
 
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Get hyperslab for querying, creating it on first access.
+     *
+     * The hyperslab (and its buffer and dataset handle) is not created by openQuery(), so surfaces
+     * that are never queried do not use any memory for values or read from the model file.
+     *
+     * @returns Hyperslab for surface.
+     */
+    geomodelgrids::serial::Hyperslab* _getHyperslab(void);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
-    geomodelgrids::serial::Hyperslab* _hyperslab; ///< Hyperslab of data in model.
+    geomodelgrids::serial::HDF5* _h5; ///< HDF5 file with model (set by openQuery()).
+    geomodelgrids::serial::Hyperslab* _hyperslab; ///< Hyperslab of data in model (created on first access).
     std::string _name; ///< Name of surface (matches dataset in HDF5 file).
 
     // Only resolution or coordinates are given.
@@ -0,0 +1,192 @@
+#include <portinfo>
+
+extern "C" {
+#include "cqueryclient.h"
+}
+
+#include "QueryClient.hh" // USES QueryClient
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
+
+#include <cassert> // USES assert()
+#include <stdexcept> // USES std::exception
+#include <iostream> // USES std::cerr
+
+// ------------------------------------------------------------------------------------------------
+// Create query client object.
+void*
+geomodelgrids_queryclient_create(void) {
+    return (void*) new geomodelgrids::serial::QueryClient();
+} // create
+
+
+// ------------------------------------------------------------------------------------------------
+// Destroy query client object.
+void
+geomodelgrids_queryclient_destroy(void** handle) {
+    geomodelgrids::serial::QueryClient** client = (geomodelgrids::serial::QueryClient**) handle;
+    if (client) {
+        delete *client;*client = NULL;
+    } // if
+} // destroy
+
+
+// ------------------------------------------------------------------------------------------------
+// Connect to query server.
+int
+geomodelgrids_queryclient_connect(void* handle,
+                                  const char* const socketPath) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_queryclient_connect().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    try {
+        client->connect(socketPath);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // try/catch
+
+    return geomodelgrids::utils::ErrorHandler::OK;
+} // connect
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of values returned in queries.
+size_t
+geomodelgrids_queryclient_getNumValues(void* handle) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_queryclient_getNumValues().";
+        return 0;
+    } // if
+
+    assert(client);
+    return client->getValueNames().size();
+} // getNumValues
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values at points.
+int
+geomodelgrids_queryclient_query(void* handle,
+                                double* const values,
+                                int* const errors,
+                                const double* const points,
+                                const size_t numPoints) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_queryclient_query().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    try {
+        client->query(values, errors, points, numPoints);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // try/catch
+
+    return geomodelgrids::utils::ErrorHandler::OK;
+} // query
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of top of model at points.
+int
+geomodelgrids_queryclient_queryTopElevation(void* handle,
+                                            double* const elevations,
+                                            const double* const points,
+                                            const size_t numPoints) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_queryclient_queryTopElevation().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    try {
+        client->queryTopElevation(elevations, points, numPoints);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // try/catch
+
+    return geomodelgrids::utils::ErrorHandler::OK;
+} // queryTopElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for elevation of topography/bathymetry at points.
+int
+geomodelgrids_queryclient_queryTopoBathyElevation(void* handle,
+                                                  double* const elevations,
+                                                  const double* const points,
+                                                  const size_t numPoints) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_queryclient_queryTopoBathyElevation().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    try {
+        client->queryTopoBathyElevation(elevations, points, numPoints);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // try/catch
+
+    return geomodelgrids::utils::ErrorHandler::OK;
+} // queryTopoBathyElevation
+
+
+// ------------------------------------------------------------------------------------------------
+// Query for values along vertical profiles below the top surface.
+int
+geomodelgrids_queryclient_queryProfile(void* handle,
+                                       double* const samples,
+                                       int* const errors,
+                                       const double* const locations,
+                                       const size_t numLocations,
+                                       const double dz,
+                                       const double maxDepth) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_queryclient_queryProfile().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    try {
+        client->queryProfile(samples, errors, locations, numLocations, dz, maxDepth);
+    } catch (const std::exception& err) {
+        std::cerr << err.what() << std::endl;
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // try/catch
+
+    return geomodelgrids::utils::ErrorHandler::OK;
+} // queryProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Close connection to query server.
+int
+geomodelgrids_queryclient_close(void* handle) {
+    geomodelgrids::serial::QueryClient* client = (geomodelgrids::serial::QueryClient*) handle;
+    if (!handle) {
+        std::cerr << "NULL handle for query client object in call to geomodelgrids_queryclient_close().";
+        return geomodelgrids::utils::ErrorHandler::ERROR;
+    } // if
+
+    assert(client);
+    client->close();
+
+    return geomodelgrids::utils::ErrorHandler::OK;
+} // close
+
+
+// End of file
@@ -0,0 +1,104 @@
+/* C interface for the geomodelgrids_queryd local query server.
+ */
+#pragma once
+
+#include <stddef.h> /* USES size_t */
+
+/** Create query client object.
+ *
+ * @returns Pointer to QueryClient object (NULL on failure).
+ */
+void* geomodelgrids_queryclient_create(void);
+
+/** Destroy query client object.
+ *
+ * @param handle QueryClient object.
+ */
+void geomodelgrids_queryclient_destroy(void** handle);
+
+/** Connect to query server.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[in] socketPath Path of Unix domain socket for server.
+ * @returns 0 on success, 2 on error.
+ */
+int geomodelgrids_queryclient_connect(void* handle,
+                                      const char* const socketPath);
+
+/** Get number of values returned in queries.
+ *
+ * @param[in] handle Handle to query client object.
+ * @returns Number of values at each point.
+ */
+size_t geomodelgrids_queryclient_getNumValues(void* handle);
+
+/** Query for values at points.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[out] values Preallocated array of values [numPoints*numValues].
+ * @param[out] errors Preallocated array of error codes [numPoints] (0 on success).
+ * @param[in] points Array of points (x, y, z) in server input CRS [numPoints*3].
+ * @param[in] numPoints Number of points.
+ * @returns 0 on success, 2 on error.
+ */
+int geomodelgrids_queryclient_query(void* handle,
+                                    double* const values,
+                                    int* const errors,
+                                    const double* const points,
+                                    const size_t numPoints);
+
+/** Query for elevation of top of model at points.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[out] elevations Preallocated array of elevations [numPoints].
+ * @param[in] points Array of points (x, y) in server input CRS [numPoints*2].
+ * @param[in] numPoints Number of points.
+ * @returns 0 on success, 2 on error.
+ */
+int geomodelgrids_queryclient_queryTopElevation(void* handle,
+                                                double* const elevations,
+                                                const double* const points,
+                                                const size_t numPoints);
+
+/** Query for elevation of topography/bathymetry at points.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[out] elevations Preallocated array of elevations [numPoints].
+ * @param[in] points Array of points (x, y) in server input CRS [numPoints*2].
+ * @param[in] numPoints Number of points.
+ * @returns 0 on success, 2 on error.
+ */
+int geomodelgrids_queryclient_queryTopoBathyElevation(void* handle,
+                                                      double* const elevations,
+                                                      const double* const points,
+                                                      const size_t numPoints);
+
+/** Query for values along vertical profiles below the top surface.
+ *
+ * Each location has 1+maxDepth/dz samples of (elevation, depth, values).
+ *
+ * @param[inout] handle Handle to query client object.
+ * @param[out] samples Preallocated array of samples [numLocations*numDepths*(2+numValues)].
+ * @param[out] errors Preallocated array of error codes [numLocations*numDepths] (0 on success).
+ * @param[in] locations Array of locations (x, y) in server input CRS [numLocations*2].
+ * @param[in] numLocations Number of locations.
+ * @param[in] dz Vertical resolution of profile (m).
+ * @param[in] maxDepth Maximum depth of profile (m).
+ * @returns 0 on success, 2 on error.
+ */
+int geomodelgrids_queryclient_queryProfile(void* handle,
+                                           double* const samples,
+                                           int* const errors,
+                                           const double* const locations,
+                                           const size_t numLocations,
+                                           const double dz,
+                                           const double maxDepth);
+
+/* Close connection to query server.
+ *
+ * @param[inout] handle Handle to query client object.
+ * @returns 0 on success, 2 on error.
+ */
+int geomodelgrids_queryclient_close(void* handle);
+
+// End of file
@@ -0,0 +1,121 @@
+/* Binary protocol for the geomodelgrids_queryd local query server.
+ *
+ * Clients connect to the server over a Unix domain socket and send requests consisting of a
+ * request header followed by the points (doubles). The server replies with a response header
+ * followed by the payload. All values use the native byte order of the machine, because the
+ * server and clients always run on the same machine.
+ *
+ * Request payloads:
+ *   INFO: none (numPoints must be 0).
+ *   QUERY: numPoints*3 doubles (x, y, z in the server input CRS).
+ *   TOP_ELEVATION, TOPOBATHY_ELEVATION: numPoints*2 doubles (x, y).
+ *   PROFILE: numPoints*2 doubles (x, y) with dz and maxDepth in the header.
+ *   SHUTDOWN: none (numPoints must be 0).
+ *
+ * Response payloads (status GEOMODELGRIDS_QUERYD_OK):
+ *   INFO: numValues NUL-terminated names of values.
+ *   QUERY: numPoints*numValues doubles followed by numPoints int32 error codes.
+ *   TOP_ELEVATION, TOPOBATHY_ELEVATION: numPoints doubles.
+ *   PROFILE: numPoints (locations * depths) samples of (elevation, depth, values) doubles followed by
+ *     numPoints int32 error codes; each location has 1+maxDepth/dz samples.
+ *   SHUTDOWN: none.
+ *
+ * Response payload (status GEOMODELGRIDS_QUERYD_ERROR): error message (not NUL-terminated).
+ * The server closes the connection after an error if it did not read the points in the request or
+ * failed while answering it.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+#define GEOMODELGRIDS_QUERYD_MAGIC 0x51474d47
+#define GEOMODELGRIDS_QUERYD_MAX_POINTS 16777216
+
+enum GeomodelgridsQuerydRequestEnum {
+    GEOMODELGRIDS_QUERYD_INFO=0,
+    GEOMODELGRIDS_QUERYD_QUERY=1,
+    GEOMODELGRIDS_QUERYD_TOP_ELEVATION=2,
+    GEOMODELGRIDS_QUERYD_TOPOBATHY_ELEVATION=3,
+    GEOMODELGRIDS_QUERYD_PROFILE=4,
+    GEOMODELGRIDS_QUERYD_SHUTDOWN=5
+};
+
+enum GeomodelgridsQuerydStatusEnum {
+    GEOMODELGRIDS_QUERYD_OK=0,
+    GEOMODELGRIDS_QUERYD_ERROR=1
+};
+
+/** Request header (40 bytes). */
+struct GeomodelgridsQuerydRequest {
+    uint32_t magic; /* GEOMODELGRIDS_QUERYD_MAGIC */
+    uint32_t type; /* GeomodelgridsQuerydRequestEnum */
+    uint64_t numPoints; /* Number of points in payload. */
+    double dz; /* Vertical resolution for profiles (m). */
+    double maxDepth; /* Maximum depth for profiles (m). */
+    uint64_t reserved; /* Unused (zero). */
+};
+
+/** Response header (32 bytes). */
+struct GeomodelgridsQuerydResponse {
+    uint32_t magic; /* GEOMODELGRIDS_QUERYD_MAGIC */
+    uint32_t status; /* GeomodelgridsQuerydStatusEnum */
+    uint64_t numPoints; /* Number of points (samples) in payload. */
+    uint64_t numValues; /* Number of values at each point. */
+    uint64_t payloadSize; /* Size of payload in bytes. */
+};
+
+/** Send buffer over socket, retrying on partial writes.
+ *
+ * @param[in] fd Socket.
+ * @param[in] buffer Data to send.
+ * @param[in] numBytes Number of bytes to send.
+ * @returns 0 on success, -1 on error.
+ */
+static inline
+int geomodelgrids_queryd_send(int fd,
+                              const void* buffer,
+                              size_t numBytes) {
+    const char* data = (const char*) buffer;
+    while (numBytes > 0) {
+        const ssize_t numSent = send(fd, data, numBytes, MSG_NOSIGNAL);
+        if (numSent < 0) {
+            if (EINTR == errno) { continue; }
+            return -1;
+        } /* if */
+        data += numSent;
+        numBytes -= (size_t) numSent;
+    } /* while */
+    return 0;
+} /* geomodelgrids_queryd_send */
+
+/** Receive buffer from socket, retrying on partial reads.
+ *
+ * @param[in] fd Socket.
+ * @param[out] buffer Buffer for data.
+ * @param[in] numBytes Number of bytes to receive.
+ * @returns 0 on success, 1 if the connection was closed before any data was received, -1 on error.
+ */
+static inline
+int geomodelgrids_queryd_recv(int fd,
+                              void* buffer,
+                              size_t numBytes) {
+    char* data = (char*) buffer;
+    size_t numReceived = 0;
+    while (numReceived < numBytes) {
+        const ssize_t n = recv(fd, data + numReceived, numBytes - numReceived, 0);
+        if (n < 0) {
+            if (EINTR == errno) { continue; }
+            return -1;
+        } else if (0 == n) {
+            return (0 == numReceived) ? 1 : -1;
+        } /* if/else */
+        numReceived += (size_t) n;
+    } /* while */
+    return 0;
+} /* geomodelgrids_queryd_recv */
+
+// End of file
@@ -4,12 +4,15 @@ namespace geomodelgrids {
     namespace serial {
         class ModelInfo;
         class Model;
+        class ModelImage;
         class Block;
         class Surface;
 
         class Query;
+        class QueryClient;
 
         class HDF5;
+        class HDF5Copier;
         class Hyperslab;
     } // serial
 } // geomodelgrids
@@ -34,7 +34,8 @@ public:
 geomodelgrids::utils::CRSTransformer::CRSTransformer(void) :
     _srcString("EPSG:4326"), // latitude/longitude WGS84
     _destString("EPSG:3488"), // NAD83(HARN) California Albers
-    _proj(nullptr) {}
+    _proj(nullptr),
+    _context(nullptr) {}
 
 
 // ------------------------------------------------------------------------------------------------
@@ -43,6 +44,9 @@ geomodelgrids::utils::CRSTransformer::~CRSTransformer(void) {
     if (_proj) {
         proj_destroy(_proj);_proj = nullptr;
     } // if
+    if (_context) {
+        proj_context_destroy(_context);_context = nullptr;
+    } // if
 } // destructor
 
 
@@ -69,12 +73,14 @@ geomodelgrids::utils::CRSTransformer::initialize(void) {
     if (_proj) {
         proj_destroy(_proj);_proj = nullptr;
     } // if
-    PJ_CONTEXT* context = PJ_DEFAULT_CTX;
-    _proj = proj_create_crs_to_crs(context, _srcString.c_str(), _destString.c_str(), nullptr);
+    if (!_context) {
+        _context = proj_context_create();
+    } // if
+    _proj = proj_create_crs_to_crs(_context, _srcString.c_str(), _destString.c_str(), nullptr);
     if (!_proj) {
         std::stringstream msg;
         msg << "Error creating CRS transformation from '" << _srcString << "' to '" << _destString << "'.\n"
-            << proj_errno_string(proj_errno(_proj));
+            << proj_errno_string(proj_context_errno(_context));
         throw std::runtime_error(msg.str());
     } // if
 } // initialize
@@ -128,21 +134,22 @@ geomodelgrids::utils::CRSTransformer::inverse_transform(double* srcX,
 // Get boundary box in x/y order from bounding box in CRS.
 geomodelgrids::utils::CRSTransformer*
 geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(const char* crsString) {
-    PJ_CONTEXT* context = PJ_DEFAULT_CTX;
+    PJ_CONTEXT* context = proj_context_create();
     PJ* projGeo = proj_create(context, crsString);
     if (!projGeo) {
         std::stringstream msg;
         msg << "Error creating CRS from '" << crsString << "'.\n"
-            << proj_errno_string(proj_errno(projGeo));
+            << proj_errno_string(proj_context_errno(context));
+        proj_context_destroy(context);
         throw std::runtime_error(msg.str());
     } // if
     PJ* projXY = proj_normalize_for_visualization(context, projGeo);
     if (!projXY) {
-        proj_destroy(projGeo);
-
         std::stringstream msg;
         msg << "Error creating normalized CRS from '" << crsString << "'.\n"
             << proj_errno_string(proj_errno(projGeo));
+        proj_destroy(projGeo);
+        proj_context_destroy(context);
         throw std::runtime_error(msg.str());
     }
     PJ* transform = proj_create_crs_to_crs_from_pj(context, projGeo, projXY, nullptr, nullptr);
@@ -151,11 +158,13 @@ geomodelgrids::utils::CRSTransformer::createGeoToXYAxisOrder(const char* crsStri
     if (!transform) {
         std::stringstream msg;
         msg << "Error geo to xy transformation for CRS from '" << crsString << "'.\n"
-            << proj_errno_string(proj_errno(transform));
+            << proj_errno_string(proj_context_errno(context));
+        proj_context_destroy(context);
         throw std::runtime_error(msg.str());
     } // if
     CRSTransformer* transformer = new CRSTransformer();
     transformer->_proj = transform;
+    transformer->_context = context;
 
     return transformer;
 }
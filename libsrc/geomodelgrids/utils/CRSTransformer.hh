@@ -1,4 +1,7 @@
 /** Transform from one georeferenced coordinate system to another.
+ *
+ * Each transformer has its own PROJ context, so separate transformers can be used concurrently in
+ * separate threads.
  */
 
 #if !defined(geomodelgrids_utils_crstransform_hh)
@@ -6,7 +9,7 @@
 
 #include "utilsfwd.hh" // forward declarations
 
-#include "proj.h" // HOLDSA PJ
+#include "proj.h" // HOLDSA PJ, PJ_CONTEXT
 
 #include <string> // HASA std::string
 
@@ -100,6 +103,7 @@ private:
     std::string _srcString;
     std::string _destString;
     PJ* _proj;
+    PJ_CONTEXT* _context;
 
     // NOT IMPLEMENTED ----------------------------------------------------------------------------
 private:
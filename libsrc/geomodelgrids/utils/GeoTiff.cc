@@ -6,8 +6,12 @@
 #include "proj.h" // USES PJ
 
 #include <cassert>
+#include <cstring> // USES strlen()
+#include <cctype> // USES toupper()
+#include <strings.h> // USES strcasecmp()
 #include <sstream> // USES std::ostringstream
 #include <stdexcept> // USES std::runtime_error
+#include <vector> // USES std::vector
 
 // ------------------------------------------------------------------------------------------------
 geomodelgrids::utils::GeoTiff::GeoTiff(void) :
@@ -17,7 +21,10 @@ geomodelgrids::utils::GeoTiff::GeoTiff(void) :
     _noDataValue(-1.0e+20),
     _numCols(0),
     _numRows(0),
-    _numBands(0) {
+    _numBands(0),
+    _tileSize(0),
+    _numOverviews(0),
+    _compression("DEFLATE") {
     GDALAllRegister();
     for (int i = 0; i < 6; ++i) {
         _transform[i] = 0.0;
@@ -160,6 +167,55 @@ geomodelgrids::utils::GeoTiff::setNoDataValue(const float value) {
 }
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::setTileSize(const size_t value) {
+    if (value % 16) {
+        std::ostringstream msg;
+        msg << "Tile size (" << value << ") must be a multiple of 16.";
+        throw std::invalid_argument(msg.str());
+    } // if
+    _tileSize = value;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+size_t
+geomodelgrids::utils::GeoTiff::getTileSize(void) const {
+    return _tileSize;
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::setCompression(const char* value) {
+    if (!value || (( 0 != strcasecmp(value, "DEFLATE")) && ( 0 != strcasecmp(value, "LZW")) &&
+                   ( 0 != strcasecmp(value, "NONE")) )) {
+        std::ostringstream msg;
+        msg << "Unknown compression '" << (value ? value : "") << "'. Compression must be DEFLATE, LZW, or NONE.";
+        throw std::invalid_argument(msg.str());
+    } // if
+    _compression = value;
+    for (size_t i = 0; i < _compression.size(); ++i) {
+        _compression[i] = toupper(_compression[i]);
+    } // for
+}
+
+
+// ------------------------------------------------------------------------------------------------
+const char*
+geomodelgrids::utils::GeoTiff::getCompression(void) const {
+    return _compression.c_str();
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::setNumOverviews(const size_t value) {
+    _numOverviews = value;
+}
+
+
 // ------------------------------------------------------------------------------------------------
 float*
 geomodelgrids::utils::GeoTiff::getBands(void) {
@@ -178,7 +234,14 @@ geomodelgrids::utils::GeoTiff::create(const char* filename) {
     } // if
 
     char** options = nullptr;
-    options = CSLSetNameValue(options, "COMPRESS", "DEFLATE");
+    options = CSLSetNameValue(options, "COMPRESS", _compression.c_str());
+    options = CSLSetNameValue(options, "BIGTIFF", "IF_SAFER");
+    if (_tileSize > 0) {
+        const std::string& tileSize = std::to_string(_tileSize);
+        options = CSLSetNameValue(options, "TILED", "YES");
+        options = CSLSetNameValue(options, "BLOCKXSIZE", tileSize.c_str());
+        options = CSLSetNameValue(options, "BLOCKYSIZE", tileSize.c_str());
+    } // if
     _dataset = _driver->Create(filename, _numCols, _numRows, _numBands, GDT_Float32, options);
     CSLDestroy(options);options = nullptr;
     if (!_dataset) {
@@ -216,6 +279,45 @@ geomodelgrids::utils::GeoTiff::write(void) {
 }
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::writeWindow(const float* values,
+                                           const size_t col,
+                                           const size_t row,
+                                           const size_t numCols,
+                                           const size_t numRows) {
+    assert(values);
+    if (!_dataset) { throw std::logic_error("GeoTiff file must be created before writing windows."); }
+    if ((col + numCols > _numCols) || (row + numRows > _numRows)) {
+        std::ostringstream msg;
+        msg << "Window with columns [" << col << ", " << col + numCols << ") and rows [" << row << ", "
+            << row + numRows << ") is outside image with " << _numCols << " columns and " << _numRows << " rows.";
+        throw std::out_of_range(msg.str());
+    } // if
+
+    CPLErr err = _dataset->RasterIO(GF_Write, col, row, numCols, numRows, const_cast<float*>(values),
+                                    numCols, numRows, GDT_Float32, _numBands, nullptr, 0, 0, 0, nullptr);
+    if (err != CE_None) { throw std::runtime_error("Error while writing window of raster bands."); }
+}
+
+
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::utils::GeoTiff::buildOverviews(void) {
+    if (!_dataset) { throw std::logic_error("GeoTiff file must be created before building overviews."); }
+    if (!_numOverviews) {
+        return;
+    } // if
+
+    std::vector<int> factors(_numOverviews);
+    for (size_t i = 0; i < _numOverviews; ++i) {
+        factors[i] = 2 << i;
+    } // for
+    CPLErr err = _dataset->BuildOverviews("AVERAGE", factors.size(), factors.data(), 0, nullptr, nullptr, nullptr);
+    if (err != CE_None) { throw std::runtime_error("Error while building overviews of raster bands."); }
+}
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::utils::GeoTiff::read(const char* filename) {
@@ -120,6 +120,39 @@ public:
      */
     void setNoDataValue(const float value);
 
+    /** Set size of internal tiles.
+     *
+     * @param[in] value Number of columns and rows in each tile; must be a multiple of 16 (default is 0, which
+     * uses strips).
+     */
+    void setTileSize(const size_t value);
+
+    /** Get size of internal tiles.
+     *
+     * @returns Number of columns and rows in each tile (0 for strips).
+     */
+    size_t getTileSize(void) const;
+
+    /** Set compression.
+     *
+     * @param[in] value Type of compression (DEFLATE, LZW, or NONE; default is DEFLATE).
+     */
+    void setCompression(const char* value);
+
+    /** Get compression.
+     *
+     * @returns Type of compression.
+     */
+    const char* getCompression(void) const;
+
+    /** Set number of overviews.
+     *
+     * Overview i is reduced by a factor of 2^(i+1).
+     *
+     * @param[in] value Number of overviews built by buildOverviews() (default is 0).
+     */
+    void setNumOverviews(const size_t value);
+
     /** Get buffer for raster bands.
      *
      * Image data is pixel sequential [row, column, band].
@@ -139,6 +172,27 @@ public:
     /// Write data to file.
     void write(void);
 
+    /** Write window of image to file.
+     *
+     * Windows can be written in any order, so the image does not need to fit in memory. For tiled images,
+     * windows aligned with the tiles avoid rewriting tiles. Not thread safe; concurrent writers must be
+     * serialized.
+     *
+     * @param[in] values Values for window, band sequential [band, row, column].
+     * @param[in] col Index of first column of window.
+     * @param[in] row Index of first row of window.
+     * @param[in] numCols Number of columns in window.
+     * @param[in] numRows Number of rows in window.
+     */
+    void writeWindow(const float* values,
+                     const size_t col,
+                     const size_t row,
+                     const size_t numCols,
+                     const size_t numRows);
+
+    /// Build overviews from data written to file.
+    void buildOverviews(void);
+
     /** Read data from file.
      *
      * @param[in] filename Name of image file.
@@ -158,6 +212,9 @@ private:
     size_t _numCols; ///< Number of columns in image.
     size_t _numRows; ///< Number of rows in image.
     size_t _numBands; ///< Number of raster bands.
+    size_t _tileSize; ///< Number of columns and rows in each tile.
+    size_t _numOverviews; ///< Number of overviews.
+    std::string _compression; ///< Type of compression.
     std::vector<std::string> _bandLabels; ///< Labels of raster bands.
     std::string _crs; ///< CRS for image data.
     double _transform[6]; ///< Geographic transformation.
@@ -0,0 +1,295 @@
+#include <portinfo>
+
+#include "PointsPipeline.hh" // implementation of class methods
+
+#include "PointsReader.hh" // USES PointsReader
+#include "PointsWriter.hh" // USES PointsWriter
+
+#include <thread> // USES std::thread
+#include <mutex> // USES std::mutex, std::unique_lock
+#include <condition_variable> // USES std::condition_variable
+#include <exception> // USES std::exception_ptr
+#include <deque> // USES std::deque
+#include <map> // USES std::map
+#include <vector> // USES std::vector
+#include <stdexcept> // USES std::invalid_argument
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace utils {
+        namespace _PointsPipeline {
+            /// Batch of points and the corresponding rows.
+            struct Batch {
+                std::vector<double> points; ///< Points in batch.
+                std::vector<double> rows; ///< Rows for points in batch.
+                size_t index; ///< Index of batch in input.
+                size_t offset; ///< Index of first point in batch.
+                size_t numPoints; ///< Number of points in batch.
+            };
+
+            /// State shared by the threads in the pipeline.
+            struct State {
+                std::mutex mutex;
+                std::condition_variable freeReady; ///< Signaled when a batch is free.
+                std::condition_variable readReady; ///< Signaled when a batch is read or reading finishes.
+                std::condition_variable doneReady; ///< Signaled when a batch is processed or reading finishes.
+                std::deque<Batch*> freeBatches; ///< Batches available for reading.
+                std::deque<Batch*> readBatches; ///< Batches waiting for processing.
+                std::map<size_t, Batch*> doneBatches; ///< Processed batches waiting for writing.
+                std::exception_ptr error; ///< First exception thrown in pipeline.
+                size_t numBatchesRead; ///< Number of batches read.
+                size_t numPointsRead; ///< Number of points read.
+                bool readFinished; ///< True when all points have been read.
+                bool aborted; ///< True if pipeline was stopped by an exception.
+
+                State(void) :
+                    numBatchesRead(0),
+                    numPointsRead(0),
+                    readFinished(false),
+                    aborted(false) {}
+
+
+                /** Stop pipeline, keeping the first exception.
+                 *
+                 * @param[in] exception Exception that stopped the pipeline.
+                 */
+                void abort(std::exception_ptr exception) {
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (!error) {
+                            error = exception;
+                        } // if
+                        aborted = true;
+                    }
+                    freeReady.notify_all();
+                    readReady.notify_all();
+                    doneReady.notify_all();
+                } // abort
+
+            }; // State
+
+            /** Read batches of points until the end of the input.
+             *
+             * @param[inout] state State of pipeline.
+             * @param[inout] reader Reader for points.
+             * @param[in] batchSize Maximum number of points in batch.
+             */
+            static
+            void
+            readPoints(State* state,
+                       geomodelgrids::utils::PointsReader* reader,
+                       const size_t batchSize) {
+                assert(state);
+                assert(reader);
+
+                try {
+                    while (true) {
+                        Batch* batch = nullptr;
+                        { // Wait for free batch.
+                            std::unique_lock<std::mutex> lock(state->mutex);
+                            state->freeReady.wait(lock, [state] {
+                                return state->aborted || !state->freeBatches.empty();
+                            });
+                            if (state->aborted) {
+                                return;
+                            } // if
+                            batch = state->freeBatches.front();
+                            state->freeBatches.pop_front();
+                        }
+
+                        batch->numPoints = reader->read(batch->points.data(), batchSize);
+
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        if (!batch->numPoints) {
+                            state->freeBatches.push_back(batch);
+                            state->readFinished = true;
+                            state->readReady.notify_all();
+                            state->doneReady.notify_all();
+                            return;
+                        } // if
+                        batch->index = state->numBatchesRead++;
+                        batch->offset = state->numPointsRead;
+                        state->numPointsRead += batch->numPoints;
+                        state->readBatches.push_back(batch);
+                        state->readReady.notify_one();
+                    } // while
+                } catch (...) {
+                    state->abort(std::current_exception());
+                } // try/catch
+            } // readPoints
+
+            /** Process batches of points until all points have been read.
+             *
+             * @param[inout] state State of pipeline.
+             * @param[in] process Function processing a batch of points into rows.
+             * @param[in] worker Index of worker.
+             */
+            static
+            void
+            processPoints(State* state,
+                          const geomodelgrids::utils::PointsPipeline::ProcessFn& process,
+                          const size_t worker) {
+                assert(state);
+
+                try {
+                    while (true) {
+                        Batch* batch = nullptr;
+                        { // Wait for batch of points.
+                            std::unique_lock<std::mutex> lock(state->mutex);
+                            state->readReady.wait(lock, [state] {
+                                return state->aborted || !state->readBatches.empty() || state->readFinished;
+                            });
+                            if (state->aborted || state->readBatches.empty()) {
+                                return;
+                            } // if
+                            batch = state->readBatches.front();
+                            state->readBatches.pop_front();
+                        }
+
+                        process(batch->rows.data(), batch->points.data(), batch->numPoints, batch->offset, worker);
+
+                        std::lock_guard<std::mutex> lock(state->mutex);
+                        state->doneBatches[batch->index] = batch;
+                        state->doneReady.notify_all();
+                    } // while
+                } catch (...) {
+                    state->abort(std::current_exception());
+                } // try/catch
+            } // processPoints
+
+        } // _PointsPipeline
+    } // utils
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::utils::PointsPipeline::PointsPipeline(void) :
+    _numWorkers(1),
+    _batchSize(16384),
+    _numBatches(0),
+    _rowsPerPoint(1) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::utils::PointsPipeline::~PointsPipeline(void) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of worker threads.
+void
+geomodelgrids::utils::PointsPipeline::setNumWorkers(const size_t value) {
+    if (!value) {
+        throw std::invalid_argument("Number of worker threads must be positive.");
+    } // if
+    _numWorkers = value;
+} // setNumWorkers
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of worker threads.
+size_t
+geomodelgrids::utils::PointsPipeline::getNumWorkers(void) const {
+    return _numWorkers;
+} // getNumWorkers
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of points in each batch.
+void
+geomodelgrids::utils::PointsPipeline::setBatchSize(const size_t value) {
+    if (!value) {
+        throw std::invalid_argument("Number of points in each batch must be positive.");
+    } // if
+    _batchSize = value;
+} // setBatchSize
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of batches in the pipeline.
+void
+geomodelgrids::utils::PointsPipeline::setNumBatches(const size_t value) {
+    _numBatches = value;
+} // setNumBatches
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of rows written for each point.
+void
+geomodelgrids::utils::PointsPipeline::setRowsPerPoint(const size_t value) {
+    if (!value) {
+        throw std::invalid_argument("Number of rows for each point must be positive.");
+    } // if
+    _rowsPerPoint = value;
+} // setRowsPerPoint
+
+
+// ------------------------------------------------------------------------------------------------
+// Read points, process them, and write the rows.
+size_t
+geomodelgrids::utils::PointsPipeline::run(geomodelgrids::utils::PointsReader* reader,
+                                          const size_t spaceDim,
+                                          geomodelgrids::utils::PointsWriter* writer,
+                                          const size_t numColumns,
+                                          const ProcessFn& process) {
+    assert(reader);
+
+    const size_t numBatches = (_numBatches > 0) ? _numBatches : 2*_numWorkers + 2;
+    std::vector<_PointsPipeline::Batch> batches(numBatches);
+    _PointsPipeline::State state;
+    for (size_t i = 0; i < numBatches; ++i) {
+        batches[i].points.resize(_batchSize*spaceDim);
+        batches[i].rows.resize(_batchSize*_rowsPerPoint*numColumns);
+        state.freeBatches.push_back(&batches[i]);
+    } // for
+
+    std::vector<std::thread> threads;
+    threads.push_back(std::thread(_PointsPipeline::readPoints, &state, reader, _batchSize));
+    for (size_t i = 0; i < _numWorkers; ++i) {
+        threads.push_back(std::thread(_PointsPipeline::processPoints, &state, std::cref(process), i));
+    } // for
+
+    // Write batches in order of the input.
+    size_t numPoints = 0;
+    for (size_t iBatch = 0; true; ++iBatch) {
+        _PointsPipeline::Batch* batch = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(state.mutex);
+            state.doneReady.wait(lock, [&state, iBatch] {
+                return state.aborted || state.doneBatches.count(iBatch) ||
+                (state.readFinished && ( iBatch == state.numBatchesRead) );
+            });
+            if (state.aborted || !state.doneBatches.count(iBatch)) {
+                break;
+            } // if
+            batch = state.doneBatches[iBatch];
+            state.doneBatches.erase(iBatch);
+        }
+
+        try {
+            if (writer) {
+                writer->write(batch->rows.data(), batch->numPoints*_rowsPerPoint);
+            } // if
+        } catch (...) {
+            state.abort(std::current_exception());
+            break;
+        } // try/catch
+        numPoints += batch->numPoints;
+
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.freeBatches.push_back(batch);
+        state.freeReady.notify_one();
+    } // for
+
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    } // for
+    if (state.error) {
+        std::rethrow_exception(state.error);
+    } // if
+
+    return numPoints;
+} // run
+
+
+// End of file
@@ -0,0 +1,114 @@
+/** Pipeline for reading points, processing them in parallel, and writing the results.
+ *
+ * A reader thread reads batches of points, a pool of worker threads processes the batches into
+ * rows, and the calling thread writes the rows in the same order as the points. A fixed number of
+ * batches circulate through the pipeline, so memory use is bounded independent of the number of
+ * points, and the input and output can be named pipes (FIFOs).
+ *
+ * The process function is called concurrently from the worker threads, so it must not share
+ * objects that are not thread safe (such as a serial::Query) across workers; use the index of the
+ * worker to select one object per worker.
+ */
+
+#if !defined(geomodelgrids_utils_pointspipeline_hh)
+#define geomodelgrids_utils_pointspipeline_hh
+
+#include "utilsfwd.hh" // forward declarations
+
+#include <functional> // USES std::function
+#include <cstddef> // USES size_t
+
+class geomodelgrids::utils::PointsPipeline {
+    friend class TestPointsPipeline; // Unit testing
+
+public:
+
+    // PUBLIC TYPEDEFS ----------------------------------------------------------------------------
+
+    /** Function processing a batch of points into rows.
+     *
+     * Arguments:
+     *   rows [out] Rows for points [numPoints*rowsPerPoint*numColumns].
+     *   points [in] Points [numPoints*spaceDim].
+     *   numPoints [in] Number of points.
+     *   offset [in] Index of first point in batch.
+     *   worker [in] Index of worker thread.
+     */
+    typedef std::function<void(double* const, const double* const, const size_t, const size_t, const size_t)> ProcessFn;
+
+public:
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+
+    /// Constructor
+    PointsPipeline(void);
+
+    /// Destructor
+    ~PointsPipeline(void);
+
+    /** Set number of worker threads.
+     *
+     * @param[in] value Number of worker threads (default is 1).
+     */
+    void setNumWorkers(const size_t value);
+
+    /** Get number of worker threads.
+     *
+     * @returns Number of worker threads.
+     */
+    size_t getNumWorkers(void) const;
+
+    /** Set number of points in each batch.
+     *
+     * @param[in] value Number of points in each batch (default is 16384).
+     */
+    void setBatchSize(const size_t value);
+
+    /** Set number of batches in the pipeline.
+     *
+     * @param[in] value Number of batches (default is 0, which uses two per worker plus two).
+     */
+    void setNumBatches(const size_t value);
+
+    /** Set number of rows written for each point.
+     *
+     * @param[in] value Number of rows for each point (default is 1).
+     */
+    void setRowsPerPoint(const size_t value);
+
+    /** Read points, process them, and write the rows.
+     *
+     * Exceptions thrown while reading, processing, or writing stop the pipeline and are rethrown.
+     *
+     * @param[inout] reader Reader for points (opened).
+     * @param[in] spaceDim Number of coordinates for each point.
+     * @param[inout] writer Writer for rows (opened); nullptr if process function writes output.
+     * @param[in] numColumns Number of columns in each row.
+     * @param[in] process Function processing a batch of points into rows.
+     * @returns Number of points processed.
+     */
+    size_t run(geomodelgrids::utils::PointsReader* reader,
+               const size_t spaceDim,
+               geomodelgrids::utils::PointsWriter* writer,
+               const size_t numColumns,
+               const ProcessFn& process);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    size_t _numWorkers; ///< Number of worker threads.
+    size_t _batchSize; ///< Number of points in each batch.
+    size_t _numBatches; ///< Number of batches in pipeline.
+    size_t _rowsPerPoint; ///< Number of rows for each point.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    PointsPipeline(const PointsPipeline&); ///< Not implemented
+    const PointsPipeline& operator=(const PointsPipeline&); ///< Not implemented
+
+}; // PointsPipeline
+
+#endif // geomodelgrids_utils_pointspipeline_hh
+
+// End of file
@@ -0,0 +1,570 @@
+#include <portinfo>
+
+#include "PointsReader.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+
+#include <sys/mman.h> // USES mmap(), munmap()
+#include <sys/stat.h> // USES fstat()
+#include <fcntl.h> // USES open()
+#include <unistd.h> // USES read(), close()
+#include <cerrno> // USES errno
+
+#include <algorithm> // USES std::max_element()
+#include <sstream> // USES std::ostringstream, std::istringstream
+#include <cstring> // USES memcmp(), memcpy(), memchr()
+#include <cstdlib> // USES strtod()
+#include <cstdint> // USES uint16_t, uint32_t
+#include <stdexcept> // USES std::runtime_error
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace utils {
+        namespace _PointsReader {
+            /** Check that the machine is little-endian, which is the byte order of raw and .npy files.
+             *
+             * @returns True if machine is little-endian, false otherwise.
+             */
+            static
+            bool
+            isLittleEndian(void) {
+                const uint16_t value = 1;
+                return 1 == *(const uint8_t*)&value;
+            } // isLittleEndian
+
+            static const size_t textBlockSize = 1024*1024;
+
+            /** Check whether character is whitespace within a line of text.
+             *
+             * @param[in] c Character.
+             * @returns True if character is a space, tab, or carriage return, false otherwise.
+             */
+            inline
+            bool
+            isBlank(const char c) {
+                return ' ' == c || '\t' == c || '\r' == c;
+            } // isBlank
+
+            /** Parse floating point value from line of memory mapped text.
+             *
+             * The mapping is not null terminated, so a value that ends at the end of the file is
+             * copied before conversion.
+             *
+             * @param[out] value Value parsed from text.
+             * @param[inout] cur Current position in line, advanced past value.
+             * @param[in] lineEnd End of line.
+             * @param[in] terminated True if the character at the end of the line can be read.
+             * @returns True if a value was parsed, false otherwise.
+             */
+            static
+            bool
+            parseValue(double* value,
+                       const char** cur,
+                       const char* lineEnd,
+                       const bool terminated) {
+                const char* begin = *cur;
+                while (begin < lineEnd && isBlank(*begin)) {
+                    ++begin;
+                } // while
+                const char* end = begin;
+                while (end < lineEnd && !isBlank(*end)) {
+                    ++end;
+                } // while
+                if (begin == end) {
+                    return false;
+                } // if
+
+                char* parseEnd = nullptr;
+                if (( end < lineEnd) || terminated) {
+                    *value = strtod(begin, &parseEnd);
+                    if (parseEnd != end) {
+                        return false;
+                    } // if
+                } else {
+                    const std::string token(begin, end);
+                    *value = strtod(token.c_str(), &parseEnd);
+                    if (parseEnd != token.c_str() + token.length()) {
+                        return false;
+                    } // if
+                } // if/else
+                *cur = end;
+                return true;
+            } // parseValue
+
+        } // _PointsReader
+    } // utils
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::utils::PointsReader::PointsReader(void) :
+    _dataset("/points"),
+    _h5(nullptr),
+    _mapping(nullptr),
+    _mappingSize(0),
+    _textSize(0),
+    _dataOffset(0),
+    _elementSize(0),
+    _numColumns(0),
+    _numPoints(0),
+    _nextPoint(0),
+    _spaceDim(0),
+    _fd(-1),
+    _textEOF(false),
+    _format(TEXT) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::utils::PointsReader::~PointsReader(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Get format from name.
+geomodelgrids::utils::PointsReader::FormatEnum
+geomodelgrids::utils::PointsReader::parseFormat(const char* name) {
+    assert(name);
+
+    const std::string& format = name;
+    if (std::string("text") == format) {
+        return TEXT;
+    } else if (std::string("raw64") == format) {
+        return RAW_FLOAT64;
+    } else if (std::string("raw32") == format) {
+        return RAW_FLOAT32;
+    } else if (std::string("npy") == format) {
+        return NPY;
+    } else if (std::string("hdf5") == format) {
+        return HDF5;
+    } // if/else
+
+    std::ostringstream msg;
+    msg << "Unknown points format '" << format << "'. Use text, raw64, raw32, npy, or hdf5.";
+    throw std::invalid_argument(msg.str());
+} // parseFormat
+
+
+// ------------------------------------------------------------------------------------------------
+// Set columns in file holding the coordinates of the points.
+void
+geomodelgrids::utils::PointsReader::setColumns(const std::vector<size_t>& columns) {
+    _columns = columns;
+} // setColumns
+
+
+// ------------------------------------------------------------------------------------------------
+// Set number of columns in raw binary files.
+void
+geomodelgrids::utils::PointsReader::setNumColumns(const size_t numColumns) {
+    _numColumns = numColumns;
+} // setNumColumns
+
+
+// ------------------------------------------------------------------------------------------------
+// Set name of dataset for HDF5 files.
+void
+geomodelgrids::utils::PointsReader::setDataset(const char* name) {
+    assert(name);
+    _dataset = name;
+} // setDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Open points file.
+void
+geomodelgrids::utils::PointsReader::open(const char* filename,
+                                         const FormatEnum format,
+                                         const size_t spaceDim) {
+    assert(filename);
+
+    close();
+    _filename = filename;
+    _format = format;
+    _spaceDim = spaceDim;
+    _nextPoint = 0;
+    _numPoints = 0;
+
+    if (_columns.empty()) {
+        for (size_t i = 0; i < spaceDim; ++i) {
+            _columns.push_back(i);
+        } // for
+    } // if
+    if (_columns.size() != spaceDim) {
+        std::ostringstream msg;
+        msg << "Number of columns selected for points (" << _columns.size()
+            << ") does not match the number of coordinates (" << spaceDim << ").";
+        throw std::length_error(msg.str());
+    } // if
+    const size_t minNumColumns = *std::max_element(_columns.begin(), _columns.end()) + 1;
+
+    switch (format) {
+    case TEXT: {
+        _numColumns = std::max(_numColumns, minNumColumns);
+        _dataOffset = 0;
+        struct stat fileStat;
+        if (( 0 == stat(filename, &fileStat)) && !S_ISREG(fileStat.st_mode) ) {
+            _fd = ::open(filename, O_RDONLY);
+            if (_fd < 0) {
+                std::ostringstream msg;
+                msg << "Could not open points file '" << filename << "' for reading.";
+                throw std::runtime_error(msg.str());
+            } // if
+            _textSize = 0;
+            _textEOF = false;
+        } else {
+            _mapFile();
+        } // if/else
+        break;
+    } // TEXT
+    case RAW_FLOAT64:
+    case RAW_FLOAT32: {
+        if (!_PointsReader::isLittleEndian()) {
+            throw std::runtime_error("Raw points files are little-endian, but this machine is big-endian.");
+        } // if
+        _elementSize = (RAW_FLOAT64 == format) ? sizeof(double) : sizeof(float);
+        _numColumns = std::max(_numColumns, minNumColumns);
+        _mapFile();
+        _dataOffset = 0;
+        if (_mappingSize % (_numColumns*_elementSize)) {
+            std::ostringstream msg;
+            msg << "Size of points file '" << filename << "' (" << _mappingSize << " bytes) is not a multiple of "
+                << "the size of a row (" << _numColumns << " columns of " << _elementSize << " bytes).";
+            throw std::runtime_error(msg.str());
+        } // if
+        _numPoints = _mappingSize / (_numColumns*_elementSize);
+        break;
+    } // RAW_FLOAT64/RAW_FLOAT32
+    case NPY: {
+        if (!_PointsReader::isLittleEndian()) {
+            throw std::runtime_error("NumPy .npy points files are read as little-endian, but this machine is big-endian.");
+        } // if
+        _mapFile();
+        _parseNpyHeader();
+        break;
+    } // NPY
+    case HDF5: {
+        _h5 = new geomodelgrids::serial::HDF5();
+        _h5->open(filename, H5F_ACC_RDONLY);
+        if (!_h5->hasDataset(_dataset.c_str())) {
+            std::ostringstream msg;
+            msg << "Could not find dataset '" << _dataset << "' in points file '" << filename << "'.";
+            throw std::runtime_error(msg.str());
+        } // if
+        hsize_t* dims = nullptr;
+        int ndims = 0;
+        _h5->getDatasetDims(&dims, &ndims, _dataset.c_str());
+        if (2 != ndims) {
+            delete[] dims;dims = nullptr;
+            std::ostringstream msg;
+            msg << "Expected 2D dataset for points in '" << filename << "', but dataset has " << ndims << " dimensions.";
+            throw std::runtime_error(msg.str());
+        } // if
+        _numPoints = dims[0];
+        _numColumns = dims[1];
+        delete[] dims;dims = nullptr;
+        break;
+    } // HDF5
+    default:
+        throw std::logic_error("Unknown points format.");
+    } // switch
+
+    if (_numColumns < minNumColumns) {
+        std::ostringstream msg;
+        msg << "Points file '" << filename << "' has " << _numColumns << " columns, but column "
+            << minNumColumns-1 << " was selected.";
+        throw std::runtime_error(msg.str());
+    } // if
+} // open
+
+
+// ------------------------------------------------------------------------------------------------
+// Get number of points in file.
+size_t
+geomodelgrids::utils::PointsReader::getNumPoints(void) const {
+    return _numPoints;
+} // getNumPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Read next batch of points.
+size_t
+geomodelgrids::utils::PointsReader::read(double* const points,
+                                         const size_t maxPoints) {
+    assert(points || !maxPoints);
+
+    if (TEXT == _format) {
+        return _readText(points, maxPoints);
+    } // if
+
+    const size_t numRead = std::min(maxPoints, _numPoints - _nextPoint);
+    const size_t numColumns = _numColumns;
+    if (HDF5 == _format) {
+        assert(_h5);
+        _buffer.resize(numRead*numColumns);
+        const hsize_t origin[2] = { _nextPoint, 0 };
+        const hsize_t dims[2] = { numRead, numColumns };
+        _h5->readDatasetHyperslab(_buffer.data(), _dataset.c_str(), origin, dims, 2, H5T_NATIVE_DOUBLE);
+        for (size_t iPt = 0; iPt < numRead; ++iPt) {
+            for (size_t iDim = 0; iDim < _spaceDim; ++iDim) {
+                points[iPt*_spaceDim+iDim] = _buffer[iPt*numColumns+_columns[iDim]];
+            } // for
+        } // for
+    } else if (sizeof(double) == _elementSize) {
+        const char* rows = _mapping + _dataOffset + _nextPoint*numColumns*sizeof(double);
+        for (size_t iPt = 0; iPt < numRead; ++iPt) {
+            for (size_t iDim = 0; iDim < _spaceDim; ++iDim) {
+                memcpy(&points[iPt*_spaceDim+iDim], rows + (iPt*numColumns+_columns[iDim])*sizeof(double), sizeof(double));
+            } // for
+        } // for
+    } else {
+        const char* rows = _mapping + _dataOffset + _nextPoint*numColumns*sizeof(float);
+        for (size_t iPt = 0; iPt < numRead; ++iPt) {
+            for (size_t iDim = 0; iDim < _spaceDim; ++iDim) {
+                float value = 0.0;
+                memcpy(&value, rows + (iPt*numColumns+_columns[iDim])*sizeof(float), sizeof(float));
+                points[iPt*_spaceDim+iDim] = value;
+            } // for
+        } // for
+    } // if/else
+    _nextPoint += numRead;
+
+    return numRead;
+} // read
+
+
+// ------------------------------------------------------------------------------------------------
+// Close points file.
+void
+geomodelgrids::utils::PointsReader::close(void) {
+    if (_h5) {
+        _h5->close();
+    } // if
+    delete _h5;_h5 = nullptr;
+    if (_mapping) {
+        munmap((void*)_mapping, _mappingSize);
+    } // if
+    _mapping = nullptr;
+    _mappingSize = 0;
+    if (_fd >= 0) {
+        ::close(_fd);
+    } // if
+    _fd = -1;
+    _buffer.clear();
+    _textBuffer.clear();
+    _textSize = 0;
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Map file into memory.
+void
+geomodelgrids::utils::PointsReader::_mapFile(void) {
+    const int fd = ::open(_filename.c_str(), O_RDONLY);
+    struct stat fileStat;
+    if (( fd < 0) || ( fstat(fd, &fileStat) != 0) ) {
+        if (fd >= 0) { ::close(fd); }
+        std::ostringstream msg;
+        msg << "Could not open points file '" << _filename << "' for reading.";
+        throw std::runtime_error(msg.str());
+    } // if
+    _mappingSize = fileStat.st_size;
+    if (_mappingSize > 0) {
+        void* mapping = mmap(nullptr, _mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == mapping) {
+            ::close(fd);
+            std::ostringstream msg;
+            msg << "Could not map points file '" << _filename << "' into memory.";
+            throw std::runtime_error(msg.str());
+        } // if
+        madvise(mapping, _mappingSize, MADV_SEQUENTIAL);
+        _mapping = (const char*) mapping;
+    } // if
+    ::close(fd);
+} // _mapFile
+
+
+// ------------------------------------------------------------------------------------------------
+// Parse header of NumPy .npy file.
+void
+geomodelgrids::utils::PointsReader::_parseNpyHeader(void) {
+    const char magic[6] = { '\x93', 'N', 'U', 'M', 'P', 'Y' };
+    if (( _mappingSize < 10) || memcmp(_mapping, magic, sizeof(magic)) ) {
+        std::ostringstream msg;
+        msg << "Points file '" << _filename << "' is not a NumPy .npy file.";
+        throw std::runtime_error(msg.str());
+    } // if
+    const uint8_t majorVersion = _mapping[6];
+    size_t headerLength = 0;
+    size_t headerOffset = 0;
+    if (1 == majorVersion) {
+        uint16_t length = 0;
+        memcpy(&length, _mapping+8, sizeof(length));
+        headerLength = length;
+        headerOffset = 10;
+    } else {
+        uint32_t length = 0;
+        memcpy(&length, _mapping+8, sizeof(length));
+        headerLength = length;
+        headerOffset = 12;
+    } // if/else
+    if (headerOffset + headerLength > _mappingSize) {
+        std::ostringstream msg;
+        msg << "Header of NumPy .npy points file '" << _filename << "' is truncated.";
+        throw std::runtime_error(msg.str());
+    } // if
+    const std::string header(_mapping + headerOffset, headerLength);
+    _dataOffset = headerOffset + headerLength;
+
+    if (std::string::npos != header.find("'fortran_order': True")) {
+        std::ostringstream msg;
+        msg << "NumPy .npy points file '" << _filename << "' uses Fortran order. Save the array in C order.";
+        throw std::runtime_error(msg.str());
+    } // if
+    if (std::string::npos != header.find("'descr': '<f8'")) {
+        _elementSize = sizeof(double);
+    } else if (std::string::npos != header.find("'descr': '<f4'")) {
+        _elementSize = sizeof(float);
+    } else {
+        std::ostringstream msg;
+        msg << "NumPy .npy points file '" << _filename << "' must contain little-endian float64 or float32 values.";
+        throw std::runtime_error(msg.str());
+    } // if/else
+
+    const size_t shapeBegin = header.find("'shape': (");
+    const size_t shapeEnd = header.find(")", shapeBegin);
+    if (( std::string::npos == shapeBegin) || ( std::string::npos == shapeEnd) ) {
+        std::ostringstream msg;
+        msg << "Could not find shape of array in NumPy .npy points file '" << _filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    std::istringstream shape(header.substr(shapeBegin+10, shapeEnd-shapeBegin-10));
+    char comma = '\0';
+    size_t numRows = 0;
+    size_t numColumns = 0;
+    shape >> numRows >> comma >> numColumns;
+    if (!shape || (',' != comma) ) {
+        std::ostringstream msg;
+        msg << "Expected 2D array in NumPy .npy points file '" << _filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    _numPoints = numRows;
+    _numColumns = numColumns;
+    if (_dataOffset + _numPoints*_numColumns*_elementSize > _mappingSize) {
+        std::ostringstream msg;
+        msg << "NumPy .npy points file '" << _filename << "' is truncated.";
+        throw std::runtime_error(msg.str());
+    } // if
+} // _parseNpyHeader
+
+
+// ------------------------------------------------------------------------------------------------
+// Get next line of text file.
+bool
+geomodelgrids::utils::PointsReader::_getTextLine(const char** begin,
+                                                 const char** end,
+                                                 bool* terminated) {
+    assert(begin);
+    assert(end);
+    assert(terminated);
+
+    if (_fd < 0) {
+        if (_dataOffset >= _mappingSize) {
+            return false;
+        } // if
+        const char* const fileEnd = _mapping + _mappingSize;
+        const char* lineEnd = (const char*) memchr(_mapping + _dataOffset, '\n', _mappingSize - _dataOffset);
+        if (!lineEnd) {
+            lineEnd = fileEnd;
+        } // if
+        *begin = _mapping + _dataOffset;
+        *end = lineEnd;
+        *terminated = lineEnd < fileEnd;
+        _dataOffset = std::min(size_t(lineEnd - _mapping) + 1, _mappingSize);
+        return true;
+    } // if
+
+    // Text buffer is null terminated, so the end of a line can always be read.
+    *terminated = true;
+    while (true) {
+        const char* text = _textBuffer.data();
+        const char* lineEnd = (_dataOffset < _textSize) ?
+                              (const char*) memchr(text + _dataOffset, '\n', _textSize - _dataOffset) : nullptr;
+        if (lineEnd || (_textEOF && ( _dataOffset < _textSize) )) {
+            if (!lineEnd) {
+                lineEnd = text + _textSize;
+            } // if
+            *begin = text + _dataOffset;
+            *end = lineEnd;
+            _dataOffset = std::min(size_t(lineEnd - text) + 1, _textSize);
+            return true;
+        } else if (_textEOF) {
+            return false;
+        } // if/else
+
+        // Move partial line to beginning of buffer and read next block.
+        const size_t partialSize = _textSize - _dataOffset;
+        if (partialSize) {
+            memmove(&_textBuffer[0], &_textBuffer[_dataOffset], partialSize);
+        } // if
+        _textSize = partialSize;
+        _dataOffset = 0;
+        _textBuffer.resize(_textSize + _PointsReader::textBlockSize + 1);
+        ssize_t numBytes = 0;
+        do {
+            numBytes = ::read(_fd, &_textBuffer[_textSize], _PointsReader::textBlockSize);
+        } while (numBytes < 0 && EINTR == errno);
+        if (numBytes < 0) {
+            std::ostringstream msg;
+            msg << "Error reading points file '" << _filename << "'.";
+            throw std::runtime_error(msg.str());
+        } // if
+        _textEOF = (0 == numBytes);
+        _textSize += numBytes;
+        _textBuffer[_textSize] = '\0';
+    } // while
+} // _getTextLine
+
+
+// ------------------------------------------------------------------------------------------------
+// Read next batch of points from text file.
+size_t
+geomodelgrids::utils::PointsReader::_readText(double* const points,
+                                              const size_t maxPoints) {
+    const size_t spaceDim = _spaceDim;
+    _buffer.resize(_numColumns);
+    double* row = _buffer.data();
+
+    // Select columns from each line; skip blank and comment lines.
+    size_t numRead = 0;
+    const char* cur = nullptr;
+    const char* lineEnd = nullptr;
+    bool terminated = false;
+    while (numRead < maxPoints && _getTextLine(&cur, &lineEnd, &terminated)) {
+        while (cur < lineEnd && _PointsReader::isBlank(*cur)) {
+            ++cur;
+        } // while
+        if (( cur == lineEnd) || ( '#' == *cur) ) {
+            continue;
+        } // if
+
+        bool ok = true;
+        for (size_t iCol = 0; iCol < _numColumns && ok; ++iCol) {
+            ok = _PointsReader::parseValue(&row[iCol], &cur, lineEnd, terminated);
+        } // for
+        if (!ok) {
+            close();
+            break;
+        } // if
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            points[numRead*spaceDim+iDim] = row[_columns[iDim]];
+        } // for
+        ++numRead;
+    } // while
+
+    return numRead;
+} // _readText
+
+
+// End of file
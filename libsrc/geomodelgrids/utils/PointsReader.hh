@@ -0,0 +1,165 @@
+/** Reader for arrays of points in text and binary formats.
+ *
+ * Text and binary files (raw and NumPy .npy) are memory mapped, so reading a batch of points is a
+ * copy (and conversion for float32) from the page cache. Text is parsed line by line with strtod()
+ * directly from the mapping, avoiding the overhead of locale-aware stream extraction. Text files
+ * that cannot be mapped, such as named pipes (FIFOs), are read in blocks. HDF5 datasets are read
+ * in hyperslabs of rows.
+ */
+
+#if !defined(geomodelgrids_utils_pointsreader_hh)
+#define geomodelgrids_utils_pointsreader_hh
+
+#include "utilsfwd.hh" // forward declarations
+
+#include "geomodelgrids/serial/serialfwd.hh" // HOLDSA HDF5
+
+#include <vector> // HASA std::vector
+#include <string> // HASA std::string
+
+class geomodelgrids::utils::PointsReader {
+    friend class TestPointsIO; // Unit testing
+
+public:
+
+    // PUBLIC ENUMS -------------------------------------------------------------------------------
+
+    /// Format of points file.
+    enum FormatEnum {
+        TEXT=0, ///< Whitespace separated ASCII text.
+        RAW_FLOAT64=1, ///< Raw little-endian float64 array, row major.
+        RAW_FLOAT32=2, ///< Raw little-endian float32 array, row major.
+        NPY=3, ///< NumPy .npy file with 2D float64 or float32 array.
+        HDF5=4, ///< 2D dataset in HDF5 file.
+    };
+
+public:
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+
+    /// Constructor
+    PointsReader(void);
+
+    /// Destructor
+    ~PointsReader(void);
+
+    /** Get format from name.
+     *
+     * @param[in] name Name of format (text, raw64, raw32, npy, hdf5).
+     * @returns Format of points file.
+     */
+    static
+    FormatEnum parseFormat(const char* name);
+
+    /** Set columns in file holding the coordinates of the points.
+     *
+     * Default is the first spaceDim columns.
+     *
+     * @param[in] columns Indices (zero based) of columns for coordinates.
+     */
+    void setColumns(const std::vector<size_t>& columns);
+
+    /** Set number of columns in raw binary files.
+     *
+     * Default is the minimum number of columns consistent with the selected columns.
+     *
+     * @param[in] numColumns Number of columns in each row.
+     */
+    void setNumColumns(const size_t numColumns);
+
+    /** Set name of dataset for HDF5 files.
+     *
+     * @param[in] name Full path of dataset (default is /points).
+     */
+    void setDataset(const char* name);
+
+    /** Open points file.
+     *
+     * @param[in] filename Name of points file.
+     * @param[in] format Format of points file.
+     * @param[in] spaceDim Number of coordinates for each point.
+     */
+    void open(const char* filename,
+              const FormatEnum format,
+              const size_t spaceDim);
+
+    /** Get number of points in file.
+     *
+     * @returns Number of points in binary files, 0 for text files.
+     */
+    size_t getNumPoints(void) const;
+
+    /** Read next batch of points.
+     *
+     * @param[out] points Preallocated array of points [maxPoints*spaceDim].
+     * @param[in] maxPoints Maximum number of points to read.
+     * @returns Number of points read (0 at end of file).
+     */
+    size_t read(double* const points,
+                const size_t maxPoints);
+
+    /// Close points file.
+    void close(void);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /// Map file into memory.
+    void _mapFile(void);
+
+    /// Parse header of NumPy .npy file.
+    void _parseNpyHeader(void);
+
+    /** Get next line of text file.
+     *
+     * @param[out] begin Beginning of line.
+     * @param[out] end End of line (excluding newline).
+     * @param[out] terminated True if the character at the end of the line can be read.
+     * @returns True if a line was found, false at end of file.
+     */
+    bool _getTextLine(const char** begin,
+                      const char** end,
+                      bool* terminated);
+
+    /** Read next batch of points from text file.
+     *
+     * @param[out] points Preallocated array of points [maxPoints*spaceDim].
+     * @param[in] maxPoints Maximum number of points to read.
+     * @returns Number of points read (0 at end of file).
+     */
+    size_t _readText(double* const points,
+                     const size_t maxPoints);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::vector<size_t> _columns; ///< Indices of columns for coordinates.
+    std::vector<double> _buffer; ///< Buffer for rows read from HDF5 file.
+    std::vector<char> _textBuffer; ///< Buffer for blocks of text files that are not mapped.
+    std::string _filename; ///< Name of points file.
+    std::string _dataset; ///< Name of dataset in HDF5 file.
+    geomodelgrids::serial::HDF5* _h5; ///< HDF5 file.
+    const char* _mapping; ///< Memory mapped binary file.
+    size_t _mappingSize; ///< Size of memory mapped file.
+    size_t _textSize; ///< Number of characters in text buffer.
+    size_t _dataOffset; ///< Offset of array (binary files) or next line (text files).
+    size_t _elementSize; ///< Size of array element in bytes.
+    size_t _numColumns; ///< Number of columns in each row.
+    size_t _numPoints; ///< Number of points in binary file.
+    size_t _nextPoint; ///< Index of next point to read.
+    size_t _spaceDim; ///< Number of coordinates for each point.
+    int _fd; ///< File descriptor for text files that are not mapped.
+    bool _textEOF; ///< True if end of text file that is not mapped has been reached.
+    FormatEnum _format; ///< Format of points file.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    PointsReader(const PointsReader&); ///< Not implemented
+    const PointsReader& operator=(const PointsReader&); ///< Not implemented
+
+}; // PointsReader
+
+#endif // geomodelgrids_utils_pointsreader_hh
+
+// End of file
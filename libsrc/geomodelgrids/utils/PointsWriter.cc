@@ -0,0 +1,311 @@
+#include <portinfo>
+
+#include "PointsWriter.hh" // implementation of class methods
+
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5::Lock
+
+#include <algorithm> // USES std::max()
+#include <fstream> // USES std::ofstream
+#include <sstream> // USES std::ostringstream
+#include <cstdint> // USES uint16_t
+#include <cstdio> // USES snprintf()
+#include <stdexcept> // USES std::runtime_error
+#include <cassert> // USES assert()
+
+namespace geomodelgrids {
+    namespace utils {
+        namespace _PointsWriter {
+            static const size_t npyAlignment = 64;
+            static const size_t npyMaxRowsDigits = 20;
+            static const size_t hdf5ChunkBytes = 1024*1024;
+            static const int textMaxExponentChars = 10; // sign, leading digit, decimal point, e+XXX
+        } // _PointsWriter
+    } // utils
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Constructor
+geomodelgrids::utils::PointsWriter::PointsWriter(void) :
+    _dataset("/values"),
+    _sout(nullptr),
+    _h5File(-1),
+    _h5Dataset(-1),
+    _numColumns(0),
+    _numRows(0),
+    _width(14),
+    _precision(6),
+    _format(geomodelgrids::utils::PointsReader::TEXT) {}
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor
+geomodelgrids::utils::PointsWriter::~PointsWriter(void) {
+    close();
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Set header written at the top of text files.
+void
+geomodelgrids::utils::PointsWriter::setHeader(const std::string& header) {
+    _header = header;
+} // setHeader
+
+
+// ------------------------------------------------------------------------------------------------
+// Set names of columns.
+void
+geomodelgrids::utils::PointsWriter::setColumnNames(const std::vector<std::string>& names) {
+    _columnNames = names;
+} // setColumnNames
+
+
+// ------------------------------------------------------------------------------------------------
+// Set width and precision of values in text files.
+void
+geomodelgrids::utils::PointsWriter::setTextFormat(const int width,
+                                                  const int precision) {
+    _width = width;
+    _precision = precision;
+} // setTextFormat
+
+
+// ------------------------------------------------------------------------------------------------
+// Set name of dataset for HDF5 files.
+void
+geomodelgrids::utils::PointsWriter::setDataset(const char* name) {
+    assert(name);
+    _dataset = name;
+} // setDataset
+
+
+// ------------------------------------------------------------------------------------------------
+// Open output file.
+void
+geomodelgrids::utils::PointsWriter::open(const char* filename,
+                                         const geomodelgrids::utils::PointsReader::FormatEnum format,
+                                         const size_t numColumns) {
+    assert(filename);
+
+    close();
+    _filename = filename;
+    _format = format;
+    _numColumns = numColumns;
+    _numRows = 0;
+
+    if (geomodelgrids::utils::PointsReader::HDF5 == format) {
+        _createHDF5();
+        return;
+    } // if
+
+    const std::ios::openmode mode = (geomodelgrids::utils::PointsReader::TEXT == format) ?
+                                    std::ios::out : std::ios::out | std::ios::binary;
+    _sout = new std::ofstream(filename, mode);
+    if (!_sout->is_open() || !_sout->good()) {
+        std::ostringstream msg;
+        msg << "Could not open output file '" << filename << "' for writing.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    switch (format) {
+    case geomodelgrids::utils::PointsReader::TEXT:
+        *_sout << _header;
+        break;
+    case geomodelgrids::utils::PointsReader::NPY: {
+        const std::string& header = _createNpyHeader(0);
+        _sout->write(header.c_str(), header.length());
+        break;
+    } // NPY
+    default:
+        break;
+    } // switch
+} // open
+
+
+// ------------------------------------------------------------------------------------------------
+// Write rows.
+void
+geomodelgrids::utils::PointsWriter::write(const double* const rows,
+                                          const size_t numRows) {
+    assert(rows || !numRows);
+
+    const size_t numValues = numRows * _numColumns;
+    switch (_format) {
+    case geomodelgrids::utils::PointsReader::TEXT: {
+        assert(_sout);
+        const size_t valueMaxSize = size_t(std::max(_width, _precision + _PointsWriter::textMaxExponentChars)) + 1;
+        _bufferText.resize(numRows*(_numColumns*valueMaxSize + 1));
+        char* const buffer = _bufferText.data();
+        const size_t bufferSize = _bufferText.size();
+        size_t length = 0;
+        for (size_t iRow = 0; iRow < numRows; ++iRow) {
+            const double* row = &rows[iRow*_numColumns];
+            for (size_t iCol = 0; iCol < _numColumns; ++iCol) {
+                length += snprintf(buffer + length, bufferSize - length, "%*.*e", _width, _precision, row[iCol]);
+            } // for
+            buffer[length++] = '\n';
+        } // for
+        assert(length <= bufferSize);
+        _sout->write(buffer, length);
+        break;
+    } // TEXT
+    case geomodelgrids::utils::PointsReader::RAW_FLOAT64:
+    case geomodelgrids::utils::PointsReader::NPY:
+        assert(_sout);
+        _sout->write((const char*)rows, numValues*sizeof(double));
+        break;
+    case geomodelgrids::utils::PointsReader::RAW_FLOAT32: {
+        assert(_sout);
+        _buffer32.resize(numValues);
+        for (size_t i = 0; i < numValues; ++i) {
+            _buffer32[i] = float(rows[i]);
+        } // for
+        _sout->write((const char*)_buffer32.data(), numValues*sizeof(float));
+        break;
+    } // RAW_FLOAT32
+    case geomodelgrids::utils::PointsReader::HDF5: {
+        assert(_h5Dataset >= 0);
+        if (!numRows) {
+            break;
+        } // if
+        geomodelgrids::serial::HDF5::Lock lock;
+        const hsize_t dimsAll[2] = { _numRows + numRows, _numColumns };
+        const hsize_t origin[2] = { _numRows, 0 };
+        const hsize_t dims[2] = { numRows, _numColumns };
+        bool ok = H5Dset_extent(_h5Dataset, dimsAll) >= 0;
+        const hid_t fileSpace = H5Dget_space(_h5Dataset);
+        const hid_t memSpace = H5Screate_simple(2, dims, nullptr);
+        ok = ok && (fileSpace >= 0) && (memSpace >= 0);
+        ok = ok && H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, origin, nullptr, dims, nullptr) >= 0;
+        ok = ok && H5Dwrite(_h5Dataset, H5T_NATIVE_DOUBLE, memSpace, fileSpace, H5P_DEFAULT, rows) >= 0;
+        if (memSpace >= 0) { H5Sclose(memSpace); }
+        if (fileSpace >= 0) { H5Sclose(fileSpace); }
+        if (!ok) {
+            std::ostringstream msg;
+            msg << "Could not write rows to dataset '" << _dataset << "' in output file '" << _filename << "'.";
+            throw std::runtime_error(msg.str());
+        } // if
+        break;
+    } // HDF5
+    default:
+        throw std::logic_error("Unknown output format.");
+    } // switch
+    _numRows += numRows;
+
+    if (_sout && !_sout->good()) {
+        std::ostringstream msg;
+        msg << "Error writing to output file '" << _filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+} // write
+
+
+// ------------------------------------------------------------------------------------------------
+// Close output file, completing headers of binary files.
+void
+geomodelgrids::utils::PointsWriter::close(void) {
+    if (_sout) {
+        if (geomodelgrids::utils::PointsReader::NPY == _format) {
+            const std::string& header = _createNpyHeader(_numRows);
+            _sout->seekp(0);
+            _sout->write(header.c_str(), header.length());
+        } // if
+        _sout->close();
+    } // if
+    delete _sout;_sout = nullptr;
+
+    _closeHDF5();
+} // close
+
+
+// ------------------------------------------------------------------------------------------------
+// Create header for NumPy .npy file.
+std::string
+geomodelgrids::utils::PointsWriter::_createNpyHeader(const size_t numRows) const {
+    std::ostringstream dict;
+    dict << "{'descr': '<f8', 'fortran_order': False, 'shape': (" << numRows << ", " << _numColumns << "), }";
+
+    // Pad header to a fixed length (independent of the number of rows) so that it can be
+    // rewritten in place with the final number of rows.
+    const size_t preambleSize = 10;
+    const size_t dictSize = dict.str().length() - std::to_string(numRows).length() + _PointsWriter::npyMaxRowsDigits;
+    const size_t alignment = _PointsWriter::npyAlignment;
+    const size_t headerSize = ((preambleSize + dictSize + 1 + alignment - 1) / alignment) * alignment - preambleSize;
+    const uint16_t headerLength = uint16_t(headerSize);
+
+    std::string header("\x93NUMPY\x01\x00", 8);
+    header.append((const char*)&headerLength, sizeof(headerLength));
+    header.append(dict.str());
+    header.append(headerSize - dict.str().length() - 1, ' ');
+    header.append("\n");
+
+    return header;
+} // _createNpyHeader
+
+
+// ------------------------------------------------------------------------------------------------
+// Create HDF5 file and extendible dataset.
+void
+geomodelgrids::utils::PointsWriter::_createHDF5(void) {
+    geomodelgrids::serial::HDF5::Lock lock;
+    _h5File = H5Fcreate(_filename.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if (_h5File < 0) {
+        std::ostringstream msg;
+        msg << "Could not create output file '" << _filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    const hsize_t dims[2] = { 0, _numColumns };
+    const hsize_t maxDims[2] = { H5S_UNLIMITED, _numColumns };
+    const hsize_t chunkRows = std::max(size_t(1), _PointsWriter::hdf5ChunkBytes / (_numColumns*sizeof(double)));
+    const hsize_t chunk[2] = { chunkRows, _numColumns };
+    const hid_t dataspace = H5Screate_simple(2, dims, maxDims);
+    const hid_t properties = H5Pcreate(H5P_DATASET_CREATE);
+    H5Pset_chunk(properties, 2, chunk);
+    _h5Dataset = H5Dcreate2(_h5File, _dataset.c_str(), H5T_IEEE_F64LE, dataspace, H5P_DEFAULT, properties, H5P_DEFAULT);
+    H5Pclose(properties);
+    H5Sclose(dataspace);
+    if (_h5Dataset < 0) {
+        _closeHDF5();
+        std::ostringstream msg;
+        msg << "Could not create dataset '" << _dataset << "' in output file '" << _filename << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    if (_columnNames.size()) {
+        std::vector<const char*> names(_columnNames.size());
+        for (size_t i = 0; i < names.size(); ++i) {
+            names[i] = _columnNames[i].c_str();
+        } // for
+        const hsize_t numNames = names.size();
+        const hid_t datatype = H5Tcopy(H5T_C_S1);
+        H5Tset_size(datatype, H5T_VARIABLE);
+        const hid_t attrSpace = H5Screate_simple(1, &numNames, nullptr);
+        const hid_t attribute = H5Acreate2(_h5Dataset, "column_names", datatype, attrSpace, H5P_DEFAULT, H5P_DEFAULT);
+        if (attribute >= 0) {
+            H5Awrite(attribute, datatype, names.data());
+            H5Aclose(attribute);
+        } // if
+        H5Sclose(attrSpace);
+        H5Tclose(datatype);
+    } // if
+} // _createHDF5
+
+
+// ------------------------------------------------------------------------------------------------
+// Close HDF5 file and dataset.
+void
+geomodelgrids::utils::PointsWriter::_closeHDF5(void) {
+    geomodelgrids::serial::HDF5::Lock lock;
+    if (_h5Dataset >= 0) {
+        H5Dclose(_h5Dataset);
+    } // if
+    _h5Dataset = -1;
+    if (_h5File >= 0) {
+        H5Fclose(_h5File);
+    } // if
+    _h5File = -1;
+} // _closeHDF5
+
+
+// End of file
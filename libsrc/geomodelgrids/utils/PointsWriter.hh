@@ -0,0 +1,127 @@
+/** Writer for arrays of points and values in text and binary formats.
+ *
+ * Rows are written in batches, so each batch is a single large write. Text rows are formatted with
+ * snprintf() into a buffer, matching the fixed-width scientific layout of std::setw() with
+ * std::scientific, without the per-value overhead of stream formatting.
+ */
+
+#if !defined(geomodelgrids_utils_pointswriter_hh)
+#define geomodelgrids_utils_pointswriter_hh
+
+#include "utilsfwd.hh" // forward declarations
+
+#include "PointsReader.hh" // USES PointsReader::FormatEnum
+
+#include <hdf5.h> // USES hid_t
+
+#include <vector> // HASA std::vector
+#include <string> // HASA std::string
+#include <iosfwd> // HOLDSA std::ofstream
+
+class geomodelgrids::utils::PointsWriter {
+    friend class TestPointsIO; // Unit testing
+
+public:
+
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+
+    /// Constructor
+    PointsWriter(void);
+
+    /// Destructor
+    ~PointsWriter(void);
+
+    /** Set header written at the top of text files.
+     *
+     * @param[in] header Header (including trailing newline).
+     */
+    void setHeader(const std::string& header);
+
+    /** Set names of columns.
+     *
+     * The names are stored in the 'column_names' attribute of HDF5 datasets.
+     *
+     * @param[in] names Names of columns.
+     */
+    void setColumnNames(const std::vector<std::string>& names);
+
+    /** Set width and precision of values in text files.
+     *
+     * @param[in] width Width of each column (default is 14).
+     * @param[in] precision Number of digits after the decimal point (default is 6).
+     */
+    void setTextFormat(const int width,
+                       const int precision);
+
+    /** Set name of dataset for HDF5 files.
+     *
+     * @param[in] name Full path of dataset (default is /values).
+     */
+    void setDataset(const char* name);
+
+    /** Open output file.
+     *
+     * @param[in] filename Name of output file.
+     * @param[in] format Format of output file.
+     * @param[in] numColumns Number of columns in each row.
+     */
+    void open(const char* filename,
+              const geomodelgrids::utils::PointsReader::FormatEnum format,
+              const size_t numColumns);
+
+    /** Write rows.
+     *
+     * @param[in] rows Array of values [numRows*numColumns].
+     * @param[in] numRows Number of rows.
+     */
+    void write(const double* const rows,
+               const size_t numRows);
+
+    /// Close output file, completing headers of binary files.
+    void close(void);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Create header for NumPy .npy file.
+     *
+     * @param[in] numRows Number of rows in array.
+     * @returns Header padded to a fixed length.
+     */
+    std::string _createNpyHeader(const size_t numRows) const;
+
+    /// Create HDF5 file and extendible dataset.
+    void _createHDF5(void);
+
+    /// Close HDF5 file and dataset.
+    void _closeHDF5(void);
+
+    // PRIVATE MEMBERS ----------------------------------------------------------------------------
+private:
+
+    std::vector<std::string> _columnNames; ///< Names of columns.
+    std::vector<float> _buffer32; ///< Buffer for converting rows to float32.
+    std::vector<char> _bufferText; ///< Buffer for formatting rows as text.
+    std::string _filename; ///< Name of output file.
+    std::string _header; ///< Header for text files.
+    std::string _dataset; ///< Name of dataset in HDF5 file.
+    std::ofstream* _sout; ///< Output stream for text and binary files.
+    hid_t _h5File; ///< HDF5 file.
+    hid_t _h5Dataset; ///< HDF5 dataset.
+    size_t _numColumns; ///< Number of columns in each row.
+    size_t _numRows; ///< Number of rows written.
+    int _width; ///< Width of columns in text files.
+    int _precision; ///< Precision of values in text files.
+    geomodelgrids::utils::PointsReader::FormatEnum _format; ///< Format of output file.
+
+    // NOT IMPLEMENTED ----------------------------------------------------------------------------
+private:
+
+    PointsWriter(const PointsWriter&); ///< Not implemented
+    const PointsWriter& operator=(const PointsWriter&); ///< Not implemented
+
+}; // PointsWriter
+
+#endif // geomodelgrids_utils_pointswriter_hh
+
+// End of file
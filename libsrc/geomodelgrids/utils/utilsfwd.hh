@@ -13,6 +13,10 @@ namespace geomodelgrids {
 
         class ErrorHandler;
 
+        class PointsReader;
+        class PointsWriter;
+        class PointsPipeline;
+
         class TestDriver;
     } // utils
 } // geomodelgrids
@@ -121,6 +121,10 @@ init_query(py::module_& m) {
 
     .def("get_error_handler", &geomodelgrids::PyQuery::getErrorHandler)
 
+    .def("set_target_resolution", &geomodelgrids::PyQuery::setTargetResolution,
+         "Set target horizontal resolution for selecting coarser levels of blocks.",
+         py::arg("resolution"))
+
     .def("initialize", &geomodelgrids::PyQuery::initialize,
          "Perform initialization required to query the models.",
          py::arg("models"),
@@ -138,6 +142,15 @@ init_query(py::module_& m) {
          "Set type of squashing.",
          py::arg("squash_type"))
 
+    .def("preload_region", &geomodelgrids::PyQuery::preloadRegion,
+         "Load the portions of the models covering a region of interest into memory.",
+         py::arg("x_min"),
+         py::arg("x_max"),
+         py::arg("y_min"),
+         py::arg("y_max"),
+         py::arg("z_min"),
+         py::arg("z_max"))
+
     .def("query_top_elevation", &geomodelgrids::PyQuery::query_top_elevation,
          "Query for elevation (m) of top of model at points using bilinear interpolation.",
          py::arg("points")
@@ -282,6 +282,66 @@ class OneBlockFlatVarZ(TestData):
     blocks[0]["z_coordinates"] = blocks[0]["z_coordinates"][::-1]  # Reverse order for testing
 
 
+class OneBlockFlatNonmonotonic(TestData):
+    filename = "one-block-flat-nonmonotonic.h5"
+    model = {
+        "title": "One Block Flat Nonmonotonic",
+        "id": "one-block-flat-nonmonotonic",
+        "description": "Model with one block, no topography, and a layer with high values in alternate columns.",
+        "keywords": ["key one", "key two", "key three"],
+        "history": "First version",
+        "comment": "One comment",
+        "creator_name": "John Doe",
+        "creator_institution": "Agency",
+        "creator_email": "johndoe@agency.org",
+        "acknowledgement": "Thank you!",
+        "authors": ["Smith, Jim", "Doe, John", "Doyle, Sarah"],
+        "references": ["Reference 1", "Reference 2"],
+        "repository_name": "Some repository",
+        "repository_url": "http://somewhere.org",
+        "repository_doi": "this.is.a.doi",
+        "license": "CC0",
+        "version": "1.0.0",
+        "data_values": ["one", "two"],
+        "data_units": ["m", "m/s"],
+        "data_layout": "vertex",
+        "crs": 'EPSG:26910',
+        "origin_x": 590000.0,
+        "origin_y": 4150000.0,
+        "y_azimuth": 90.0,
+        "dim_x": 32.0e+3,
+        "dim_y": 40.0e+3,
+        "dim_z": 5.0e+3,
+    }
+
+    top_surface = None
+    topo_bathy = None
+
+    blocks = [
+        {
+            "name": "block",
+            "x_resolution": 8.0e+3,
+            "y_resolution": 10.0e+3,
+            "z_resolution": 0.5e+3,
+            "z_top": 0.0e+3,
+            "dim_z": 5.0e+3,
+            "chunk_size": (1, 1, 11, 2),
+        }
+    ]
+    for block in blocks:
+        x, y, z = TestData.create_block_xyz(model, block)
+        (nx, ny, nz) = x.shape
+        nvalues = len(model["data_values"])
+        data = numpy.zeros((nx, ny, nz, nvalues), dtype=numpy.float32)
+        # Values do not vary with y, except for a layer with high values between depths of
+        # 1.0 km and 1.5 km at every other y coordinate.
+        data[:, :, :, 0] = calc_one(x, 0.0, z)
+        data[:, :, :, 1] = calc_two(x, 0.0, z)
+        layer = numpy.logical_and(numpy.logical_and(z <= -1.0e+3, z >= -1.5e+3), (y / 10.0e+3) % 2 == 1)
+        data[layer, :] += 2.0e+4
+        block["data"] = data
+
+
 class OneBlockTopo(TestData):
     filename = "one-block-topo.h5"
     model = {
@@ -354,6 +414,53 @@ class OneBlockTopo(TestData):
             h5["surfaces"]["top_surface"].attrs["x_resolution"] *= 0.5
             h5.attrs["data_layout"] = "cell"
 
+    def quantized(self):
+        """Store block values as 16-bit integers with a scale factor and offset for each value
+        matching Block.get_value_encoding() in the create package. The last point is NODATA.
+        """
+        self.filename = "one-block-topo-quantized.h5"
+        self.create()
+        with h5py.File(self.filename, "a") as h5:
+            block_dataset = h5["blocks"]["block"]
+            values = block_dataset[:].astype(numpy.float64)
+            attrs = dict(block_dataset.attrs)
+            chunks = block_dataset.chunks
+            del h5["blocks"]["block"]
+
+            code_max = numpy.iinfo(numpy.int16).max
+            value_min = numpy.min(values, axis=(0, 1, 2))
+            value_max = numpy.max(values, axis=(0, 1, 2))
+            scale_factor = (value_max - value_min) / (2 * code_max)
+            add_offset = 0.5 * (value_max + value_min)
+            missing_value = float(numpy.iinfo(numpy.int16).min)
+            codes = numpy.rint((values - add_offset) / scale_factor).astype(numpy.int16)
+            codes[-1, -1, -1, :] = missing_value
+
+            block_dataset = h5["blocks"].create_dataset("block", data=codes, chunks=chunks)
+            for attr_name, value in attrs.items():
+                block_dataset.attrs[attr_name] = value
+            block_dataset.attrs["scale_factor"] = scale_factor
+            block_dataset.attrs["add_offset"] = add_offset
+            block_dataset.attrs["missing_value"] = missing_value
+
+    def planar(self):
+        """Store block values with the value index as the leading dimension (value, x, y, z)
+        matching value_layout = planar in the create package.
+        """
+        self.filename = "one-block-topo-planar.h5"
+        self.create()
+        with h5py.File(self.filename, "a") as h5:
+            block_dataset = h5["blocks"]["block"]
+            values = numpy.moveaxis(block_dataset[:], 3, 0)
+            attrs = dict(block_dataset.attrs)
+            chunks = (1,) + block_dataset.chunks[:3]
+            del h5["blocks"]["block"]
+
+            block_dataset = h5["blocks"].create_dataset("block", data=values, chunks=chunks)
+            for attr_name, value in attrs.items():
+                block_dataset.attrs[attr_name] = value
+            block_dataset.attrs["value_layout"] = numpy.string_("planar")
+
 
 class OneBlockTopoVarXY(TestData):
     filename = "one-block-topo-varxy.h5"
@@ -641,6 +748,32 @@ class ThreeBlocksTopo(TestData):
         with h5py.File(self.filename, "a") as h5:
             h5.attrs["data_units"] = ["km", "km/s"]
 
+    def levels(self):
+        """Add coarser levels of blocks with steps (x, y, z) matching HDF5Storage.save_block_levels()
+        for factors [2, 4, 8].
+        """
+        self.filename = "three-blocks-topo-levels.h5"
+        self.create()
+        levels = {
+            "top": {"2": (2, 2, 1), "4": (2, 4, 1)},
+            "middle": {"2": (1, 2, 2)},
+            "bottom": {"2": (2, 2, 2), "4": (2, 4, 2)},
+        }
+        with h5py.File(self.filename, "a") as h5:
+            levels_group = h5.create_group("levels")
+            for block_name, block_levels in levels.items():
+                block_dataset = h5["blocks"][block_name]
+                block_group = levels_group.create_group(block_name)
+                for factor, steps in block_levels.items():
+                    (step_x, step_y, step_z) = steps
+                    level_dataset = block_group.create_dataset(
+                        factor, data=block_dataset[::step_x, ::step_y, ::step_z, :])
+                    attrs = level_dataset.attrs
+                    for attr_name, value in block_dataset.attrs.items():
+                        attrs[attr_name] = value
+                    for axis, step in zip("xyz", steps):
+                        attrs[f"{axis}_resolution"] *= step
+
 
 class ThreeBlocksTopoVarXYZ(TestData):
     filename = "three-blocks-topo-varxyz.h5"
@@ -737,15 +870,19 @@ if __name__ == "__main__":
     ThreeBlocksTopo().create()
 
     OneBlockFlatVarZ().create()
+    OneBlockFlatNonmonotonic().create()
     OneBlockTopoVarXY().create()
     OneBlockTopoVarXY().bad_topo_coordinates()
     OneBlockTopoVarXY().bad_block_coordinates()
     ThreeBlocksTopoVarXYZ().create()
 
     OneBlockTopo().bad_topo_metadata()
+    OneBlockTopo().quantized()
+    OneBlockTopo().planar()
     ThreeBlocksTopo().bad_block_metadata()
     ThreeBlocksTopo().missing_metadata()
     ThreeBlocksTopo().inconsistent_units()
+    ThreeBlocksTopo().levels()
 
 
 # End of file
@@ -62,6 +62,12 @@ public:
     /// Test _parseArgs() with all arguments.
     void testParseArgsAll(void);
 
+    /// Test _parseArgs() with file of locations.
+    void testParseArgsLocations(void);
+
+    /// Test _parseArgs() with conflicting locations.
+    void testParseArgsConflictingLocations(void);
+
     /// Test _printHelp().
     void testPrintHelp(void);
 
@@ -80,6 +86,12 @@ public:
     /// Test run() wth bad output location.
     void testRunBadLocation(void);
 
+    /// Test run() wth file of locations and combined output.
+    void testRunLocations(void);
+
+    /// Test run() wth file of locations and output for each site.
+    void testRunLocationsPerSite(void);
+
 }; // class TestBorehole
 
 // ------------------------------------------------------------------------------------------------
@@ -113,6 +125,12 @@ TEST_CASE("TestBorehole::testParseArgsMinimal", "[TestBorehole]") {
 TEST_CASE("TestBorehole::testParseArgsAll", "[TestBorehole]") {
     geomodelgrids::apps::TestBorehole().testParseArgsAll();
 }
+TEST_CASE("TestBorehole::testParseArgsLocations", "[TestBorehole]") {
+    geomodelgrids::apps::TestBorehole().testParseArgsLocations();
+}
+TEST_CASE("TestBorehole::testParseArgsConflictingLocations", "[TestBorehole]") {
+    geomodelgrids::apps::TestBorehole().testParseArgsConflictingLocations();
+}
 TEST_CASE("TestBorehole::testPrintHelp", "[TestBorehole]") {
     geomodelgrids::apps::TestBorehole().testPrintHelp();
 }
@@ -131,6 +149,12 @@ TEST_CASE("TestBorehole::testRunBadOutput", "[TestBorehole]") {
 TEST_CASE("TestBorehole::testRunBadLocation", "[TestBorehole]") {
     geomodelgrids::apps::TestBorehole().testRunBadLocation();
 }
+TEST_CASE("TestBorehole::testRunLocations", "[TestBorehole]") {
+    geomodelgrids::apps::TestBorehole().testRunLocations();
+}
+TEST_CASE("TestBorehole::testRunLocationsPerSite", "[TestBorehole]") {
+    geomodelgrids::apps::TestBorehole().testRunLocationsPerSite();
+}
 
 // ------------------------------------------------------------------------------------------------
 namespace geomodelgrids {
@@ -144,7 +168,12 @@ public:
 
     static
     void checkBorehole(std::istream& sin,
-                       const geomodelgrids::testdata::ModelPoints& points);
+                       const geomodelgrids::testdata::ModelPoints& points,
+                       const size_t numHeaderLines=2,
+                       const bool withLocation=false);
+
+    static
+    void writeLocations(const char* filename);
 
 }; // _TestBorehole
 // ------------------------------------------------------------------------------------------------
@@ -313,10 +342,74 @@ geomodelgrids::apps::TestBorehole::testParseArgsAll(void) {
     CHECK(300.0 == borehole._maxDepth);
     CHECK(100.0 == borehole._dz);
     CHECK(std::string("error.log") == borehole._logFilename);
+    CHECK(size_t(1) == borehole._numThreads);
+    CHECK(!borehole._outputPerSite);
     CHECK(!borehole._showHelp);
 } // testParseArgsAll
 
 
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with file of locations.
+void
+geomodelgrids::apps::TestBorehole::testParseArgsLocations(void) {
+    const int nargs = 7;
+    const char* const args[nargs] = {
+        "test",
+        "--models=A",
+        "--locations=sites.txt",
+        "--output=points.out",
+        "--output-per-site",
+        "--num-threads=4",
+        "--values=one",
+    };
+
+    Borehole borehole;
+    borehole._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(std::string("sites.txt") == borehole._locationsFilename);
+    CHECK(NODATA_VALUE == borehole._location[0]);
+    CHECK(NODATA_VALUE == borehole._location[1]);
+    CHECK(borehole._outputPerSite);
+    CHECK(size_t(4) == borehole._numThreads);
+    CHECK(!borehole._showHelp);
+} // testParseArgsLocations
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with conflicting locations.
+void
+geomodelgrids::apps::TestBorehole::testParseArgsConflictingLocations(void) {
+    { // --location and --locations
+        optind = 1;
+        const int nargs = 6;
+        const char* const args[nargs] = {
+            "test", "--models=A", "--location=1.0,2.0", "--locations=sites.txt", "--output=points.out", "--values=one",
+        };
+        Borehole borehole;
+        CHECK_THROWS_AS(borehole._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --location and --locations
+
+    { // --output-per-site without --locations
+        optind = 1;
+        const int nargs = 6;
+        const char* const args[nargs] = {
+            "test", "--models=A", "--location=1.0,2.0", "--output-per-site", "--output=points.out", "--values=one",
+        };
+        Borehole borehole;
+        CHECK_THROWS_AS(borehole._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --output-per-site without --locations
+
+    { // --num-threads=0
+        optind = 1;
+        const int nargs = 6;
+        const char* const args[nargs] = {
+            "test", "--models=A", "--locations=sites.txt", "--num-threads=0", "--output=points.out", "--values=one",
+        };
+        Borehole borehole;
+        CHECK_THROWS_AS(borehole._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --num-threads=0
+} // testParseArgsConflictingLocations
+
+
 // ------------------------------------------------------------------------------------------------
 // Test _printHelp().
 void
@@ -328,7 +421,7 @@ geomodelgrids::apps::TestBorehole::testPrintHelp(void) {
     Borehole borehole;
     borehole._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1053) == coutHelp.str().length());
+    CHECK(size_t(1439) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -349,7 +442,7 @@ geomodelgrids::apps::TestBorehole::testRunHelp(void) {
     borehole.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1053) == coutHelp.str().length());
+    CHECK(size_t(1439) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -447,18 +540,102 @@ geomodelgrids::apps::TestBorehole::testRunBadLocation(void) {
 } // testRunBadLocation
 
 
+// ------------------------------------------------------------------------------------------------
+// Test run() with file of locations and combined output.
+void
+geomodelgrids::apps::TestBorehole::testRunLocations(void) {
+    _TestBorehole::writeLocations("three-blocks-topo-boreholes.in");
+
+    const int nargs = 9;
+    const char* const args[nargs] = {
+        "test",
+        "--models=../../data/three-blocks-topo.h5",
+        "--locations=three-blocks-topo-boreholes.in",
+        "--max-depth=25.0e+3",
+        "--dz=5.0e+3",
+        "--output=three-blocks-topo-boreholes.out",
+        "--points-coordsys=EPSG:4326",
+        "--values=two,one",
+        "--num-threads=2",
+    };
+    geomodelgrids::testdata::ThreeBlocksTopoBorehole boreholeThree;
+
+    Borehole borehole;
+    CHECK(0 == borehole.run(nargs, const_cast<char**>(args)));
+
+    std::ifstream sin("three-blocks-topo-boreholes.out");assert(sin.is_open() && sin.good());
+    _TestBorehole::checkBorehole(sin, boreholeThree, 2, true);
+    _TestBorehole::checkBorehole(sin, boreholeThree, 0, true);
+
+    // Location outside model.
+    const size_t numDepths = boreholeThree.getNumPoints();
+    for (size_t iDepth = 0; iDepth < numDepths; ++iDepth) {
+        double x = 0.0, y = 0.0, elev = 0.0, depth = 0.0, two = 0.0, one = 0.0;
+        sin >> x >> y >> elev >> depth >> two >> one;
+        CHECK(sin.good());
+        CHECK(97.7 == y);
+        CHECK(NODATA_VALUE == elev);
+        CHECK(NODATA_VALUE == two);
+        CHECK(NODATA_VALUE == one);
+    } // for
+    sin.close();
+} // testRunLocations
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with file of locations and output for each site.
+void
+geomodelgrids::apps::TestBorehole::testRunLocationsPerSite(void) {
+    _TestBorehole::writeLocations("three-blocks-topo-boreholes.in");
+
+    const int nargs = 10;
+    const char* const args[nargs] = {
+        "test",
+        "--models=../../data/three-blocks-topo.h5",
+        "--locations=three-blocks-topo-boreholes.in",
+        "--max-depth=25.0e+3",
+        "--dz=5.0e+3",
+        "--output=three-blocks-topo-site.out",
+        "--output-per-site",
+        "--points-coordsys=EPSG:4326",
+        "--values=two,one",
+        "--num-threads=3",
+    };
+    geomodelgrids::testdata::ThreeBlocksTopoBorehole boreholeThree;
+
+    Borehole borehole;
+    CHECK(0 == borehole.run(nargs, const_cast<char**>(args)));
+
+    const size_t numSites = 2;
+    const char* const filenames[numSites] = {
+        "three-blocks-topo-site-0.out",
+        "three-blocks-topo-site-1.out",
+    };
+    for (size_t iSite = 0; iSite < numSites; ++iSite) {
+        std::ifstream sin(filenames[iSite]);assert(sin.is_open() && sin.good());
+        _TestBorehole::checkBorehole(sin, boreholeThree, 3);
+        sin.close();
+    } // for
+    std::ifstream sin("three-blocks-topo-site-2.out");
+    CHECK(sin.is_open());
+} // testRunLocationsPerSite
+
+
 // ------------------------------------------------------------------------------------------------
 void
 geomodelgrids::apps::_TestBorehole::checkBorehole(std::istream& sin,
-                                                  const geomodelgrids::testdata::ModelPoints& points) {
+                                                  const geomodelgrids::testdata::ModelPoints& points,
+                                                  const size_t numHeaderLines,
+                                                  const bool withLocation) {
     const size_t spaceDim = 3;
     const size_t numPoints = points.getNumPoints();
     const double* const pointsXYZ = points.getXYZ();
     const double* const pointsLLE = points.getLatLonElev();
 
     std::string comment;
-    std::getline(sin, comment); // Command
-    std::getline(sin, comment); // Column headers
+    for (size_t i = 0; i < numHeaderLines; ++i) {
+        std::getline(sin, comment); // Command, location, column headers
+    } // for
 
     const double groundSurf = pointsLLE[0*spaceDim+2];
     for (size_t iPt = 0; iPt < numPoints; ++iPt) {
@@ -468,6 +645,13 @@ geomodelgrids::apps::_TestBorehole::checkBorehole(std::istream& sin,
 
         double elev, depth;
         const double tolerance = 1.0e-6;
+        if (withLocation) {
+            double locationX, locationY;
+            sin >> locationX;CHECK(sin.good());
+            sin >> locationY;CHECK(sin.good());
+            CHECK_THAT(locationX, Catch::Matchers::WithinAbs(pointsLLE[iPt*spaceDim+0], tolerance));
+            CHECK_THAT(locationY, Catch::Matchers::WithinAbs(pointsLLE[iPt*spaceDim+1], tolerance));
+        } // if
         sin >> elev;CHECK(sin.good());
         sin >> depth;CHECK(sin.good());
 
@@ -502,4 +686,16 @@ geomodelgrids::apps::_TestBorehole::checkBorehole(std::istream& sin,
 } // checkBorehole
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::apps::_TestBorehole::writeLocations(const char* filename) {
+    std::ofstream sout(filename);
+    sout << "# Latitude Longitude\n"
+         << "35.1 -117.7\n"
+         << "35.1 -117.7\n"
+         << "35.1 97.7\n";
+    sout.close();
+} // writeLocations
+
+
 // End of file
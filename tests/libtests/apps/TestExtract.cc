@@ -0,0 +1,490 @@
+/**
+ * C++ unit testing of geomodelgrids::apps::Extract.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/apps/Extract.hh" // USES Extract
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Query.hh" // USES Query
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include "hdf5.h" // USES H5Fopen(), H5Dopen2(), H5Dread_chunk()
+
+#include <iostream> // USES std::cout
+#include <sstream> // USES std::ostringstream
+#include <getopt.h> // USES optind
+#include <cmath> // USES M_PI, cos(), sin()
+#include <vector> // USES std::vector
+
+namespace geomodelgrids {
+    namespace apps {
+        class TestExtract;
+    } // apps
+} // geomodelgrids
+
+class geomodelgrids::apps::TestExtract {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    TestExtract(void);
+
+    /// Test constructor.
+    void testConstructor(void);
+
+    /// Test _parseArgs() with no args.
+    void testParseNoArgs(void);
+
+    /// Test _parseArgs() with --help.
+    void testParseArgsHelp(void);
+
+    /// Test _parseArgs() with missing arguments.
+    void testParseArgsMissing(void);
+
+    /// Test _parseArgs() with wrong arguments.
+    void testParseArgsWrong(void);
+
+    /// Test _parseArgs() with bad bounding box.
+    void testParseArgsBadBBox(void);
+
+    /// Test _parseArgs() with all arguments.
+    void testParseArgsAll(void);
+
+    /// Test _printHelp().
+    void testPrintHelp(void);
+
+    /// Test run() with three-blocks-topo.
+    void testRunThreeBlocksTopo(void);
+
+    /// Test run() with subset ending within chunks of the model.
+    void testRunEdgeChunks(void);
+
+    /// Test run() with bounding box outside model.
+    void testRunOutside(void);
+
+}; // class TestExtract
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestExtract::testConstructor", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testConstructor();
+}
+TEST_CASE("TestExtract::testParseNoArgs", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testParseNoArgs();
+}
+TEST_CASE("TestExtract::testParseArgsHelp", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testParseArgsHelp();
+}
+TEST_CASE("TestExtract::testParseArgsMissing", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testParseArgsMissing();
+}
+TEST_CASE("TestExtract::testParseArgsWrong", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testParseArgsWrong();
+}
+TEST_CASE("TestExtract::testParseArgsBadBBox", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testParseArgsBadBBox();
+}
+TEST_CASE("TestExtract::testParseArgsAll", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testParseArgsAll();
+}
+TEST_CASE("TestExtract::testPrintHelp", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testPrintHelp();
+}
+TEST_CASE("TestExtract::testRunThreeBlocksTopo", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testRunThreeBlocksTopo();
+}
+TEST_CASE("TestExtract::testRunEdgeChunks", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testRunEdgeChunks();
+}
+TEST_CASE("TestExtract::testRunOutside", "[TestExtract]") {
+    geomodelgrids::apps::TestExtract().testRunOutside();
+}
+
+// ------------------------------------------------------------------------------------------------
+geomodelgrids::apps::TestExtract::TestExtract(void) {
+    optind = 1; // reset parsing of argc and argv
+} // setUp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::apps::TestExtract::testConstructor(void) {
+    Extract extract;
+
+    CHECK(std::string("EPSG:4326") == extract._bboxCRS);
+    CHECK(false == extract._showHelp);
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with no args.
+void
+geomodelgrids::apps::TestExtract::testParseNoArgs(void) {
+    const int nargs = 1;
+    const char* const args[nargs] = { "test" };
+
+    Extract extract;
+    extract._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(extract._showHelp);
+} // testParseNoArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with --help.
+void
+geomodelgrids::apps::TestExtract::testParseArgsHelp(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--help" };
+
+    Extract extract;
+    extract._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(extract._showHelp);
+} // testParseArgsHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with missing arguments.
+void
+geomodelgrids::apps::TestExtract::testParseArgsMissing(void) {
+    { // --model
+        optind = 1;
+        const int nargs = 3;
+        const char* const args[nargs] = { "test", "--output=B", "--bbox=0,1,0,1" };
+
+        Extract extract;
+        CHECK_THROWS_AS(extract._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --model
+
+    { // --output
+        optind = 1;
+        const int nargs = 3;
+        const char* const args[nargs] = { "test", "--model=A", "--bbox=0,1,0,1" };
+
+        Extract extract;
+        CHECK_THROWS_AS(extract._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --output
+
+    { // --bbox
+        optind = 1;
+        const int nargs = 3;
+        const char* const args[nargs] = { "test", "--model=A", "--output=B" };
+
+        Extract extract;
+        CHECK_THROWS_AS(extract._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --bbox
+} // testParseArgsMissing
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with wrong arguments.
+void
+geomodelgrids::apps::TestExtract::testParseArgsWrong(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--blah" };
+
+    Extract extract;
+    CHECK_THROWS_AS(extract._parseArgs(nargs, const_cast<char**>(args)), std::logic_error);
+} // testParseArgsWrong
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with bad bounding box.
+void
+geomodelgrids::apps::TestExtract::testParseArgsBadBBox(void) {
+    { // Wrong number of values
+        optind = 1;
+        const int nargs = 4;
+        const char* const args[nargs] = { "test", "--model=A", "--output=B", "--bbox=0,1,2" };
+
+        Extract extract;
+        CHECK_THROWS_AS(extract._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // Wrong number of values
+
+    { // Minimum greater than maximum
+        optind = 1;
+        const int nargs = 4;
+        const char* const args[nargs] = { "test", "--model=A", "--output=B", "--bbox=0,1,2,1" };
+
+        Extract extract;
+        CHECK_THROWS_AS(extract._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // Minimum greater than maximum
+} // testParseArgsBadBBox
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with all arguments.
+void
+geomodelgrids::apps::TestExtract::testParseArgsAll(void) {
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--model=A",
+        "--output=B",
+        "--bbox=-121.5,-120.5,36.0,37.5",
+        "--bbox-crs=EPSG:26910",
+    };
+
+    Extract extract;
+    extract._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(std::string("A") == extract._modelFilename);
+    CHECK(std::string("B") == extract._outputFilename);
+    CHECK(-121.5 == extract._bbox[0]);
+    CHECK(-120.5 == extract._bbox[1]);
+    CHECK(36.0 == extract._bbox[2]);
+    CHECK(37.5 == extract._bbox[3]);
+    CHECK(std::string("EPSG:26910") == extract._bboxCRS);
+    CHECK(!extract._showHelp);
+} // testParseArgsAll
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _printHelp().
+void
+geomodelgrids::apps::TestExtract::testPrintHelp(void) {
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutHelp;
+    std::cout.rdbuf(coutHelp.rdbuf() );
+
+    Extract extract;
+    extract._printHelp();
+    std::cout.rdbuf(coutOrig);
+    CHECK(size_t(491) == coutHelp.str().length());
+} // testPrintHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with three-blocks-topo.
+void
+geomodelgrids::apps::TestExtract::testRunThreeBlocksTopo(void) {
+    // Bounding box around (x=30km, y=90km) in the model coordinate system. The horizontal
+    // resolutions of the model (5, 10, 20, and 30 km) align the subset to 60 km, so the subset
+    // covers y=[60km, 120km] and the full model along the x axis.
+    const double originX = 200000.0;
+    const double originY = -400000.0;
+    const double yazimuth = 330.0 * M_PI / 180.0;
+    const double cosAz = cos(yazimuth);
+    const double sinAz = sin(yazimuth);
+
+    const char* const filenameIn = "../../data/three-blocks-topo.h5";
+    const char* const filenameOut = "three-blocks-topo-extract.h5";
+    std::ostringstream bbox;
+    const double xCenter = originX + 30.0e+3*cosAz + 90.0e+3*sinAz;
+    const double yCenter = originY - 30.0e+3*sinAz + 90.0e+3*cosAz;
+    bbox << "--bbox=" << xCenter-5.0e+3 << "," << xCenter+5.0e+3 << "," << yCenter-5.0e+3 << "," << yCenter+5.0e+3;
+    const std::string bboxArg = bbox.str();
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--model=../../data/three-blocks-topo.h5",
+        "--output=three-blocks-topo-extract.h5",
+        bboxArg.c_str(),
+        "--bbox-crs=EPSG:3311",
+    };
+
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutRun;
+    std::cout.rdbuf(coutRun.rdbuf() );
+    Extract extract;
+    const int err = extract.run(nargs, const_cast<char**>(args));
+    std::cout.rdbuf(coutOrig);
+    REQUIRE(0 == err);
+
+    { // Metadata
+        geomodelgrids::serial::Model model;
+        model.open(filenameOut, geomodelgrids::serial::Model::READ);
+        model.loadMetadata();
+        const double tolerance = 1.0e-6;
+        CHECK_THAT(model.getOrigin()[0], Catch::Matchers::WithinAbs(originX + 60.0e+3*sinAz, tolerance));
+        CHECK_THAT(model.getOrigin()[1], Catch::Matchers::WithinAbs(originY + 60.0e+3*cosAz, tolerance));
+        CHECK_THAT(model.getDims()[0], Catch::Matchers::WithinAbs(60.0e+3, tolerance));
+        CHECK_THAT(model.getDims()[1], Catch::Matchers::WithinAbs(60.0e+3, tolerance));
+        CHECK_THAT(model.getDims()[2], Catch::Matchers::WithinAbs(45.0e+3, tolerance));
+        model.close();
+    } // Metadata
+
+    // Values at points in the subset match the original model.
+    std::vector<std::string> valueNames;
+    valueNames.push_back("one");
+    valueNames.push_back("two");
+    geomodelgrids::serial::Query queryIn;
+    queryIn.initialize(std::vector<std::string>(1, filenameIn), valueNames, "EPSG:3311");
+    geomodelgrids::serial::Query queryOut;
+    queryOut.initialize(std::vector<std::string>(1, filenameOut), valueNames, "EPSG:3311");
+
+    const size_t numX = 4;
+    const size_t numY = 4;
+    const size_t numZ = 4;
+    const double xModel[numX] = { 2.0e+3, 21.0e+3, 38.0e+3, 58.0e+3 };
+    const double yModel[numY] = { 61.0e+3, 77.0e+3, 99.0e+3, 119.0e+3 };
+    const double zModel[numZ] = { -1.0e+3, -12.0e+3, -27.0e+3, -44.0e+3 };
+    for (size_t iX = 0; iX < numX; ++iX) {
+        for (size_t iY = 0; iY < numY; ++iY) {
+            const double x = originX + xModel[iX]*cosAz + yModel[iY]*sinAz;
+            const double y = originY - xModel[iX]*sinAz + yModel[iY]*cosAz;
+            CHECK_THAT(queryOut.queryTopElevation(x, y),
+                       Catch::Matchers::WithinAbs(queryIn.queryTopElevation(x, y), 1.0e-6));
+            for (size_t iZ = 0; iZ < numZ; ++iZ) {
+                double valuesIn[2];
+                double valuesOut[2];
+                const int errIn = queryIn.query(valuesIn, x, y, zModel[iZ]);
+                const int errOut = queryOut.query(valuesOut, x, y, zModel[iZ]);
+                INFO("x=" << xModel[iX] << ", y=" << yModel[iY] << ", z=" << zModel[iZ]);
+                CHECK(errIn == errOut);
+                CHECK_THAT(valuesOut[0], Catch::Matchers::WithinRel(valuesIn[0], 1.0e-6));
+                CHECK_THAT(valuesOut[1], Catch::Matchers::WithinRel(valuesIn[1], 1.0e-6));
+            } // for
+        } // for
+    } // for
+    queryIn.finalize();
+    queryOut.finalize();
+} // testRunThreeBlocksTopo
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with subset ending within chunks of the model.
+void
+geomodelgrids::apps::TestExtract::testRunEdgeChunks(void) {
+    // Bounding box around (x=30km, y=30km) in the model coordinate system, so the subset covers
+    // y=[0km, 60km] and ends within chunks of the top block and surfaces along the y axis.
+    const double originX = 200000.0;
+    const double originY = -400000.0;
+    const double yazimuth = 330.0 * M_PI / 180.0;
+    const double cosAz = cos(yazimuth);
+    const double sinAz = sin(yazimuth);
+
+    const char* const filenameIn = "../../data/three-blocks-topo.h5";
+    const char* const filenameOut = "three-blocks-topo-extract.h5";
+    std::ostringstream bbox;
+    const double xCenter = originX + 30.0e+3*cosAz + 30.0e+3*sinAz;
+    const double yCenter = originY - 30.0e+3*sinAz + 30.0e+3*cosAz;
+    bbox << "--bbox=" << xCenter-5.0e+3 << "," << xCenter+5.0e+3 << "," << yCenter-5.0e+3 << "," << yCenter+5.0e+3;
+    const std::string bboxArg = bbox.str();
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--model=../../data/three-blocks-topo.h5",
+        "--output=three-blocks-topo-extract.h5",
+        bboxArg.c_str(),
+        "--bbox-crs=EPSG:3311",
+    };
+
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutRun;
+    std::cout.rdbuf(coutRun.rdbuf() );
+    Extract extract;
+    const int err = extract.run(nargs, const_cast<char**>(args));
+    std::cout.rdbuf(coutOrig);
+    REQUIRE(0 == err);
+    INFO(coutRun.str());
+    CHECK(std::string::npos == coutRun.str().find(" 0 edge chunks by value"));
+
+    hid_t h5In = H5Fopen(filenameIn, H5F_ACC_RDONLY, H5P_DEFAULT);REQUIRE(h5In >= 0);
+    hid_t h5Out = H5Fopen(filenameOut, H5F_ACC_RDONLY, H5P_DEFAULT);REQUIRE(h5Out >= 0);
+    const size_t numDatasets = 5;
+    const char* const datasetPaths[numDatasets] = {
+        "surfaces/top_surface",
+        "surfaces/topography_bathymetry",
+        "blocks/top",
+        "blocks/middle",
+        "blocks/bottom",
+    };
+    size_t numOutside = 0;
+    for (size_t iDataset = 0; iDataset < numDatasets; ++iDataset) {
+        INFO("Dataset '" << datasetPaths[iDataset] << "'.");
+        hid_t datasetIn = H5Dopen2(h5In, datasetPaths[iDataset], H5P_DEFAULT);REQUIRE(datasetIn >= 0);
+        hid_t datasetOut = H5Dopen2(h5Out, datasetPaths[iDataset], H5P_DEFAULT);REQUIRE(datasetOut >= 0);
+        hid_t spaceOut = H5Dget_space(datasetOut);
+        const int ndims = H5Sget_simple_extent_ndims(spaceOut);
+        std::vector<hsize_t> dims(ndims);
+        H5Sget_simple_extent_dims(spaceOut, dims.data(), nullptr);
+        hid_t dcpl = H5Dget_create_plist(datasetOut);
+        std::vector<hsize_t> chunk(ndims);
+        REQUIRE(ndims == H5Pget_chunk(dcpl, ndims, chunk.data()));
+        REQUIRE(0 == H5Pget_nfilters(dcpl));
+        hid_t datatype = H5Dget_type(datasetOut);
+        const size_t typeSize = H5Tget_size(datatype);
+
+        // Values in the subset match the original model, which starts at the same point.
+        hsize_t numValues = 1;
+        hsize_t numChunks = 1;
+        std::vector<hsize_t> numChunksDim(ndims);
+        for (int iDim = 0; iDim < ndims; ++iDim) {
+            numValues *= dims[iDim];
+            numChunksDim[iDim] = (dims[iDim] + chunk[iDim] - 1) / chunk[iDim];
+            numChunks *= numChunksDim[iDim];
+        } // for
+        std::vector<char> valuesIn(numValues*typeSize);
+        std::vector<char> valuesOut(numValues*typeSize);
+        hid_t spaceIn = H5Dget_space(datasetIn);
+        const std::vector<hsize_t> start(ndims, 0);
+        H5Sselect_hyperslab(spaceIn, H5S_SELECT_SET, start.data(), nullptr, dims.data(), nullptr);
+        REQUIRE(H5Dread(datasetIn, datatype, spaceOut, spaceIn, H5P_DEFAULT, valuesIn.data()) >= 0);
+        REQUIRE(H5Dread(datasetOut, datatype, H5S_ALL, H5S_ALL, H5P_DEFAULT, valuesOut.data()) >= 0);
+        CHECK(valuesIn == valuesOut);
+
+        // Points of chunks outside the subset hold the fill value (zero) rather than points of the
+        // original model.
+        std::vector<char> buffer;
+        std::vector<hsize_t> offset(ndims);
+        for (hsize_t iChunk = 0; iChunk < numChunks; ++iChunk) {
+            hsize_t index = iChunk;
+            for (int iDim = ndims-1; iDim >= 0; --iDim) {
+                offset[iDim] = (index % numChunksDim[iDim]) * chunk[iDim];
+                index /= numChunksDim[iDim];
+            } // for
+            hsize_t numBytes = 0;
+            REQUIRE(H5Dget_chunk_storage_size(datasetOut, offset.data(), &numBytes) >= 0);
+            buffer.resize(numBytes);
+            uint32_t filters = 0;
+            REQUIRE(H5Dread_chunk(datasetOut, H5P_DEFAULT, offset.data(), &filters, buffer.data()) >= 0);
+            const size_t numChunkValues = numBytes / typeSize;
+            for (size_t iValue = 0; iValue < numChunkValues; ++iValue) {
+                bool isOutside = false;
+                hsize_t indexValue = iValue;
+                for (int iDim = ndims-1; iDim >= 0; --iDim) {
+                    isOutside = isOutside || offset[iDim] + indexValue % chunk[iDim] >= dims[iDim];
+                    indexValue /= chunk[iDim];
+                } // for
+                if (isOutside) {
+                    CHECK(std::vector<char>(typeSize, 0) ==
+                          std::vector<char>(&buffer[iValue*typeSize], &buffer[(iValue+1)*typeSize]));
+                    ++numOutside;
+                } // if
+            } // for
+        } // for
+
+        H5Sclose(spaceIn);
+        H5Tclose(datatype);
+        H5Pclose(dcpl);
+        H5Sclose(spaceOut);
+        H5Dclose(datasetOut);
+        H5Dclose(datasetIn);
+    } // for
+    CHECK(numOutside > 0);
+    H5Fclose(h5Out);
+    H5Fclose(h5In);
+} // testRunEdgeChunks
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with bounding box outside model.
+void
+geomodelgrids::apps::TestExtract::testRunOutside(void) {
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--model=../../data/three-blocks-topo.h5",
+        "--output=three-blocks-topo-extract.h5",
+        "--bbox=0.0,1.0e+3,0.0,1.0e+3",
+        "--bbox-crs=EPSG:3311",
+    };
+
+    Extract extract;
+    CHECK_THROWS_AS(extract.run(nargs, const_cast<char**>(args)), std::runtime_error);
+} // testRunOutside
+
+
+// End of file
@@ -19,6 +19,7 @@
 #include <sstream> // USES std::ostringstream
 #include <iomanip> // USES ios::setf(), ios::setprecision()
 #include <cmath> // USES fabs()
+#include <vector> // USES std::vector
 
 namespace geomodelgrids {
     namespace apps {
@@ -84,6 +85,9 @@ public:
     /// Test run() wth three-blocks-topo.
     void testRunThreeBlocksTopo(void);
 
+    /// Test run() with --seed-neighbors.
+    void testRunSeedNeighbors(void);
+
     /// Test run() wth bad output file.
     void testRunBadOutput(void);
 
@@ -141,6 +145,9 @@ TEST_CASE("TestIsosurface::testRunOneBlockFlat", "[TestIsosurface]") {
 TEST_CASE("TestIsosurface::testRunThreeBlocksTopo", "[TestIsosurface]") {
     geomodelgrids::apps::TestIsosurface().testRunThreeBlocksTopo();
 }
+TEST_CASE("TestIsosurface::testRunSeedNeighbors", "[TestIsosurface]") {
+    geomodelgrids::apps::TestIsosurface().testRunSeedNeighbors();
+}
 TEST_CASE("TestIsosurface::testRunBadOutput", "[TestIsosurface]") {
     geomodelgrids::apps::TestIsosurface().testRunBadOutput();
 }
@@ -160,6 +167,10 @@ public:
                          const double isoTwo,
                          const geomodelgrids::testdata::ModelPoints& points);
 
+    static
+    void checkSame(const char* filename,
+                   const char* filenameE);
+
 }; // _TestIsosurface
 
 // ------------------------------------------------------------------------------------------------
@@ -183,8 +194,13 @@ geomodelgrids::apps::TestIsosurface::testConstructor(void) {
     CHECK(10.0 == isosurface._vertRes);
     CHECK(0.0 == isosurface._maxDepth);
     CHECK(10 == isosurface._numSearchPoints);
+    CHECK(size_t(1) == isosurface._numThreads);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY == isosurface._depthSurface);
     CHECK(true == isosurface._preferShallow);
+    CHECK(true == isosurface._columnSearch);
+    CHECK(false == isosurface._seedNeighbors);
+    CHECK(std::string("DEFLATE") == isosurface._compression);
+    CHECK(size_t(0) == isosurface._numOverviews);
 
     CHECK(size_t(2) == isosurface._isosurfaces.size());
     CHECK(std::string("Vs") == isosurface._isosurfaces[0].first);
@@ -340,7 +356,7 @@ geomodelgrids::apps::TestIsosurface::testParseArgsNoOutput(void) {
 // Test _parseArgs() with bad values.
 void
 geomodelgrids::apps::TestIsosurface::testParseArgsBadValues(void) {
-    const int nargs = 9;
+    const int nargs = 11;
     const char* const args[nargs] = {
         "test",
         "--bbox=-1.0,0.0,1.0,-3.0",
@@ -351,6 +367,8 @@ geomodelgrids::apps::TestIsosurface::testParseArgsBadValues(void) {
         "--num-search-points=0",
         "--depth-reference=none",
         "--models=one.h5",
+        "--seed-neighbors",
+        "--compression=zip",
     };
 
     Isosurface isosurface;
@@ -406,6 +424,8 @@ geomodelgrids::apps::TestIsosurface::testParseArgsMinimal(void) {
     CHECK(10 == isosurface._numSearchPoints);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY == isosurface._depthSurface);
     CHECK(true == isosurface._preferShallow);
+    CHECK(true == isosurface._columnSearch);
+    CHECK(false == isosurface._seedNeighbors);
 
     CHECK(size_t(1) == isosurface._modelFilenames.size());
     CHECK(std::string("one.h5") == isosurface._modelFilenames[0]);
@@ -418,7 +438,7 @@ geomodelgrids::apps::TestIsosurface::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
-    const int nargs = 14;
+    const int nargs = 19;
     const char* const args[nargs] = {
         "test",
         "--log=my.log",
@@ -434,6 +454,11 @@ geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
         "--output=iso.tiff",
         "--prefer-deep",
         "--bbox-coordsys=EPSG:3311",
+        "--num-threads=8",
+        "--line-search",
+        "--seed-neighbors",
+        "--compression=LZW",
+        "--num-overviews=2",
     };
 
     Isosurface isosurface;
@@ -454,8 +479,13 @@ geomodelgrids::apps::TestIsosurface::testParseArgsAll(void) {
     CHECK(0.4 == isosurface._vertRes);
     CHECK(2.0 == isosurface._maxDepth);
     CHECK(5 == isosurface._numSearchPoints);
+    CHECK(size_t(8) == isosurface._numThreads);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == isosurface._depthSurface);
     CHECK(false == isosurface._preferShallow);
+    CHECK(false == isosurface._columnSearch);
+    CHECK(true == isosurface._seedNeighbors);
+    CHECK(std::string("LZW") == isosurface._compression);
+    CHECK(size_t(2) == isosurface._numOverviews);
 
     CHECK(size_t(2) == isosurface._modelFilenames.size());
     CHECK(std::string("one.h5") == isosurface._modelFilenames[0]);
@@ -476,7 +506,7 @@ geomodelgrids::apps::TestIsosurface::testPrintHelp(void) {
     Isosurface isosurface;
     isosurface._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1473) == coutHelp.str().length());
+    CHECK(size_t(2233) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -497,7 +527,7 @@ geomodelgrids::apps::TestIsosurface::testRunHelp(void) {
     isosurface.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1473) == coutHelp.str().length());
+    CHECK(size_t(2233) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -505,7 +535,7 @@ geomodelgrids::apps::TestIsosurface::testRunHelp(void) {
 // Test run() with one-block-flat.
 void
 geomodelgrids::apps::TestIsosurface::testRunOneBlockFlat(void) {
-    const int nargs = 11;
+    const int nargs = 12;
     const char* const args[nargs] = {
         "test",
         "--models=../../data/one-block-flat.h5",
@@ -518,6 +548,7 @@ geomodelgrids::apps::TestIsosurface::testRunOneBlockFlat(void) {
         "--output=one-block-flat-isosurface.tiff",
         "--bbox-coordsys=EPSG:4326",
         "--log=error.log",
+        "--line-search",
     };
     geomodelgrids::testdata::OneBlockFlatIsosurface isosurfaceOne;
 
@@ -533,7 +564,7 @@ geomodelgrids::apps::TestIsosurface::testRunOneBlockFlat(void) {
 // Test run() with three-blocks-topo.
 void
 geomodelgrids::apps::TestIsosurface::testRunThreeBlocksTopo(void) {
-    const int nargs = 13;
+    const int nargs = 16;
     const char* const args[nargs] = {
         "test",
         "--models=../../data/three-blocks-topo.h5",
@@ -548,6 +579,9 @@ geomodelgrids::apps::TestIsosurface::testRunThreeBlocksTopo(void) {
         "--output=three-blocks-topo-isosurface.tiff",
         "--bbox-coordsys=EPSG:4326",
         "--log=error.log",
+        "--num-threads=3",
+        "--compression=LZW",
+        "--num-overviews=1",
     };
     geomodelgrids::testdata::ThreeBlocksTopoIsosurface isosurfaceThree;
 
@@ -559,6 +593,75 @@ geomodelgrids::apps::TestIsosurface::testRunThreeBlocksTopo(void) {
 } // testRunThreeBlocksTopo
 
 
+// ------------------------------------------------------------------------------------------------
+// Test run() with --seed-neighbors.
+void
+geomodelgrids::apps::TestIsosurface::testRunSeedNeighbors(void) {
+    { // one-block-flat
+        const int nargs = 13;
+        const char* const args[nargs] = {
+            "test",
+            "--models=../../data/one-block-flat.h5",
+            "--bbox=37.30,37.40,-121.80,-121.65",
+            "--hresolution=0.05",
+            "--vresolution=500.0",
+            "--isosurface=one,25.0e+3",
+            "--isosurface=two,10.0e+3",
+            "--max-depth=5.0e+3",
+            "--output=one-block-flat-isosurface-seeded.tiff",
+            "--bbox-coordsys=EPSG:4326",
+            "--log=error.log",
+            "--line-search",
+            "--seed-neighbors",
+        };
+        geomodelgrids::testdata::OneBlockFlatIsosurface isosurfaceOne;
+
+        Isosurface isosurface;
+        isosurface.run(nargs, const_cast<char**>(args));
+
+        _TestIsosurface::checkIsosurface("one-block-flat-isosurface-seeded.tiff", 25.0e+3, 10.0e+3, isosurfaceOne);
+    } // one-block-flat
+
+    // Values in alternate columns of the model cross the isosurface values in a shallow layer, so
+    // the seeded search must not follow the deeper crossing found in a neighboring cell. Cells are
+    // centered on the model grid in the y direction, so each cell either has the layer or not.
+    for (int preferDeep = 0; preferDeep < 2; ++preferDeep) {
+        for (int seedNeighbors = 0; seedNeighbors < 2; ++seedNeighbors) {
+            std::vector<const char*> args = {
+                "test",
+                "--models=../../data/one-block-flat-nonmonotonic.h5",
+                "--bbox=595000.0,625000.0,4120000.0,4150000.0",
+                "--hresolution=10.0e+3",
+                "--vresolution=20.0",
+                "--isosurface=one,20.0e+3",
+                "--isosurface=two,10.0e+3",
+                "--max-depth=5.0e+3",
+                "--bbox-coordsys=EPSG:26910",
+                "--log=error.log",
+                "--line-search",
+            };
+            args.push_back((seedNeighbors) ?
+                           "--output=one-block-flat-nonmonotonic-isosurface-seeded.tiff" :
+                           "--output=one-block-flat-nonmonotonic-isosurface.tiff");
+            if (seedNeighbors) {
+                args.push_back("--seed-neighbors");
+            } // if
+            if (preferDeep) {
+                args.push_back("--prefer-deep");
+            } // if
+
+            optind = 1;
+            Isosurface isosurface;
+            isosurface.run(int(args.size()), const_cast<char**>(&args[0]));
+        } // for
+
+        INFO("Prefer deep: " << preferDeep);
+        _TestIsosurface::checkSame("one-block-flat-nonmonotonic-isosurface-seeded.tiff",
+                                   "one-block-flat-nonmonotonic-isosurface.tiff");
+    } // for
+} // testRunSeedNeighbors
+
+
 // ------------------------------------------------------------------------------------------------
 // Test run() with bad output specification.
 void
@@ -657,4 +760,33 @@ geomodelgrids::apps::_TestIsosurface::checkIsosurface(const char* filename,
 } // checkIsosurface
 
 
+// ------------------------------------------------------------------------------------------------
+void
+geomodelgrids::apps::_TestIsosurface::checkSame(const char* filename,
+                                                const char* filenameE) {
+    geomodelgrids::utils::GeoTiff readerE;
+    readerE.read(filenameE);
+    geomodelgrids::utils::GeoTiff reader;
+    reader.read(filename);
+
+    const size_t numX = readerE.getNumCols();
+    const size_t numY = readerE.getNumRows();
+    const size_t numBands = readerE.getNumBands();
+    REQUIRE(numX == reader.getNumCols());
+    REQUIRE(numY == reader.getNumRows());
+    REQUIRE(numBands == reader.getNumBands());
+
+    const float* dataE = readerE.getBands();
+    const float* data = reader.getBands();
+    const double tolerance = 1.0e-4;
+    for (size_t i = 0; i < numBands*numY*numX; ++i) {
+        INFO("Mismatch for band " << i / (numY*numX) << ", cell " << i % (numY*numX) << ".");
+        CHECK_THAT(data[i], Catch::Matchers::WithinAbs(dataE[i], tolerance));
+    } // for
+    reader.close();
+    readerE.close();
+
+} // checkSame
+
+
 // End of file
@@ -6,6 +6,8 @@
 
 #include "geomodelgrids/apps/Query.hh" // USES Query
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+#include "geomodelgrids/utils/PointsReader.hh" // USES PointsReader
+#include "geomodelgrids/utils/PointsWriter.hh" // USES PointsWriter
 
 #include "tests/data/ModelPoints.hh"
 
@@ -62,6 +64,9 @@ public:
     /// Test _parseArgs() with all arguments.
     void testParseArgsAll(void);
 
+    /// Test _parseArgs() with input and output formats.
+    void testParseArgsFormats(void);
+
     /// Test _printHelp().
     void testPrintHelp(void);
 
@@ -83,6 +88,9 @@ public:
     /// Test run() wth one-block-flat and three-blocks-topo.
     void testRunTwoModels(void);
 
+    /// Test run() wth three-blocks-topo using .npy input, HDF5 output, and multiple threads.
+    void testRunBinary(void);
+
     /// Test run() wth bad input.
     void testRunBadInput(void);
 
@@ -125,6 +133,9 @@ TEST_CASE("TestQuery::testParseArgsMinimal", "[TestQuery]") {
 TEST_CASE("TestQuery::testParseArgsAll", "[TestQuery]") {
     geomodelgrids::apps::TestQuery().testParseArgsAll();
 }
+TEST_CASE("TestQuery::testParseArgsFormats", "[TestQuery]") {
+    geomodelgrids::apps::TestQuery().testParseArgsFormats();
+}
 TEST_CASE("TestQuery::testPrintHelp", "[TestQuery]") {
     geomodelgrids::apps::TestQuery().testPrintHelp();
 }
@@ -146,6 +157,9 @@ TEST_CASE("TestQuery::testRunThreeBlocksSquashTopoBathy", "[TestQuery]") {
 TEST_CASE("TestQuery::testRunTwoModels", "[TestQuery]") {
     geomodelgrids::apps::TestQuery().testRunTwoModels();
 }
+TEST_CASE("TestQuery::testRunBinary", "[TestQuery]") {
+    geomodelgrids::apps::TestQuery().testRunBinary();
+}
 TEST_CASE("TestQuery::testRunBadInput", "[TestQuery]") {
     geomodelgrids::apps::TestQuery().testRunBadInput();
 }
@@ -314,7 +328,7 @@ geomodelgrids::apps::TestQuery::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
-    const int nargs = 9;
+    const int nargs = 11;
     const char* const args[nargs] = {
         "test",
         "--values=one,two,three",
@@ -325,6 +339,8 @@ geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
         "--squash-min-elev=-2.0e+3",
         "--squash-surface=top_surface",
         "--log=error.log",
+        "--num-threads=4",
+        "--target-resolution=20.0e+3",
     };
     const size_t numValues = 3;
     const char* const valueNamesE[numValues] = { "one", "two", "three" };
@@ -343,10 +359,50 @@ geomodelgrids::apps::TestQuery::testParseArgsAll(void) {
     CHECK(-2.0e+3 == query._squashMinElev);
     CHECK(geomodelgrids::serial::Query::SQUASH_TOP_SURFACE == query._squash);
     CHECK(std::string("error.log") == query._logFilename);
+    CHECK(size_t(4) == query._numThreads);
+    CHECK(20.0e+3 == query._targetResolution);
     CHECK(!query._showHelp);
 } // testParseArgsAll
 
 
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with input and output formats.
+void
+geomodelgrids::apps::TestQuery::testParseArgsFormats(void) {
+    const int nargs = 11;
+    const char* const args[nargs] = {
+        "test",
+        "--values=one",
+        "--models=A",
+        "--points=points.raw",
+        "--output=points.h5",
+        "--input-format=raw32",
+        "--input-columns=2,0,1",
+        "--input-num-columns=4",
+        "--input-dataset=/xyz",
+        "--output-format=hdf5",
+        "--output-dataset=/results",
+    };
+
+    Query query;
+    query._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(geomodelgrids::utils::PointsReader::RAW_FLOAT32 == query._inputFormat);
+    REQUIRE(size_t(3) == query._inputColumns.size());
+    CHECK(size_t(2) == query._inputColumns[0]);
+    CHECK(size_t(0) == query._inputColumns[1]);
+    CHECK(size_t(1) == query._inputColumns[2]);
+    CHECK(size_t(4) == query._inputNumColumns);
+    CHECK(std::string("/xyz") == query._inputDataset);
+    CHECK(geomodelgrids::utils::PointsReader::HDF5 == query._outputFormat);
+    CHECK(std::string("/results") == query._outputDataset);
+
+    optind = 1;
+    const char* const argsBad[3] = { "test", "--input-format=csv", "--output-format=text" };
+    Query queryBad;
+    CHECK_THROWS_AS(queryBad._parseArgs(3, const_cast<char**>(argsBad)), std::invalid_argument);
+} // testParseArgsFormats
+
+
 // ------------------------------------------------------------------------------------------------
 // Test _printHelp().
 void
@@ -358,7 +414,7 @@ geomodelgrids::apps::TestQuery::testPrintHelp(void) {
     Query query;
     query._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1062) == coutHelp.str().length());
+    CHECK(size_t(2187) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -379,7 +435,7 @@ geomodelgrids::apps::TestQuery::testRunHelp(void) {
     query.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(1062) == coutHelp.str().length());
+    CHECK(size_t(2187) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -533,6 +589,64 @@ geomodelgrids::apps::TestQuery::testRunTwoModels(void) {
 } // testRunTwoModels
 
 
+// ------------------------------------------------------------------------------------------------
+// Test run() with three-blocks-topo using .npy input, HDF5 output, and multiple threads.
+void
+geomodelgrids::apps::TestQuery::testRunBinary(void) {
+    const int nargs = 10;
+    const char* const args[nargs] = {
+        "test",
+        "--values=two,one",
+        "--models=../../data/three-blocks-topo.h5",
+        "--points=three-blocks-topo.npy",
+        "--output=three-blocks-topo-values.h5",
+        "--points-coordsys=EPSG:4326",
+        "--input-format=npy",
+        "--output-format=hdf5",
+        "--output-dataset=/values",
+        "--num-threads=3",
+    };
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const size_t numPoints = pointsThree.getNumPoints();
+    const size_t spaceDim = 3;
+
+    geomodelgrids::utils::PointsWriter writer;
+    writer.open("three-blocks-topo.npy", geomodelgrids::utils::PointsReader::NPY, spaceDim);
+    writer.write(pointsThree.getLatLonElev(), numPoints);
+    writer.close();
+
+    Query query;
+    query.run(nargs, const_cast<char**>(args));
+
+    const size_t numColumns = spaceDim + 2;
+    std::vector<double> rows(numPoints*numColumns);
+    geomodelgrids::utils::PointsReader reader;
+    reader.setDataset("/values");
+    reader.open("three-blocks-topo-values.h5", geomodelgrids::utils::PointsReader::HDF5, numColumns);
+    REQUIRE(numPoints == reader.getNumPoints());
+    REQUIRE(numPoints == reader.read(rows.data(), numPoints));
+    reader.close();
+
+    const double* const pointsXYZ = pointsThree.getXYZ();
+    const double* const pointsLLE = pointsThree.getLatLonElev();
+    const double tolerance = 1.0e-5;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double x = pointsXYZ[iPt*spaceDim+0];
+        const double y = pointsXYZ[iPt*spaceDim+1];
+        const double z = pointsXYZ[iPt*spaceDim+2];
+        const double* row = &rows[iPt*numColumns];
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            CHECK(pointsLLE[iPt*spaceDim+iDim] == row[iDim]);
+        } // for
+
+        const double valueTwoE = pointsThree.computeValueTwo(x, y, z);
+        CHECK_THAT(row[3], Catch::Matchers::WithinAbs(valueTwoE, std::max(tolerance, tolerance*fabs(valueTwoE))));
+        const double valueOneE = pointsThree.computeValueOne(x, y, z);
+        CHECK_THAT(row[4], Catch::Matchers::WithinAbs(valueOneE, std::max(tolerance, tolerance*fabs(valueOneE))));
+    } // for
+} // testRunBinary
+
+
 // ------------------------------------------------------------------------------------------------
 // Test run() with bad input.
 void
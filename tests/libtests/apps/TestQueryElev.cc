@@ -273,7 +273,7 @@ geomodelgrids::apps::TestQueryElev::testParseArgsMinimal(void) {
 // Test _parseArgs() with all arguments.
 void
 geomodelgrids::apps::TestQueryElev::testParseArgsAll(void) {
-    const int nargs = 7;
+    const int nargs = 8;
     const char* const args[nargs] = {
         "test",
         "--models=A",
@@ -282,6 +282,7 @@ geomodelgrids::apps::TestQueryElev::testParseArgsAll(void) {
         "--points-coordsys=EPSG:26910",
         "--surface=topography_bathymetry",
         "--log=error.log",
+        "--num-threads=2",
     };
 
     QueryElev query;
@@ -293,6 +294,7 @@ geomodelgrids::apps::TestQueryElev::testParseArgsAll(void) {
     CHECK(std::string("EPSG:26910") == query._pointsCRS);
     CHECK(true == query._useTopoBathy);
     CHECK(std::string("error.log") == query._logFilename);
+    CHECK(size_t(2) == query._numThreads);
     CHECK(!query._showHelp);
 } // testParseArgsAll
 
@@ -308,7 +310,7 @@ geomodelgrids::apps::TestQueryElev::testPrintHelp(void) {
     QueryElev query;
     query._printHelp();
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(758) == coutHelp.str().length());
+    CHECK(size_t(874) == coutHelp.str().length());
 } // testPrintHelp
 
 
@@ -329,7 +331,7 @@ geomodelgrids::apps::TestQueryElev::testRunHelp(void) {
     query.run(nargs, const_cast<char**>(args));
 
     std::cout.rdbuf(coutOrig);
-    CHECK(size_t(758) == coutHelp.str().length());
+    CHECK(size_t(874) == coutHelp.str().length());
 } // testRunHelp
 
 
@@ -0,0 +1,580 @@
+/**
+ * C++ unit testing of geomodelgrids::apps::QueryServer and geomodelgrids::serial::QueryClient.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/apps/QueryServer.hh" // USES QueryServer
+#include "geomodelgrids/serial/QueryClient.hh" // USES QueryClient
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+#include "tests/data/ModelPoints.hh"
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+extern "C" {
+#include "geomodelgrids/serial/queryprotocol.h" // USES GeomodelgridsQuerydRequest, GeomodelgridsQuerydResponse
+}
+
+#include <sys/wait.h> // USES waitpid()
+#include <sys/socket.h> // USES socket(), connect()
+#include <sys/un.h> // USES sockaddr_un
+#include <sys/stat.h> // USES stat()
+#include <fstream> // USES std::ofstream
+#include <unistd.h> // USES fork(), usleep(), _exit()
+#include <iostream> // USES std::cout
+#include <sstream> // USES std::ostringstream
+#include <getopt.h> // USES optind
+#include <cmath> // USES fabs()
+#include <cstring> // USES memset(), strncpy()
+
+namespace geomodelgrids {
+    namespace apps {
+        class TestQueryServer;
+    } // apps
+} // geomodelgrids
+
+class geomodelgrids::apps::TestQueryServer {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    TestQueryServer(void);
+
+    /// Test constructor.
+    void testConstructor(void);
+
+    /// Test _parseArgs() with no args.
+    void testParseNoArgs(void);
+
+    /// Test _parseArgs() with --help.
+    void testParseArgsHelp(void);
+
+    /// Test _parseArgs() missing --socket.
+    void testParseArgsNoSocket(void);
+
+    /// Test _parseArgs() with wrong arguments.
+    void testParseArgsWrong(void);
+
+    /// Test _parseArgs() with all arguments.
+    void testParseArgsAll(void);
+
+    /// Test _printHelp().
+    void testPrintHelp(void);
+
+    /// Test run() with three-blocks-topo and queries from QueryClient.
+    void testRunThreeBlocksTopo(void);
+
+    /// Test run() with malformed requests.
+    void testRunBadRequests(void);
+
+    /// Test run() with idle and partial clients connected while another client queries.
+    void testRunConcurrentClients(void);
+
+    /// Test _openSocket() with existing files.
+    void testOpenSocket(void);
+
+    /// Test QueryClient without server.
+    void testClientNotConnected(void);
+
+}; // class TestQueryServer
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestQueryServer::testConstructor", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testConstructor();
+}
+TEST_CASE("TestQueryServer::testParseNoArgs", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testParseNoArgs();
+}
+TEST_CASE("TestQueryServer::testParseArgsHelp", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testParseArgsHelp();
+}
+TEST_CASE("TestQueryServer::testParseArgsNoSocket", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testParseArgsNoSocket();
+}
+TEST_CASE("TestQueryServer::testParseArgsWrong", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testParseArgsWrong();
+}
+TEST_CASE("TestQueryServer::testParseArgsAll", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testParseArgsAll();
+}
+TEST_CASE("TestQueryServer::testPrintHelp", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testPrintHelp();
+}
+TEST_CASE("TestQueryServer::testRunThreeBlocksTopo", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testRunThreeBlocksTopo();
+}
+TEST_CASE("TestQueryServer::testRunBadRequests", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testRunBadRequests();
+}
+TEST_CASE("TestQueryServer::testRunConcurrentClients", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testRunConcurrentClients();
+}
+TEST_CASE("TestQueryServer::testOpenSocket", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testOpenSocket();
+}
+TEST_CASE("TestQueryServer::testClientNotConnected", "[TestQueryServer]") {
+    geomodelgrids::apps::TestQueryServer().testClientNotConnected();
+}
+
+// ------------------------------------------------------------------------------------------------
+geomodelgrids::apps::TestQueryServer::TestQueryServer(void) {
+    optind = 1; // reset parsing of argc and argv
+} // setUp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::apps::TestQueryServer::testConstructor(void) {
+    QueryServer server;
+
+    CHECK(std::string("EPSG:4326") == server._pointsCRS);
+    CHECK(-10.0e+3 == server._squashMinElev);
+    CHECK(geomodelgrids::serial::Query::SQUASH_NONE == server._squash);
+    CHECK(-1 == server._socket);
+    CHECK(false == server._showHelp);
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with no args.
+void
+geomodelgrids::apps::TestQueryServer::testParseNoArgs(void) {
+    const int nargs = 1;
+    const char* const args[nargs] = { "test", };
+
+    QueryServer server;
+    server._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(server._showHelp);
+} // testParseNoArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with --help.
+void
+geomodelgrids::apps::TestQueryServer::testParseArgsHelp(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--help" };
+
+    QueryServer server;
+    server._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(server._showHelp);
+} // testParseArgsHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() without --socket.
+void
+geomodelgrids::apps::TestQueryServer::testParseArgsNoSocket(void) {
+    const int nargs = 3;
+    const char* const args[nargs] = { "test", "--values=A", "--models=B", };
+
+    QueryServer server;
+    CHECK_THROWS_AS(server._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+} // testParseArgsNoSocket
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with wrong arguments.
+void
+geomodelgrids::apps::TestQueryServer::testParseArgsWrong(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--blah" };
+
+    QueryServer server;
+    CHECK_THROWS_AS(server._parseArgs(nargs, const_cast<char**>(args)), std::logic_error);
+} // testParseArgsWrong
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with all arguments.
+void
+geomodelgrids::apps::TestQueryServer::testParseArgsAll(void) {
+    const int nargs = 8;
+    const char* const args[nargs] = {
+        "test",
+        "--socket=queryd.sock",
+        "--values=one,two",
+        "--models=A,B",
+        "--points-coordsys=EPSG:26910",
+        "--squash-min-elev=-2.0e+3",
+        "--squash-surface=topography_bathymetry",
+        "--log=error.log",
+    };
+
+    QueryServer server;
+    server._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(std::string("queryd.sock") == server._socketPath);
+    REQUIRE(size_t(2) == server._valueNames.size());
+    CHECK(std::string("one") == server._valueNames[0]);
+    CHECK(std::string("two") == server._valueNames[1]);
+    REQUIRE(size_t(2) == server._modelFilenames.size());
+    CHECK(std::string("A") == server._modelFilenames[0]);
+    CHECK(std::string("B") == server._modelFilenames[1]);
+    CHECK(std::string("EPSG:26910") == server._pointsCRS);
+    CHECK(-2.0e+3 == server._squashMinElev);
+    CHECK(geomodelgrids::serial::Query::SQUASH_TOPOGRAPHY_BATHYMETRY == server._squash);
+    CHECK(std::string("error.log") == server._logFilename);
+    CHECK(!server._showHelp);
+} // testParseArgsAll
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _printHelp().
+void
+geomodelgrids::apps::TestQueryServer::testPrintHelp(void) {
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutHelp;
+    std::cout.rdbuf(coutHelp.rdbuf() );
+
+    QueryServer server;
+    server._printHelp();
+    std::cout.rdbuf(coutOrig);
+    CHECK(size_t(994) == coutHelp.str().length());
+} // testPrintHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with three-blocks-topo and queries from QueryClient.
+void
+geomodelgrids::apps::TestQueryServer::testRunThreeBlocksTopo(void) {
+    const char* const socketPath = "three-blocks-topo.sock";
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--socket=three-blocks-topo.sock",
+        "--values=two,one",
+        "--models=../../data/three-blocks-topo.h5",
+        "--points-coordsys=EPSG:4326",
+    };
+    unlink(socketPath);
+
+    const pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (0 == pid) {
+        int err = 0;
+        try {
+            QueryServer server;
+            err = server.run(nargs, const_cast<char**>(args));
+        } catch (...) {
+            err = 1;
+        } // try/catch
+        _exit(err);
+    } // if
+
+    geomodelgrids::serial::QueryClient client;
+    bool connected = false;
+    for (int iTry = 0; iTry < 200 && !connected; ++iTry) {
+        try {
+            client.connect(socketPath);
+            connected = true;
+        } catch (const std::runtime_error&) {
+            usleep(50000);
+        } // try/catch
+    } // for
+    REQUIRE(connected);
+
+    const std::vector<std::string>& valueNames = client.getValueNames();
+    REQUIRE(size_t(2) == valueNames.size());
+    CHECK(std::string("two") == valueNames[0]);
+    CHECK(std::string("one") == valueNames[1]);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t spaceDim = 3;
+    const size_t numValues = 2;
+    const size_t numPoints = points.getNumPoints();
+    const double* const pointsXYZ = points.getXYZ();
+    const double* const pointsLLE = points.getLatLonElev();
+    const double tolerance = 1.0e-5;
+
+    { // query
+        std::vector<double> values(numPoints*numValues);
+        std::vector<int> errors(numPoints);
+        client.query(values.data(), errors.data(), pointsLLE, numPoints);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double x = pointsXYZ[iPt*spaceDim+0];
+            const double y = pointsXYZ[iPt*spaceDim+1];
+            const double z = pointsXYZ[iPt*spaceDim+2];
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1] << ", " << pointsLLE[iPt*spaceDim+2] << ").");
+            CHECK(0 == errors[iPt]);
+
+            const double valueTwoE = points.computeValueTwo(x, y, z);
+            CHECK_THAT(values[iPt*numValues+0], Catch::Matchers::WithinAbs(valueTwoE, std::max(tolerance, tolerance*fabs(valueTwoE))));
+            const double valueOneE = points.computeValueOne(x, y, z);
+            CHECK_THAT(values[iPt*numValues+1], Catch::Matchers::WithinAbs(valueOneE, std::max(tolerance, tolerance*fabs(valueOneE))));
+        } // for
+    } // query
+
+    std::vector<double> locations(numPoints*2);
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        locations[iPt*2+0] = pointsLLE[iPt*spaceDim+0];
+        locations[iPt*2+1] = pointsLLE[iPt*spaceDim+1];
+    } // for
+
+    std::vector<double> elevations(numPoints);
+    { // queryTopElevation
+        client.queryTopElevation(elevations.data(), locations.data(), numPoints);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double elevationE = points.computeTopElevation(pointsXYZ[iPt*spaceDim+0], pointsXYZ[iPt*spaceDim+1]);
+            CHECK_THAT(elevations[iPt], Catch::Matchers::WithinAbs(elevationE, tolerance*fabs(elevationE)));
+        } // for
+    } // queryTopElevation
+
+    { // queryProfile
+        const double dz = 100.0;
+        const double maxDepth = 500.0;
+        const size_t numDepths = geomodelgrids::serial::QueryClient::getNumProfileDepths(dz, maxDepth);
+        REQUIRE(size_t(6) == numDepths);
+        const size_t sampleSize = 2 + numValues;
+        std::vector<double> samples(numPoints*numDepths*sampleSize);
+        std::vector<int> errors(numPoints*numDepths);
+        client.queryProfile(samples.data(), errors.data(), locations.data(), numPoints, dz, maxDepth);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const double x = pointsXYZ[iPt*spaceDim+0];
+            const double y = pointsXYZ[iPt*spaceDim+1];
+            for (size_t iDepth = 0; iDepth < numDepths; ++iDepth) {
+                const double* sample = &samples[(iPt*numDepths+iDepth)*sampleSize];
+                const double elevation = sample[0];
+                CHECK_THAT(sample[1], Catch::Matchers::WithinAbs(dz*iDepth, tolerance));
+                CHECK_THAT(elevation + sample[1], Catch::Matchers::WithinAbs(elevations[iPt], 1.0e-3));
+                CHECK(0 == errors[iPt*numDepths+iDepth]);
+
+                const double valueTwoE = points.computeValueTwo(x, y, elevation);
+                CHECK_THAT(sample[2], Catch::Matchers::WithinAbs(valueTwoE, std::max(tolerance, tolerance*fabs(valueTwoE))));
+            } // for
+        } // for
+
+        CHECK_THROWS_AS(client.queryProfile(samples.data(), errors.data(), locations.data(), numPoints, 0.0, maxDepth), std::runtime_error);
+    } // queryProfile
+
+    client.shutdown();
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status));
+    CHECK(0 == WEXITSTATUS(status));
+    CHECK(access(socketPath, F_OK) != 0);
+} // testRunThreeBlocksTopo
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with malformed requests.
+void
+geomodelgrids::apps::TestQueryServer::testRunBadRequests(void) {
+    const char* const socketPath = "three-blocks-topo-bad.sock";
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--socket=three-blocks-topo-bad.sock",
+        "--values=two,one",
+        "--models=../../data/three-blocks-topo.h5",
+        "--points-coordsys=EPSG:4326",
+    };
+    unlink(socketPath);
+
+    const pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (0 == pid) {
+        int err = 0;
+        try {
+            QueryServer server;
+            err = server.run(nargs, const_cast<char**>(args));
+        } catch (...) {
+            err = 1;
+        } // try/catch
+        _exit(err);
+    } // if
+
+    geomodelgrids::serial::QueryClient client;
+    bool connected = false;
+    for (int iTry = 0; iTry < 200 && !connected; ++iTry) {
+        try {
+            client.connect(socketPath);
+            connected = true;
+        } catch (const std::runtime_error&) {
+            usleep(50000);
+        } // try/catch
+    } // for
+    REQUIRE(connected);
+
+    { // Profile with number of depths that does not fit in size_t.
+        const double location[2] = { 37.5, -121.5 };
+        double sample = 0.0;
+        int error = 0;
+        CHECK_THROWS_AS(client.queryProfile(&sample, &error, location, 1, 1.0e-300, 1.0e+3), std::runtime_error);
+        CHECK_THROWS_AS(client.queryProfile(&sample, &error, location, 1, NAN, 1.0e+3), std::runtime_error);
+        CHECK_NOTHROW(client.queryTopElevation(&sample, location, 1)); // Connection remains open.
+    } // Profile
+
+    { // INFO request with points.
+        client.close();
+
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        strncpy(address.sun_path, socketPath, sizeof(address.sun_path)-1);
+        const int connection = socket(AF_UNIX, SOCK_STREAM, 0);
+        REQUIRE(connection >= 0);
+        REQUIRE(0 == ::connect(connection, (struct sockaddr*) &address, sizeof(address)));
+
+        GeomodelgridsQuerydRequest request;
+        memset(&request, 0, sizeof(request));
+        request.magic = GEOMODELGRIDS_QUERYD_MAGIC;
+        request.type = GEOMODELGRIDS_QUERYD_INFO;
+        request.numPoints = 1;
+        const double point[3] = { 37.5, -121.5, 0.0 };
+        REQUIRE(0 == geomodelgrids_queryd_send(connection, &request, sizeof(request)));
+        REQUIRE(0 == geomodelgrids_queryd_send(connection, point, sizeof(point)));
+
+        GeomodelgridsQuerydResponse response;
+        REQUIRE(0 == geomodelgrids_queryd_recv(connection, &response, sizeof(response)));
+        CHECK(GEOMODELGRIDS_QUERYD_ERROR == response.status);
+        std::vector<char> payload(response.payloadSize);
+        REQUIRE(0 == geomodelgrids_queryd_recv(connection, payload.data(), payload.size()));
+        char byte = 0;
+        CHECK(0 != geomodelgrids_queryd_recv(connection, &byte, 1)); // Server closed connection.
+        ::close(connection);
+    } // INFO
+
+    client.connect(socketPath);
+    client.shutdown();
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status));
+    CHECK(0 == WEXITSTATUS(status));
+    CHECK(access(socketPath, F_OK) != 0);
+} // testRunBadRequests
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with idle and partial clients connected while another client queries.
+void
+geomodelgrids::apps::TestQueryServer::testRunConcurrentClients(void) {
+    const char* const socketPath = "three-blocks-topo-concurrent.sock";
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--socket=three-blocks-topo-concurrent.sock",
+        "--values=two,one",
+        "--models=../../data/three-blocks-topo.h5",
+        "--points-coordsys=EPSG:4326",
+    };
+    unlink(socketPath);
+
+    const pid_t pid = fork();
+    REQUIRE(pid >= 0);
+    if (0 == pid) {
+        int err = 0;
+        try {
+            QueryServer server;
+            err = server.run(nargs, const_cast<char**>(args));
+        } catch (...) {
+            err = 1;
+        } // try/catch
+        _exit(err);
+    } // if
+
+    geomodelgrids::serial::QueryClient clientIdle;
+    bool connected = false;
+    for (int iTry = 0; iTry < 200 && !connected; ++iTry) {
+        try {
+            clientIdle.connect(socketPath);
+            connected = true;
+        } catch (const std::runtime_error&) {
+            usleep(50000);
+        } // try/catch
+    } // for
+    REQUIRE(connected);
+
+    // Only the user running the server may connect.
+    struct stat socketStat;
+    REQUIRE(0 == stat(socketPath, &socketStat));
+    CHECK(0 == (socketStat.st_mode & (S_IRWXG | S_IRWXO)));
+
+    // Client that sends only part of a request header.
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, socketPath, sizeof(address.sun_path)-1);
+    const int connectionPartial = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(connectionPartial >= 0);
+    REQUIRE(0 == ::connect(connectionPartial, (struct sockaddr*) &address, sizeof(address)));
+    GeomodelgridsQuerydRequest request;
+    memset(&request, 0, sizeof(request));
+    request.magic = GEOMODELGRIDS_QUERYD_MAGIC;
+    REQUIRE(0 == geomodelgrids_queryd_send(connectionPartial, &request, sizeof(request)/2));
+
+    // Other clients are answered while the idle and partial clients remain connected.
+    geomodelgrids::serial::QueryClient client;
+    client.connect(socketPath);
+    REQUIRE(size_t(2) == client.getValueNames().size());
+    const double location[2] = { 37.5, -121.5 };
+    double elevation = 0.0;
+    CHECK_NOTHROW(client.queryTopElevation(&elevation, location, 1));
+    CHECK_NOTHROW(clientIdle.queryTopElevation(&elevation, location, 1));
+
+    client.shutdown();
+    ::close(connectionPartial);
+
+    int status = 0;
+    REQUIRE(waitpid(pid, &status, 0) == pid);
+    CHECK(WIFEXITED(status));
+    CHECK(0 == WEXITSTATUS(status));
+    CHECK(access(socketPath, F_OK) != 0);
+} // testRunConcurrentClients
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _openSocket() with existing files.
+void
+geomodelgrids::apps::TestQueryServer::testOpenSocket(void) {
+    const char* const filename = "not-a-socket.txt";
+    { // Create regular file.
+        std::ofstream fout(filename);
+        fout << "data";
+    } // Create regular file.
+
+    QueryServer server;
+    server._socketPath = filename;
+    CHECK_THROWS_AS(server._openSocket(), std::runtime_error);
+    CHECK(0 == access(filename, F_OK)); // Regular file is not removed.
+    unlink(filename);
+
+    // Stale socket file is replaced.
+    server._socketPath = "stale.sock";
+    server._openSocket();
+    server._closeSocket();
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(fd >= 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    strncpy(address.sun_path, "stale.sock", sizeof(address.sun_path)-1);
+    REQUIRE(0 == bind(fd, (struct sockaddr*) &address, sizeof(address)));
+    ::close(fd);
+    CHECK(0 == access("stale.sock", F_OK));
+    CHECK_NOTHROW(server._openSocket());
+    server._closeSocket();
+    CHECK(access("stale.sock", F_OK) != 0);
+} // testOpenSocket
+
+
+// ------------------------------------------------------------------------------------------------
+// Test QueryClient without server.
+void
+geomodelgrids::apps::TestQueryServer::testClientNotConnected(void) {
+    geomodelgrids::serial::QueryClient client;
+    CHECK_THROWS_AS(client.connect("no-such-server.sock"), std::runtime_error);
+
+    double value = 0.0;
+    int error = 0;
+    const double xyz[3] = { 0.0, 0.0, 0.0 };
+    CHECK_THROWS_AS(client.query(&value, &error, xyz, 1), std::logic_error);
+    CHECK(size_t(0) == geomodelgrids::serial::QueryClient::getNumProfileDepths(0.0, 100.0));
+} // testClientNotConnected
+
+
+// End of file
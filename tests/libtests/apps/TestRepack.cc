@@ -0,0 +1,448 @@
+/**
+ * C++ unit testing of geomodelgrids::apps::Repack.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/apps/Repack.hh" // USES Repack
+#include "geomodelgrids/serial/Query.hh" // USES Query
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include "hdf5.h" // USES H5Fopen(), H5Dopen2()
+
+#include <iostream> // USES std::cout
+#include <sstream> // USES std::ostringstream
+#include <getopt.h> // USES optind
+#include <cmath> // USES M_PI, cos(), sin()
+
+namespace geomodelgrids {
+    namespace apps {
+        class TestRepack;
+    } // apps
+} // geomodelgrids
+
+class geomodelgrids::apps::TestRepack {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    TestRepack(void);
+
+    /// Test constructor.
+    void testConstructor(void);
+
+    /// Test _parseArgs() with no args.
+    void testParseNoArgs(void);
+
+    /// Test _parseArgs() with --help.
+    void testParseArgsHelp(void);
+
+    /// Test _parseArgs() with missing arguments.
+    void testParseArgsMissing(void);
+
+    /// Test _parseArgs() with wrong arguments.
+    void testParseArgsWrong(void);
+
+    /// Test _parseArgs() with bad values.
+    void testParseArgsBad(void);
+
+    /// Test _parseArgs() with all arguments.
+    void testParseArgsAll(void);
+
+    /// Test _printHelp().
+    void testPrintHelp(void);
+
+    /// Test run() with deflate filter.
+    void testRunDeflate(void);
+
+    /// Test run() with scale-offset filter.
+    void testRunScaleOffset(void);
+
+    /// Test run() with coarser levels of blocks.
+    void testRunLevels(void);
+
+    /** Run repack and compare queries of repacked model with original model.
+     *
+     * @param[in] args Command line arguments after the model and output arguments.
+     * @param[in] numArgs Number of arguments.
+     * @param[in] tolerance Absolute tolerance for values.
+     */
+    void _checkRun(const char* const args[],
+                   const int numArgs,
+                   const double tolerance);
+
+}; // class TestRepack
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestRepack::testConstructor", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testConstructor();
+}
+TEST_CASE("TestRepack::testParseNoArgs", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testParseNoArgs();
+}
+TEST_CASE("TestRepack::testParseArgsHelp", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testParseArgsHelp();
+}
+TEST_CASE("TestRepack::testParseArgsMissing", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testParseArgsMissing();
+}
+TEST_CASE("TestRepack::testParseArgsWrong", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testParseArgsWrong();
+}
+TEST_CASE("TestRepack::testParseArgsBad", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testParseArgsBad();
+}
+TEST_CASE("TestRepack::testParseArgsAll", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testParseArgsAll();
+}
+TEST_CASE("TestRepack::testPrintHelp", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testPrintHelp();
+}
+TEST_CASE("TestRepack::testRunDeflate", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testRunDeflate();
+}
+TEST_CASE("TestRepack::testRunScaleOffset", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testRunScaleOffset();
+}
+TEST_CASE("TestRepack::testRunLevels", "[TestRepack]") {
+    geomodelgrids::apps::TestRepack().testRunLevels();
+}
+
+// ------------------------------------------------------------------------------------------------
+geomodelgrids::apps::TestRepack::TestRepack(void) {
+    optind = 1; // reset parsing of argc and argv
+} // setUp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::apps::TestRepack::testConstructor(void) {
+    Repack repack;
+
+    CHECK(size_t(0) == repack._chunk[0]);
+    CHECK(size_t(0) == repack._chunk[1]);
+    CHECK(size_t(0) == repack._chunk[2]);
+    CHECK(Repack::FILTER_KEEP == repack._filter);
+    CHECK(Repack::TYPE_KEEP == repack._valueType);
+    CHECK(size_t(1000) == repack._benchmarkNumPoints);
+    CHECK(false == repack._showHelp);
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with no args.
+void
+geomodelgrids::apps::TestRepack::testParseNoArgs(void) {
+    const int nargs = 1;
+    const char* const args[nargs] = { "test" };
+
+    Repack repack;
+    repack._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(repack._showHelp);
+} // testParseNoArgs
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with --help.
+void
+geomodelgrids::apps::TestRepack::testParseArgsHelp(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--help" };
+
+    Repack repack;
+    repack._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(repack._showHelp);
+} // testParseArgsHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with missing arguments.
+void
+geomodelgrids::apps::TestRepack::testParseArgsMissing(void) {
+    { // --model
+        optind = 1;
+        const int nargs = 2;
+        const char* const args[nargs] = { "test", "--output=B" };
+
+        Repack repack;
+        CHECK_THROWS_AS(repack._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --model
+
+    { // --output
+        optind = 1;
+        const int nargs = 2;
+        const char* const args[nargs] = { "test", "--model=A" };
+
+        Repack repack;
+        CHECK_THROWS_AS(repack._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // --output
+} // testParseArgsMissing
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with wrong arguments.
+void
+geomodelgrids::apps::TestRepack::testParseArgsWrong(void) {
+    const int nargs = 2;
+    const char* const args[nargs] = { "test", "--blah" };
+
+    Repack repack;
+    CHECK_THROWS_AS(repack._parseArgs(nargs, const_cast<char**>(args)), std::logic_error);
+} // testParseArgsWrong
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with bad values.
+void
+geomodelgrids::apps::TestRepack::testParseArgsBad(void) {
+    const size_t numBad = 6;
+    const char* const bad[numBad] = {
+        "--chunk=8,8",
+        "--chunk=8,0,8",
+        "--filter=lzf",
+        "--filter=deflate:10",
+        "--filter=scaleoffset:-1",
+        "--type=int32",
+    };
+    for (size_t i = 0; i < numBad; ++i) {
+        optind = 1;
+        const int nargs = 4;
+        const char* const args[nargs] = { "test", "--model=A", "--output=B", bad[i] };
+
+        Repack repack;
+        INFO("Argument: " << bad[i]);
+        CHECK_THROWS_AS(repack._parseArgs(nargs, const_cast<char**>(args)), std::runtime_error);
+    } // for
+} // testParseArgsBad
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _parseArgs() with all arguments.
+void
+geomodelgrids::apps::TestRepack::testParseArgsAll(void) {
+    const int nargs = 7;
+    const char* const args[nargs] = {
+        "test",
+        "--model=A",
+        "--output=B",
+        "--chunk=16,32,8",
+        "--filter=deflate:4",
+        "--type=float64",
+        "--benchmark=20",
+    };
+
+    Repack repack;
+    repack._parseArgs(nargs, const_cast<char**>(args));
+    CHECK(std::string("A") == repack._modelFilename);
+    CHECK(std::string("B") == repack._outputFilename);
+    CHECK(size_t(16) == repack._chunk[0]);
+    CHECK(size_t(32) == repack._chunk[1]);
+    CHECK(size_t(8) == repack._chunk[2]);
+    CHECK(Repack::FILTER_DEFLATE == repack._filter);
+    CHECK(4 == repack._filterLevel);
+    CHECK(Repack::TYPE_FLOAT64 == repack._valueType);
+    CHECK(size_t(20) == repack._benchmarkNumPoints);
+    CHECK(!repack._showHelp);
+} // testParseArgsAll
+
+
+// ------------------------------------------------------------------------------------------------
+// Test _printHelp().
+void
+geomodelgrids::apps::TestRepack::testPrintHelp(void) {
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutHelp;
+    std::cout.rdbuf(coutHelp.rdbuf() );
+
+    Repack repack;
+    repack._printHelp();
+    std::cout.rdbuf(coutOrig);
+    CHECK(size_t(726) == coutHelp.str().length());
+} // testPrintHelp
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with deflate filter.
+void
+geomodelgrids::apps::TestRepack::testRunDeflate(void) {
+    const int nargs = 4;
+    const char* const args[nargs] = {
+        "--chunk=2,3,2",
+        "--filter=deflate:4",
+        "--type=float64",
+        "--benchmark=20",
+    };
+    _checkRun(args, nargs, 1.0e-6);
+
+    // Check storage of repacked block.
+    hid_t h5 = H5Fopen("three-blocks-topo-repack.h5", H5F_ACC_RDONLY, H5P_DEFAULT);REQUIRE(h5 >= 0);
+    hid_t dataset = H5Dopen2(h5, "blocks/top", H5P_DEFAULT);REQUIRE(dataset >= 0);
+    hid_t dcpl = H5Dget_create_plist(dataset);
+    hsize_t chunk[4];
+    REQUIRE(4 == H5Pget_chunk(dcpl, 4, chunk));
+    CHECK(hsize_t(2) == chunk[0]);
+    CHECK(hsize_t(3) == chunk[1]);
+    CHECK(hsize_t(2) == chunk[2]);
+    CHECK(hsize_t(2) == chunk[3]);
+    REQUIRE(2 == H5Pget_nfilters(dcpl));
+    CHECK(H5Z_FILTER_SHUFFLE == H5Pget_filter2(dcpl, 0, nullptr, nullptr, nullptr, 0, nullptr, nullptr));
+    CHECK(H5Z_FILTER_DEFLATE == H5Pget_filter2(dcpl, 1, nullptr, nullptr, nullptr, 0, nullptr, nullptr));
+    hid_t datatype = H5Dget_type(dataset);
+    CHECK(size_t(8) == H5Tget_size(datatype));
+    H5Tclose(datatype);
+    H5Pclose(dcpl);
+    H5Dclose(dataset);
+    H5Fclose(h5);
+} // testRunDeflate
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with scale-offset filter.
+void
+geomodelgrids::apps::TestRepack::testRunScaleOffset(void) {
+    const int nargs = 3;
+    const char* const args[nargs] = {
+        "--filter=scaleoffset:3",
+        "--type=float32",
+        "--benchmark=0",
+    };
+    _checkRun(args, nargs, 1.0e-3);
+} // testRunScaleOffset
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with coarser levels of blocks.
+void
+geomodelgrids::apps::TestRepack::testRunLevels(void) {
+    const int nargs = 5;
+    const char* const args[nargs] = {
+        "test",
+        "--model=../../data/three-blocks-topo-levels.h5",
+        "--output=three-blocks-topo-levels-repack.h5",
+        "--filter=deflate",
+        "--benchmark=0",
+    };
+
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutRun;
+    std::cout.rdbuf(coutRun.rdbuf() );
+    Repack repack;
+    const int err = repack.run(nargs, const_cast<char**>(args));
+    std::cout.rdbuf(coutOrig);
+    REQUIRE(0 == err);
+
+    // Levels are repacked along with the blocks.
+    hid_t h5 = H5Fopen("three-blocks-topo-levels-repack.h5", H5F_ACC_RDONLY, H5P_DEFAULT);REQUIRE(h5 >= 0);
+    const size_t numLevels = 5;
+    const char* levels[numLevels] = {
+        "levels/bottom/2",
+        "levels/bottom/4",
+        "levels/middle/2",
+        "levels/top/2",
+        "levels/top/4",
+    };
+    for (size_t i = 0; i < numLevels; ++i) {
+        INFO("Level '" << levels[i] << "'.");
+        hid_t dataset = H5Dopen2(h5, levels[i], H5P_DEFAULT);REQUIRE(dataset >= 0);
+        hid_t dcpl = H5Dget_create_plist(dataset);
+        CHECK(2 == H5Pget_nfilters(dcpl));
+        H5Pclose(dcpl);
+        H5Dclose(dataset);
+    } // for
+    H5Fclose(h5);
+
+    // Queries at a target resolution use the repacked levels.
+    std::vector<std::string> valueNames;
+    valueNames.push_back("one");
+    valueNames.push_back("two");
+    geomodelgrids::serial::Query queryIn;
+    queryIn.setTargetResolution(20.0e+3);
+    queryIn.initialize(std::vector<std::string>(1, "../../data/three-blocks-topo-levels.h5"), valueNames,
+                       "EPSG:3311");
+    geomodelgrids::serial::Query queryOut;
+    queryOut.setTargetResolution(20.0e+3);
+    queryOut.initialize(std::vector<std::string>(1, "three-blocks-topo-levels-repack.h5"), valueNames, "EPSG:3311");
+
+    const double x = 200000.0 + 31.0e+3*cos(330.0*M_PI/180.0) + 57.0e+3*sin(330.0*M_PI/180.0);
+    const double y = -400000.0 - 31.0e+3*sin(330.0*M_PI/180.0) + 57.0e+3*cos(330.0*M_PI/180.0);
+    double valuesIn[2];
+    double valuesOut[2];
+    CHECK(queryIn.query(valuesIn, x, y, -12.0e+3) == queryOut.query(valuesOut, x, y, -12.0e+3));
+    CHECK_THAT(valuesOut[0], Catch::Matchers::WithinAbs(valuesIn[0], 1.0e-6));
+    CHECK_THAT(valuesOut[1], Catch::Matchers::WithinAbs(valuesIn[1], 1.0e-6));
+    queryIn.finalize();
+    queryOut.finalize();
+} // testRunLevels
+
+
+// ------------------------------------------------------------------------------------------------
+// Run repack and compare queries of repacked model with original model.
+void
+geomodelgrids::apps::TestRepack::_checkRun(const char* const args[],
+                                           const int numArgs,
+                                           const double tolerance) {
+    const char* const filenameIn = "../../data/three-blocks-topo.h5";
+    const char* const filenameOut = "three-blocks-topo-repack.h5";
+
+    std::vector<const char*> argv;
+    argv.push_back("test");
+    argv.push_back("--model=../../data/three-blocks-topo.h5");
+    argv.push_back("--output=three-blocks-topo-repack.h5");
+    for (int i = 0; i < numArgs; ++i) {
+        argv.push_back(args[i]);
+    } // for
+
+    std::streambuf* coutOrig = std::cout.rdbuf();
+    std::ostringstream coutRun;
+    std::cout.rdbuf(coutRun.rdbuf() );
+    Repack repack;
+    const int err = repack.run(int(argv.size()), const_cast<char**>(argv.data()));
+    std::cout.rdbuf(coutOrig);
+    REQUIRE(0 == err);
+
+    std::vector<std::string> valueNames;
+    valueNames.push_back("one");
+    valueNames.push_back("two");
+    geomodelgrids::serial::Query queryIn;
+    queryIn.initialize(std::vector<std::string>(1, filenameIn), valueNames, "EPSG:3311");
+    geomodelgrids::serial::Query queryOut;
+    queryOut.initialize(std::vector<std::string>(1, filenameOut), valueNames, "EPSG:3311");
+
+    const double originX = 200000.0;
+    const double originY = -400000.0;
+    const double yazimuth = 330.0 * M_PI / 180.0;
+    const double cosAz = cos(yazimuth);
+    const double sinAz = sin(yazimuth);
+    const size_t numX = 3;
+    const size_t numY = 3;
+    const size_t numZ = 3;
+    const double xModel[numX] = { 2.0e+3, 31.0e+3, 58.0e+3 };
+    const double yModel[numY] = { 1.0e+3, 57.0e+3, 119.0e+3 };
+    const double zModel[numZ] = { -1.0e+3, -12.0e+3, -44.0e+3 };
+    for (size_t iX = 0; iX < numX; ++iX) {
+        for (size_t iY = 0; iY < numY; ++iY) {
+            const double x = originX + xModel[iX]*cosAz + yModel[iY]*sinAz;
+            const double y = originY - xModel[iX]*sinAz + yModel[iY]*cosAz;
+            CHECK_THAT(queryOut.queryTopElevation(x, y),
+                       Catch::Matchers::WithinAbs(queryIn.queryTopElevation(x, y), tolerance));
+            for (size_t iZ = 0; iZ < numZ; ++iZ) {
+                double valuesIn[2];
+                double valuesOut[2];
+                const int errIn = queryIn.query(valuesIn, x, y, zModel[iZ]);
+                const int errOut = queryOut.query(valuesOut, x, y, zModel[iZ]);
+                INFO("x=" << xModel[iX] << ", y=" << yModel[iY] << ", z=" << zModel[iZ]);
+                CHECK(errIn == errOut);
+                CHECK_THAT(valuesOut[0], Catch::Matchers::WithinAbs(valuesIn[0], tolerance));
+                CHECK_THAT(valuesOut[1], Catch::Matchers::WithinAbs(valuesIn[1], tolerance));
+            } // for
+        } // for
+    } // for
+    queryIn.finalize();
+    queryOut.finalize();
+} // _checkRun
+
+
+// End of file
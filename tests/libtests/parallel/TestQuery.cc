@@ -0,0 +1,389 @@
+/**
+ * C++ unit testing of geomodelgrids::parallel::Query.
+ */
+
+#include <portinfo>
+
+#include "tests/data/ModelPoints.hh"
+
+#include "geomodelgrids/parallel/Query.hh" // USES Query
+#include "geomodelgrids/parallel/NodeCache.hh" // USES NodeCache
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/Surface.hh" // USES Surface
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include <vector> // USES std::vector
+#include <cassert> // USES assert()
+#include <cmath>
+
+namespace geomodelgrids {
+    namespace parallel {
+        class TestQuery;
+    } // parallel
+} // geomodelgrids
+
+class geomodelgrids::parallel::TestQuery {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test initialize() and finalize().
+    static
+    void testInitialize(void);
+
+    /// Test query() with each process querying its own points without loading a region.
+    static
+    void testQuery(void);
+
+    /// Test loadRegion() and query() with each process querying its own points.
+    static
+    void testQueryRegion(void);
+
+    /// Test loadRegion() with processes that do not have any points.
+    static
+    void testLoadRegionEmpty(void);
+
+    /// Test loadNodeCache() and query() with each process querying its own points.
+    static
+    void testQueryNodeCache(void);
+
+    // PRIVATE METHODS ----------------------------------------------------------------------------
+private:
+
+    /** Get points queried by this process.
+     *
+     * Points are distributed round-robin among processes.
+     *
+     * @param[out] pointsLLE Points (latitude, longitude, elevation) for this process.
+     * @param[out] pointsXYZ Points (model coordinates) for this process.
+     * @param[in] points Points for all processes.
+     * @param[in] comm MPI communicator.
+     */
+    static
+    void _getLocalPoints(std::vector<double>* pointsLLE,
+                         std::vector<double>* pointsXYZ,
+                         const geomodelgrids::testdata::ModelPoints& points,
+                         MPI_Comm comm);
+
+    /** Check query values at points against expected values.
+     *
+     * @param[in] query Query object.
+     * @param[in] pointsLLE Points (latitude, longitude, elevation) for this process.
+     * @param[in] pointsXYZ Points (model coordinates) for this process.
+     * @param[in] points Points for all processes (used to compute expected values).
+     */
+    static
+    void _checkQuery(Query& query,
+                     const std::vector<double>& pointsLLE,
+                     const std::vector<double>& pointsXYZ,
+                     const geomodelgrids::testdata::ModelPoints& points);
+
+}; // class TestQuery
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestQuery::testConstructor", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testConstructor();
+}
+TEST_CASE("TestQuery::testInitialize", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testInitialize();
+}
+TEST_CASE("TestQuery::testQuery", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testQuery();
+}
+TEST_CASE("TestQuery::testQueryRegion", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testQueryRegion();
+}
+TEST_CASE("TestQuery::testLoadRegionEmpty", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testLoadRegionEmpty();
+}
+TEST_CASE("TestQuery::testQueryNodeCache", "[TestQuery]") {
+    geomodelgrids::parallel::TestQuery::testQueryNodeCache();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::parallel::TestQuery::testConstructor(void) {
+    Query query;
+
+    int result = MPI_UNEQUAL;
+    MPI_Comm_compare(MPI_COMM_WORLD, query.getCommunicator(), &result);
+    CHECK(MPI_IDENT == result);
+    CHECK(MPI_COMM_WORLD == query._comm);
+
+    Query querySelf(MPI_COMM_SELF);
+    CHECK(MPI_COMM_SELF == querySelf.getCommunicator());
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test initialize().
+void
+geomodelgrids::parallel::TestQuery::testInitialize(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+    const size_t valueIndexE[numValues] = { 1, 0 };
+
+    const char* const crs = "EPSG:4326";
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+
+    REQUIRE(numModels == query._models.size());
+    REQUIRE(numModels == query._valuesIndex.size());
+    for (size_t iModel = 0; iModel < numModels; ++iModel) {
+        REQUIRE(query._models[iModel]);
+
+        REQUIRE(numValues == query._valuesIndex[iModel].size());
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            CHECK(valueIndexE[iValue] == query._valuesIndex[iModel][iValue]);
+        } // for
+    } // for
+
+    query.finalize();
+} // testInitialize
+
+
+// ------------------------------------------------------------------------------------------------
+// Test query() without loading a region.
+void
+geomodelgrids::parallel::TestQuery::testQuery(void) {
+    const size_t numModels = 1;
+    const char* const filenamesArray[numModels] = {
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    std::vector<double> pointsLLE;
+    std::vector<double> pointsXYZ;
+    _getLocalPoints(&pointsLLE, &pointsXYZ, points, MPI_COMM_WORLD);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    Query query;
+    query.initialize(filenames, valueNames, points.getCRSLatLonElev());
+    _checkQuery(query, pointsLLE, pointsXYZ, points);
+    query.finalize();
+} // testQuery
+
+
+// ------------------------------------------------------------------------------------------------
+// Test loadRegion() and query().
+void
+geomodelgrids::parallel::TestQuery::testQueryRegion(void) {
+    const size_t numModels = 1;
+    const char* const filenamesArray[numModels] = {
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    { // Three Block Topo
+        geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+        std::vector<double> pointsLLE;
+        std::vector<double> pointsXYZ;
+        _getLocalPoints(&pointsLLE, &pointsXYZ, points, MPI_COMM_WORLD);
+
+        Query query;
+        query.initialize(filenames, valueNames, points.getCRSLatLonElev());
+        const size_t spaceDim = 3;
+        query.loadRegion(pointsLLE.data(), pointsLLE.size() / spaceDim, spaceDim);
+        _checkQuery(query, pointsLLE, pointsXYZ, points);
+        query.finalize();
+    } // Three Block Topo
+
+    { // One Block Flat
+        filenames[0] = "../../data/one-block-flat.h5";
+
+        geomodelgrids::testdata::OneBlockFlatPoints points;
+        std::vector<double> pointsLLE;
+        std::vector<double> pointsXYZ;
+        _getLocalPoints(&pointsLLE, &pointsXYZ, points, MPI_COMM_WORLD);
+
+        Query query;
+        query.initialize(filenames, valueNames, points.getCRSLatLonElev());
+        const size_t spaceDim = 3;
+        query.loadRegion(pointsLLE.data(), pointsLLE.size() / spaceDim, spaceDim);
+        _checkQuery(query, pointsLLE, pointsXYZ, points);
+        query.finalize();
+    } // One Block Flat
+} // testQueryRegion
+
+
+// ------------------------------------------------------------------------------------------------
+// Test loadRegion() with processes that do not have any points.
+void
+geomodelgrids::parallel::TestQuery::testLoadRegionEmpty(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    std::vector<double> pointsLLE;
+    std::vector<double> pointsXYZ;
+
+    // Only the first process has points.
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (0 == rank) {
+        _getLocalPoints(&pointsLLE, &pointsXYZ, points, MPI_COMM_SELF);
+    } // if
+
+    Query query;
+    query.initialize(filenames, valueNames, points.getCRSLatLonElev());
+    const size_t spaceDim = 3;
+    CHECK_NOTHROW(query.loadRegion(pointsLLE.data(), pointsLLE.size() / spaceDim, spaceDim));
+    _checkQuery(query, pointsLLE, pointsXYZ, points);
+
+    // Clear region.
+    CHECK_NOTHROW(query.loadRegion(1.0, 0.0, 1.0, 0.0));
+    _checkQuery(query, pointsLLE, pointsXYZ, points);
+
+    CHECK_THROWS_AS(query.loadRegion(nullptr, 1, spaceDim), std::invalid_argument);
+    CHECK_THROWS_AS(query.loadRegion(pointsLLE.data(), 1, 1), std::invalid_argument);
+    query.finalize();
+} // testLoadRegionEmpty
+
+
+// ------------------------------------------------------------------------------------------------
+// Test loadNodeCache() and query().
+void
+geomodelgrids::parallel::TestQuery::testQueryNodeCache(void) {
+    const size_t numModels = 1;
+    const char* const filenamesArray[numModels] = {
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    std::vector<double> pointsLLE;
+    std::vector<double> pointsXYZ;
+    _getLocalPoints(&pointsLLE, &pointsXYZ, points, MPI_COMM_WORLD);
+
+    Query query;
+    query.initialize(filenames, valueNames, points.getCRSLatLonElev());
+    query.loadNodeCache();
+    REQUIRE(query._nodeCache);
+
+    // Shared memory holds top surface, topography/bathymetry, and all blocks.
+    const geomodelgrids::serial::Model* model = query._models[0].get();
+    size_t numBytesE = 0;
+    if (model->getTopSurface()) {
+        const size_t* dims = model->getTopSurface()->getDims();
+        numBytesE += dims[0] * dims[1] * sizeof(double);
+    } // if
+    if (model->getTopoBathy()) {
+        const size_t* dims = model->getTopoBathy()->getDims();
+        numBytesE += dims[0] * dims[1] * sizeof(double);
+    } // if
+    const std::vector<std::shared_ptr<geomodelgrids::serial::Block> >& blocks = model->getBlocks();
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const size_t* dims = blocks[i]->getDims();
+        numBytesE += dims[0] * dims[1] * dims[2] * blocks[i]->getNumValues() * sizeof(double);
+    } // for
+    CHECK(numBytesE == query._nodeCache->getNumBytes());
+
+    _checkQuery(query, pointsLLE, pointsXYZ, points);
+    query.finalize();
+    CHECK(!query._nodeCache);
+} // testQueryNodeCache
+
+
+// ------------------------------------------------------------------------------------------------
+// Get points queried by this process.
+void
+geomodelgrids::parallel::TestQuery::_getLocalPoints(std::vector<double>* pointsLLE,
+                                                    std::vector<double>* pointsXYZ,
+                                                    const geomodelgrids::testdata::ModelPoints& points,
+                                                    MPI_Comm comm) {
+    assert(pointsLLE);
+    assert(pointsXYZ);
+
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    const size_t spaceDim = 3;
+    const size_t numPoints = points.getNumPoints();
+    const double* allLLE = points.getLatLonElev();
+    const double* allXYZ = points.getXYZ();
+
+    pointsLLE->clear();
+    pointsXYZ->clear();
+    for (size_t iPt = rank; iPt < numPoints; iPt += size) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            pointsLLE->push_back(allLLE[iPt*spaceDim+iDim]);
+            pointsXYZ->push_back(allXYZ[iPt*spaceDim+iDim]);
+        } // for
+    } // for
+} // _getLocalPoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Check query values at points against expected values.
+void
+geomodelgrids::parallel::TestQuery::_checkQuery(Query& query,
+                                                const std::vector<double>& pointsLLE,
+                                                const std::vector<double>& pointsXYZ,
+                                                const geomodelgrids::testdata::ModelPoints& points) {
+    const size_t spaceDim = 3;
+    const size_t numValues = 2;
+    const double tolerance = 2.0e-5;
+
+    const size_t numPoints = pointsLLE.size() / spaceDim;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        double values[numValues];
+        const int err = query.query(values, pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1], pointsLLE[iPt*spaceDim+2]);
+        REQUIRE(!err);
+
+        const double x = pointsXYZ[iPt*spaceDim+0];
+        const double y = pointsXYZ[iPt*spaceDim+1];
+        const double z = pointsXYZ[iPt*spaceDim+2];
+        double valuesE[numValues];
+        valuesE[0] = points.computeValueTwo(x, y, z);
+        valuesE[1] = points.computeValueOne(x, y, z);
+
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            INFO("Mismatch at point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                       << ", " << pointsLLE[iPt*spaceDim+2] << ") for value " << iValue << ".");
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+            CHECK_THAT(values[iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+        } // for
+    } // for
+} // _checkQuery
+
+
+// End of file
@@ -215,6 +215,7 @@ geomodelgrids::serial::TestBlock::testQuery(void) {
     Block block("block");
     block.loadMetadata(&h5);
     block.openQuery(&h5);
+    CHECK(!block._hyperslab);
 
     const size_t spaceDim = 3;
     REQUIRE(_data->points);
@@ -225,6 +226,7 @@ geomodelgrids::serial::TestBlock::testQuery(void) {
 
     for (size_t iPt = 0; iPt < numPoints; ++iPt) {
         const double* values = block.query(pointsXYZ[iPt*spaceDim+0], pointsXYZ[iPt*spaceDim+1], pointsXYZ[iPt*spaceDim+2]);
+        CHECK(block._hyperslab);
 
         const double x = pointsXYZ[iPt*spaceDim+0];
         const double y = pointsXYZ[iPt*spaceDim+1];
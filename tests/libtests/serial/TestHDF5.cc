@@ -12,6 +12,8 @@
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath> // USES fabs()
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <cstdio> // USES remove()
 
 namespace geomodelgrids {
     namespace serial {
@@ -60,6 +62,20 @@ public:
     /// Test readDatasetHyperslab().
     void testReadDatasetHyperslab(void);
 
+    /// Test reading metadata from metadata snapshot.
+    void testMetadataSnapshot(void);
+
+    /** Copy model file and add metadata snapshot.
+     *
+     * @param[in] filename Name of file to create.
+     * @param[in] records Records in metadata snapshot.
+     * @param[in] numRecords Number of records.
+     */
+    static
+    void _writeSnapshot(const char* filename,
+                        const char* records[],
+                        const size_t numRecords);
+
 private:
 
     H5E_auto2_t _errFunc;
@@ -99,6 +115,9 @@ TEST_CASE("TestHDF5::testReadAttributeStringArray", "[TestHDF5]") {
 TEST_CASE("TestHDF5::testReadDatasetHyperslab", "[TestHDF5]") {
     geomodelgrids::serial::TestHDF5().testReadDatasetHyperslab();
 }
+TEST_CASE("TestHDF5::testMetadataSnapshot", "[TestHDF5]") {
+    geomodelgrids::serial::TestHDF5().testMetadataSnapshot();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Constructor.
@@ -141,6 +160,7 @@ geomodelgrids::serial::TestHDF5::testOpenClose(void) {
     REQUIRE(!h5.isOpen());
 
     h5.open("../../data/one-block-flat.h5", H5F_ACC_RDONLY);REQUIRE(h5.isOpen());
+    CHECK(!h5.hasMetadataSnapshot());
     h5.close();REQUIRE(!h5.isOpen());
 
     const size_t cacheSize = 1048576;
@@ -359,6 +379,19 @@ geomodelgrids::serial::TestHDF5::testReadDatasetHyperslab(void) {
         } // for
     } // for
 
+    // Subset of values at each point.
+    const hsize_t indices[1] = { 1 };
+    double valuesSubset[nvalues/2];
+    h5.readDatasetHyperslab((void*)valuesSubset, dataset, origin, dims, ndims, indices, 1, H5T_NATIVE_DOUBLE);
+    for (int i = 0; i < nvalues/2; ++i) {
+        CHECK(values[2*i+1] == valuesSubset[i]);
+    } // for
+
+    // Indices not in increasing order
+    const hsize_t badIndices[2] = { 1, 0 };
+    CHECK_THROWS_AS(h5.readDatasetHyperslab((void*)values, dataset, origin, dims, ndims, badIndices, 2,
+                                            H5T_NATIVE_DOUBLE), std::runtime_error);
+
     // Bad number of dimensions
     CHECK_THROWS_AS(h5.readDatasetHyperslab((void*)values, dataset, origin, dims, 1, H5T_NATIVE_DOUBLE),
                     std::runtime_error);
@@ -372,4 +405,117 @@ geomodelgrids::serial::TestHDF5::testReadDatasetHyperslab(void) {
 } // testReadDatasetHyperslab
 
 
+// ------------------------------------------------------------------------------------------------
+// Test reading metadata from metadata snapshot.
+void
+geomodelgrids::serial::TestHDF5::testMetadataSnapshot(void) {
+    const char* filename = "hdf5_snapshot.h5";
+
+    // Values differ from the attributes in the file, so we can tell where they were read from.
+    const char* records[] = {
+        "geomodelgrids-metadata-1",
+        "/", "", "group", "0",
+        "/", "title", "string", "1", "Snapshot title",
+        "/", "keywords", "string", "2", "one", "two",
+        "/blocks", "", "group", "0",
+        "/blocks/top", "", "dataset", "4", "1", "2", "3", "2",
+        "/blocks/top", "x_resolution", "float", "1", "12.5",
+        "/blocks/top", "x_coordinates", "float", "3", "0.0", "1.5", "3.0",
+    };
+    const size_t numRecords = sizeof(records) / sizeof(const char*);
+    _writeSnapshot(filename, records, numRecords);
+
+    HDF5 h5;
+    h5.open(filename, H5F_ACC_RDONLY);
+    CHECK(h5.hasMetadataSnapshot());
+
+    CHECK(std::string("Snapshot title") == h5.readAttribute("/", "title"));
+    std::vector<std::string> keywords;
+    h5.readAttribute("/", "keywords", &keywords);
+    REQUIRE(size_t(2) == keywords.size());
+    CHECK(std::string("one") == keywords[0]);
+    CHECK(std::string("two") == keywords[1]);
+
+    CHECK(h5.hasGroup("blocks"));
+    CHECK(h5.hasDataset("blocks/top"));
+    CHECK(!h5.hasGroup("/blocks/top"));
+    std::vector<std::string> names;
+    h5.getGroupDatasets(&names, "/blocks");
+    REQUIRE(size_t(1) == names.size());
+    CHECK(std::string("top") == names[0]);
+
+    const hsize_t dimsE[4] = { 1, 2, 3, 2 };
+    hsize_t* dims = nullptr;
+    int ndims = 0;
+    h5.getDatasetDims(&dims, &ndims, "/blocks/top");
+    REQUIRE(4 == ndims);
+    for (int i = 0; i < ndims; ++i) {
+        CHECK(dimsE[i] == dims[i]);
+    } // for
+    delete[] dims;dims = nullptr;
+
+    CHECK(h5.hasAttribute("/blocks/top", "x_resolution"));
+    CHECK(!h5.hasAttribute("/blocks/top", "z_resolution"));
+    double resolution = 0.0;
+    h5.readAttribute("/blocks/top", "x_resolution", H5T_NATIVE_DOUBLE, (void*)&resolution);
+    CHECK(12.5 == resolution);
+
+    double* coordinates = nullptr;
+    size_t numCoordinates = 0;
+    h5.readAttribute("/blocks/top", "x_coordinates", H5T_NATIVE_DOUBLE, (void**)&coordinates, &numCoordinates);
+    REQUIRE(size_t(3) == numCoordinates);
+    CHECK(0.0 == coordinates[0]);
+    CHECK(1.5 == coordinates[1]);
+    CHECK(3.0 == coordinates[2]);
+    delete[] coordinates;coordinates = nullptr;
+
+    // Objects not in snapshot are read from the file.
+    CHECK(h5.hasAttribute("/blocks/middle", "x_resolution"));
+    h5.readAttribute("/blocks/middle", "x_resolution", H5T_NATIVE_DOUBLE, (void*)&resolution);
+    CHECK(20.0e+3 == resolution);
+    h5.getDatasetDims(&dims, &ndims, "/blocks/middle");
+    REQUIRE(4 == ndims);
+    CHECK(hsize_t(7) == dims[1]);
+    delete[] dims;dims = nullptr;
+    h5.close();
+
+    // Snapshot with unknown format is ignored.
+    records[0] = "geomodelgrids-metadata-0";
+    _writeSnapshot(filename, records, numRecords);
+    h5.open(filename, H5F_ACC_RDONLY);
+    CHECK(!h5.hasMetadataSnapshot());
+    CHECK(std::string("Three Blocks Flat") == h5.readAttribute("/", "title"));
+    h5.close();
+
+    remove(filename);
+} // testMetadataSnapshot
+
+
+// ------------------------------------------------------------------------------------------------
+// Copy model file and add metadata snapshot.
+void
+geomodelgrids::serial::TestHDF5::_writeSnapshot(const char* filename,
+                                                const char* records[],
+                                                const size_t numRecords) {
+    { // Copy model file.
+        std::ifstream sin("../../data/three-blocks-flat.h5", std::ios::binary);
+        std::ofstream sout(filename, std::ios::binary);
+        sout << sin.rdbuf();
+    } // Copy model file.
+
+    hid_t file = H5Fopen(filename, H5F_ACC_RDWR, H5P_DEFAULT);REQUIRE(file >= 0);
+    hid_t datatype = H5Tcopy(H5T_C_S1);REQUIRE(datatype >= 0);
+    REQUIRE(H5Tset_size(datatype, H5T_VARIABLE) >= 0);
+    const hsize_t dims[1] = { numRecords };
+    hid_t dataspace = H5Screate_simple(1, dims, nullptr);REQUIRE(dataspace >= 0);
+    hid_t attribute = H5Acreate2(file, "metadata_snapshot", datatype, dataspace, H5P_DEFAULT, H5P_DEFAULT);
+    REQUIRE(attribute >= 0);
+    REQUIRE(H5Awrite(attribute, datatype, records) >= 0);
+    H5Aclose(attribute);
+    H5Sclose(dataspace);
+    H5Tclose(datatype);
+    H5Fclose(file);
+} // _writeSnapshot
+
+
 // End of file
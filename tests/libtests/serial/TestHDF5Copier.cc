@@ -0,0 +1,279 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::HDF5Copier.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/serial/HDF5Copier.hh" // USES HDF5Copier
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdio> // USES remove()
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestHDF5Copier;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestHDF5Copier {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Constructor.
+    TestHDF5Copier(void);
+
+    /// Destructor.
+    ~TestHDF5Copier(void);
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test open() and close().
+    void testOpenClose(void);
+
+    /// Test getDatasets().
+    void testGetDatasets(void);
+
+    /// Test isPlanar().
+    void testIsPlanar(void);
+
+    /// Test copyGroups() and writeAttribute().
+    void testCopyGroups(void);
+
+    /// Test copying metadata snapshot.
+    void testCopySnapshot(void);
+
+private:
+
+    H5E_auto2_t _errFunc;
+    void* _errData;
+
+}; // class TestHDF5Copier
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestHDF5Copier::testConstructor", "[TestHDF5Copier]") {
+    geomodelgrids::serial::TestHDF5Copier::testConstructor();
+}
+TEST_CASE("TestHDF5Copier::testOpenClose", "[TestHDF5Copier]") {
+    geomodelgrids::serial::TestHDF5Copier().testOpenClose();
+}
+TEST_CASE("TestHDF5Copier::testGetDatasets", "[TestHDF5Copier]") {
+    geomodelgrids::serial::TestHDF5Copier().testGetDatasets();
+}
+TEST_CASE("TestHDF5Copier::testIsPlanar", "[TestHDF5Copier]") {
+    geomodelgrids::serial::TestHDF5Copier().testIsPlanar();
+}
+TEST_CASE("TestHDF5Copier::testCopyGroups", "[TestHDF5Copier]") {
+    geomodelgrids::serial::TestHDF5Copier().testCopyGroups();
+}
+TEST_CASE("TestHDF5Copier::testCopySnapshot", "[TestHDF5Copier]") {
+    geomodelgrids::serial::TestHDF5Copier().testCopySnapshot();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Constructor.
+geomodelgrids::serial::TestHDF5Copier::TestHDF5Copier(void) {
+    // Temporarily turn off HDF5 error handler.
+    H5Eget_auto(H5E_DEFAULT, &_errFunc, &_errData);
+    H5Eset_auto(H5E_DEFAULT, nullptr, nullptr);
+} // constructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Destructor.
+geomodelgrids::serial::TestHDF5Copier::~TestHDF5Copier(void) {
+    // Restore default HDF5 error handler.
+    H5Eset_auto(H5E_DEFAULT, _errFunc, _errData);
+} // destructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::serial::TestHDF5Copier::testConstructor(void) {
+    HDF5Copier copier;
+
+    CHECK(hid_t(-1) == copier._srcFile);
+    CHECK(hid_t(-1) == copier._destFile);
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test open() and close().
+void
+geomodelgrids::serial::TestHDF5Copier::testOpenClose(void) {
+    HDF5Copier copier;
+
+    copier.open("../../data/one-block-flat.h5", "hdf5_copier.h5");
+    CHECK(copier.getSource() >= 0);
+    CHECK(copier.getDestination() >= 0);
+    copier.close();
+    CHECK(hid_t(-1) == copier.getSource());
+    CHECK(hid_t(-1) == copier.getDestination());
+
+    CHECK_THROWS_AS(copier.open("../../data/nonexistent.h5", "hdf5_copier.h5"), std::runtime_error);
+    CHECK_THROWS_AS(copier.open("../../data/one-block-flat.h5", "nonexistent/hdf5_copier.h5"), std::runtime_error);
+    CHECK(hid_t(-1) == copier.getSource());
+
+    remove("hdf5_copier.h5");
+} // testOpenClose
+
+
+// ------------------------------------------------------------------------------------------------
+// Test getDatasets().
+void
+geomodelgrids::serial::TestHDF5Copier::testGetDatasets(void) {
+    HDF5Copier copier;
+    copier.open("../../data/three-blocks-topo.h5", "hdf5_copier.h5");
+
+    std::vector<std::string> paths;
+    copier.getDatasets(&paths);
+    copier.close();
+
+    const size_t numPaths = 5;
+    const char* pathsE[numPaths] = {
+        "surfaces/top_surface",
+        "surfaces/topography_bathymetry",
+        "blocks/bottom",
+        "blocks/middle",
+        "blocks/top",
+    };
+    REQUIRE(numPaths == paths.size());
+    for (size_t i = 0; i < numPaths; ++i) {
+        CHECK(std::string(pathsE[i]) == paths[i]);
+    } // for
+
+    // Coarser levels of blocks.
+    copier.open("../../data/three-blocks-topo-levels.h5", "hdf5_copier.h5");
+    copier.getDatasets(&paths);
+    CHECK(numPaths == paths.size());
+    copier.getDatasets(&paths, true);
+    copier.copyGroups(false, true);
+    copier.close();
+
+    const size_t numLevels = 5;
+    const char* levelsE[numLevels] = {
+        "levels/bottom/2",
+        "levels/bottom/4",
+        "levels/middle/2",
+        "levels/top/2",
+        "levels/top/4",
+    };
+    REQUIRE(numPaths+numLevels == paths.size());
+    for (size_t i = 0; i < numLevels; ++i) {
+        CHECK(std::string(levelsE[i]) == paths[numPaths+i]);
+    } // for
+
+    HDF5 h5;
+    h5.open("hdf5_copier.h5", H5F_ACC_RDONLY);
+    CHECK(h5.hasGroup("levels/bottom"));
+    CHECK(h5.hasGroup("levels/middle"));
+    CHECK(h5.hasGroup("levels/top"));
+    h5.close();
+
+    remove("hdf5_copier.h5");
+} // testGetDatasets
+
+
+// ------------------------------------------------------------------------------------------------
+// Test isPlanar().
+void
+geomodelgrids::serial::TestHDF5Copier::testIsPlanar(void) {
+    HDF5Copier copier;
+    copier.open("../../data/one-block-topo-planar.h5", "hdf5_copier.h5");
+    CHECK(copier.isPlanar("blocks/block"));
+    CHECK(!copier.isPlanar("surfaces/top_surface"));
+    copier.close();
+
+    copier.open("../../data/one-block-topo.h5", "hdf5_copier.h5");
+    CHECK(!copier.isPlanar("blocks/block"));
+    copier.close();
+
+    remove("hdf5_copier.h5");
+} // testIsPlanar
+
+
+// ------------------------------------------------------------------------------------------------
+// Test copyGroups() and writeAttribute().
+void
+geomodelgrids::serial::TestHDF5Copier::testCopyGroups(void) {
+    HDF5Copier copier;
+    copier.open("../../data/one-block-flat.h5", "hdf5_copier.h5");
+    copier.copyGroups(false);
+    copier.writeAttribute("/", "dim_x", 1234.0);
+    copier.writeAttribute("/", "new_attribute", 5.0);
+    copier.close();
+
+    HDF5 h5Src;
+    h5Src.open("../../data/one-block-flat.h5", H5F_ACC_RDONLY);
+    HDF5 h5;
+    h5.open("hdf5_copier.h5", H5F_ACC_RDONLY);
+    CHECK(h5.hasGroup("blocks"));
+    CHECK(h5Src.hasGroup("surfaces") == h5.hasGroup("surfaces"));
+    CHECK(h5Src.readAttribute("/", "crs") == h5.readAttribute("/", "crs"));
+    CHECK(h5Src.readAttribute("/", "title") == h5.readAttribute("/", "title"));
+
+    std::vector<std::string> valuesSrc;
+    h5Src.readAttribute("/", "data_values", &valuesSrc);
+    std::vector<std::string> values;
+    h5.readAttribute("/", "data_values", &values);
+    CHECK(valuesSrc == values);
+
+    double originSrc = 0.0;
+    h5Src.readAttribute("/", "origin_x", H5T_NATIVE_DOUBLE, (void*)&originSrc);
+    double origin = 0.0;
+    h5.readAttribute("/", "origin_x", H5T_NATIVE_DOUBLE, (void*)&origin);
+    CHECK(originSrc == origin);
+
+    double dimX = 0.0;
+    h5.readAttribute("/", "dim_x", H5T_NATIVE_DOUBLE, (void*)&dimX);
+    CHECK(1234.0 == dimX);
+    double newValue = 0.0;
+    h5.readAttribute("/", "new_attribute", H5T_NATIVE_DOUBLE, (void*)&newValue);
+    CHECK(5.0 == newValue);
+    h5.close();
+    h5Src.close();
+
+    remove("hdf5_copier.h5");
+} // testCopyGroups
+
+
+// ------------------------------------------------------------------------------------------------
+// Test copying metadata snapshot.
+void
+geomodelgrids::serial::TestHDF5Copier::testCopySnapshot(void) {
+    const char* const snapshotName = "metadata_snapshot";
+    HDF5Copier copier;
+    copier.open("../../data/one-block-flat.h5", "hdf5_copier.h5");
+    copier.copyGroups(false);
+    copier.writeAttribute("/", snapshotName, 1.0);
+    copier.close();
+
+    copier.open("hdf5_copier.h5", "hdf5_copier_snapshot.h5");
+    copier.copyGroups(true);
+    copier.close();
+
+    copier.open("hdf5_copier.h5", "hdf5_copier_nosnapshot.h5");
+    copier.copyGroups(false);
+    copier.close();
+
+    // The snapshot written above is not a valid snapshot, so check the files without HDF5.
+    hid_t h5 = H5Fopen("hdf5_copier_snapshot.h5", H5F_ACC_RDONLY, H5P_DEFAULT);REQUIRE(h5 >= 0);
+    CHECK(H5Aexists(h5, snapshotName) > 0);
+    H5Fclose(h5);
+
+    h5 = H5Fopen("hdf5_copier_nosnapshot.h5", H5F_ACC_RDONLY, H5P_DEFAULT);REQUIRE(h5 >= 0);
+    CHECK(0 == H5Aexists(h5, snapshotName));
+    CHECK(H5Aexists(h5, "crs") > 0);
+    H5Fclose(h5);
+
+    remove("hdf5_copier.h5");
+    remove("hdf5_copier_snapshot.h5");
+    remove("hdf5_copier_nosnapshot.h5");
+} // testCopySnapshot
+
+
+// End of file
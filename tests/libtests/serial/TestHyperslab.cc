@@ -9,11 +9,13 @@
 #include "geomodelgrids/serial/Hyperslab.hh" // Test subject
 
 #include "geomodelgrids/serial/HDF5.hh" // HASA HDF5
+#include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath> // USES fabs()
+#include <vector> // USES std::vector
 
 namespace geomodelgrids {
     namespace serial {
@@ -49,6 +51,21 @@ public:
     /// Test interpolate in 2D.
     void testInterpolate3D(void);
 
+    /// Test loadRegion() and interpolate in 3D.
+    void testLoadRegion3D(void);
+
+    /// Test readValues(), setRegion() and interpolate in 3D.
+    void testSetRegion3D(void);
+
+    /// Test decoding values stored as integers in 3D.
+    void testQuantized3D(void);
+
+    /// Test querying a subset of the values in 3D.
+    void testSelectValues3D(void);
+
+    /// Test reading values stored with planar layout in 3D.
+    void testPlanar3D(void);
+
     // PRIVATE MEMBERS ----------------------------------------------------------------------------
 private:
 
@@ -76,6 +93,21 @@ TEST_CASE("TestHyperslab::testInterpolate2D", "[TestHyperslab]") {
 TEST_CASE("TestHyperslab::testInterpolate3D", "[TestHyperslab]") {
     geomodelgrids::serial::TestHyperslab().testInterpolate3D();
 }
+TEST_CASE("TestHyperslab::testLoadRegion3D", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testLoadRegion3D();
+}
+TEST_CASE("TestHyperslab::testSetRegion3D", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testSetRegion3D();
+}
+TEST_CASE("TestHyperslab::testQuantized3D", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testQuantized3D();
+}
+TEST_CASE("TestHyperslab::testSelectValues3D", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testSelectValues3D();
+}
+TEST_CASE("TestHyperslab::testPlanar3D", "[TestHyperslab]") {
+    geomodelgrids::serial::TestHyperslab().testPlanar3D();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Constructor.
@@ -115,7 +147,7 @@ geomodelgrids::serial::TestHyperslab::testConstructor2D(void) {
         CHECK(dimsAll[i] == hyperslab._dimsAll[i]);
     } // for
 
-    CHECK(hyperslab._values);
+    CHECK(!hyperslab._values);
     CHECK(hyperslab._hyperslab);
 } // testConstructor2D
 
@@ -144,7 +176,7 @@ geomodelgrids::serial::TestHyperslab::testConstructor3D(void) {
         CHECK(dimsAll[i] == hyperslab._dimsAll[i]);
     } // for
 
-    CHECK(hyperslab._values);
+    CHECK(!hyperslab._values);
     CHECK(hyperslab._hyperslab);
 } // testConstructor3D
 
@@ -173,7 +205,7 @@ geomodelgrids::serial::TestHyperslab::testConstructorOversize3D(void) {
         CHECK(dimsAll[i] == hyperslab._dimsAll[i]);
     } // for
 
-    CHECK(hyperslab._values);
+    CHECK(!hyperslab._values);
     CHECK(hyperslab._hyperslab);
 } // testConstructorOversize3D
 
@@ -292,4 +324,415 @@ geomodelgrids::serial::TestHyperslab::testInterpolate3D(void) {
 } // testInterplate3D
 
 
+// ------------------------------------------------------------------------------------------------
+// Test loadRegion() and interpolate in 3D.
+void
+geomodelgrids::serial::TestHyperslab::testLoadRegion3D(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 2, 2, 2, 2 };
+
+    const size_t spaceDim = 3;
+    const hsize_t regionOrigin[spaceDim] = { 1, 1, 0 };
+    const hsize_t regionDims[spaceDim] = { 3, 3, 2 };
+
+    // Points inside and outside region.
+    const size_t npoints(6);
+    const double index[npoints*spaceDim] = {
+        1.0, 1.0, 0.2,
+        1.3, 1.2, 0.3,
+        2.4, 2.5, 0.9,
+        3.0, 3.0, 0.0,
+        0.6, 4.0, 0.5,
+        2.1, 0.3, 0.3,
+    };
+    const bool inRegionE[npoints] = { true, true, true, true, false, false };
+
+    Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+    hyperslab.loadRegion(regionOrigin, regionDims);
+    REQUIRE(hyperslab._regionValues);
+    REQUIRE(hyperslab._regionOrigin);
+    REQUIRE(hyperslab._regionDims);
+    for (size_t i = 0; i < spaceDim; ++i) {
+        CHECK(regionOrigin[i] == hyperslab._regionOrigin[i]);
+        CHECK(regionDims[i] == hyperslab._regionDims[i]);
+    } // for
+    CHECK(0 == hyperslab._regionOrigin[spaceDim]);
+    CHECK(dims[spaceDim] == hyperslab._regionDims[spaceDim]);
+
+    double dx = 0.0;
+    double dy = 0.0;
+    double dz = 0.0;
+    double zTop = 0.0;
+    _h5.readAttribute(dataset.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    _h5.readAttribute(dataset.c_str(), "y_resolution", H5T_NATIVE_DOUBLE, &dy);
+    _h5.readAttribute(dataset.c_str(), "z_resolution", H5T_NATIVE_DOUBLE, &dz);
+    _h5.readAttribute(dataset.c_str(), "z_top", H5T_NATIVE_DOUBLE, &zTop);
+
+    double values[2] = { -999.0, -999.0 };
+    const double tolerance = 1.0e-6;
+    for (size_t i = 0; i < npoints; ++i) {
+        hyperslab.interpolate(values, &index[i*spaceDim]);
+
+        // Sliding hyperslab is only read for points outside region (points inside region are first).
+        CHECK(inRegionE[i] == !hyperslab._origin);
+
+        const double x = dx * index[i*spaceDim + 0];
+        const double y = dx * index[i*spaceDim + 1];
+        const double z = zTop - dz * index[i*spaceDim + 2];
+
+        { // Value 0
+            const double valueE = geomodelgrids::testdata::ModelPoints::computeValueOne(x, y, z);
+            INFO("Mismatch in value 'one' for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1]
+                                                       << ", " << index[i*spaceDim+2] << ").");
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[0], Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // Value 0
+
+        { // Value 1
+            const double valueE = geomodelgrids::testdata::ModelPoints::computeValueTwo(x, y, z);
+            INFO("Mismatch in value 'two' for index (" << index[i*spaceDim+0] << ", " << index[i*spaceDim+1]
+                                                       << ", " << index[i*spaceDim+2] << ").");
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // Value 1
+    } // for
+
+    // Range of values over region.
+    const size_t numRegionPoints = regionDims[0] * regionDims[1] * regionDims[2];
+    for (size_t iValue = 0; iValue < dims[spaceDim]; ++iValue) {
+        double minValueE = hyperslab._regionValues[iValue];
+        double maxValueE = hyperslab._regionValues[iValue];
+        for (size_t iPt = 0; iPt < numRegionPoints; ++iPt) {
+            minValueE = std::min(minValueE, hyperslab._regionValues[iPt*dims[spaceDim]+iValue]);
+            maxValueE = std::max(maxValueE, hyperslab._regionValues[iPt*dims[spaceDim]+iValue]);
+        } // for
+        double minValue = 0.0;
+        double maxValue = 0.0;
+        REQUIRE(hyperslab.getRegionRange(&minValue, &maxValue, iValue));
+        CHECK(minValueE == minValue);
+        CHECK(maxValueE == maxValue);
+    } // for
+
+    // Clear region.
+    const hsize_t emptyDims[spaceDim] = { 0, 0, 0 };
+    hyperslab.loadRegion(regionOrigin, emptyDims);
+    CHECK(!hyperslab._regionValues);
+    CHECK(!hyperslab._regionOrigin);
+    CHECK(!hyperslab._regionDims);
+    double minValue = 0.0;
+    double maxValue = 0.0;
+    CHECK(!hyperslab.getRegionRange(&minValue, &maxValue));
+
+    // Region exceeding dataset.
+    const hsize_t badDims[spaceDim] = { 4, 3, 2 };
+    CHECK_THROWS_AS(hyperslab.loadRegion(regionOrigin, badDims), std::length_error);
+} // testLoadRegion3D
+
+
+// ------------------------------------------------------------------------------------------------
+// Test readValues(), setRegion() and interpolate in 3D.
+void
+geomodelgrids::serial::TestHyperslab::testSetRegion3D(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 2, 2, 2, 2 };
+
+    const size_t spaceDim = 3;
+    const hsize_t regionOrigin[spaceDim] = { 1, 1, 0 };
+    const hsize_t regionDims[spaceDim] = { 3, 3, 2 };
+
+    // Points inside region.
+    const size_t npoints(3);
+    const double index[npoints*spaceDim] = {
+        1.0, 1.0, 0.2,
+        2.4, 2.5, 0.9,
+        3.0, 3.0, 0.0,
+    };
+
+    Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+
+    // Values in external memory.
+    const size_t numValues = regionDims[0] * regionDims[1] * regionDims[2] * dims[spaceDim];
+    std::vector<double> regionValues(numValues);
+    hyperslab.readValues(regionValues.data(), regionOrigin, regionDims);
+    CHECK(!hyperslab._regionValues);
+
+    hyperslab.setRegion(regionOrigin, regionDims, regionValues.data());
+    CHECK(regionValues.data() == hyperslab._regionValues);
+    CHECK(!hyperslab._regionBuffer);
+    REQUIRE(hyperslab._regionOrigin);
+    REQUIRE(hyperslab._regionDims);
+    for (size_t i = 0; i < spaceDim; ++i) {
+        CHECK(regionOrigin[i] == hyperslab._regionOrigin[i]);
+        CHECK(regionDims[i] == hyperslab._regionDims[i]);
+    } // for
+
+    double dx = 0.0;
+    double dz = 0.0;
+    double zTop = 0.0;
+    _h5.readAttribute(dataset.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    _h5.readAttribute(dataset.c_str(), "z_resolution", H5T_NATIVE_DOUBLE, &dz);
+    _h5.readAttribute(dataset.c_str(), "z_top", H5T_NATIVE_DOUBLE, &zTop);
+
+    double values[2] = { -999.0, -999.0 };
+    const double tolerance = 1.0e-6;
+    for (size_t i = 0; i < npoints; ++i) {
+        hyperslab.interpolate(values, &index[i*spaceDim]);
+        CHECK(!hyperslab._origin);
+
+        const double x = dx * index[i*spaceDim + 0];
+        const double y = dx * index[i*spaceDim + 1];
+        const double z = zTop - dz * index[i*spaceDim + 2];
+
+        { // Value 0
+            const double valueE = geomodelgrids::testdata::ModelPoints::computeValueOne(x, y, z);
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[0], Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // Value 0
+
+        { // Value 1
+            const double valueE = geomodelgrids::testdata::ModelPoints::computeValueTwo(x, y, z);
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // Value 1
+    } // for
+
+    // Clear region.
+    hyperslab.setRegion(regionOrigin, regionDims, nullptr);
+    CHECK(!hyperslab._regionValues);
+    CHECK(!hyperslab._regionOrigin);
+
+    // Region exceeding dataset.
+    const hsize_t badDims[spaceDim] = { 4, 3, 2 };
+    CHECK_THROWS_AS(hyperslab.setRegion(regionOrigin, badDims, regionValues.data()), std::length_error);
+    CHECK_THROWS_AS(hyperslab.readValues(regionValues.data(), regionOrigin, badDims), std::length_error);
+} // testSetRegion3D
+
+
+// ------------------------------------------------------------------------------------------------
+// Test decoding values stored as integers in 3D.
+void
+geomodelgrids::serial::TestHyperslab::testQuantized3D(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 2, 2, 2, 2 };
+    const size_t spaceDim = 3;
+
+    { // Values stored as floating point values are not decoded.
+        Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims);
+        CHECK(!hyperslab._scaleFactor);
+        CHECK(!hyperslab._addOffset);
+        CHECK(!hyperslab._hasMissingValue);
+    } // Floating point
+
+    HDF5 h5;
+    h5.open("../../data/one-block-topo-quantized.h5", H5F_ACC_RDONLY);
+    Hyperslab hyperslab(&h5, dataset.c_str(), dims, ndims);
+    REQUIRE(hyperslab._scaleFactor);
+    REQUIRE(hyperslab._addOffset);
+    CHECK(hyperslab._hasMissingValue);
+    CHECK(-32768.0 == hyperslab._missingValue);
+
+    const hsize_t* dimsAll = hyperslab._dimsAll;
+    double dx = 0.0;
+    double dy = 0.0;
+    double dz = 0.0;
+    double zTop = 0.0;
+    h5.readAttribute(dataset.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    h5.readAttribute(dataset.c_str(), "y_resolution", H5T_NATIVE_DOUBLE, &dy);
+    h5.readAttribute(dataset.c_str(), "z_resolution", H5T_NATIVE_DOUBLE, &dz);
+    h5.readAttribute(dataset.c_str(), "z_top", H5T_NATIVE_DOUBLE, &zTop);
+
+    // Values at all points.
+    const hsize_t origin[spaceDim] = { 0, 0, 0 };
+    const size_t numPoints = dimsAll[0] * dimsAll[1] * dimsAll[2];
+    std::vector<double> blockValues(numPoints*dims[spaceDim]);
+    hyperslab.readValues(blockValues.data(), origin, dimsAll);
+
+    // Last point is NODATA.
+    CHECK(geomodelgrids::NODATA_VALUE == blockValues[(numPoints-1)*2+0]);
+    CHECK(geomodelgrids::NODATA_VALUE == blockValues[(numPoints-1)*2+1]);
+
+    double values[2] = { -999.0, -999.0 };
+    for (size_t ix = 0, iPt = 0; ix < dimsAll[0]; ++ix) {
+        for (size_t iy = 0; iy < dimsAll[1]; ++iy) {
+            for (size_t iz = 0; iz < dimsAll[2]; ++iz, ++iPt) {
+                if (iPt+1 == numPoints) {
+                    continue;
+                } // if
+                INFO("Mismatch in values for index (" << ix << ", " << iy << ", " << iz << ").");
+
+                const double x = dx * ix;
+                const double y = dy * iy;
+                const double z = zTop - dz * iz;
+                const double valuesE[2] = {
+                    geomodelgrids::testdata::ModelPoints::computeValueOne(x, y, z),
+                    geomodelgrids::testdata::ModelPoints::computeValueTwo(x, y, z),
+                };
+                for (size_t iValue = 0; iValue < 2; ++iValue) {
+                    const double toleranceV = 0.5 * hyperslab._scaleFactor[iValue] + 1.0e-6;
+                    CHECK_THAT(blockValues[iPt*2+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+                } // for
+
+                // Sliding hyperslab at points in cells without NODATA.
+                if (ix+2 < dimsAll[0]) {
+                    const double index[spaceDim] = { double(ix), double(iy), double(iz) };
+                    hyperslab.interpolate(values, index);
+                    CHECK(blockValues[iPt*2+0] == values[0]);
+                    CHECK(blockValues[iPt*2+1] == values[1]);
+                } // if
+            } // for
+        } // for
+    } // for
+    h5.close();
+} // testQuantized3D
+
+
+// ------------------------------------------------------------------------------------------------
+// Test querying a subset of the values in 3D.
+void
+geomodelgrids::serial::TestHyperslab::testSelectValues3D(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 2, 2, 2, 2 };
+    const size_t spaceDim = 3;
+
+    CHECK_THROWS_AS(Hyperslab(&_h5, dataset.c_str(), dims, ndims, std::vector<size_t>(1, 2)), std::invalid_argument);
+
+    const std::vector<size_t> valueIndices(1, 1);
+    Hyperslab hyperslab(&_h5, dataset.c_str(), dims, ndims, valueIndices);
+    REQUIRE(1 == hyperslab._valueIndices.size());
+    CHECK(1 == hyperslab._valueIndices[0]);
+    CHECK(1 == hyperslab._dims[spaceDim]);
+
+    double dx = 0.0;
+    double dz = 0.0;
+    double zTop = 0.0;
+    _h5.readAttribute(dataset.c_str(), "x_resolution", H5T_NATIVE_DOUBLE, &dx);
+    _h5.readAttribute(dataset.c_str(), "z_resolution", H5T_NATIVE_DOUBLE, &dz);
+    _h5.readAttribute(dataset.c_str(), "z_top", H5T_NATIVE_DOUBLE, &zTop);
+
+    const size_t npoints(3);
+    const double index[npoints*spaceDim] = {
+        1.0, 1.0, 0.2,
+        2.4, 2.5, 0.9,
+        3.0, 3.0, 0.0,
+    };
+    const hsize_t regionOrigin[spaceDim] = { 1, 1, 0 };
+    const hsize_t regionDims[spaceDim] = { 3, 3, 2 };
+
+    // Values in external memory contain all values at a point.
+    std::vector<double> regionValues(regionDims[0] * regionDims[1] * regionDims[2] * 2);
+    hyperslab.readValues(regionValues.data(), regionOrigin, regionDims);
+
+    const double tolerance = 1.0e-6;
+    for (size_t iCase = 0; iCase < 3; ++iCase) {
+        double minValue = 0.0;
+        double maxValue = 0.0;
+        if (0 == iCase) { // Sliding hyperslab
+            CHECK(!hyperslab.getRegionRange(&minValue, &maxValue, 1));
+        } else if (1 == iCase) { // Loaded region
+            hyperslab.loadRegion(regionOrigin, regionDims);
+            REQUIRE(hyperslab._regionDims);
+            CHECK(1 == hyperslab._regionDims[spaceDim]);
+            CHECK(hyperslab.getRegionRange(&minValue, &maxValue, 1));
+            CHECK(!hyperslab.getRegionRange(&minValue, &maxValue, 0));
+        } else { // External region
+            hyperslab.setRegion(regionOrigin, regionDims, regionValues.data());
+            REQUIRE(hyperslab._regionDims);
+            CHECK(2 == hyperslab._regionDims[spaceDim]);
+            CHECK(hyperslab.getRegionRange(&minValue, &maxValue, 1));
+            CHECK(!hyperslab.getRegionRange(&minValue, &maxValue, 0));
+        } // if/else
+
+        for (size_t i = 0; i < npoints; ++i) {
+            INFO("Case " << iCase << ", point " << i << ".");
+            double values[2] = { -999.0, -999.0 };
+            hyperslab.interpolate(values, &index[i*spaceDim]);
+
+            const double x = dx * index[i*spaceDim + 0];
+            const double y = dx * index[i*spaceDim + 1];
+            const double z = zTop - dz * index[i*spaceDim + 2];
+
+            // Value 0 is not selected.
+            CHECK(-999.0 == values[0]);
+
+            const double valueE = geomodelgrids::testdata::ModelPoints::computeValueTwo(x, y, z);
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valueE, toleranceV));
+        } // for
+    } // for
+} // testSelectValues3D
+
+
+// ------------------------------------------------------------------------------------------------
+// Test reading values stored with planar layout in 3D.
+void
+geomodelgrids::serial::TestHyperslab::testPlanar3D(void) {
+    const std::string dataset("/blocks/block");
+    const size_t ndims(4);
+    const hsize_t dims[ndims] = { 2, 2, 2, 2 };
+    const size_t spaceDim = 3;
+
+    HDF5 h5;
+    h5.open("../../data/one-block-topo-planar.h5", H5F_ACC_RDONLY);
+    Hyperslab hyperslab(&h5, dataset.c_str(), dims, ndims);
+    Hyperslab hyperslabE(&_h5, dataset.c_str(), dims, ndims);
+    CHECK(hyperslab._isPlanar);
+    CHECK(!hyperslabE._isPlanar);
+
+    // Dimensions use interleaved order (x, y, z, value).
+    for (size_t i = 0; i < ndims; ++i) {
+        CHECK(hyperslabE._dimsAll[i] == hyperslab._dimsAll[i]);
+    } // for
+
+    // Values at all points.
+    const hsize_t* dimsAll = hyperslab._dimsAll;
+    const hsize_t origin[spaceDim] = { 0, 0, 0 };
+    const size_t numValues = dimsAll[0] * dimsAll[1] * dimsAll[2] * dims[spaceDim];
+    std::vector<double> blockValues(numValues);
+    hyperslab.readValues(blockValues.data(), origin, dimsAll);
+    std::vector<double> blockValuesE(numValues);
+    hyperslabE.readValues(blockValuesE.data(), origin, dimsAll);
+    CHECK(blockValuesE == blockValues);
+
+    const size_t npoints(3);
+    const double index[npoints*spaceDim] = {
+        1.0, 1.0, 0.2,
+        2.4, 2.5, 0.9,
+        3.0, 3.0, 0.0,
+    };
+    const hsize_t regionOrigin[spaceDim] = { 1, 1, 0 };
+    const hsize_t regionDims[spaceDim] = { 3, 3, 2 };
+
+    const double tolerance = 1.0e-6;
+    for (size_t iCase = 0; iCase < 4; ++iCase) {
+        // Odd cases query a subset of the values.
+        const std::vector<size_t> valueIndices = (iCase % 2) ? std::vector<size_t>(1, 1) : std::vector<size_t>();
+        Hyperslab hyperslabP(&h5, dataset.c_str(), dims, ndims, valueIndices);
+        if (iCase >= 2) { // Loaded region
+            hyperslabP.loadRegion(regionOrigin, regionDims);
+            hyperslabE.loadRegion(regionOrigin, regionDims);
+        } // if
+
+        for (size_t i = 0; i < npoints; ++i) {
+            INFO("Case " << iCase << ", point " << i << ".");
+            double values[2] = { -999.0, -999.0 };
+            hyperslabP.interpolate(values, &index[i*spaceDim]);
+            double valuesE[2] = { -999.0, -999.0 };
+            hyperslabE.interpolate(valuesE, &index[i*spaceDim]);
+
+            if (iCase % 2) {
+                CHECK(-999.0 == values[0]);
+            } else {
+                CHECK_THAT(values[0], Catch::Matchers::WithinAbs(valuesE[0], tolerance*fabs(valuesE[0])));
+            } // if/else
+            CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valuesE[1], tolerance*fabs(valuesE[1])));
+        } // for
+    } // for
+    h5.close();
+} // testPlanar3D
+
+
 // End of file
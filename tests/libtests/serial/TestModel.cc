@@ -7,6 +7,7 @@
 #include "tests/data/ModelPoints.hh" // USES ModelPoints
 
 #include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/HDF5.hh" // USES HDF5
 #include "geomodelgrids/serial/ModelInfo.hh" // USES ModelInfo
 #include "geomodelgrids/serial/Surface.hh" // USES Surface
 #include "geomodelgrids/serial/Block.hh" // USES Block
@@ -16,6 +17,12 @@
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
 
 #include <cmath> // USES fabs()
+#include <vector> // USES std::vector
+#include <memory> // USES std::unique_ptr
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <sys/stat.h> // USES utimensat()
+#include <fcntl.h> // USES AT_FDCWD
+#include <unistd.h> // USES unlink()
 
 namespace geomodelgrids {
     namespace serial {
@@ -75,6 +82,18 @@ public:
     static
     void testQueryVarXYZ(void);
 
+    /// Test setTargetResolution() and query() with coarser levels of blocks.
+    static
+    void testTargetResolution(void);
+
+    /// Test queryColumn().
+    static
+    void testQueryColumn(void);
+
+    /// Test queryNodeElevations().
+    static
+    void testQueryNodeElevations(void);
+
 }; // class TestModel
 
 // ------------------------------------------------------------------------------------------------
@@ -114,6 +133,15 @@ TEST_CASE("TestModel::testQuery", "[TestModel]") {
 TEST_CASE("TestModel::testQueryVarXYZ", "[TestModel]") {
     geomodelgrids::serial::TestModel::testQueryVarXYZ();
 }
+TEST_CASE("TestModel::testTargetResolution", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testTargetResolution();
+}
+TEST_CASE("TestModel::testQueryColumn", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testQueryColumn();
+}
+TEST_CASE("TestModel::testQueryNodeElevations", "[TestModel]") {
+    geomodelgrids::serial::TestModel::testQueryNodeElevations();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -237,6 +265,56 @@ geomodelgrids::serial::TestModel::testOpenClose(void) {
     model.open("../../data/tmp.h5", Model::READ_WRITE_TRUNCATE);
     CHECK(model._h5);
     model.close();
+    CHECK(!model._h5);
+
+    { // Models opened for reading share the model file.
+        Model modelA;
+        modelA.open("../../data/three-blocks-topo.h5", Model::READ);
+        Model modelB;
+        modelB.open("../../data/../data/three-blocks-topo.h5", Model::READ);
+        CHECK(modelA._h5 == modelB._h5);
+
+        hid_t fileAccess = H5Pcreate(H5P_FILE_ACCESS);
+        Model modelC;
+        modelC.open("../../data/three-blocks-topo.h5", Model::READ, fileAccess);
+        CHECK(modelA._h5 != modelC._h5);
+        H5Pclose(fileAccess);
+
+        modelA.close();
+        REQUIRE(modelB._h5);
+        CHECK(modelB._h5->isOpen());
+        modelB.loadMetadata();
+        CHECK(size_t(3) == modelB.getBlocks().size());
+        modelB.close();
+        modelC.close();
+    } // Models opened for reading share the model file.
+
+    { // Model file changed with same inode and size within the same second is opened again.
+        const char* filename = "model-shared-changed.h5";
+        { // Copy model file.
+            std::ifstream fin("../../data/three-blocks-topo.h5", std::ios::binary);
+            std::ofstream fout(filename, std::ios::binary);
+            fout << fin.rdbuf();
+        } // Copy model file.
+        struct timespec times[2];
+        times[0].tv_sec = 1600000000;
+        times[0].tv_nsec = 0;
+        times[1].tv_sec = 1600000000;
+        times[1].tv_nsec = 100;
+        REQUIRE(0 == utimensat(AT_FDCWD, filename, times, 0));
+
+        Model modelA;
+        modelA.open(filename, Model::READ);
+        times[1].tv_nsec = 200;
+        REQUIRE(0 == utimensat(AT_FDCWD, filename, times, 0));
+        Model modelB;
+        modelB.open(filename, Model::READ);
+        CHECK(modelA._h5 != modelB._h5);
+
+        modelA.close();
+        modelB.close();
+        unlink(filename);
+    } // Model file changed
 } // testOpenClose
 
 
@@ -611,4 +689,192 @@ geomodelgrids::serial::TestModel::testQueryVarXYZ(void) {
 } // testQueryVarXYZ
 
 
+// ------------------------------------------------------------------------------------------------
+// Test setTargetResolution() and query() with coarser levels of blocks.
+void
+geomodelgrids::serial::TestModel::testTargetResolution(void) {
+    Model model;
+    model.open("../../data/three-blocks-topo-levels.h5", Model::READ);
+    model.loadMetadata();
+
+    const std::vector<std::shared_ptr<Block> >& blocks = model.getBlocks();
+    const size_t numBlocks = 3;
+    REQUIRE(numBlocks == blocks.size());
+    const std::vector<size_t> levelsE[numBlocks] = { {2, 4}, {2}, {2, 4} };
+    for (size_t i = 0; i < numBlocks; ++i) {
+        INFO("Block '" << blocks[i]->getName() << "'.");
+        CHECK(levelsE[i] == blocks[i]->getLevels());
+        CHECK(size_t(1) == blocks[i]->getLevel());
+    } // for
+    CHECK_THROWS_AS(blocks[1]->setLevel(model._h5.get(), 4), std::invalid_argument);
+
+    { // Coarsest levels with resolution at least as fine as 40 km.
+        model.setTargetResolution(40.0e+3);
+        const size_t levelE[numBlocks] = { 4, 2, 1 };
+        const char* const pathE[numBlocks] = { "levels/top/4", "levels/middle/2", "blocks/bottom" };
+        for (size_t i = 0; i < numBlocks; ++i) {
+            INFO("Block '" << blocks[i]->getName() << "'.");
+            CHECK(levelE[i] == blocks[i]->getLevel());
+            CHECK(std::string(pathE[i]) == blocks[i]->getPath());
+        } // for
+        CHECK(20.0e+3 == blocks[0]->getResolutionX());
+        CHECK(40.0e+3 == blocks[0]->getResolutionY());
+        CHECK(40.0e+3 == blocks[0]->getResolutionHoriz());
+        CHECK(size_t(4) == blocks[0]->getDims()[1]);
+    } // Coarsest levels with resolution at least as fine as 40 km.
+
+    { // Full resolution.
+        model.setTargetResolution(0.0);
+        for (size_t i = 0; i < numBlocks; ++i) {
+            CHECK(size_t(1) == blocks[i]->getLevel());
+        } // for
+        CHECK(10.0e+3 == blocks[0]->getResolutionY());
+        CHECK(size_t(13) == blocks[0]->getDims()[1]);
+    } // Full resolution.
+
+    // Coarsest levels. Model values vary linearly, so queries of the levels are exact.
+    model.setTargetResolution(1.0e+6);
+    const size_t levelE[numBlocks] = { 4, 2, 4 };
+    for (size_t i = 0; i < numBlocks; ++i) {
+        CHECK(levelE[i] == blocks[i]->getLevel());
+    } // for
+    model.initialize();
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const size_t spaceDim = 3;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double* values = model.query(pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1], pointsLLE[iPt*spaceDim+2]);
+
+        const double x = pointsXYZ[iPt*spaceDim+0];
+        const double y = pointsXYZ[iPt*spaceDim+1];
+        const double z = pointsXYZ[iPt*spaceDim+2];
+
+        const double tolerance = 1.0e-5;
+        { // Value 0
+            const double valueE = points.computeValueOne(x, y, z);
+
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for value 0.");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[0], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // Value 0
+
+        { // Value 1
+            const double valueE = points.computeValueTwo(x, y, z);
+
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for value 1.");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // Value 1
+    } // for
+} // testTargetResolution
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryColumn().
+void
+geomodelgrids::serial::TestModel::testQueryColumn(void) {
+    Model model;
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+
+    geomodelgrids::testdata::ThreeBlocksTopoBorehole points;
+    const size_t spaceDim = 3;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+
+    // Points in borehole plus one point above the ground surface and one below the bottom.
+    const size_t numPointsBorehole = points.getNumPoints();
+    const size_t numPoints = numPointsBorehole + 2;
+    std::vector<double> elevations(numPoints);
+    for (size_t iPt = 0; iPt < numPointsBorehole; ++iPt) {
+        elevations[iPt] = pointsLLE[iPt*spaceDim+2];
+    } // for
+    elevations[numPointsBorehole+0] = +1.0e+3;
+    elevations[numPointsBorehole+1] = -1.0e+5;
+
+    const size_t numValues = model.getValueNames().size();
+    std::vector<double> values(numPoints*numValues);
+    std::unique_ptr<bool[]> inModel(new bool[numPoints]);
+    const size_t numInModel = model.queryColumn(values.data(), inModel.get(), pointsLLE[0], pointsLLE[1],
+                                                elevations.data(), numPoints);
+    CHECK(numPointsBorehole == numInModel);
+    CHECK(!inModel[numPointsBorehole+0]);
+    CHECK(!inModel[numPointsBorehole+1]);
+
+    const double tolerance = 1.0e-5;
+    for (size_t iPt = 0; iPt < numPointsBorehole; ++iPt) {
+        REQUIRE(inModel[iPt]);
+
+        const double x = pointsXYZ[iPt*spaceDim+0];
+        const double y = pointsXYZ[iPt*spaceDim+1];
+        const double z = pointsXYZ[iPt*spaceDim+2];
+
+        { // Value 0
+            const double valueE = points.computeValueOne(x, y, z);
+
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for value 0.");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[iPt*numValues+0], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // Value 0
+
+        { // Value 1
+            const double valueE = points.computeValueTwo(x, y, z);
+
+            INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                        << ", " << pointsLLE[iPt*spaceDim+2] << ") for value 1.");
+            const double valueTolerance = std::max(tolerance, tolerance*fabs(valueE));
+            CHECK_THAT(values[iPt*numValues+1], Catch::Matchers::WithinAbs(valueE, valueTolerance));
+        } // Value 1
+    } // for
+
+    // Location outside model.
+    CHECK(size_t(0) == model.queryColumn(values.data(), inModel.get(), 35.1, 97.7, elevations.data(), numPoints));
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        CHECK(!inModel[iPt]);
+    } // for
+} // testQueryColumn
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryNodeElevations().
+void
+geomodelgrids::serial::TestModel::testQueryNodeElevations(void) {
+    Model model;
+    model.open("../../data/three-blocks-topo.h5", Model::READ);
+    model.loadMetadata();
+    model.initialize();
+
+    geomodelgrids::testdata::ThreeBlocksTopoBorehole points;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+    const double zTop = points.computeTopElevation(pointsXYZ[0], pointsXYZ[1]);
+    const double zBottom = points.getDomain().zBottom;
+
+    // Grid points of blocks 'top', 'middle', and 'bottom' with shared points at block interfaces.
+    const size_t numNodes = 6;
+    const double zModelE[numNodes] = { 0.0, -5.0e+3, -15.0e+3, -25.0e+3, -35.0e+3, -45.0e+3 };
+
+    const std::vector<double>& elevations = model.queryNodeElevations(pointsLLE[0], pointsLLE[1]);
+    REQUIRE(numNodes == elevations.size());
+    const double tolerance = 1.0e-6;
+    for (size_t i = 0; i < numNodes; ++i) {
+        const double elevationE = zTop - zModelE[i] * (zTop - zBottom) / zBottom;
+        INFO("Mismatch for grid point " << i << ".");
+        const double valueTolerance = std::max(tolerance, tolerance*fabs(elevationE));
+        CHECK_THAT(elevations[i], Catch::Matchers::WithinAbs(elevationE, valueTolerance));
+    } // for
+
+    // Location outside model.
+    CHECK(model.queryNodeElevations(35.1, 97.7).empty());
+} // testQueryNodeElevations
+
+
 // End of file
@@ -0,0 +1,330 @@
+/**
+ * C++ unit testing of geomodelgrids::serial::ModelImage.
+ */
+
+#include <portinfo>
+
+#include "tests/data/ModelPoints.hh" // USES ModelPoints
+
+#include "geomodelgrids/serial/ModelImage.hh" // Test subject
+#include "geomodelgrids/serial/Model.hh" // USES Model
+#include "geomodelgrids/serial/Block.hh" // USES Block
+#include "geomodelgrids/serial/Surface.hh" // USES Surface
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include <unistd.h> // USES unlink(), symlink(), chown(), geteuid()
+#include <sys/stat.h> // USES utimensat(), stat(), chmod()
+#include <fcntl.h> // USES AT_FDCWD
+#include <cstdio> // USES rename()
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <cstdlib> // USES setenv(), unsetenv()
+#include <vector> // USES std::vector
+#include <cmath> // USES fabs()
+
+namespace geomodelgrids {
+    namespace serial {
+        class TestModelImage;
+    } // serial
+} // geomodelgrids
+
+class geomodelgrids::serial::TestModelImage {
+    // PUBLIC METHODS -----------------------------------------------------------------------------
+public:
+
+    /// Test constructor.
+    static
+    void testConstructor(void);
+
+    /// Test getImagePath().
+    static
+    void testGetImagePath(void);
+
+    /// Test write(), open(), getValues(), and close().
+    static
+    void testWriteOpen(void);
+
+    /// Test open() after model file changes.
+    static
+    void testOpenChanged(void);
+
+    /// Test open() with images that cannot be trusted.
+    static
+    void testOpenUntrusted(void);
+
+    /// Test Model::open() and query() with model image.
+    static
+    void testModelQuery(void);
+
+}; // class TestModelImage
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestModelImage::testConstructor", "[TestModelImage]") {
+    geomodelgrids::serial::TestModelImage::testConstructor();
+}
+TEST_CASE("TestModelImage::testGetImagePath", "[TestModelImage]") {
+    geomodelgrids::serial::TestModelImage::testGetImagePath();
+}
+TEST_CASE("TestModelImage::testWriteOpen", "[TestModelImage]") {
+    geomodelgrids::serial::TestModelImage::testWriteOpen();
+}
+TEST_CASE("TestModelImage::testOpenChanged", "[TestModelImage]") {
+    geomodelgrids::serial::TestModelImage::testOpenChanged();
+}
+TEST_CASE("TestModelImage::testOpenUntrusted", "[TestModelImage]") {
+    geomodelgrids::serial::TestModelImage::testOpenUntrusted();
+}
+TEST_CASE("TestModelImage::testModelQuery", "[TestModelImage]") {
+    geomodelgrids::serial::TestModelImage::testModelQuery();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor.
+void
+geomodelgrids::serial::TestModelImage::testConstructor(void) {
+    ModelImage image;
+
+    CHECK(!image._data);
+    CHECK(0 == image._size);
+    CHECK(!image.getValues("blocks/block", 1));
+} // testConstructor
+
+
+// ------------------------------------------------------------------------------------------------
+// Test getImagePath().
+void
+geomodelgrids::serial::TestModelImage::testGetImagePath(void) {
+    const char* filename = "../../data/one-block-flat.h5";
+
+    const std::string& path = ModelImage::getImagePath(filename, "/tmp");
+    CHECK(0 == path.find("/tmp/geomodelgrids-one-block-flat.h5-"));
+
+    // Same model file gives the same path; different model files give different paths.
+    CHECK(path == ModelImage::getImagePath(filename, "/tmp"));
+    CHECK(path != ModelImage::getImagePath("../../data/one-block-topo.h5", "/tmp"));
+
+    // Empty directory disables images.
+    CHECK(ModelImage::getImagePath(filename, "").empty());
+
+    // Directory from environment.
+    setenv("GEOMODELGRIDS_IMAGE_DIR", "/tmp", 1);
+    CHECK(path == ModelImage::getImagePath(filename));
+    unsetenv("GEOMODELGRIDS_IMAGE_DIR");
+    CHECK(0 == ModelImage::getImagePath(filename).find("/dev/shm/"));
+} // testGetImagePath
+
+
+// ------------------------------------------------------------------------------------------------
+// Test write(), open(), getValues(), and close().
+void
+geomodelgrids::serial::TestModelImage::testWriteOpen(void) {
+    const char* filename = "../../data/three-blocks-topo.h5";
+    const std::string& imagePath = ModelImage::getImagePath(filename, ".");
+
+    Model model;
+    model.open(filename, Model::READ);
+    model.loadMetadata();
+    model.initialize();
+    const size_t numBytes = ModelImage::write(imagePath.c_str(), filename, model);
+    CHECK(numBytes > 0);
+
+    ModelImage image;
+    REQUIRE(image.open(imagePath.c_str(), filename));
+    CHECK(numBytes == image._size);
+
+    const std::vector<std::shared_ptr<Block> >& blocks = model.getBlocks();
+    for (size_t iBlock = 0; iBlock < blocks.size(); ++iBlock) {
+        const size_t* dims = blocks[iBlock]->getDims();
+        const size_t numValues = dims[0] * dims[1] * dims[2] * blocks[iBlock]->getNumValues();
+        const std::string& name = std::string("blocks/") + blocks[iBlock]->getName();
+        const double* values = image.getValues(name.c_str(), numValues);
+        REQUIRE(values);
+
+        std::vector<double> valuesE(numValues);
+        blocks[iBlock]->readValues(valuesE.data(), 0, dims[0]);
+        for (size_t i = 0; i < numValues; ++i) {
+            REQUIRE(valuesE[i] == values[i]);
+        } // for
+
+        CHECK(!image.getValues(name.c_str(), numValues+1));
+    } // for
+    REQUIRE(model.getTopSurface());
+    const size_t* dims = model.getTopSurface()->getDims();
+    CHECK(image.getValues("surfaces/top_surface", dims[0]*dims[1]));
+    CHECK(!image.getValues("blocks/none", 1));
+
+    image.close();
+    CHECK(!image._data);
+
+    // Image does not match other model files.
+    CHECK(!image.open(imagePath.c_str(), "../../data/one-block-flat.h5"));
+    CHECK(!image._data);
+
+    // Missing image.
+    CHECK(!image.open("nonexistent.img", filename));
+
+    model.close();
+    unlink(imagePath.c_str());
+} // testWriteOpen
+
+
+// ------------------------------------------------------------------------------------------------
+// Test open() after model file changes.
+void
+geomodelgrids::serial::TestModelImage::testOpenChanged(void) {
+    const char* filename = "model-image-changed.h5";
+    const char* filenameTmp = "model-image-changed.h5.tmp";
+    { // Copy model file.
+        std::ifstream fin("../../data/one-block-flat.h5", std::ios::binary);
+        std::ofstream fout(filename, std::ios::binary);
+        fout << fin.rdbuf();
+    } // Copy model file.
+    const std::string& imagePath = ModelImage::getImagePath(filename, ".");
+
+    struct timespec times[2];
+    times[0].tv_sec = 1600000000;
+    times[0].tv_nsec = 0;
+    times[1].tv_sec = 1600000000;
+    times[1].tv_nsec = 100;
+    REQUIRE(0 == utimensat(AT_FDCWD, filename, times, 0));
+
+    { // Write image
+        Model model;
+        model.open(filename, Model::READ);
+        model.loadMetadata();
+        model.initialize();
+        ModelImage::write(imagePath.c_str(), filename, model);
+    } // Write image
+
+    ModelImage image;
+    CHECK(image.open(imagePath.c_str(), filename));
+
+    // Modification time differs only in nanoseconds.
+    times[1].tv_nsec = 200;
+    REQUIRE(0 == utimensat(AT_FDCWD, filename, times, 0));
+    CHECK(!image.open(imagePath.c_str(), filename));
+    times[1].tv_nsec = 100;
+    REQUIRE(0 == utimensat(AT_FDCWD, filename, times, 0));
+    CHECK(image.open(imagePath.c_str(), filename));
+
+    // Model file replaced by file with same size and modification time (different inode).
+    struct stat fileStat;
+    REQUIRE(0 == stat(filename, &fileStat));
+    { // Copy model file.
+        std::ifstream fin(filename, std::ios::binary);
+        std::ofstream fout(filenameTmp, std::ios::binary);
+        fout << fin.rdbuf();
+    } // Copy model file.
+    REQUIRE(0 == utimensat(AT_FDCWD, filenameTmp, times, 0));
+    REQUIRE(0 == rename(filenameTmp, filename));
+    struct stat fileStatNew;
+    REQUIRE(0 == stat(filename, &fileStatNew));
+    CHECK(fileStat.st_size == fileStatNew.st_size);
+    CHECK(fileStat.st_ino != fileStatNew.st_ino);
+    CHECK(!image.open(imagePath.c_str(), filename));
+
+    image.close();
+    unlink(imagePath.c_str());
+    unlink(filename);
+} // testOpenChanged
+
+
+// ------------------------------------------------------------------------------------------------
+// Test open() with images that cannot be trusted.
+void
+geomodelgrids::serial::TestModelImage::testOpenUntrusted(void) {
+    const char* filename = "../../data/one-block-flat.h5";
+    const std::string& imagePath = ModelImage::getImagePath(filename, ".");
+    const std::string linkPath = imagePath + ".link";
+
+    { // Write image
+        Model model;
+        model.open(filename, Model::READ);
+        model.loadMetadata();
+        model.initialize();
+        ModelImage::write(imagePath.c_str(), filename, model);
+    } // Write image
+
+    struct stat imageStat;
+    REQUIRE(0 == stat(imagePath.c_str(), &imageStat));
+    CHECK((S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) == (imageStat.st_mode & 0777));
+
+    ModelImage image;
+    CHECK(image.open(imagePath.c_str(), filename));
+
+    // Image writable by others.
+    REQUIRE(0 == chmod(imagePath.c_str(), 0666));
+    CHECK(!image.open(imagePath.c_str(), filename));
+    REQUIRE(0 == chmod(imagePath.c_str(), 0644));
+    CHECK(image.open(imagePath.c_str(), filename));
+
+    // Symbolic link to image.
+    unlink(linkPath.c_str());
+    REQUIRE(0 == symlink(imagePath.c_str(), linkPath.c_str()));
+    CHECK(!image.open(linkPath.c_str(), filename));
+    unlink(linkPath.c_str());
+
+    // Image owned by another user (requires privileges to change owner).
+    if (0 == geteuid()) {
+        REQUIRE(0 == chown(imagePath.c_str(), 12345, -1));
+        CHECK(!image.open(imagePath.c_str(), filename));
+    } // if
+
+    image.close();
+    unlink(imagePath.c_str());
+} // testOpenUntrusted
+
+
+// ------------------------------------------------------------------------------------------------
+// Test Model::open() and query() with model image.
+void
+geomodelgrids::serial::TestModelImage::testModelQuery(void) {
+    const char* filename = "../../data/three-blocks-topo.h5";
+    const std::string& imagePath = ModelImage::getImagePath(filename, ".");
+
+    { // Write image
+        Model model;
+        model.open(filename, Model::READ);
+        model.loadMetadata();
+        model.initialize();
+        ModelImage::write(imagePath.c_str(), filename, model);
+    } // Write image
+
+    setenv("GEOMODELGRIDS_IMAGE_DIR", ".", 1);
+    Model model;
+    model.open(filename, Model::READ);
+    CHECK(model.hasImage());
+    model.loadMetadata();
+    model.initialize();
+    unsetenv("GEOMODELGRIDS_IMAGE_DIR");
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints points;
+    const size_t numPoints = points.getNumPoints();
+    const size_t spaceDim = 3;
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+
+    const double tolerance = 1.0e-5;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        const double* values = model.query(pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1], pointsLLE[iPt*spaceDim+2]);
+
+        const double x = pointsXYZ[iPt*spaceDim+0];
+        const double y = pointsXYZ[iPt*spaceDim+1];
+        const double z = pointsXYZ[iPt*spaceDim+2];
+
+        INFO("Mismatch for point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                    << ", " << pointsLLE[iPt*spaceDim+2] << ").");
+        const double valueOneE = points.computeValueOne(x, y, z);
+        CHECK_THAT(values[0], Catch::Matchers::WithinAbs(valueOneE, std::max(tolerance, tolerance*fabs(valueOneE))));
+        const double valueTwoE = points.computeValueTwo(x, y, z);
+        CHECK_THAT(values[1], Catch::Matchers::WithinAbs(valueTwoE, std::max(tolerance, tolerance*fabs(valueTwoE))));
+    } // for
+
+    model.close();
+    CHECK(!model.hasImage());
+    unlink(imagePath.c_str());
+} // testModelQuery
+
+
+// End of file
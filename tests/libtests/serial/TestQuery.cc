@@ -8,6 +8,7 @@
 
 #include "geomodelgrids/serial/Query.hh" // USES Query
 #include "geomodelgrids/utils/constants.hh" // USES NODATA_VALUE
+#include "geomodelgrids/utils/ErrorHandler.hh" // USES ErrorHandler
 
 #include "catch2/catch_test_macros.hpp"
 #include "catch2/matchers/catch_matchers_floating_point.hpp"
@@ -56,6 +57,22 @@ public:
     static
     void testQuerySquashTop(void);
 
+    /// Test queryProfile().
+    static
+    void testQueryProfile(void);
+
+    /// Test queryNodeElevations().
+    static
+    void testQueryNodeElevations(void);
+
+    /// Test queryGrid().
+    static
+    void testQueryGrid(void);
+
+    /// Test preloadRegion().
+    static
+    void testPreloadRegion(void);
+
     /// Test query() for model using topography/bathymetry for squashing.
     static
     void testQuerySquashTopoBathy(void);
@@ -90,6 +107,18 @@ TEST_CASE("TestQuery::testQuerySquashTop", "[TestQuery]") {
 TEST_CASE("TestQuery::testQuerySquashTopoBathy", "[TestQuery]") {
     geomodelgrids::serial::TestQuery::testQuerySquashTopoBathy();
 }
+TEST_CASE("TestQuery::testQueryProfile", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryProfile();
+}
+TEST_CASE("TestQuery::testQueryNodeElevations", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryNodeElevations();
+}
+TEST_CASE("TestQuery::testQueryGrid", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testQueryGrid();
+}
+TEST_CASE("TestQuery::testPreloadRegion", "[TestQuery]") {
+    geomodelgrids::serial::TestQuery::testPreloadRegion();
+}
 
 // ------------------------------------------------------------------------------------------------
 // Test constructor.
@@ -695,4 +724,263 @@ geomodelgrids::serial::TestQuery::testQuerySquashTopoBathy(void) {
 } // TestQuerySquash
 
 
+// ------------------------------------------------------------------------------------------------
+// Test queryProfile().
+void
+geomodelgrids::serial::TestQuery::testQueryProfile(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoBorehole pointsThree;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+
+    const double tolerance = 1.0e-5;
+    { // Three Block Topo
+        const size_t numPoints = pointsThree.getNumPoints();
+        const double* pointsLLE = pointsThree.getLatLonElev();
+        const double* pointsXYZ = pointsThree.getXYZ();
+
+        // Profile includes points in reverse order with small offset below ground surface.
+        std::vector<double> elevations(numPoints);
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            elevations[iPt] = pointsLLE[(numPoints-1-iPt)*spaceDim+2] - 1.0e-6;
+        } // for
+        std::vector<double> values(numPoints*numValues);
+        const int err = query.queryProfile(values.data(), pointsLLE[0], pointsLLE[1], elevations.data(), numPoints);
+        REQUIRE(!err);
+
+        for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+            const size_t iPtE = numPoints-1-iPt;
+            const double x = pointsXYZ[iPtE*spaceDim+0];
+            const double y = pointsXYZ[iPtE*spaceDim+1];
+            const double z = pointsXYZ[iPtE*spaceDim+2];
+            double valuesE[numValues];
+            valuesE[0] = pointsThree.computeValueTwo(x, y, z);
+            valuesE[1] = pointsThree.computeValueOne(x, y, z);
+
+            double valuesPt[numValues];
+            REQUIRE(!query.query(valuesPt, pointsLLE[0], pointsLLE[1], elevations[iPt]));
+
+            for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                INFO("Mismatch at point (" << pointsLLE[iPtE*spaceDim+0] << ", " << pointsLLE[iPtE*spaceDim+1]
+                                           << ", " << pointsLLE[iPtE*spaceDim+2] << ") for value '" << valueNames[iValue]
+                                           << "' in three-blocks-topo.");
+                const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+                CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesPt[iValue], toleranceV));
+            } // for
+        } // for
+    } // Three Block Topo
+
+    { // Profile extending above ground surface and outside domain
+        const size_t numPoints = 3;
+        const double elevations[numPoints] = { 1.0e+4, 0.0, -1.0e+5 };
+        const double* pointsLLE = pointsThree.getLatLonElev();
+        double values[numPoints*numValues];
+        const int err = query.queryProfile(values, pointsLLE[0], pointsLLE[1], elevations, numPoints);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            CHECK(NODATA_VALUE == values[0*numValues+iValue]);
+            CHECK(NODATA_VALUE != values[1*numValues+iValue]);
+            CHECK(NODATA_VALUE == values[2*numValues+iValue]);
+        } // for
+    } // Profile extending above ground surface and outside domain
+
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryProfile(nullptr, 0.0, 0.0, nullptr, 0));
+} // testQueryProfile
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryNodeElevations().
+void
+geomodelgrids::serial::TestQuery::testQueryNodeElevations(void) {
+    const size_t numModels = 1;
+    const char* const filenamesArray[numModels] = {
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "one", "two" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoBorehole points;
+    const std::string& crs = points.getCRSLatLonElev();
+    const double* pointsLLE = points.getLatLonElev();
+    const double* pointsXYZ = points.getXYZ();
+    const double zTop = points.computeTopElevation(pointsXYZ[0], pointsXYZ[1]);
+    const double zTopoBathy = points.computeTopoBathyElevation(pointsXYZ[0], pointsXYZ[1]);
+    const double zBottom = points.getDomain().zBottom;
+    const double squashMinElev = -4.0e+3;
+
+    Query query;
+    query.setSquashMinElev(squashMinElev);
+    query.setSquashing(Query::SQUASH_TOPOGRAPHY_BATHYMETRY);
+    query.initialize(filenames, valueNames, crs);
+
+    // Grid points of blocks in model, unsquashed above the minimum squashing elevation.
+    const size_t numNodes = 6;
+    const double zModelE[numNodes] = { 0.0, -5.0e+3, -15.0e+3, -25.0e+3, -35.0e+3, -45.0e+3 };
+
+    const std::vector<double>& elevations = query.queryNodeElevations(pointsLLE[0], pointsLLE[1]);
+    REQUIRE(numNodes == elevations.size());
+    const double tolerance = 1.0e-6;
+    for (size_t i = 0; i < numNodes; ++i) {
+        double elevationE = zTop - zModelE[i] * (zTop - zBottom) / zBottom;
+        if (elevationE > squashMinElev) {
+            elevationE = (elevationE - zTopoBathy) * squashMinElev / (squashMinElev - zTopoBathy);
+        } // if
+        INFO("Mismatch for grid point " << i << ".");
+        const double valueTolerance = std::max(tolerance, tolerance*fabs(elevationE));
+        CHECK_THAT(elevations[i], Catch::Matchers::WithinAbs(elevationE, valueTolerance));
+    } // for
+
+    // Location outside models.
+    CHECK(query.queryNodeElevations(35.1, 97.7).empty());
+} // testQueryNodeElevations
+
+
+// ------------------------------------------------------------------------------------------------
+// Test queryGrid().
+void
+geomodelgrids::serial::TestQuery::testQueryGrid(void) {
+    const size_t numModels = 2;
+    const char* const filenamesArray[numModels] = {
+        "../../data/one-block-topo.h5",
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const double* pointsLLE = pointsThree.getLatLonElev();
+
+    Query query;
+    query.initialize(filenames, valueNames, crs);
+
+    // Grid extends above the ground surface.
+    const double origin[3] = { pointsLLE[0], pointsLLE[1], 5.0e+3 };
+    const double spacing[3] = { 0.02, 0.03, -2.5e+3 };
+    const size_t dims[3] = { 3, 4, 5 };
+    const double azimuth = 30.0;
+    const size_t numPoints = dims[0] * dims[1] * dims[2];
+
+    const double azimuthRad = azimuth * M_PI / 180.0;
+    const double tolerance = 1.0e-5;
+    for (size_t iSquash = 0; iSquash < 2; ++iSquash) {
+        if (iSquash) {
+            query.setSquashMinElev(-4.0e+3);
+        } // if
+
+        std::vector<double> values(numPoints*numValues);
+        const int err = query.queryGrid(values.data(), origin, spacing, dims, azimuth);
+        CHECK(geomodelgrids::utils::ErrorHandler::WARNING == err);
+
+        for (size_t i = 0, iPt = 0; i < dims[0]; ++i) {
+            for (size_t j = 0; j < dims[1]; ++j) {
+                for (size_t k = 0; k < dims[2]; ++k, ++iPt) {
+                    const double x = origin[0] + i*spacing[0]*cos(azimuthRad) + j*spacing[1]*sin(azimuthRad);
+                    const double y = origin[1] - i*spacing[0]*sin(azimuthRad) + j*spacing[1]*cos(azimuthRad);
+                    const double z = origin[2] + k*spacing[2];
+                    double valuesE[numValues];
+                    query.query(valuesE, x, y, z);
+
+                    for (size_t iValue = 0; iValue < numValues; ++iValue) {
+                        INFO("Mismatch at point (" << x << ", " << y << ", " << z << ") for value '"
+                                                   << valueNames[iValue] << "' with squashing " << iSquash << ".");
+                        const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+                        CHECK_THAT(values[iPt*numValues+iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+                    } // for
+                } // for
+            } // for
+        } // for
+    } // for
+
+    // Bad arguments.
+    CHECK(geomodelgrids::utils::ErrorHandler::ERROR == query.queryGrid(nullptr, origin, spacing, dims));
+} // testQueryGrid
+
+
+// ------------------------------------------------------------------------------------------------
+// Test preloadRegion().
+void
+geomodelgrids::serial::TestQuery::testPreloadRegion(void) {
+    const size_t numModels = 1;
+    const char* const filenamesArray[numModels] = {
+        "../../data/three-blocks-topo.h5",
+    };
+    std::vector<std::string> filenames(filenamesArray, filenamesArray+numModels);
+
+    const size_t numValues = 2;
+    const char* const valueNamesArray[numValues] = { "two", "one" };
+    std::vector<std::string> valueNames(valueNamesArray, valueNamesArray+numValues);
+
+    geomodelgrids::testdata::ThreeBlocksTopoPoints pointsThree;
+    const std::string& crs = pointsThree.getCRSLatLonElev();
+    const size_t spaceDim = 3;
+    const size_t numPoints = pointsThree.getNumPoints();
+    const double* pointsLLE = pointsThree.getLatLonElev();
+    const double* pointsXYZ = pointsThree.getXYZ();
+
+    Query query;
+    CHECK_THROWS_AS(query.preloadRegion(0.0, 1.0, 0.0, 1.0, 0.0, 1.0), std::logic_error);
+    query.initialize(filenames, valueNames, crs);
+
+    // Bounding box of points.
+    double bboxMin[spaceDim];
+    double bboxMax[spaceDim];
+    for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+        bboxMin[iDim] = pointsLLE[iDim];
+        bboxMax[iDim] = pointsLLE[iDim];
+        for (size_t iPt = 1; iPt < numPoints; ++iPt) {
+            bboxMin[iDim] = std::min(bboxMin[iDim], pointsLLE[iPt*spaceDim+iDim]);
+            bboxMax[iDim] = std::max(bboxMax[iDim], pointsLLE[iPt*spaceDim+iDim]);
+        } // for
+    } // for
+    query.preloadRegion(bboxMin[0], bboxMax[0], bboxMin[1], bboxMax[1], bboxMin[2], bboxMax[2]);
+
+    const double tolerance = 1.0e-5;
+    for (size_t iPt = 0; iPt < numPoints; ++iPt) {
+        double values[numValues];
+        const int err = query.query(values, pointsLLE[iPt*spaceDim+0], pointsLLE[iPt*spaceDim+1], pointsLLE[iPt*spaceDim+2]);
+        REQUIRE(!err);
+
+        const double x = pointsXYZ[iPt*spaceDim+0];
+        const double y = pointsXYZ[iPt*spaceDim+1];
+        const double z = pointsXYZ[iPt*spaceDim+2];
+        double valuesE[numValues];
+        valuesE[0] = pointsThree.computeValueTwo(x, y, z);
+        valuesE[1] = pointsThree.computeValueOne(x, y, z);
+
+        for (size_t iValue = 0; iValue < numValues; ++iValue) {
+            INFO("Mismatch at point (" << pointsLLE[iPt*spaceDim+0] << ", " << pointsLLE[iPt*spaceDim+1]
+                                       << ", " << pointsLLE[iPt*spaceDim+2] << ") for value '" << valueNames[iValue]
+                                       << "' in three-blocks-topo.");
+            const double toleranceV = std::max(tolerance, tolerance*fabs(valuesE[iValue]));
+            CHECK_THAT(values[iValue], Catch::Matchers::WithinAbs(valuesE[iValue], toleranceV));
+        } // for
+    } // for
+
+    // Clear region.
+    query.preloadRegion(1.0, 0.0, 1.0, 0.0, 1.0, 0.0);
+    query.finalize();
+} // testPreloadRegion
+
+
 // End of file
@@ -189,6 +189,7 @@ geomodelgrids::serial::TestSurface::testQuery(void) {
     surf.loadMetadata(&h5);
 
     surf.openQuery(&h5);
+    CHECK(!surf._hyperslab);
     for (size_t i = 0; i < npoints; ++i) {
         const double tolerance = 1.0e-6;
         const double x = xy[i*spaceDim+0];
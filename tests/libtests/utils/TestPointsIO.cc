@@ -0,0 +1,336 @@
+/**
+ * C++ unit testing of geomodelgrids::utils::PointsReader and geomodelgrids::utils::PointsWriter.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/utils/PointsReader.hh" // USES PointsReader
+#include "geomodelgrids/utils/PointsWriter.hh" // USES PointsWriter
+
+#include "catch2/catch_test_macros.hpp"
+#include "catch2/matchers/catch_matchers_floating_point.hpp"
+
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <sstream> // USES std::ostringstream
+#include <iomanip> // USES std::setw(), std::setprecision()
+#include <vector> // USES std::vector
+#include <cmath> // USES fabs()
+
+namespace geomodelgrids {
+    namespace utils {
+        class TestPointsIO;
+    } // utils
+} // geomodelgrids
+
+class geomodelgrids::utils::TestPointsIO {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test parseFormat().
+    static
+    void testParseFormat(void);
+
+    /// Test writing and reading text files.
+    static
+    void testText(void);
+
+    /// Test reading text files with column selection.
+    static
+    void testTextColumns(void);
+
+    /// Test text formatting matches stream formatting.
+    static
+    void testTextFormat(void);
+
+    /// Test writing and reading raw float64 files.
+    static
+    void testRawFloat64(void);
+
+    /// Test writing and reading raw float32 files.
+    static
+    void testRawFloat32(void);
+
+    /// Test writing and reading NumPy .npy files.
+    static
+    void testNpy(void);
+
+    /// Test writing and reading HDF5 files.
+    static
+    void testHDF5(void);
+
+    /// Test reading files with errors.
+    static
+    void testReadErrors(void);
+
+    /** Write rows and read back selected columns.
+     *
+     * @param[in] filename Name of file.
+     * @param[in] format Format of file.
+     * @param[in] tolerance Relative tolerance for values.
+     */
+    static
+    void _checkRoundTrip(const char* filename,
+                         const PointsReader::FormatEnum format,
+                         const double tolerance);
+
+}; // class TestPointsIO
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestPointsIO::testParseFormat", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testParseFormat();
+}
+TEST_CASE("TestPointsIO::testText", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testText();
+}
+TEST_CASE("TestPointsIO::testTextColumns", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testTextColumns();
+}
+TEST_CASE("TestPointsIO::testTextFormat", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testTextFormat();
+}
+TEST_CASE("TestPointsIO::testRawFloat64", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testRawFloat64();
+}
+TEST_CASE("TestPointsIO::testRawFloat32", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testRawFloat32();
+}
+TEST_CASE("TestPointsIO::testNpy", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testNpy();
+}
+TEST_CASE("TestPointsIO::testHDF5", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testHDF5();
+}
+TEST_CASE("TestPointsIO::testReadErrors", "[TestPointsIO]") {
+    geomodelgrids::utils::TestPointsIO::testReadErrors();
+}
+
+// ------------------------------------------------------------------------------------------------
+namespace geomodelgrids {
+    namespace utils {
+        namespace _TestPointsIO {
+            static const size_t numRows = 5;
+            static const size_t numColumns = 4;
+            static const double rows[numRows*numColumns] = {
+                37.455, -121.941, 0.0, 1.0,
+                37.479, -121.734, -5.0e+3, 2.0,
+                37.381, -121.581, -3.0e+3, 3.0,
+                37.283, -121.959, -1.5e+3, 4.0,
+                37.262, -121.684, -4.0e+3, 5.0,
+            };
+        } // _TestPointsIO
+    } // utils
+} // geomodelgrids
+
+// ------------------------------------------------------------------------------------------------
+// Test parseFormat().
+void
+geomodelgrids::utils::TestPointsIO::testParseFormat(void) {
+    CHECK(PointsReader::TEXT == PointsReader::parseFormat("text"));
+    CHECK(PointsReader::RAW_FLOAT64 == PointsReader::parseFormat("raw64"));
+    CHECK(PointsReader::RAW_FLOAT32 == PointsReader::parseFormat("raw32"));
+    CHECK(PointsReader::NPY == PointsReader::parseFormat("npy"));
+    CHECK(PointsReader::HDF5 == PointsReader::parseFormat("hdf5"));
+    CHECK_THROWS_AS(PointsReader::parseFormat("csv"), std::invalid_argument);
+} // testParseFormat
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading text files.
+void
+geomodelgrids::utils::TestPointsIO::testText(void) {
+    PointsWriter writer;
+    writer.setHeader("# header\n");
+    writer.open("points.txt", PointsReader::TEXT, 3);
+    const double row[3] = { 1.0, -2.5, 3.0e+4 };
+    writer.write(row, 1);
+    writer.close();
+
+    std::ifstream sin("points.txt");
+    std::string header, line;
+    std::getline(sin, header);
+    std::getline(sin, line);
+    CHECK(std::string("# header") == header);
+    CHECK(std::string("  1.000000e+00 -2.500000e+00  3.000000e+04") == line);
+    sin.close();
+
+    _checkRoundTrip("points.txt", PointsReader::TEXT, 1.0e-6);
+} // testText
+
+
+// ------------------------------------------------------------------------------------------------
+// Test reading text files with column selection.
+void
+geomodelgrids::utils::TestPointsIO::testTextColumns(void) {
+    std::ofstream sout("points_columns.txt");
+    sout << "# x y z\n"
+         << "1.0 2.0 3.0 4.0\n"
+         << "\n"
+         << "5.0 6.0 7.0 8.0\r\n"
+         << "  # comment\n"
+         << "9.0 1.0e+1 1.1e+1 1.2e+1"; // no trailing newline
+    sout.close();
+
+    PointsReader reader;
+    reader.setColumns(std::vector<size_t>({ 3, 0, 1 }));
+    reader.open("points_columns.txt", PointsReader::TEXT, 3);
+    double points[2*3];
+    REQUIRE(size_t(2) == reader.read(points, 2));
+    CHECK(4.0 == points[0]);
+    CHECK(1.0 == points[1]);
+    CHECK(2.0 == points[2]);
+    CHECK(8.0 == points[3]);
+    CHECK(5.0 == points[4]);
+    CHECK(6.0 == points[5]);
+    REQUIRE(size_t(1) == reader.read(points, 2));
+    CHECK(12.0 == points[0]);
+    CHECK(9.0 == points[1]);
+    CHECK(10.0 == points[2]);
+    CHECK(size_t(0) == reader.read(points, 2));
+} // testTextColumns
+
+
+// ------------------------------------------------------------------------------------------------
+// Test text formatting matches stream formatting.
+void
+geomodelgrids::utils::TestPointsIO::testTextFormat(void) {
+    const size_t numValues = 8;
+    const double values[numValues] = { 0.0, -0.0, 1.0e-300, -2.5e+300, 3.14159265, -123456.789, 9.9999995e+9, 1.0e+99 };
+    const int width = 16;
+    const int precision = 8;
+
+    PointsWriter writer;
+    writer.setTextFormat(width, precision);
+    writer.open("points_format.txt", PointsReader::TEXT, 2);
+    writer.write(values, numValues/2);
+    writer.close();
+
+    std::ostringstream lineE;
+    lineE << std::scientific << std::setprecision(precision);
+    for (size_t i = 0; i < numValues; ++i) {
+        lineE << std::setw(width) << values[i];
+        if (1 == i % 2) { lineE << "\n"; }
+    } // for
+
+    std::ifstream sin("points_format.txt");
+    std::ostringstream contents;
+    contents << sin.rdbuf();
+    CHECK(lineE.str() == contents.str());
+} // testTextFormat
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading raw float64 files.
+void
+geomodelgrids::utils::TestPointsIO::testRawFloat64(void) {
+    _checkRoundTrip("points.raw64", PointsReader::RAW_FLOAT64, 0.0);
+} // testRawFloat64
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading raw float32 files.
+void
+geomodelgrids::utils::TestPointsIO::testRawFloat32(void) {
+    _checkRoundTrip("points.raw32", PointsReader::RAW_FLOAT32, 1.0e-7);
+} // testRawFloat32
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading NumPy .npy files.
+void
+geomodelgrids::utils::TestPointsIO::testNpy(void) {
+    _checkRoundTrip("points.npy", PointsReader::NPY, 0.0);
+
+    // Header length must align data to 64 bytes.
+    std::ifstream sin("points.npy", std::ios::binary);
+    char preamble[10];
+    sin.read(preamble, sizeof(preamble));
+    const size_t headerLength = size_t((unsigned char)preamble[8]) + 256*size_t((unsigned char)preamble[9]);
+    CHECK(size_t(0) == (10 + headerLength) % 64);
+    std::string header(headerLength, ' ');
+    sin.read(&header[0], headerLength);
+    CHECK(std::string::npos != header.find("'shape': (5, 4)"));
+} // testNpy
+
+
+// ------------------------------------------------------------------------------------------------
+// Test writing and reading HDF5 files.
+void
+geomodelgrids::utils::TestPointsIO::testHDF5(void) {
+    _checkRoundTrip("points.h5", PointsReader::HDF5, 0.0);
+} // testHDF5
+
+
+// ------------------------------------------------------------------------------------------------
+// Test reading files with errors.
+void
+geomodelgrids::utils::TestPointsIO::testReadErrors(void) {
+    PointsReader reader;
+    CHECK_THROWS_AS(reader.open("blah/points.txt", PointsReader::TEXT, 3), std::runtime_error);
+    CHECK_THROWS_AS(reader.open("blah/points.raw64", PointsReader::RAW_FLOAT64, 3), std::runtime_error);
+
+    // Size is not a multiple of row size.
+    std::ofstream sout("points_bad.raw64", std::ios::binary);
+    const double values[4] = { 1.0, 2.0, 3.0, 4.0 };
+    sout.write((const char*)values, sizeof(values));
+    sout.close();
+    CHECK_THROWS_AS(reader.open("points_bad.raw64", PointsReader::RAW_FLOAT64, 3), std::runtime_error);
+
+    // Not a .npy file.
+    CHECK_THROWS_AS(reader.open("points_bad.raw64", PointsReader::NPY, 3), std::runtime_error);
+
+    // Wrong number of columns selected.
+    reader.setColumns(std::vector<size_t>({ 0, 1 }));
+    CHECK_THROWS_AS(reader.open("points_bad.raw64", PointsReader::RAW_FLOAT64, 3), std::length_error);
+} // testReadErrors
+
+
+// ------------------------------------------------------------------------------------------------
+// Write rows and read back selected columns.
+void
+geomodelgrids::utils::TestPointsIO::_checkRoundTrip(const char* filename,
+                                                   const PointsReader::FormatEnum format,
+                                                   const double tolerance) {
+    const size_t numRows = _TestPointsIO::numRows;
+    const size_t numColumns = _TestPointsIO::numColumns;
+    const double* rows = _TestPointsIO::rows;
+
+    PointsWriter writer;
+    writer.setColumnNames(std::vector<std::string>({ "x", "y", "z", "id" }));
+    writer.open(filename, format, numColumns);
+    writer.write(&rows[0], 2);
+    writer.write(&rows[2*numColumns], numRows-2);
+    writer.close();
+
+    const size_t spaceDim = 3;
+    const size_t columns[spaceDim] = { 3, 0, 2 };
+    PointsReader reader;
+    reader.setColumns(std::vector<size_t>(columns, columns+spaceDim));
+    reader.setNumColumns(numColumns);
+    reader.setDataset("/values");
+    reader.open(filename, format, spaceDim);
+    if (PointsReader::TEXT != format) {
+        CHECK(numRows == reader.getNumPoints());
+    } // if
+
+    // Read in batches smaller than the number of rows.
+    std::vector<double> points(numRows*spaceDim);
+    size_t numRead = 0;
+    while (true) {
+        const size_t n = reader.read(&points[numRead*spaceDim], std::min(size_t(2), numRows-numRead));
+        if (!n) { break; }
+        numRead += n;
+    } // while
+    reader.close();
+    REQUIRE(numRows == numRead);
+
+    for (size_t iRow = 0; iRow < numRows; ++iRow) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            const double valueE = rows[iRow*numColumns+columns[iDim]];
+            INFO("Mismatch in row " << iRow << ", column " << columns[iDim] << ".");
+            CHECK_THAT(points[iRow*spaceDim+iDim], Catch::Matchers::WithinAbs(valueE, tolerance*fabs(valueE)));
+        } // for
+    } // for
+} // _checkRoundTrip
+
+
+// End of file
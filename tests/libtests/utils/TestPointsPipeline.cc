@@ -0,0 +1,241 @@
+/**
+ * C++ unit testing of geomodelgrids::utils::PointsPipeline.
+ */
+
+#include <portinfo>
+
+#include "geomodelgrids/utils/PointsPipeline.hh" // USES PointsPipeline
+#include "geomodelgrids/utils/PointsReader.hh" // USES PointsReader
+#include "geomodelgrids/utils/PointsWriter.hh" // USES PointsWriter
+
+#include "catch2/catch_test_macros.hpp"
+
+#include <sys/stat.h> // USES mkfifo()
+#include <unistd.h> // USES unlink()
+
+#include <thread> // USES std::thread
+#include <fstream> // USES std::ofstream
+#include <vector> // USES std::vector
+#include <stdexcept> // USES std::runtime_error
+
+namespace geomodelgrids {
+    namespace utils {
+        class TestPointsPipeline;
+    } // utils
+} // geomodelgrids
+
+class geomodelgrids::utils::TestPointsPipeline {
+    // PUBLIC METHODS /////////////////////////////////////////////////////////////////////////////
+public:
+
+    /// Test constructor and accessors.
+    static
+    void testAccessors(void);
+
+    /// Test run() with multiple workers.
+    static
+    void testRun(void);
+
+    /// Test run() with points from a named pipe.
+    static
+    void testRunFifo(void);
+
+    /// Test run() with exception in worker.
+    static
+    void testRunError(void);
+
+    /** Write points to text file.
+     *
+     * @param[in] filename Name of file.
+     * @param[in] numPoints Number of points.
+     */
+    static
+    void _writePoints(const char* filename,
+                      const size_t numPoints);
+
+    /** Run pipeline and check output.
+     *
+     * @param[in] filename Name of points file.
+     * @param[in] numPoints Number of points in file.
+     * @param[in] numWorkers Number of worker threads.
+     */
+    static
+    void _checkRun(const char* filename,
+                   const size_t numPoints,
+                   const size_t numWorkers);
+
+}; // class TestPointsPipeline
+
+// ------------------------------------------------------------------------------------------------
+TEST_CASE("TestPointsPipeline::testAccessors", "[TestPointsPipeline]") {
+    geomodelgrids::utils::TestPointsPipeline::testAccessors();
+}
+TEST_CASE("TestPointsPipeline::testRun", "[TestPointsPipeline]") {
+    geomodelgrids::utils::TestPointsPipeline::testRun();
+}
+TEST_CASE("TestPointsPipeline::testRunFifo", "[TestPointsPipeline]") {
+    geomodelgrids::utils::TestPointsPipeline::testRunFifo();
+}
+TEST_CASE("TestPointsPipeline::testRunError", "[TestPointsPipeline]") {
+    geomodelgrids::utils::TestPointsPipeline::testRunError();
+}
+
+// ------------------------------------------------------------------------------------------------
+// Test constructor and accessors.
+void
+geomodelgrids::utils::TestPointsPipeline::testAccessors(void) {
+    PointsPipeline pipeline;
+    CHECK(size_t(1) == pipeline._numWorkers);
+    CHECK(size_t(16384) == pipeline._batchSize);
+    CHECK(size_t(0) == pipeline._numBatches);
+    CHECK(size_t(1) == pipeline._rowsPerPoint);
+
+    pipeline.setNumWorkers(4);
+    CHECK(size_t(4) == pipeline.getNumWorkers());
+
+    pipeline.setBatchSize(100);
+    CHECK(size_t(100) == pipeline._batchSize);
+
+    pipeline.setNumBatches(3);
+    CHECK(size_t(3) == pipeline._numBatches);
+
+    pipeline.setRowsPerPoint(5);
+    CHECK(size_t(5) == pipeline._rowsPerPoint);
+
+    CHECK_THROWS_AS(pipeline.setNumWorkers(0), std::invalid_argument);
+    CHECK_THROWS_AS(pipeline.setBatchSize(0), std::invalid_argument);
+    CHECK_THROWS_AS(pipeline.setRowsPerPoint(0), std::invalid_argument);
+} // testAccessors
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with multiple workers.
+void
+geomodelgrids::utils::TestPointsPipeline::testRun(void) {
+    const size_t numPoints = 1000;
+    _writePoints("pipeline_points.txt", numPoints);
+    _checkRun("pipeline_points.txt", numPoints, 1);
+    _checkRun("pipeline_points.txt", numPoints, 4);
+} // testRun
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with points from a named pipe.
+void
+geomodelgrids::utils::TestPointsPipeline::testRunFifo(void) {
+    const char* filename = "pipeline_points.fifo";
+    unlink(filename);
+    REQUIRE(0 == mkfifo(filename, S_IRUSR | S_IWUSR));
+
+    const size_t numPoints = 500;
+    std::thread producer(_writePoints, filename, numPoints);
+    _checkRun(filename, numPoints, 3);
+    producer.join();
+    unlink(filename);
+} // testRunFifo
+
+
+// ------------------------------------------------------------------------------------------------
+// Test run() with exception in worker.
+void
+geomodelgrids::utils::TestPointsPipeline::testRunError(void) {
+    const size_t numPoints = 1000;
+    _writePoints("pipeline_points.txt", numPoints);
+
+    PointsReader reader;
+    reader.open("pipeline_points.txt", PointsReader::TEXT, 2);
+    PointsWriter writer;
+    writer.open("pipeline_values.raw64", PointsReader::RAW_FLOAT64, 3);
+
+    PointsPipeline pipeline;
+    pipeline.setNumWorkers(3);
+    pipeline.setBatchSize(10);
+    PointsPipeline::ProcessFn process = [](double* const rows,
+                                           const double* const points,
+                                           const size_t numPoints,
+                                           const size_t offset,
+                                           const size_t worker) {
+        for (size_t i = 0; i < numPoints; ++i) {
+            if (555.0 == points[2*i]) {
+                throw std::runtime_error("Bad point.");
+            } // if
+        } // for
+    };
+    CHECK_THROWS_AS(pipeline.run(&reader, 2, &writer, 3, process), std::runtime_error);
+} // testRunError
+
+
+// ------------------------------------------------------------------------------------------------
+// Write points to text file.
+void
+geomodelgrids::utils::TestPointsPipeline::_writePoints(const char* filename,
+                                                       const size_t numPoints) {
+    std::ofstream sout(filename);
+    sout << "# x y\n";
+    for (size_t i = 0; i < numPoints; ++i) {
+        sout << i << " " << 2*i << "\n";
+    } // for
+    sout.close();
+} // _writePoints
+
+
+// ------------------------------------------------------------------------------------------------
+// Run pipeline and check output.
+void
+geomodelgrids::utils::TestPointsPipeline::_checkRun(const char* filename,
+                                                    const size_t numPoints,
+                                                    const size_t numWorkers) {
+    const size_t spaceDim = 2;
+    const size_t numColumns = 3;
+
+    PointsReader reader;
+    reader.open(filename, PointsReader::TEXT, spaceDim);
+    PointsWriter writer;
+    writer.open("pipeline_values.raw64", PointsReader::RAW_FLOAT64, numColumns);
+
+    PointsPipeline pipeline;
+    pipeline.setNumWorkers(numWorkers);
+    pipeline.setBatchSize(7);
+    pipeline.setRowsPerPoint(2);
+    std::vector<size_t> workerPoints(numWorkers);
+    PointsPipeline::ProcessFn process = [&workerPoints](double* const rows,
+                                                        const double* const points,
+                                                        const size_t numPoints,
+                                                        const size_t offset,
+                                                        const size_t worker) {
+        for (size_t i = 0; i < numPoints; ++i) {
+            rows[6*i+0] = points[2*i+0];
+            rows[6*i+1] = points[2*i+1];
+            rows[6*i+2] = points[2*i+0] + points[2*i+1];
+            rows[6*i+3] = double(offset + i);
+            rows[6*i+4] = 0.0;
+            rows[6*i+5] = 0.0;
+        } // for
+        workerPoints[worker] += numPoints;
+    };
+    CHECK(numPoints == pipeline.run(&reader, spaceDim, &writer, numColumns, process));
+    writer.close();
+    reader.close();
+
+    size_t numProcessed = 0;
+    for (size_t i = 0; i < numWorkers; ++i) {
+        numProcessed += workerPoints[i];
+    } // for
+    CHECK(numPoints == numProcessed);
+
+    PointsReader check;
+    check.open("pipeline_values.raw64", PointsReader::RAW_FLOAT64, numColumns);
+    REQUIRE(2*numPoints == check.getNumPoints());
+    std::vector<double> rows(2*numPoints*numColumns);
+    REQUIRE(2*numPoints == check.read(rows.data(), 2*numPoints));
+    for (size_t i = 0; i < numPoints; ++i) {
+        INFO("Mismatch for point " << i << ".");
+        CHECK(double(i) == rows[6*i+0]);
+        CHECK(double(2*i) == rows[6*i+1]);
+        CHECK(double(3*i) == rows[6*i+2]);
+        CHECK(double(i) == rows[6*i+3]);
+    } // for
+} // _checkRun
+
+
+// End of file
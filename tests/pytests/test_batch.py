@@ -54,6 +54,20 @@ class TestBatchGenerator2D(unittest.TestCase):
         genbatch = batch.BatchGenerator2D(NUM_X, NUM_Y, max_nvalues=15*16)
         self._check_batches(BATCHES, genbatch)
 
+    def test_chunks(self):
+        NUM_X = 15
+        NUM_Y = 23
+        BATCHES = [
+            [(0, 8), (0, 9)],
+            [(0, 8), (9, 18)],
+            [(0, 8), (18, 23)],
+            [(8, 15), (0, 9)],
+            [(8, 15), (9, 18)],
+            [(8, 15), (18, 23)],
+        ]
+        genbatch = batch.BatchGenerator2D(NUM_X, NUM_Y, max_nvalues=10**2, chunks=(4, 3))
+        self._check_batches(BATCHES, genbatch)
+
     def _check_batches(self, batchesE, genbatch):
         count = 0
         for bE, b in zip(batchesE, genbatch):
@@ -170,6 +184,27 @@ class TestBatchGenerator3D(unittest.TestCase):
         genbatch = batch.BatchGenerator3D(NUM_X, NUM_Y, NUM_Z, max_nvalues=15**3)
         self._check_batches(BATCHES, genbatch)
 
+    def test_chunks(self):
+        NUM_X = 15
+        NUM_Y = 23
+        NUM_Z = 18
+        BATCHES = [
+            [(0, 8), (0, 12), (0, 6)],
+            [(0, 8), (0, 12), (6, 12)],
+            [(0, 8), (0, 12), (12, 18)],
+            [(0, 8), (12, 23), (0, 6)],
+            [(0, 8), (12, 23), (6, 12)],
+            [(0, 8), (12, 23), (12, 18)],
+            [(8, 15), (0, 12), (0, 6)],
+            [(8, 15), (0, 12), (6, 12)],
+            [(8, 15), (0, 12), (12, 18)],
+            [(8, 15), (12, 23), (0, 6)],
+            [(8, 15), (12, 23), (6, 12)],
+            [(8, 15), (12, 23), (12, 18)],
+        ]
+        genbatch = batch.BatchGenerator3D(NUM_X, NUM_Y, NUM_Z, max_nvalues=10**3, chunks=(4, 12, 6))
+        self._check_batches(BATCHES, genbatch)
+
     def _check_batches(self, batchesE, genbatch):
         count = 0
         for bE, b in zip(batchesE, genbatch):
@@ -9,6 +9,7 @@ import numpy
 import json
 
 from geomodelgrids.create.apps.create_model import App
+from geomodelgrids.create.core import NODATA_VALUE
 from geomodelgrids.create.core.model import ModelMetadata
 from geomodelgrids.create.testing.datasrc import AnalyticDataSrc
 from geomodelgrids.create.utils import config
@@ -17,6 +18,9 @@ from geomodelgrids.create.utils import config
 class TestApp(unittest.TestCase):
     CONFIG_FILENAME = "test_createapp.cfg"
     TOLERANCE = 1.0e-6
+    LEVELS = {}  # Expected steps (x, y, z) for each level of each block.
+    PLANAR = ()  # Blocks with planar layout of values.
+    NUM_WORKERS = 1  # Number of worker processes evaluating batches of block values.
 
     def setUp(self):
         def _surface_metadata(sconfig):
@@ -102,6 +106,10 @@ class TestApp(unittest.TestCase):
         attrs = h5.attrs
         self._check_attributes(ModelMetadata.__dataclass_fields__, self.metadata, attrs)
 
+        snapshot = [v.decode("utf-8") if isinstance(v, bytes) else v for v in attrs["metadata_snapshot"]]
+        self.assertEqual("geomodelgrids-metadata-1", snapshot[0])
+        self.assertIn("title", snapshot)
+
     def test_surfaces(self):
         ARGS = {
             "config_filenames": self.CONFIG_FILENAME,
@@ -149,6 +157,7 @@ class TestApp(unittest.TestCase):
             "import_domain": True,
             "import_surfaces": True,
             "import_blocks": True,
+            "num_workers": self.NUM_WORKERS,
         }
         app = App(show_progress=False, debug=True)
         app.main(**ARGS)
@@ -161,9 +170,21 @@ class TestApp(unittest.TestCase):
             valuesE[:, :, :, 0] = AnalyticDataSrc._get_values_one(points)
             valuesE[:, :, :, 1] = AnalyticDataSrc._get_values_two(points)
 
-            values = h5["blocks"][block][:]
+            block_dataset = h5["blocks"][block]
+            values = self._get_values(block_dataset)
+            self.assertEqual(block in self.PLANAR, "value_layout" in block_dataset.attrs)
+            if block in self.PLANAR:
+                self.assertEqual(1, block_dataset.chunks[0])
 
             toleranceV = numpy.maximum(self.TOLERANCE, numpy.abs(valuesE)*self.TOLERANCE)
+            if "scale_factor" in block_dataset.attrs:
+                scale_factor = block_dataset.attrs["scale_factor"]
+                self.assertFalse(numpy.any(values == block_dataset.attrs["missing_value"]))
+                values = values * scale_factor + block_dataset.attrs["add_offset"]
+                toleranceV = numpy.maximum(toleranceV, 0.5001*scale_factor)
+            if block_dataset.scaleoffset is not None:
+                self.assertEqual(block_dataset.fillvalue, numpy.float32(NODATA_VALUE))
+                toleranceV = numpy.maximum(toleranceV, 10.0**-block_dataset.scaleoffset)
             valuesOk = numpy.abs(valuesE - values) < toleranceV
             if numpy.sum(valuesOk.ravel()) != valuesOk.size:
                 msg = (
@@ -174,6 +195,48 @@ class TestApp(unittest.TestCase):
                 h5.close()
                 self.assertEqual(numpy.sum(valuesOk.ravel()), valuesOk.size, msg="\n".join(msg))
 
+    def test_levels(self):
+        ARGS = {
+            "config_filenames": self.CONFIG_FILENAME,
+            "import_domain": True,
+            "import_surfaces": True,
+            "import_blocks": True,
+            "num_workers": self.NUM_WORKERS,
+        }
+        app = App(show_progress=False, debug=True)
+        app.main(**ARGS)
+
+        h5 = h5py.File(self.metadata["filename"], "r")
+        self.assertEqual(bool(self.LEVELS), "levels" in h5)
+        for block, levels in self.LEVELS.items():
+            block_dataset = h5["blocks"][block]
+            values = self._get_values(block_dataset)
+            self.assertEqual(sorted(levels), sorted(h5["levels"][block]))
+            for factor, steps in levels.items():
+                level_dataset = h5["levels"][block][factor]
+                (step_x, step_y, step_z) = steps
+                self.assertTrue(numpy.array_equal(values[::step_x, ::step_y, ::step_z, :],
+                                                  self._get_values(level_dataset)),
+                                msg=f"Mismatch in values of level {factor} of block '{block}'.")
+                for axis, step in zip("xyz", steps):
+                    name = f"{axis}_resolution"
+                    self.assertEqual(step * block_dataset.attrs[name], level_dataset.attrs[name])
+                self.assertEqual(block_dataset.attrs["z_top"], level_dataset.attrs["z_top"])
+
+        snapshot = [v.decode("utf-8") if isinstance(v, bytes) else v for v in h5.attrs["metadata_snapshot"]]
+        for block, levels in self.LEVELS.items():
+            for factor in levels:
+                self.assertIn(f"/levels/{block}/{factor}", snapshot)
+        h5.close()
+
+    @staticmethod
+    def _get_values(dataset):
+        """Get values of block dataset with values as the last dimension."""
+        values = dataset[:]
+        if "value_layout" in dataset.attrs and dataset.attrs["value_layout"] in ("planar", b"planar"):
+            values = numpy.moveaxis(values, 0, -1)
+        return values
+
     def _check_attributes(self, names, attrsE, attrs):
         for attr in names:
             msg = f"Mismatch for attribute '{attr}'."
@@ -247,6 +310,20 @@ class TestApp(unittest.TestCase):
 
 class TestAppBatch(TestApp):
     CONFIG_FILENAME = "test_createapp_batch.cfg"
+    LEVELS = {
+        "top": {"2": (2, 2, 1), "4": (2, 4, 1)},
+        "bottom": {"2": (1, 2, 1)},
+    }
+    PLANAR = ("top",)
+
+
+class TestAppBatchWorkers(TestAppBatch):
+    NUM_WORKERS = 2
+
+
+class TestAppFilesWorkers(TestAppBatch):
+    CONFIG_FILENAME = "test_createapp_files.cfg"
+    NUM_WORKERS = 2
 
 
 class TestAppVarZ(TestApp):
@@ -280,7 +357,7 @@ class TestAppVarXYZ(TestApp):
 
 
 def load_tests(loader, tests, pattern):
-    TEST_CLASSES = [TestApp, TestAppBatch, TestAppVarZ, TestAppVarXYZ]
+    TEST_CLASSES = [TestApp, TestAppBatch, TestAppBatchWorkers, TestAppFilesWorkers, TestAppVarZ, TestAppVarXYZ]
 
     suite = unittest.TestSuite()
     for cls in TEST_CLASSES:
@@ -17,6 +17,10 @@
 
 #include "catch2/catch_session.hpp"
 
+#if defined(WITH_MPI)
+#include <mpi.h> // USES MPI_Init(), MPI_Finalize()
+#endif
+
 namespace geomodelgrids {
     namespace testing {
         class TestDriver;
@@ -77,7 +81,14 @@ geomodelgrids::testing::TestDriver::run(int argc,
 int
 main(int argc,
      char* argv[]) {
+#if defined(WITH_MPI)
+    MPI_Init(&argc, &argv);
+    const int result = geomodelgrids::testing::TestDriver().run(argc, argv);
+    MPI_Finalize();
+    return result;
+#else
     return geomodelgrids::testing::TestDriver().run(argc, argv);
+#endif
 } // main
 
 